@@ -0,0 +1,74 @@
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "exceptions.hpp"
+
+namespace cpp_utils {
+
+    MappedFile::MappedFile(const boost::filesystem::path& path): path{path}, data{nullptr}, bytes{0} {
+        int fd = ::open(path.native().c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw cpp_utils::exceptions::FileOpeningException{path};
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw cpp_utils::exceptions::FileOpeningException{path};
+        }
+        this->bytes = static_cast<std::size_t>(info.st_size);
+        if (this->bytes > 0) {
+            void* result = ::mmap(nullptr, this->bytes, PROT_READ, MAP_SHARED, fd, 0);
+            if (result == MAP_FAILED) {
+                ::close(fd);
+                throw cpp_utils::exceptions::FileOpeningException{path};
+            }
+            this->data = static_cast<char*>(result);
+        }
+        //the mapping keeps the file alive
+        ::close(fd);
+    }
+
+    MappedFile::MappedFile(MappedFile&& o): path{::std::move(o.path)}, data{o.data}, bytes{o.bytes} {
+        o.data = nullptr;
+        o.bytes = 0;
+    }
+
+    MappedFile& MappedFile::operator =(MappedFile&& o) {
+        this->unmap();
+        this->path = ::std::move(o.path);
+        this->data = o.data;
+        this->bytes = o.bytes;
+        o.data = nullptr;
+        o.bytes = 0;
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        this->unmap();
+    }
+
+    const char* MappedFile::getData() const {
+        return this->data;
+    }
+
+    std::size_t MappedFile::size() const {
+        return this->bytes;
+    }
+
+    const boost::filesystem::path& MappedFile::getPath() const {
+        return this->path;
+    }
+
+    void MappedFile::unmap() {
+        if (this->data != nullptr) {
+            ::munmap(this->data, this->bytes);
+            this->data = nullptr;
+            this->bytes = 0;
+        }
+    }
+
+}
@@ -212,7 +212,7 @@ namespace cpp_utils {
     #else
         timespec raw_time;
         clock_gettime(CLOCK_MONOTONIC , &raw_time);
-        return timing_t{(double)(raw_time.tv_nsec), timeunit_e::NANO}.toMicros();
+        return timing_t{(double)(raw_time.tv_sec) * 1e9 + (double)(raw_time.tv_nsec), timeunit_e::NANO}.toMicros();
     #endif
     }
 
@@ -228,10 +228,8 @@ namespace cpp_utils {
         timespec stop;
         clock_gettime(CLOCK_MONOTONIC , &stop);
 
-        if ((stop.tv_nsec-start_time.tv_nsec) < 0)
-            return timing_t{(double)(1000000000+stop.tv_nsec-start_time.tv_nsec), timeunit_e::NANO}.toMicros();
-        else
-            return timing_t{(double)(stop.tv_nsec - start_time.tv_nsec), timeunit_e::NANO}.toMicros();
+        //seconds need to be considered as well, otherwise timings longer than 1 second are wrapped around
+        return timing_t{(double)(stop.tv_sec - start_time.tv_sec) * 1e9 + (double)(stop.tv_nsec - start_time.tv_nsec), timeunit_e::NANO}.toMicros();
     #endif
     }
 
@@ -245,10 +243,7 @@ namespace cpp_utils {
         //Nanoseconds nanosecs = AbsoluteToNanoseconds(*(AbsoluteTime*)&elapsed_time);
         //return (double) UnsignedWideToUInt64(nanosecs) ;
     #else
-        if ((stop_time.tv_nsec-start_time.tv_nsec) < 0)
-            return timing_t{(double)(1000000000+stop_time.tv_nsec-start_time.tv_nsec), timeunit_e::NANO}.toMicros();
-        else
-            return timing_t{(double)(stop_time.tv_nsec - start_time.tv_nsec), timeunit_e::NANO}.toMicros();
+        return timing_t{(double)(stop_time.tv_sec - start_time.tv_sec) * 1e9 + (double)(stop_time.tv_nsec - start_time.tv_nsec), timeunit_e::NANO}.toMicros();
     #endif
     }
 
@@ -0,0 +1,88 @@
+#include "firstMoveDatabase.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include "adjacentGraph.hpp"
+
+namespace cpp_utils::graphs {
+
+    FirstMoveDatabase::FirstMoveDatabase(const boost::filesystem::path& path): file{new MappedFile{path}} {
+        using namespace cpp_utils::graphs::internal;
+
+        if (this->file->size() < sizeof(MappedFirstMoveDatabaseHeader)) {
+            throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "header"};
+        }
+        const MappedFirstMoveDatabaseHeader* header = reinterpret_cast<const MappedFirstMoveDatabaseHeader*>(this->file->getData());
+        if (std::memcmp(header->magic, MAPPED_FIRST_MOVE_DATABASE_MAGIC, sizeof(header->magic)) != 0) {
+            throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "magic number"};
+        }
+        if (header->version != MAPPED_FIRST_MOVE_DATABASE_VERSION) {
+            throw cpp_utils::exceptions::InvalidFormatException<std::string, uint32_t>{path.native(), header->version};
+        }
+        if (header->numberOfVertices == std::numeric_limits<uint64_t>::max()
+            || !this->file->containsSection<uint32_t>(header->orderOffset, header->numberOfVertices)
+            || !this->file->containsSection<uint64_t>(header->runsBeginOffset, header->numberOfVertices + 1)
+            || !this->file->containsSection<uint32_t>(header->runStartsOffset, header->numberOfRuns)
+            || !this->file->containsSection<moveid_t>(header->runMovesOffset, header->numberOfRuns)) {
+            throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "truncated file"};
+        }
+
+        const char* base = this->file->getData();
+        this->order = ConstSpan<uint32_t>{reinterpret_cast<const uint32_t*>(base + header->orderOffset), header->numberOfVertices};
+        this->runsBegin = ConstSpan<uint64_t>{reinterpret_cast<const uint64_t*>(base + header->runsBeginOffset), header->numberOfVertices + 1};
+        this->runStarts = ConstSpan<uint32_t>{reinterpret_cast<const uint32_t*>(base + header->runStartsOffset), header->numberOfRuns};
+        this->runMoves = ConstSpan<moveid_t>{reinterpret_cast<const moveid_t*>(base + header->runMovesOffset), header->numberOfRuns};
+
+        //lookups index runStarts with runsBegin and assume the first run of each source starts at 0
+        const uint64_t vertices = header->numberOfVertices;
+        const uint64_t* runsBegin = this->runsBegin.data();
+        const uint32_t* runStarts = this->runStarts.data();
+        if (runsBegin[0] != 0 || runsBegin[vertices] != header->numberOfRuns) {
+            throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "runs of the vertices"};
+        }
+        for (uint64_t id=0; id<vertices; ++id) {
+            if (runsBegin[id] > runsBegin[id + 1]) {
+                throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "runs of the vertices"};
+            }
+            //with a single vertex, no lookup reaches the runs
+            if (vertices > 1 && (runsBegin[id] == runsBegin[id + 1] || runStarts[runsBegin[id]] != 0)) {
+                throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "runs of the vertices"};
+            }
+        }
+    }
+
+}
+
+namespace cpp_utils::serializers {
+
+    void saveToMappableFile(FILE* f, const cpp_utils::graphs::FirstMoveDatabase& db) {
+        using namespace cpp_utils::graphs;
+        using namespace cpp_utils::graphs::internal;
+
+        const uint64_t vertices = db.numberOfVertices();
+        const uint64_t runs = db.numberOfRuns();
+
+        MappedFirstMoveDatabaseHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAPPED_FIRST_MOVE_DATABASE_MAGIC, sizeof(header.magic));
+        header.version = MAPPED_FIRST_MOVE_DATABASE_VERSION;
+        header.flags = 0;
+        header.numberOfVertices = vertices;
+        header.numberOfRuns = runs;
+        header.orderOffset = alignMappedOffset(sizeof(header));
+        header.runsBeginOffset = alignMappedOffset(header.orderOffset + sizeof(uint32_t) * vertices);
+        header.runStartsOffset = alignMappedOffset(header.runsBeginOffset + sizeof(uint64_t) * (vertices + 1));
+        header.runMovesOffset = alignMappedOffset(header.runStartsOffset + sizeof(uint32_t) * runs);
+
+        uint64_t position = 0;
+        writeMappedSection<MappedFirstMoveDatabaseHeader>(f, position, 0, 1, [&](uint64_t i) { return header; });
+        writeMappedSection<uint32_t>(f, position, header.orderOffset, vertices, [&](uint64_t i) { return db.order.data()[i]; });
+        writeMappedSection<uint64_t>(f, position, header.runsBeginOffset, vertices + 1, [&](uint64_t i) {
+            return (vertices == 0) ? static_cast<uint64_t>(0) : db.runsBegin.data()[i];
+        });
+        writeMappedSection<uint32_t>(f, position, header.runStartsOffset, runs, [&](uint64_t i) { return db.runStarts.data()[i]; });
+        writeMappedSection<moveid_t>(f, position, header.runMovesOffset, runs, [&](uint64_t i) { return db.runMoves.data()[i]; });
+    }
+
+}
@@ -0,0 +1,324 @@
+#include "graphRenderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace cpp_utils::graphs::internal {
+
+    namespace {
+
+        /**
+         * @brief ideal length of an edge in the layout
+         *
+         */
+        constexpr double IDEAL_DISTANCE = 1.0;
+
+        /**
+         * @brief vertices farther than this are assumed not to push each other
+         *
+         */
+        constexpr double REPULSION_RADIUS = 2 * IDEAL_DISTANCE;
+
+        /**
+         * @brief distances below this are considered 0
+         *
+         */
+        constexpr double EPSILON = 1e-9;
+
+        constexpr uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * @brief an undirected view of the edges, in CSR form
+         *
+         */
+        struct UndirectedAdjacency {
+            /**
+             * @brief the neighbours of the vertex @c v are `neighbours[begin[v]]` up to `neighbours[begin[v + 1]]` (excluded)
+             *
+             */
+            std::vector<uint32_t> begin;
+            std::vector<uint32_t> neighbours;
+
+            UndirectedAdjacency(uint32_t vertices, const std::vector<std::pair<uint32_t, uint32_t>>& edges): begin(static_cast<size_t>(vertices) + 1, 0), neighbours(2 * edges.size()) {
+                for (auto& edge : edges) {
+                    this->begin[edge.first + 1] += 1;
+                    this->begin[edge.second + 1] += 1;
+                }
+                for (size_t id=1; id<this->begin.size(); ++id) {
+                    this->begin[id] += this->begin[id - 1];
+                }
+                std::vector<uint32_t> next{this->begin.begin(), this->begin.end() - 1};
+                for (auto& edge : edges) {
+                    this->neighbours[next[edge.first]++] = edge.second;
+                    this->neighbours[next[edge.second]++] = edge.first;
+                }
+            }
+
+            /**
+             * @brief number of hops from @c source to each vertex, or UNREACHABLE
+             *
+             */
+            std::vector<uint32_t> getHops(uint32_t source) const {
+                std::vector<uint32_t> result(this->begin.size() - 1, UNREACHABLE);
+                std::vector<uint32_t> queue{source};
+                result[source] = 0;
+                for (size_t head=0; head<queue.size(); ++head) {
+                    const uint32_t id = queue[head];
+                    for (uint32_t i=this->begin[id]; i<this->begin[id + 1]; ++i) {
+                        if (result[this->neighbours[i]] == UNREACHABLE) {
+                            result[this->neighbours[i]] = result[id] + 1;
+                            queue.push_back(this->neighbours[i]);
+                        }
+                    }
+                }
+                return result;
+            }
+        };
+
+        /**
+         * @brief the reachable vertex maximizing the given score
+         *
+         */
+        template <typename SCORE>
+        uint32_t getBestPivot(const std::vector<uint32_t>& hops, SCORE score) {
+            uint32_t result = 0;
+            for (uint32_t id=0; id<hops.size(); ++id) {
+                if (hops[id] != UNREACHABLE && score(id) > score(result)) {
+                    result = id;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief the vertices of a layout bucketed by the cell of a uniform grid they are in
+         *
+         */
+        class RepulsionGrid {
+        private:
+            double minX;
+            double minY;
+            double cellSide;
+            uint32_t columns;
+            uint32_t rows;
+            /**
+             * @brief the vertices in the cell @c c are `vertices[begin[c]]` up to `vertices[begin[c + 1]]` (excluded)
+             *
+             */
+            std::vector<uint32_t> begin;
+            std::vector<uint32_t> vertices;
+        public:
+            explicit RepulsionGrid(const std::vector<std::pair<double, double>>& positions) {
+                double maxX = -std::numeric_limits<double>::infinity();
+                double maxY = -std::numeric_limits<double>::infinity();
+                this->minX = std::numeric_limits<double>::infinity();
+                this->minY = std::numeric_limits<double>::infinity();
+                for (auto& position : positions) {
+                    this->minX = std::min(this->minX, position.first);
+                    this->minY = std::min(this->minY, position.second);
+                    maxX = std::max(maxX, position.first);
+                    maxY = std::max(maxY, position.second);
+                }
+                //we don't want more cells than vertices, otherwise scanning the empty ones dominates
+                const double maxSide = std::max(maxX - this->minX, maxY - this->minY);
+                const double maxCells = std::max(1.0, std::ceil(std::sqrt(static_cast<double>(positions.size()))));
+                this->cellSide = std::max(REPULSION_RADIUS, maxSide / maxCells);
+                this->columns = static_cast<uint32_t>((maxX - this->minX) / this->cellSide) + 1;
+                this->rows = static_cast<uint32_t>((maxY - this->minY) / this->cellSide) + 1;
+
+                std::vector<uint32_t> cellOf(positions.size());
+                this->begin.assign(static_cast<size_t>(this->columns) * this->rows + 1, 0);
+                for (uint32_t id=0; id<positions.size(); ++id) {
+                    cellOf[id] = this->getCell(positions[id]);
+                    this->begin[cellOf[id] + 1] += 1;
+                }
+                for (size_t cell=1; cell<this->begin.size(); ++cell) {
+                    this->begin[cell] += this->begin[cell - 1];
+                }
+                std::vector<uint32_t> next{this->begin.begin(), this->begin.end() - 1};
+                this->vertices.resize(positions.size());
+                for (uint32_t id=0; id<positions.size(); ++id) {
+                    this->vertices[next[cellOf[id]]++] = id;
+                }
+            }
+        public:
+            uint32_t getColumn(double x) const {
+                return std::min(this->columns - 1, static_cast<uint32_t>((x - this->minX) / this->cellSide));
+            }
+            uint32_t getRow(double y) const {
+                return std::min(this->rows - 1, static_cast<uint32_t>((y - this->minY) / this->cellSide));
+            }
+            uint32_t getCell(const std::pair<double, double>& position) const {
+                return this->getRow(position.second) * this->columns + this->getColumn(position.first);
+            }
+            /**
+             * @brief call @c lambda over each vertex in the cells around the given position
+             *
+             */
+            template <typename LAMBDA>
+            void forEachNearbyVertex(const std::pair<double, double>& position, LAMBDA lambda) const {
+                const uint32_t column = this->getColumn(position.first);
+                const uint32_t row = this->getRow(position.second);
+                for (uint32_t y=(row > 0 ? row - 1 : 0); y<=std::min(this->rows - 1, row + 1); ++y) {
+                    for (uint32_t x=(column > 0 ? column - 1 : 0); x<=std::min(this->columns - 1, column + 1); ++x) {
+                        const uint32_t cell = y * this->columns + x;
+                        for (uint32_t i=this->begin[cell]; i<this->begin[cell + 1]; ++i) {
+                            lambda(this->vertices[i]);
+                        }
+                    }
+                }
+            }
+        };
+
+    }
+
+    std::vector<std::pair<double, double>> computeForceDirectedLayout(uint32_t vertices, const std::vector<std::pair<uint32_t, uint32_t>>& edges, size_t iterations, uint32_t seed) {
+        //a square where each vertex has roughly an ideal distance worth of space
+        const double side = std::max(1.0, std::sqrt(static_cast<double>(vertices))) * IDEAL_DISTANCE;
+        std::mt19937 generator{seed};
+        std::uniform_real_distribution<double> distribution{0, side};
+        std::uniform_real_distribution<double> jitter{-0.1 * IDEAL_DISTANCE, 0.1 * IDEAL_DISTANCE};
+        std::vector<std::pair<double, double>> positions{};
+        positions.reserve(vertices);
+        if (vertices == 0) {
+            return positions;
+        }
+
+        //springs alone untangle a random placement of a large graph very slowly. So we start from the hop distances from 2
+        //far apart pivots (which, for instance, already yields a rotated grid for a grid), and the springs only refine it
+        UndirectedAdjacency adjacency{vertices, edges};
+        const std::vector<uint32_t> fromStart = adjacency.getHops(0);
+        const uint32_t firstPivot = getBestPivot(fromStart, [&](uint32_t id) { return fromStart[id]; });
+        const std::vector<uint32_t> fromFirst = adjacency.getHops(firstPivot);
+        const uint32_t farthestPivot = getBestPivot(fromFirst, [&](uint32_t id) { return fromFirst[id]; });
+        const std::vector<uint32_t> fromFarthest = adjacency.getHops(farthestPivot);
+        //the 2 pivots above are on the same axis. The second one is far from both
+        const uint32_t secondPivot = getBestPivot(fromFirst, [&](uint32_t id) { return std::min(fromFirst[id], fromFarthest[id]); });
+        const std::vector<uint32_t> fromSecond = adjacency.getHops(secondPivot);
+        for (uint32_t id=0; id<vertices; ++id) {
+            if (fromFirst[id] == UNREACHABLE) {
+                //not in the component of the vertex 0
+                positions.push_back(std::make_pair(distribution(generator), distribution(generator)));
+            } else {
+                positions.push_back(std::make_pair(fromFirst[id] * IDEAL_DISTANCE + jitter(generator), fromSecond[id] * IDEAL_DISTANCE + jitter(generator)));
+            }
+        }
+
+        const double squaredIdealDistance = IDEAL_DISTANCE * IDEAL_DISTANCE;
+        const double squaredRepulsionRadius = REPULSION_RADIUS * REPULSION_RADIUS;
+        std::vector<std::pair<double, double>> displacements(vertices);
+        for (size_t iteration=0; iteration<iterations; ++iteration) {
+            //the maximum movement of a vertex linearly cools down
+            const double temperature = IDEAL_DISTANCE * (1.0 - static_cast<double>(iteration) / iterations);
+            std::fill(displacements.begin(), displacements.end(), std::make_pair(0.0, 0.0));
+
+            RepulsionGrid grid{positions};
+            for (uint32_t id=0; id<vertices; ++id) {
+                const auto& position = positions[id];
+                grid.forEachNearbyVertex(position, [&](uint32_t other) {
+                    if (other == id) {
+                        return;
+                    }
+                    double dx = position.first - positions[other].first;
+                    double dy = position.second - positions[other].second;
+                    double squaredDistance = dx * dx + dy * dy;
+                    if (squaredDistance > squaredRepulsionRadius) {
+                        return;
+                    }
+                    if (squaredDistance < EPSILON) {
+                        //overlapping vertices: push them apart along an arbitrary (but deterministic) direction
+                        dx = id < other ? EPSILON : -EPSILON;
+                        dy = 0;
+                        squaredDistance = EPSILON * EPSILON;
+                    }
+                    //k^2 / d along the unit vector (dx, dy) / d
+                    const double factor = squaredIdealDistance / squaredDistance;
+                    displacements[id].first += dx * factor;
+                    displacements[id].second += dy * factor;
+                });
+            }
+            for (auto& edge : edges) {
+                if (edge.first == edge.second) {
+                    continue;
+                }
+                const double dx = positions[edge.first].first - positions[edge.second].first;
+                const double dy = positions[edge.first].second - positions[edge.second].second;
+                const double distance = std::sqrt(dx * dx + dy * dy);
+                if (distance < EPSILON) {
+                    continue;
+                }
+                //Eades' spring: log(d / k) along the unit vector (dx, dy) / d. It grows slower than the d^2 / k of
+                //Fruchterman-Reingold, so the few long edges do not dominate the displacements
+                const double factor = std::log(distance / IDEAL_DISTANCE) / distance;
+                displacements[edge.first].first -= dx * factor;
+                displacements[edge.first].second -= dy * factor;
+                displacements[edge.second].first += dx * factor;
+                displacements[edge.second].second += dy * factor;
+            }
+            for (uint32_t id=0; id<vertices; ++id) {
+                const double length = std::sqrt(displacements[id].first * displacements[id].first + displacements[id].second * displacements[id].second);
+                if (length < EPSILON) {
+                    continue;
+                }
+                const double movement = std::min(length, temperature) / length;
+                positions[id].first += displacements[id].first * movement;
+                positions[id].second += displacements[id].second * movement;
+            }
+        }
+        return positions;
+    }
+
+    void rasterizeGraph(PPMImage& image, const std::vector<std::pair<double, double>>& positions, const std::vector<std::pair<uint32_t, uint32_t>>& edges, const GraphRenderingStyle& style) {
+        image.setAllPixels(style.background);
+        if (positions.empty()) {
+            return;
+        }
+
+        double minX = std::numeric_limits<double>::infinity();
+        double minY = std::numeric_limits<double>::infinity();
+        double maxX = -std::numeric_limits<double>::infinity();
+        double maxY = -std::numeric_limits<double>::infinity();
+        for (auto& position : positions) {
+            minX = std::min(minX, position.first);
+            minY = std::min(minY, position.second);
+            maxX = std::max(maxX, position.first);
+            maxY = std::max(maxY, position.second);
+        }
+        const double usableWidth = std::max(0.0, static_cast<double>(image.getWidth()) - 1 - 2 * style.margin);
+        const double usableHeight = std::max(0.0, static_cast<double>(image.getHeight()) - 1 - 2 * style.margin);
+        //same scale on both axes, otherwise the drawing is distorted. A single point goes in the top left corner
+        const double spanX = maxX - minX;
+        const double spanY = maxY - minY;
+        double scale = std::numeric_limits<double>::infinity();
+        if (spanX > 0) {
+            scale = std::min(scale, usableWidth / spanX);
+        }
+        if (spanY > 0) {
+            scale = std::min(scale, usableHeight / spanY);
+        }
+        if (std::isinf(scale)) {
+            scale = 0;
+        }
+
+        std::vector<std::pair<long, long>> pixels{};
+        pixels.reserve(positions.size());
+        for (auto& position : positions) {
+            pixels.push_back(std::make_pair(
+                static_cast<long>(style.margin) + std::lround((position.first - minX) * scale),
+                static_cast<long>(style.margin) + std::lround((position.second - minY) * scale)
+            ));
+        }
+
+        for (auto& edge : edges) {
+            const auto& source = pixels[edge.first];
+            const auto& sink = pixels[edge.second];
+            image.setLine(source.first, source.second, sink.first, sink.second, style.edgeColor);
+        }
+        for (auto& pixel : pixels) {
+            image.setSquare(pixel.first, pixel.second, style.vertexRadius, style.vertexColor);
+        }
+    }
+
+}
@@ -0,0 +1,540 @@
+#include "partitioning.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <random>
+
+namespace cpp_utils::graphs::internal {
+
+    namespace {
+
+        constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * @brief we stop coarsening once the graph has at most this number of vertices
+         *
+         */
+        constexpr uint32_t COARSEST_VERTICES = 100;
+
+        /**
+         * @brief we stop coarsening when a level does not remove at least this fraction of the vertices
+         *
+         */
+        constexpr double MINIMUM_COARSENING = 0.05;
+
+        /**
+         * @brief number of random regions we grow while bisecting the coarsest graph
+         *
+         */
+        constexpr int INITIAL_BISECTION_TRIES = 8;
+
+        /**
+         * @brief number of independent coarsenings (and bisections) we try for each bisection
+         *
+         */
+        constexpr int MULTILEVEL_TRIES = 4;
+
+        constexpr int MAXIMUM_REFINEMENT_PASSES = 8;
+
+        using Bisection = std::vector<uint8_t>;
+        using Weights = std::array<uint64_t, 2>;
+
+        /**
+         * @brief a graph coarser than another one, with the coarse vertex of each fine vertex
+         *
+         */
+        struct Coarsening {
+            PartitionGraph coarse;
+            std::vector<uint32_t> coarseIds;
+        };
+
+        /**
+         * @brief how much the weights of the sides exceed their maximum
+         *
+         */
+        uint64_t getOverweight(const Weights& weights, const Weights& maxWeights) {
+            uint64_t result = 0;
+            for (int side=0; side<2; ++side) {
+                result += (weights[side] > maxWeights[side]) ? (weights[side] - maxWeights[side]) : 0;
+            }
+            return result;
+        }
+
+        Weights getSideWeights(const PartitionGraph& graph, const Bisection& sides) {
+            Weights result{0, 0};
+            for (uint32_t id=0; id<graph.numberOfVertices(); ++id) {
+                result[sides[id]] += graph.vertexWeights[id];
+            }
+            return result;
+        }
+
+        /**
+         * @brief the total weight of the edges between the 2 sides
+         *
+         */
+        int64_t getCut(const PartitionGraph& graph, const Bisection& sides) {
+            int64_t result = 0;
+            for (uint32_t id=0; id<graph.numberOfVertices(); ++id) {
+                for (uint64_t e=graph.adjacencyBegin[id]; e<graph.adjacencyBegin[id + 1]; ++e) {
+                    if (sides[id] != sides[graph.neighbours[e]]) {
+                        result += graph.edgeWeights[e];
+                    }
+                }
+            }
+            return result / 2;
+        }
+
+        /**
+         * @brief contract a heavy edge matching of the graph
+         *
+         * Vertices are visited in random order: each one not matched yet is matched with the neighbour not matched yet
+         * connected by the heaviest edge (ties go to the lightest neighbour), unless the pair would weight more than
+         * @c maxVertexWeight.
+         */
+        Coarsening coarsen(const PartitionGraph& graph, uint64_t maxVertexWeight, std::mt19937& random) {
+            const uint32_t vertices = graph.numberOfVertices();
+            std::vector<uint32_t> order(vertices);
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin(), order.end(), random);
+
+            std::vector<uint32_t> match(vertices, NO_VERTEX);
+            for (auto id : order) {
+                if (match[id] != NO_VERTEX) {
+                    continue;
+                }
+                uint32_t best = id;
+                uint32_t bestWeight = 0;
+                for (uint64_t e=graph.adjacencyBegin[id]; e<graph.adjacencyBegin[id + 1]; ++e) {
+                    const uint32_t neighbour = graph.neighbours[e];
+                    if (match[neighbour] != NO_VERTEX || graph.vertexWeights[id] + graph.vertexWeights[neighbour] > maxVertexWeight) {
+                        continue;
+                    }
+                    if (graph.edgeWeights[e] > bestWeight || (graph.edgeWeights[e] == bestWeight && graph.vertexWeights[neighbour] < graph.vertexWeights[best])) {
+                        best = neighbour;
+                        bestWeight = graph.edgeWeights[e];
+                    }
+                }
+                match[id] = best;
+                match[best] = id;
+            }
+
+            Coarsening result{PartitionGraph{}, std::vector<uint32_t>(vertices, NO_VERTEX)};
+            std::vector<uint32_t> members{};
+            for (uint32_t id=0; id<vertices; ++id) {
+                if (result.coarseIds[id] == NO_VERTEX) {
+                    result.coarseIds[id] = members.size() / 2;
+                    result.coarseIds[match[id]] = members.size() / 2;
+                    members.push_back(id);
+                    members.push_back(match[id]);
+                }
+            }
+
+            //slot[c] is the position of the edge towards coarse vertex c in the adjacency being built
+            const uint32_t coarseVertices = members.size() / 2;
+            PartitionGraph& coarse = result.coarse;
+            std::vector<uint64_t> slot(coarseVertices, NO_VERTEX);
+            coarse.vertexWeights.reserve(coarseVertices);
+            coarse.adjacencyBegin.reserve(coarseVertices + 1);
+            coarse.adjacencyBegin.push_back(0);
+            for (uint32_t coarseId=0; coarseId<coarseVertices; ++coarseId) {
+                const uint32_t first = members[2 * coarseId];
+                const uint32_t second = members[2 * coarseId + 1];
+                coarse.vertexWeights.push_back(graph.vertexWeights[first] + ((first != second) ? graph.vertexWeights[second] : 0));
+                for (auto member : {first, second}) {
+                    for (uint64_t e=graph.adjacencyBegin[member]; e<graph.adjacencyBegin[member + 1]; ++e) {
+                        const uint32_t neighbour = result.coarseIds[graph.neighbours[e]];
+                        if (neighbour == coarseId) {
+                            continue;
+                        }
+                        if (slot[neighbour] == NO_VERTEX) {
+                            slot[neighbour] = coarse.neighbours.size();
+                            coarse.neighbours.push_back(neighbour);
+                            coarse.edgeWeights.push_back(graph.edgeWeights[e]);
+                        } else {
+                            coarse.edgeWeights[slot[neighbour]] += graph.edgeWeights[e];
+                        }
+                    }
+                    if (first == second) {
+                        break;
+                    }
+                }
+                for (uint64_t e=coarse.adjacencyBegin.back(); e<coarse.neighbours.size(); ++e) {
+                    slot[coarse.neighbours[e]] = NO_VERTEX;
+                }
+                coarse.adjacencyBegin.push_back(coarse.neighbours.size());
+            }
+            return result;
+        }
+
+        /**
+         * @brief improve a bisection via Fiduccia-Mattheyses
+         *
+         * Each pass moves every vertex at most once, always choosing the move with the best gain among the ones keeping
+         * the sides within their maximum weight (or reducing how much they exceed it). After a while without improvements
+         * the pass stops and the moves after the best state seen are undone. Passes go on while they improve the bisection.
+         */
+        void refineBisection(const PartitionGraph& graph, Bisection& sides, const Weights& maxWeights) {
+            using item_t = std::pair<int64_t, uint32_t>;
+            const uint32_t vertices = graph.numberOfVertices();
+            const size_t patience = std::max<size_t>(100, vertices / 20);
+            std::vector<int64_t> gains(vertices);
+            std::vector<uint8_t> locked(vertices);
+            std::vector<uint32_t> moves{};
+            Weights weights = getSideWeights(graph, sides);
+
+            for (int pass=0; pass<MAXIMUM_REFINEMENT_PASSES; ++pass) {
+                std::array<std::priority_queue<item_t>, 2> queues{};
+                for (uint32_t id=0; id<vertices; ++id) {
+                    int64_t gain = 0;
+                    bool onBoundary = false;
+                    for (uint64_t e=graph.adjacencyBegin[id]; e<graph.adjacencyBegin[id + 1]; ++e) {
+                        const bool external = sides[graph.neighbours[e]] != sides[id];
+                        gain += external ? graph.edgeWeights[e] : -static_cast<int64_t>(graph.edgeWeights[e]);
+                        onBoundary |= external;
+                    }
+                    gains[id] = gain;
+                    locked[id] = false;
+                    if (onBoundary) {
+                        queues[sides[id]].push(item_t{gain, id});
+                    }
+                }
+                //moving unbalanced heavy vertices may be the only way to fix the balance
+                if (getOverweight(weights, maxWeights) > 0) {
+                    for (uint32_t id=0; id<vertices; ++id) {
+                        if (weights[sides[id]] > maxWeights[sides[id]]) {
+                            queues[sides[id]].push(item_t{gains[id], id});
+                        }
+                    }
+                }
+
+                moves.clear();
+                int64_t cut = getCut(graph, sides);
+                int64_t bestCut = cut;
+                uint64_t bestOverweight = getOverweight(weights, maxWeights);
+                size_t bestMoves = 0;
+                size_t sinceBest = 0;
+                while (sinceBest < patience) {
+                    //drop the stale entries and the moves breaking the balance
+                    for (int side=0; side<2; ++side) {
+                        auto& queue = queues[side];
+                        while (!queue.empty()) {
+                            const uint32_t id = queue.top().second;
+                            if (locked[id] || sides[id] != side || gains[id] != queue.top().first) {
+                                queue.pop();
+                                continue;
+                            }
+                            const uint64_t to = weights[1 - side] + graph.vertexWeights[id];
+                            const uint64_t toExcess = (to > maxWeights[1 - side]) ? (to - maxWeights[1 - side]) : 0;
+                            const uint64_t fromExcess = (weights[side] > maxWeights[side]) ? (weights[side] - maxWeights[side]) : 0;
+                            if (toExcess > 0 && toExcess >= fromExcess) {
+                                queue.pop();
+                                continue;
+                            }
+                            break;
+                        }
+                    }
+                    int side;
+                    if (queues[0].empty() && queues[1].empty()) {
+                        break;
+                    } else if (queues[0].empty()) {
+                        side = 1;
+                    } else if (queues[1].empty()) {
+                        side = 0;
+                    } else {
+                        side = (queues[0].top().first >= queues[1].top().first) ? 0 : 1;
+                    }
+
+                    const uint32_t id = queues[side].top().second;
+                    queues[side].pop();
+                    sides[id] = 1 - side;
+                    locked[id] = true;
+                    weights[side] -= graph.vertexWeights[id];
+                    weights[1 - side] += graph.vertexWeights[id];
+                    cut -= gains[id];
+                    moves.push_back(id);
+                    for (uint64_t e=graph.adjacencyBegin[id]; e<graph.adjacencyBegin[id + 1]; ++e) {
+                        const uint32_t neighbour = graph.neighbours[e];
+                        if (locked[neighbour]) {
+                            continue;
+                        }
+                        //the edge became internal for the neighbours on the new side, and external for the ones on the old side
+                        gains[neighbour] += (sides[neighbour] == side) ? 2 * graph.edgeWeights[e] : -2 * static_cast<int64_t>(graph.edgeWeights[e]);
+                        queues[sides[neighbour]].push(item_t{gains[neighbour], neighbour});
+                    }
+
+                    const uint64_t overweight = getOverweight(weights, maxWeights);
+                    if (overweight < bestOverweight || (overweight == bestOverweight && cut < bestCut)) {
+                        bestOverweight = overweight;
+                        bestCut = cut;
+                        bestMoves = moves.size();
+                        sinceBest = 0;
+                    } else {
+                        sinceBest += 1;
+                    }
+                }
+
+                for (size_t i=moves.size(); i>bestMoves; --i) {
+                    const uint32_t id = moves[i - 1];
+                    weights[sides[id]] -= graph.vertexWeights[id];
+                    sides[id] = 1 - sides[id];
+                    weights[sides[id]] += graph.vertexWeights[id];
+                }
+                if (bestMoves == 0) {
+                    break;
+                }
+            }
+        }
+
+        /**
+         * @brief bisect a (small) graph by growing side 0 from random vertices, then refining it
+         *
+         * Side 0 grows greedily (GGGP): the next vertex is the one of the frontier whose move increases the cut the least.
+         *
+         * @return Bisection the best bisection found among INITIAL_BISECTION_TRIES tries
+         */
+        Bisection growBisection(const PartitionGraph& graph, uint64_t target, const Weights& maxWeights, std::mt19937& random) {
+            using item_t = std::pair<int64_t, uint32_t>;
+            const uint32_t vertices = graph.numberOfVertices();
+            std::uniform_int_distribution<uint32_t> distribution{0, vertices - 1};
+            Bisection best{};
+            uint64_t bestOverweight = 0;
+            int64_t bestCut = 0;
+            std::vector<int64_t> gains(vertices);
+
+            for (int attempt=0; attempt<INITIAL_BISECTION_TRIES; ++attempt) {
+                Bisection sides(vertices, 1);
+                std::vector<uint8_t> handled(vertices, false);
+                for (uint32_t id=0; id<vertices; ++id) {
+                    gains[id] = 0;
+                    for (uint64_t e=graph.adjacencyBegin[id]; e<graph.adjacencyBegin[id + 1]; ++e) {
+                        gains[id] -= graph.edgeWeights[e];
+                    }
+                }
+                std::priority_queue<item_t> frontier{};
+                uint64_t weight = 0;
+                uint32_t nextStart = distribution(random);
+                while (weight < target) {
+                    if (frontier.empty()) {
+                        //the graph may be disconnected
+                        uint32_t checked = 0;
+                        while (checked < vertices && handled[nextStart]) {
+                            nextStart = (nextStart + 1) % vertices;
+                            checked += 1;
+                        }
+                        if (checked == vertices) {
+                            break;
+                        }
+                        frontier.push(item_t{gains[nextStart], nextStart});
+                    }
+                    const uint32_t id = frontier.top().second;
+                    const bool stale = handled[id] || gains[id] != frontier.top().first;
+                    frontier.pop();
+                    if (stale) {
+                        continue;
+                    }
+                    handled[id] = true;
+                    if (weight > 0 && weight + graph.vertexWeights[id] > maxWeights[0]) {
+                        continue;
+                    }
+                    sides[id] = 0;
+                    weight += graph.vertexWeights[id];
+                    for (uint64_t e=graph.adjacencyBegin[id]; e<graph.adjacencyBegin[id + 1]; ++e) {
+                        const uint32_t neighbour = graph.neighbours[e];
+                        if (!handled[neighbour]) {
+                            gains[neighbour] += 2 * graph.edgeWeights[e];
+                            frontier.push(item_t{gains[neighbour], neighbour});
+                        }
+                    }
+                }
+
+                refineBisection(graph, sides, maxWeights);
+                const uint64_t overweight = getOverweight(getSideWeights(graph, sides), maxWeights);
+                const int64_t cut = getCut(graph, sides);
+                if (best.empty() || overweight < bestOverweight || (overweight == bestOverweight && cut < bestCut)) {
+                    best = std::move(sides);
+                    bestOverweight = overweight;
+                    bestCut = cut;
+                }
+            }
+            return best;
+        }
+
+        /**
+         * @brief bisect a graph via coarsening, initial bisection and refinement while uncoarsening
+         *
+         * The coarsening is random, so we repeat everything MULTILEVEL_TRIES times and keep the best bisection.
+         *
+         * @param fraction the fraction of the total weight side 0 should have
+         * @param imbalance each side weights at most `(1 + imbalance)` times its target
+         */
+        Bisection bisect(const PartitionGraph& graph, double fraction, double imbalance, std::mt19937& random) {
+            const uint64_t total = graph.getTotalWeight();
+            const uint64_t target = static_cast<uint64_t>(std::llround(total * fraction));
+            const Weights maxWeights{
+                std::max(target, static_cast<uint64_t>(std::floor((1 + imbalance) * target))),
+                std::max(total - target, static_cast<uint64_t>(std::floor((1 + imbalance) * (total - target))))
+            };
+
+            Bisection best{};
+            uint64_t bestOverweight = 0;
+            int64_t bestCut = 0;
+            for (int attempt=0; attempt<MULTILEVEL_TRIES; ++attempt) {
+                //level i + 1 is the contraction of level i; level 0 is the graph itself
+                std::vector<Coarsening> levels{};
+                auto getLevel = [&](size_t level) -> const PartitionGraph& {
+                    return (level == 0) ? graph : levels[level - 1].coarse;
+                };
+                const uint64_t maxVertexWeight = std::max<uint64_t>(1, (3 * total) / (2 * COARSEST_VERTICES));
+                while (getLevel(levels.size()).numberOfVertices() > COARSEST_VERTICES) {
+                    const PartitionGraph& fine = getLevel(levels.size());
+                    Coarsening coarsening = coarsen(fine, maxVertexWeight, random);
+                    if (coarsening.coarse.numberOfVertices() > (1 - MINIMUM_COARSENING) * fine.numberOfVertices()) {
+                        break;
+                    }
+                    levels.push_back(std::move(coarsening));
+                }
+
+                Bisection sides = growBisection(getLevel(levels.size()), target, maxWeights, random);
+                for (size_t level=levels.size(); level>0; --level) {
+                    const PartitionGraph& fine = getLevel(level - 1);
+                    Bisection fineSides(fine.numberOfVertices());
+                    for (uint32_t id=0; id<fine.numberOfVertices(); ++id) {
+                        fineSides[id] = sides[levels[level - 1].coarseIds[id]];
+                    }
+                    refineBisection(fine, fineSides, maxWeights);
+                    sides = std::move(fineSides);
+                }
+
+                const uint64_t overweight = getOverweight(getSideWeights(graph, sides), maxWeights);
+                const int64_t cut = getCut(graph, sides);
+                if (best.empty() || overweight < bestOverweight || (overweight == bestOverweight && cut < bestCut)) {
+                    best = std::move(sides);
+                    bestOverweight = overweight;
+                    bestCut = cut;
+                }
+            }
+            return best;
+        }
+
+        /**
+         * @brief the subgraph induced by the vertices on a side of a bisection
+         *
+         * @param originalIds the ids in the input graph of the vertices of @c graph
+         * @param subOriginalIds the ids in the input graph of the vertices of the result
+         */
+        PartitionGraph getSide(const PartitionGraph& graph, const std::vector<uint32_t>& originalIds, const Bisection& sides, uint8_t side, std::vector<uint32_t>& subOriginalIds) {
+            std::vector<uint32_t> subIds(graph.numberOfVertices(), NO_VERTEX);
+            subOriginalIds.clear();
+            for (uint32_t id=0; id<graph.numberOfVertices(); ++id) {
+                if (sides[id] == side) {
+                    subIds[id] = subOriginalIds.size();
+                    subOriginalIds.push_back(originalIds[id]);
+                }
+            }
+
+            PartitionGraph result{};
+            result.adjacencyBegin.push_back(0);
+            for (uint32_t id=0; id<graph.numberOfVertices(); ++id) {
+                if (sides[id] != side) {
+                    continue;
+                }
+                result.vertexWeights.push_back(graph.vertexWeights[id]);
+                for (uint64_t e=graph.adjacencyBegin[id]; e<graph.adjacencyBegin[id + 1]; ++e) {
+                    if (sides[graph.neighbours[e]] == side) {
+                        result.neighbours.push_back(subIds[graph.neighbours[e]]);
+                        result.edgeWeights.push_back(graph.edgeWeights[e]);
+                    }
+                }
+                result.adjacencyBegin.push_back(result.neighbours.size());
+            }
+            return result;
+        }
+
+        void bisectRecursively(const PartitionGraph& graph, const std::vector<uint32_t>& originalIds, uint32_t firstCell, uint32_t k, double imbalance, std::mt19937& random, std::vector<uint32_t>& cells) {
+            if (k == 1 || graph.numberOfVertices() == 0) {
+                for (auto id : originalIds) {
+                    cells[id] = firstCell;
+                }
+                return;
+            }
+
+            const uint32_t k0 = k / 2;
+            Bisection sides = bisect(graph, static_cast<double>(k0) / k, imbalance, random);
+            std::vector<uint32_t> subOriginalIds{};
+            {
+                PartitionGraph side0 = getSide(graph, originalIds, sides, 0, subOriginalIds);
+                bisectRecursively(side0, subOriginalIds, firstCell, k0, imbalance, random, cells);
+            }
+            {
+                PartitionGraph side1 = getSide(graph, originalIds, sides, 1, subOriginalIds);
+                bisectRecursively(side1, subOriginalIds, firstCell + k0, k - k0, imbalance, random, cells);
+            }
+        }
+
+    }
+
+    uint64_t PartitionGraph::getTotalWeight() const {
+        return std::accumulate(this->vertexWeights.begin(), this->vertexWeights.end(), static_cast<uint64_t>(0));
+    }
+
+    PartitionGraph PartitionGraph::fromEdges(uint32_t vertices, std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+        size_t last = 0;
+        for (const auto& edge : edges) {
+            if (edge.first != edge.second) {
+                edges[last++] = std::make_pair(std::min(edge.first, edge.second), std::max(edge.first, edge.second));
+            }
+        }
+        edges.resize(last);
+        std::sort(edges.begin(), edges.end());
+
+        //merge the parallel edges
+        std::vector<uint32_t> weights{};
+        last = 0;
+        for (size_t i=0; i<edges.size(); ++i) {
+            if (last > 0 && edges[last - 1] == edges[i]) {
+                weights.back() += 1;
+            } else {
+                edges[last++] = edges[i];
+                weights.push_back(1);
+            }
+        }
+        edges.resize(last);
+
+        PartitionGraph result{};
+        result.vertexWeights.assign(vertices, 1);
+        result.adjacencyBegin.assign(vertices + 1, 0);
+        for (const auto& edge : edges) {
+            result.adjacencyBegin[edge.first + 1] += 1;
+            result.adjacencyBegin[edge.second + 1] += 1;
+        }
+        std::partial_sum(result.adjacencyBegin.begin(), result.adjacencyBegin.end(), result.adjacencyBegin.begin());
+        result.neighbours.resize(2 * edges.size());
+        result.edgeWeights.resize(2 * edges.size());
+        std::vector<uint64_t> next{result.adjacencyBegin.begin(), result.adjacencyBegin.end() - 1};
+        for (size_t i=0; i<edges.size(); ++i) {
+            const auto& edge = edges[i];
+            result.neighbours[next[edge.first]] = edge.second;
+            result.edgeWeights[next[edge.first]++] = weights[i];
+            result.neighbours[next[edge.second]] = edge.first;
+            result.edgeWeights[next[edge.second]++] = weights[i];
+        }
+        return result;
+    }
+
+    std::vector<uint32_t> computeRecursiveBisection(const PartitionGraph& graph, uint32_t k, double imbalance, unsigned int seed) {
+        std::vector<uint32_t> result(graph.numberOfVertices(), 0);
+        std::vector<uint32_t> originalIds(graph.numberOfVertices());
+        std::iota(originalIds.begin(), originalIds.end(), 0);
+        std::mt19937 random{seed};
+
+        //the imbalances of the bisections multiply along the recursion
+        const double levels = std::ceil(std::log2(std::max<uint32_t>(k, 2)));
+        const double bisectionImbalance = std::pow(1 + imbalance, 1 / levels) - 1;
+        bisectRecursively(graph, originalIds, 0, k, bisectionImbalance, random, result);
+        return result;
+    }
+
+}
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <sstream>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include "log.hpp"
@@ -151,6 +152,50 @@ void PPMImage::setAllPixels(const color_t& color) {
 	}
 }
 
+void PPMImage::setLine(long x0, long y0, long x1, long y1, const color_t& color) {
+	const long width = static_cast<long>(this->width);
+	const long height = static_cast<long>(this->height);
+	//trivially outside the image
+	if ((x0 < 0 && x1 < 0) || (y0 < 0 && y1 < 0) || (x0 >= width && x1 >= width) || (y0 >= height && y1 >= height)) {
+		return;
+	}
+	const long dx = std::abs(x1 - x0);
+	const long dy = -std::abs(y1 - y0);
+	const long stepX = x0 < x1 ? 1 : -1;
+	const long stepY = y0 < y1 ? 1 : -1;
+	long error = dx + dy;
+	while (true) {
+		if (x0 >= 0 && y0 >= 0 && x0 < width && y0 < height) {
+			this->image[y0 * width + x0] = color;
+		}
+		if (x0 == x1 && y0 == y1) {
+			break;
+		}
+		const long doubleError = 2 * error;
+		if (doubleError >= dy) {
+			error += dy;
+			x0 += stepX;
+		}
+		if (doubleError <= dx) {
+			error += dx;
+			y0 += stepY;
+		}
+	}
+}
+
+void PPMImage::setSquare(long x, long y, size_t radius, const color_t& color) {
+	const long r = static_cast<long>(radius);
+	const long top = std::max(0L, y - r);
+	const long left = std::max(0L, x - r);
+	const long bottom = std::min(static_cast<long>(this->height), y + r + 1);
+	const long right = std::min(static_cast<long>(this->width), x + r + 1);
+	for (long row=top; row<bottom; ++row) {
+		for (long column=left; column<right; ++column) {
+			this->image[row * static_cast<long>(this->width) + column] = color;
+		}
+	}
+}
+
 void PPMImage::mergePixel(size_t x, size_t y, const color_t& color) {
 	this->setPixel(x, y, color.merge(this->getPixel(x, y)));
 }
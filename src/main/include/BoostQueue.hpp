@@ -158,12 +158,13 @@ namespace cpp_utils {
         }
         virtual void decrease_key(ITEM& val) {
             auto handle = this->itemToHandleHeap[&val];
-            this->queue.decrease(handle);
+            //boost heaps are max-heaps over HeapNode, whose order is reversed: a lower key is a boost increase
+            this->queue.increase(handle);
         }
 
         virtual void increase_key(ITEM& val) {
             auto handle = this->itemToHandleHeap[&val];
-            this->queue.increase(handle);
+            this->queue.decrease(handle);
         }
 
         virtual void push(ITEM& val) {
@@ -0,0 +1,247 @@
+#ifndef _CPP_UTILS_INTRUSIVEQUEUE_HEADER__
+#define _CPP_UTILS_INTRUSIVEQUEUE_HEADER__
+
+#include <cassert>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "IQueue.hpp"
+
+namespace cpp_utils {
+
+    /**
+     * @brief a minimum k-ary heap whose items remember their own position in it
+     *
+     * The position of an item in the heap is saved in the item itself via HasPriority::setPriority (as StaticPriorityQueue
+     * does), so decrease_key, increase_key and contains reach the item in O(1) without any lookup table. Compared to
+     * BoostQueue, no hash map operation is performed on push, decrease_key and pop.
+     *
+     * By default the comparator used is "<" on ITEM, which can be changed as in BoostQueue:
+     *
+     * @code
+     *  IntrusiveQueue<Foo, NewOrder> q{};
+     * @endcode
+     *
+     * Like the other queues, this queue saves the **pointers** of the items, so you can't `move` or `clone`
+     * the objects while they are in the queue.
+     *
+     * @pre
+     *  @li ITEM implements HasPriority<priority_t>. The queue passes itself as context, so an item may be in several
+     *      queues at once if its getPriority and setPriority distinguish them
+     *
+     * @tparam ITEM the item to store. The queue stores pointers to ITEMs, not ITEMs themselves
+     * @tparam COMPARATOR binary function returning true if the first item should be popped before the second one
+     * @tparam K number of children of each node of the heap. 4 is a good default: the tree is shallower than a binary one
+     *  and the children of a node are contiguous
+     */
+    template <typename ITEM, typename COMPARATOR = std::less<ITEM>, int K = 4>
+    class IntrusiveQueue: public IQueue<ITEM> {
+        static_assert(K >= 2, "a heap node needs at least 2 children");
+    public:
+        using This = IntrusiveQueue<ITEM, COMPARATOR, K>;
+        using Super = IQueue<ITEM>;
+    public:
+        friend std::ostream& operator << (std::ostream& ss, const This& q) {
+            ss << "(size=" << q.size() << ")[";
+            for(priority_t i=0; i < q.size(); i++) {
+                ss << i << ": " << *q.heap[i];
+                ss << ", ";
+            }
+            ss << "]";
+            return ss;
+        }
+    private:
+        /**
+         * @brief the heap. Each item has as priority its index in this vector
+         *
+         * Note that the queue does not OWN the data
+         */
+        std::vector<ITEM*> heap;
+        COMPARATOR comparator;
+    public:
+        /**
+         * @brief create a new queue
+         *
+         * @param capacity number of items the queue can hold before reallocating
+         */
+        explicit IntrusiveQueue(size_t capacity = 0): heap{}, comparator{} {
+            this->heap.reserve(capacity);
+        }
+        virtual ~IntrusiveQueue() {
+
+        }
+        IntrusiveQueue(const This& o) = delete;
+        This& operator=(const This& o) = delete;
+        IntrusiveQueue(This&& o) = delete;
+        This& operator=(This&& o) = delete;
+    public:
+        virtual bool isEmpty() const {
+            return this->heap.empty();
+        }
+
+        /**
+         * @brief reprioritise an item whose value has improved (namely it should be popped sooner)
+         *
+         * @param val an item in the queue
+         */
+        virtual void decrease_key(ITEM& val) {
+            assert(this->contains(val));
+            this->heapify_up(val.getPriority(this));
+        }
+
+        /**
+         * @brief reprioritise an item whose value has worsened (namely it should be popped later)
+         *
+         * @param val an item in the queue
+         */
+        virtual void increase_key(ITEM& val) {
+            assert(this->contains(val));
+            this->heapify_down(val.getPriority(this));
+        }
+
+        virtual void pushOrDecreaseKey(ITEM& val) {
+            if (this->contains(val)) {
+                this->heapify_up(val.getPriority(this));
+            } else {
+                this->push(val);
+            }
+        }
+
+        /**
+         * @brief add a new element to the queue
+         *
+         * Nothing happens if the item is already in the queue
+         *
+         * @param val the item to add to the queue
+         */
+        virtual void push(ITEM& val) {
+            if (this->contains(val)) {
+                return;
+            }
+            this->heap.push_back(&val);
+            this->heapify_up(this->heap.size() - 1);
+        }
+
+        /**
+         * @brief remove the top element from the queue
+         *
+         * @throw EmptyObjectException if the queue is empty
+         * @return ITEM& the element which has the "best" priority
+         */
+        virtual ITEM& pop() {
+            if (this->heap.empty()) {
+                throw exceptions::EmptyObjectException<This>{*this};
+            }
+            ITEM& result = *this->heap[0];
+            ITEM* last = this->heap.back();
+            this->heap.pop_back();
+            if (!this->heap.empty()) {
+                this->heap[0] = last;
+                this->heapify_down(0);
+            }
+            return result;
+        }
+
+        /**
+         * @brief check if an element is inside the queue
+         *
+         * @note
+         * The time is O(1). We compare addresses, so the priority of an item never pushed can be anything
+         *
+         * @param n the item to check
+         * @return true if @c n is in the queue
+         * @return false otherwise
+         */
+        virtual bool contains(const ITEM& n) const {
+            priority_t priority = n.getPriority(this);
+            return priority < this->heap.size() && this->heap[priority] == &n;
+        }
+
+        /**
+         * @brief retrieve the top element without removing it
+         *
+         * @throw EmptyObjectException if the queue is empty
+         * @return ITEM& the item on the top of the queue
+         */
+        virtual ITEM& peek() const {
+            if (this->heap.empty()) {
+                throw exceptions::EmptyObjectException<This>{*this};
+            }
+            return *this->heap[0];
+        }
+
+        virtual size_t size() const {
+            return this->heap.size();
+        }
+    public:
+        virtual void cleanup() {
+            this->heap.clear();
+        }
+    public:
+        virtual MemoryConsumption getByteMemoryOccupied() const {
+            return MemoryConsumption{sizeof(*this) + sizeof(ITEM*) * this->heap.capacity(), MemoryConsumptionEnum::BYTE};
+        }
+    private:
+        /**
+         * @brief move the item at @c index towards the root until its parent should be popped before it
+         *
+         * Items are moved into the hole left by the item, rather than swapped, so each one is written (and told its new
+         * position) once
+         *
+         * @param index index in the heap of the item to reposition
+         */
+        void heapify_up(priority_t index) {
+            assert(index < this->heap.size());
+            ITEM* item = this->heap[index];
+            while (index > 0) {
+                priority_t parent = (index - 1) / K;
+                if (!this->comparator(*item, *this->heap[parent])) {
+                    break;
+                }
+                this->place(index, this->heap[parent]);
+                index = parent;
+            }
+            this->place(index, item);
+        }
+
+        /**
+         * @brief move the item at @c index towards the leaves until it should be popped before all its children
+         *
+         * @param index index in the heap of the item to reposition
+         */
+        void heapify_down(priority_t index) {
+            assert(index < this->heap.size());
+            const priority_t size = this->heap.size();
+            ITEM* item = this->heap[index];
+            for (;;) {
+                priority_t first = index * K + 1;
+                if (first >= size) {
+                    break;
+                }
+                priority_t end = first + K < size ? first + K : size;
+                priority_t best = first;
+                for (priority_t child = first + 1; child < end; ++child) {
+                    if (this->comparator(*this->heap[child], *this->heap[best])) {
+                        best = child;
+                    }
+                }
+                if (!this->comparator(*this->heap[best], *item)) {
+                    break;
+                }
+                this->place(index, this->heap[best]);
+                index = best;
+            }
+            this->place(index, item);
+        }
+
+        void place(priority_t index, ITEM* item) {
+            this->heap[index] = item;
+            item->setPriority(this, index);
+        }
+    };
+
+}
+
+#endif
@@ -4,15 +4,72 @@
 #include <utility>
 #include <vector>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
 #include <functional>
 #include <algorithm>
 #include <iostream>
 #include "ICleanable.hpp"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace cpp_utils {
 
 //#define INTERNAL_HEAP_CHECKS
 
+/**
+ * @brief size of a cache line, in bytes
+ * 
+ */
+constexpr std::size_t HEAP_CACHE_LINE = 64;
+
+/**
+ * @brief an allocator whose memory starts at the beginning of a cache line
+ * 
+ * @tparam T type of the elements to allocate
+ */
+template<typename T>
+struct cache_aligned_allocator {
+	typedef T value_type;
+
+	cache_aligned_allocator() = default;
+	template<typename U>
+	cache_aligned_allocator(const cache_aligned_allocator<U>&) {}
+
+	T* allocate(std::size_t n) {
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{HEAP_CACHE_LINE}));
+	}
+	void deallocate(T* p, std::size_t) {
+		::operator delete(p, std::align_val_t{HEAP_CACHE_LINE});
+	}
+	template<typename U>
+	bool operator ==(const cache_aligned_allocator<U>&) const {
+		return true;
+	}
+	template<typename U>
+	bool operator !=(const cache_aligned_allocator<U>&) const {
+		return false;
+	}
+};
+
+/**
+ * @brief an indexed k-ary min heap
+ * 
+ * The children of a node are contiguous. The root is stored at index k-1, so that every group of children starts at a multiple of k:
+ * if @c k entries fill a cache line (e.g., k=4 with 16 bytes entries), each group spans exactly a single cache line.
+ * When a node has all its k children, the minimum one is chosen without data dependent branches.
+ * 
+ * The best arity depends on the key type and the heap size: see the "benchmark kway heap arity" scenario.
+ * 
+ * @tparam idT type of the ids. Ids range from 0 to the number of ids given in the constructor
+ * @tparam keyT type of the keys
+ * @tparam k arity of the heap
+ * @tparam key_orderT strict ordering of the keys
+ */
 template<typename idT, class keyT, int k, class key_orderT = std::less<keyT>>
 class kway_min_id_heap: public ICleanable {
 public:
@@ -24,9 +81,15 @@ private:
 		id_type id;
 		key_type key;
 	};
+private:
+	/**
+	 * @brief the index of the root in heap. The logical position @c p is stored in heap[p + heap_offset]
+	 * 
+	 */
+	static constexpr int heap_offset = k - 1;
 private:
 	int heap_end;
-	std::vector<id_key_pair>heap;
+	std::vector<id_key_pair, cache_aligned_allocator<id_key_pair>>heap;
 	/**
 	 * @brief given an index representing the actual value we have stored in the queue
 	 * 
@@ -40,7 +103,7 @@ public:
 	friend std::ostream& operator <<(std::ostream& out, const kway_min_id_heap<idT, keyT, k, key_orderT>& q) {
 		out << "(size=" << q.heap_end << ")[";
 		for(int i=0; i < q.heap_end; i++) {
-			out << i <<": {id=" << q.heap[i].id << ", key=" << q.heap[i].key << "}";
+			out << i <<": {id=" << q.slot(i).id << ", key=" << q.slot(i).key << "}";
 			out << ", ";
 		}
 		out << "]";
@@ -48,7 +111,7 @@ public:
 	}
 public:
 	explicit kway_min_id_heap(std::size_t id_count, key_order_type order = key_order_type()):
-		heap_end(0), heap(id_count), id_pos(id_count, -1), order(std::move(order)) {
+		heap_end(0), heap(id_count + heap_offset), id_pos(id_count, -1), order(std::move(order)) {
 		check_id_invariants();
 		check_order_invariants();
 	}
@@ -82,8 +145,8 @@ public:
 		if(!contains(id)){
 			id_type new_pos = heap_end;
 			++heap_end;
-			heap[new_pos].id = id;
-			heap[new_pos].key = std::move(key);
+			slot(new_pos).id = id;
+			slot(new_pos).key = std::move(key);
 			id_pos[id] = new_pos;
 			move_up(new_pos);
 
@@ -92,8 +155,8 @@ public:
 		
 			return true;
 		}else{
-			if(order(key, heap[id_pos[id]].key)){
-				heap[id_pos[id]].key = std::move(key);
+			if(order(key, slot(id_pos[id]).key)){
+				slot(id_pos[id]).key = std::move(key);
 				move_up(id_pos[id]);
 
 				check_id_invariants();
@@ -114,8 +177,8 @@ public:
 		if(!contains(id)){
 			id_type new_pos = heap_end;
 			++heap_end;
-			heap[new_pos].id = id;
-			heap[new_pos].key = std::move(key);
+			slot(new_pos).id = id;
+			slot(new_pos).key = std::move(key);
 			id_pos[id] = new_pos;
 			move_up(new_pos);
 
@@ -124,8 +187,8 @@ public:
 		
 			return true;
 		}else{
-			if(order(heap[id_pos[id]].key, key)){
-				heap[id_pos[id]].key = std::move(key);
+			if(order(slot(id_pos[id]).key, key)){
+				slot(id_pos[id]).key = std::move(key);
 				move_down(id_pos[id]);
 				
 				check_id_invariants();
@@ -143,7 +206,7 @@ public:
 		check_id_invariants();
 		check_order_invariants();
 		
-		return heap[0].key;
+		return slot(0).key;
 	}
 
 	id_type peekId() const {
@@ -152,7 +215,7 @@ public:
 		check_id_invariants();
 		check_order_invariants();
 		
-		return heap[0].id;
+		return slot(0).id;
 	}
 
 	id_type pop(){
@@ -163,21 +226,21 @@ public:
 		
 		if(heap_end == 1){
 			heap_end = 0;
-			id_pos[heap[0].id] = -1;
+			id_pos[slot(0).id] = -1;
 
 			check_id_invariants();
 			check_order_invariants();
 			
-			return heap[0].id;
+			return slot(0).id;
 		}else{	
-			id_type ret = heap[0].id;
+			id_type ret = slot(0).id;
 			--heap_end;
 			#ifdef INTERNAL_HEAP_CHECKS
-			assert(ret != heap[heap_end].id);
+			assert(ret != slot(heap_end).id);
 			#endif
-			heap[0].id = heap[heap_end].id;
-			heap[0].key = std::move(heap[heap_end].key);
-			id_pos[heap[0].id] = 0;
+			slot(0).id = slot(heap_end).id;
+			slot(0).key = std::move(slot(heap_end).key);
+			id_pos[slot(0).id] = 0;
 			id_pos[ret] = -1;
 			move_down(0);
 
@@ -188,9 +251,17 @@ public:
 		}
 	}
 public:
+	/**
+	 * @brief empty the heap
+	 * 
+	 * Only the ids still in the heap are reset, hence it takes O(size of the heap) rather than O(id_count).
+	 * Reusing the same heap over several searches is therefore cheap
+	 */
 	void cleanup() {
+		for(int i=0; i<heap_end; ++i) {
+			id_pos[slot(i).id] = -1;
+		}
 		heap_end = 0;
-		std::fill(id_pos.begin(), id_pos.end(), -1);
 
 		check_id_invariants();
 		check_order_invariants();
@@ -208,9 +279,9 @@ public:
 		check_order_invariants();
 	}
 	void reset(int new_id_count = 0, key_order_type new_order = key_order_type()){
-		heap.resize(new_id_count);
-		id_pos.resize(new_id_count);
-		cleanup();
+		heap_end = 0;
+		heap.resize(new_id_count + heap_offset);
+		id_pos.assign(new_id_count, -1);
 
 		check_id_invariants();
 		check_order_invariants();
@@ -231,13 +302,21 @@ public:
 		check_id_invariants();
 		check_order_invariants();
 
-		return heap[id_pos[id]].key;
+		return slot(id_pos[id]).key;
 	}
 
 	
 
 private:
 
+	id_key_pair& slot(int pos){
+		return heap[pos + heap_offset];
+	}
+
+	const id_key_pair& slot(int pos) const{
+		return heap[pos + heap_offset];
+	}
+
 	static int parent(int pos){
 		assert(pos != 0);
 		return (pos-1) / k;
@@ -258,14 +337,14 @@ private:
 
 	void move_up(int pos){
 		if(pos != 0){
-			key_type key = std::move(heap[pos].key);
-			int id = heap[pos].id;
+			key_type key = std::move(slot(pos).key);
+			id_type id = slot(pos).id;
 
 			int parent_pos = parent(pos);
-			while(order(key, heap[parent_pos].key)){
-				heap[pos].id = heap[parent_pos].id;
-				heap[pos].key = std::move(heap[parent_pos].key);
-				id_pos[heap[parent_pos].id] = pos;
+			while(order(key, slot(parent_pos).key)){
+				slot(pos).id = slot(parent_pos).id;
+				slot(pos).key = std::move(slot(parent_pos).key);
+				id_pos[slot(parent_pos).id] = pos;
 
 				pos = parent_pos;
 				if(pos == 0)
@@ -273,15 +352,34 @@ private:
 				parent_pos = parent(pos);
 			}
 
-			heap[pos].id = id;
-			heap[pos].key = std::move(key);
+			slot(pos).id = id;
+			slot(pos).key = std::move(key);
 			id_pos[id] = pos;
 		}
 	}
 
+	/**
+	 * @brief the position of the minimum among the @c count entries starting at @c begin
+	 * 
+	 * The loop has a compile time trip count and carries the best key along, so the compiler can unroll it and use
+	 * conditional moves instead of data dependent branches. On ties, the leftmost entry wins.
+	 */
+	template<int count>
+	int min_child_of_group(int begin)const{
+		int best = begin;
+		key_type best_key = slot(begin).key;
+		for(int i=begin+1; i<begin+count; ++i){
+			const key_type& candidate = slot(i).key;
+			const bool smaller = order(candidate, best_key);
+			best = smaller ? i : best;
+			best_key = smaller ? candidate : best_key;
+		}
+		return best;
+	}
+
 	void move_down(int pos){
-		key_type key = std::move(heap[pos].key);
-		id_type id = heap[pos].id;
+		key_type key = std::move(slot(pos).key);
+		id_type id = slot(pos).id;
 
 		for(;;){
 			int begin = std::min(heap_end, children_begin(pos));
@@ -290,40 +388,45 @@ private:
 			if(begin == end)
 				break;
 
-			int min_child_pos = begin;
-			for(int i=begin+1; i<end; ++i){
-				if(order(heap[i].key, heap[min_child_pos].key))
-					min_child_pos = i;
+			int min_child_pos;
+			if(end - begin == k){
+				min_child_pos = min_child_of_group<k>(begin);
+			}else{
+				min_child_pos = begin;
+				for(int i=begin+1; i<end; ++i){
+					if(order(slot(i).key, slot(min_child_pos).key))
+						min_child_pos = i;
+				}
 			}
 
-			if(!order(heap[min_child_pos].key, key))
+			if(!order(slot(min_child_pos).key, key))
 				break;
 
-			heap[pos].id = heap[min_child_pos].id;
-			heap[pos].key = std::move(heap[min_child_pos].key);
-			id_pos[heap[min_child_pos].id] = pos;
+			slot(pos).id = slot(min_child_pos).id;
+			slot(pos).key = std::move(slot(min_child_pos).key);
+			id_pos[slot(min_child_pos).id] = pos;
 
 			pos = min_child_pos;
 		}
-		heap[pos].id = id;
-		heap[pos].key = std::move(key);
+		slot(pos).id = id;
+		slot(pos).key = std::move(key);
 		id_pos[id] = pos;
 	}
 
 	void check_id_invariants()const{
 		#ifdef INTERNAL_HEAP_CHECKS
 		for(int i=0; i<heap_end; ++i){
-			assert(heap[i].id != -1);
-			assert(0 <= heap[i].id);
-			assert(heap[i].id < (int)id_pos.size());
-			assert(id_pos[heap[i].id] == i);
+			assert(slot(i).id != -1);
+			assert(0 <= slot(i).id);
+			assert(slot(i).id < (int)id_pos.size());
+			assert(id_pos[slot(i).id] == i);
 		}
 
 		for(int i=0; i<(int)id_pos.size(); ++i){
 			if(id_pos[i] != -1){
 				assert(0 <= id_pos[i]);
 				assert(id_pos[i] < heap_end);
-				assert(heap[id_pos[i]].id == i);
+				assert(slot(id_pos[i]).id == i);
 			}
 		}
 		#endif
@@ -332,7 +435,7 @@ private:
 	void check_order_invariants()const{
 		#ifdef INTERNAL_HEAP_CHECKS
 		for(int i=1; i<heap_end; ++i)
-			assert(!order(heap[i].key, heap[parent(i)].key));
+			assert(!order(slot(i).key, slot(parent(i)).key));
 		#endif
 	}
 };
@@ -411,6 +514,307 @@ private:
 // };
 
 
+/**
+ * @brief position of the minimum key among a full group of @c k children
+ * 
+ * The generic version is a loop with conditional moves. Groups of 32 bits integers or floats sorted by std::less are
+ * scanned with SSE2 instead, 4 keys per instruction.
+ * 
+ * @pre
+ *  @li @c keys is aligned to 16 bytes (the SIMD specializations exist only when @c k is a multiple of 4)
+ * 
+ * @tparam keyT type of the keys
+ * @tparam k arity of the heap
+ * @tparam key_orderT strict ordering of the keys
+ */
+template<class keyT, int k, class key_orderT, class enable = void>
+struct kway_group_min {
+	static int find(const keyT* keys, const key_orderT& order){
+		int best = 0;
+		keyT best_key = keys[0];
+		for(int i=1; i<k; ++i){
+			const bool smaller = order(keys[i], best_key);
+			best = smaller ? i : best;
+			best_key = smaller ? keys[i] : best_key;
+		}
+		return best;
+	}
+};
+
+#if defined(__SSE2__)
+
+/**
+ * @brief SSE2 scan of groups of 32 bits integers
+ * 
+ * SSE2 can only compare signed integers: unsigned ones are flipped in their most significant bit first
+ * 
+ */
+template<class keyT, int k>
+struct kway_int32_group_min {
+	static_assert(sizeof(keyT) == 4 && k % 4 == 0, "groups of 32 bits keys whose size is a multiple of 4");
+
+	static __m128i load(const keyT* keys){
+		const __m128i result = _mm_load_si128(reinterpret_cast<const __m128i*>(keys));
+		if(std::is_signed<keyT>::value){
+			return result;
+		}
+		return _mm_xor_si128(result, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+	}
+
+	static __m128i min(__m128i a, __m128i b){
+		const __m128i a_smaller = _mm_cmplt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(a_smaller, a), _mm_andnot_si128(a_smaller, b));
+	}
+
+	static int find(const keyT* keys, const std::less<keyT>&){
+		__m128i minimum = load(keys);
+		for(int i=4; i<k; i+=4){
+			minimum = min(minimum, load(keys + i));
+		}
+		//every lane becomes the minimum of the group
+		minimum = min(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+		minimum = min(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+		for(int i=0; i<k; i+=4){
+			const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(load(keys + i), minimum)));
+			if(mask != 0){
+				return i + __builtin_ctz(mask);
+			}
+		}
+		assert(false && "the minimum is in the group");
+		return 0;
+	}
+};
+
+template<int k>
+struct kway_group_min<int32_t, k, std::less<int32_t>, typename std::enable_if<k % 4 == 0>::type>: kway_int32_group_min<int32_t, k> {
+};
+
+template<int k>
+struct kway_group_min<uint32_t, k, std::less<uint32_t>, typename std::enable_if<k % 4 == 0>::type>: kway_int32_group_min<uint32_t, k> {
+};
+
+/**
+ * @brief SSE2 scan of groups of floats
+ * 
+ */
+template<int k>
+struct kway_group_min<float, k, std::less<float>, typename std::enable_if<k % 4 == 0>::type> {
+	static int find(const float* keys, const std::less<float>&){
+		__m128 minimum = _mm_load_ps(keys);
+		for(int i=4; i<k; i+=4){
+			minimum = _mm_min_ps(minimum, _mm_load_ps(keys + i));
+		}
+		minimum = _mm_min_ps(minimum, _mm_shuffle_ps(minimum, minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+		minimum = _mm_min_ps(minimum, _mm_shuffle_ps(minimum, minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+		for(int i=0; i<k; i+=4){
+			const int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_load_ps(keys + i), minimum));
+			if(mask != 0){
+				return i + __builtin_ctz(mask);
+			}
+		}
+		assert(false && "the minimum is in the group");
+		return 0;
+	}
+};
+
+#endif
+
+/**
+ * @brief an indexed k-ary min heap storing keys and ids in separate arrays
+ * 
+ * Same interface as kway_min_id_heap, but sift-down only reads the keys of the children, which are contiguous and aligned
+ * like in kway_min_id_heap: with 4 bytes keys and k=16 a group is exactly a cache line. Groups of 32 bits integers or
+ * floats are scanned with SSE2 (see kway_group_min). The id of a child is read only when it moves up.
+ * 
+ * Prefer it over kway_min_id_heap for large arities and small keys: see the "benchmark kway heap layout" scenario.
+ * 
+ * @tparam idT type of the ids. Ids range from 0 to the number of ids given in the constructor
+ * @tparam keyT type of the keys
+ * @tparam k arity of the heap
+ * @tparam key_orderT strict ordering of the keys
+ */
+template<typename idT, class keyT, int k, class key_orderT = std::less<keyT>>
+class kway_min_id_split_heap: public ICleanable {
+public:
+	typedef idT id_type;
+	typedef keyT key_type;
+	typedef key_orderT key_order_type;
+private:
+	/**
+	 * @brief the index of the root in keys and ids. The logical position @c p is stored in keys[p + heap_offset]
+	 * 
+	 */
+	static constexpr int heap_offset = k - 1;
+private:
+	int heap_end;
+	std::vector<key_type, cache_aligned_allocator<key_type>>keys;
+	std::vector<id_type>ids;
+	/**
+	 * @brief the logical position of each id in the heap, -1 if the id is not in it
+	 * 
+	 */
+	std::vector<int32_t>id_pos;
+	key_order_type order;
+public:
+	explicit kway_min_id_split_heap(std::size_t id_count, key_order_type order = key_order_type()):
+		heap_end(0), keys(id_count + heap_offset), ids(id_count + heap_offset), id_pos(id_count, -1), order(std::move(order)) {
+	}
+
+	explicit kway_min_id_split_heap(key_order_type order = key_order_type()):
+		heap_end(0), order(std::move(order)) {
+	}
+public:
+	bool isEmpty() const{
+		return heap_end == 0;
+	}
+	bool contains(id_type id) const{
+		assert(0 <= id && id < (id_type)id_pos.size() && "id is in range");
+		return id_pos[id] != -1;
+	}
+	bool pushOrDecrease(id_type id, key_type key){
+		assert(0 <= id && id < (id_type)id_pos.size() && "id is in range");
+
+		if(!contains(id)){
+			move_up(heap_end++, id, std::move(key));
+			return true;
+		}
+		const int pos = id_pos[id];
+		if(order(key, key_at(pos))){
+			move_up(pos, id, std::move(key));
+			return true;
+		}
+		return false;
+	}
+	bool pushOrIncrease(id_type id, key_type key){
+		assert(0 <= id && id < (id_type)id_pos.size() && "id is in range");
+
+		if(!contains(id)){
+			move_up(heap_end++, id, std::move(key));
+			return true;
+		}
+		const int pos = id_pos[id];
+		if(order(key_at(pos), key)){
+			move_down(pos, id, std::move(key));
+			return true;
+		}
+		return false;
+	}
+	key_type peekKey() const {
+		assert(!isEmpty() && "heap is not empty");
+		return key_at(0);
+	}
+	id_type peekId() const {
+		assert(!isEmpty() && "heap is not empty");
+		return id_at(0);
+	}
+	id_type pop(){
+		assert(!isEmpty() && "heap is not empty");
+
+		const id_type result = id_at(0);
+		id_pos[result] = -1;
+		--heap_end;
+		if(heap_end > 0){
+			move_down(0, id_at(heap_end), std::move(key_at(heap_end)));
+		}
+		return result;
+	}
+	const key_type& get_key(id_type id)const{
+		assert(0 <= id && id < (id_type)id_pos.size() && "id is in range");
+		assert(contains(id) && "id is contained");
+		return key_at(id_pos[id]);
+	}
+public:
+	/**
+	 * @brief empty the heap
+	 * 
+	 * Only the ids still in the heap are reset, hence it takes O(size of the heap) rather than O(id_count)
+	 */
+	void cleanup() {
+		for(int i=0; i<heap_end; ++i) {
+			id_pos[id_at(i)] = -1;
+		}
+		heap_end = 0;
+	}
+	void reorder(key_order_type new_order){
+		order = std::move(new_order);
+		for(int i=heap_end-1; i>=0; --i){
+			move_down(i, id_at(i), std::move(key_at(i)));
+		}
+	}
+	void reset(int new_id_count = 0, key_order_type new_order = key_order_type()){
+		heap_end = 0;
+		keys.resize(new_id_count + heap_offset);
+		ids.resize(new_id_count + heap_offset);
+		id_pos.assign(new_id_count, -1);
+	}
+	void reset(key_order_type new_order){
+		cleanup();
+		order = std::move(new_order);
+	}
+private:
+	key_type& key_at(int pos){
+		return keys[pos + heap_offset];
+	}
+	const key_type& key_at(int pos)const{
+		return keys[pos + heap_offset];
+	}
+	id_type& id_at(int pos){
+		return ids[pos + heap_offset];
+	}
+	const id_type& id_at(int pos)const{
+		return ids[pos + heap_offset];
+	}
+	void place(int pos, id_type id, key_type key){
+		key_at(pos) = std::move(key);
+		id_at(pos) = id;
+		id_pos[id] = pos;
+	}
+	/**
+	 * @brief put @c id with @c key in @c pos, or in one of its ancestors if @c key is smaller than theirs
+	 * 
+	 */
+	void move_up(int pos, id_type id, key_type key){
+		while(pos != 0){
+			const int parent_pos = (pos - 1) / k;
+			if(!order(key, key_at(parent_pos))){
+				break;
+			}
+			place(pos, id_at(parent_pos), std::move(key_at(parent_pos)));
+			pos = parent_pos;
+		}
+		place(pos, id, std::move(key));
+	}
+	/**
+	 * @brief put @c id with @c key in @c pos, or in one of its descendants if @c key is greater than theirs
+	 * 
+	 */
+	void move_down(int pos, id_type id, key_type key){
+		for(;;){
+			const int begin = k * pos + 1;
+			if(begin >= heap_end){
+				break;
+			}
+			int min_child_pos;
+			if(begin + k <= heap_end){
+				min_child_pos = begin + kway_group_min<key_type, k, key_order_type>::find(&key_at(begin), order);
+			}else{
+				min_child_pos = begin;
+				for(int i=begin+1; i<heap_end; ++i){
+					if(order(key_at(i), key_at(min_child_pos)))
+						min_child_pos = i;
+				}
+			}
+			if(!order(key_at(min_child_pos), key)){
+				break;
+			}
+			place(pos, id_at(min_child_pos), std::move(key_at(min_child_pos)));
+			pos = min_child_pos;
+		}
+		place(pos, id, std::move(key));
+	}
+};
+
+
 template<typename idT, class keyT, class key_orderT = std::less<keyT>>
 class min_id_heap : public kway_min_id_heap<idT, keyT, 4, key_orderT>{
 private:
@@ -0,0 +1,90 @@
+#ifndef _CPP_UTILS_MAPPEDFILE_HEADER__
+#define _CPP_UTILS_MAPPEDFILE_HEADER__
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/filesystem.hpp>
+
+namespace cpp_utils {
+
+    /**
+     * @brief a file of the filesystem mapped (read only) in the memory of the process
+     * 
+     * The file is mapped via `mmap` in shared mode: several processes mapping the same file will share the
+     * same copy of the page cache and nothing is read until it is actually accessed.
+     * 
+     * The mapping is released when the object is destroyed.
+     */
+    class MappedFile {
+    private:
+        /**
+         * @brief the file mapped
+         * 
+         */
+        boost::filesystem::path path;
+        /**
+         * @brief first byte of the mapping. nullptr if the file is empty
+         * 
+         */
+        char* data;
+        /**
+         * @brief number of bytes mapped
+         * 
+         */
+        std::size_t bytes;
+    public:
+        /**
+         * @brief map a file in memory
+         * 
+         * @param path the file to map
+         * @throw cpp_utils::exceptions::FileOpeningException if the file cannot be opened or mapped
+         */
+        explicit MappedFile(const boost::filesystem::path& path);
+        MappedFile(const MappedFile& o) = delete;
+        MappedFile(MappedFile&& o);
+        MappedFile& operator =(const MappedFile& o) = delete;
+        MappedFile& operator =(MappedFile&& o);
+        virtual ~MappedFile();
+    public:
+        /**
+         * @brief the first byte of the file
+         * 
+         * @return const char* the beginning of the mapping. nullptr if the file is empty
+         */
+        const char* getData() const;
+        /**
+         * @brief number of bytes of the file
+         * 
+         * @return std::size_t number of bytes we can access from ::getData
+         */
+        std::size_t size() const;
+        /**
+         * @brief the file mapped
+         * 
+         * @return const boost::filesystem::path& 
+         */
+        const boost::filesystem::path& getPath() const;
+        /**
+         * @brief check that an array of @c count elements starting at @c offset lies within the file
+         * 
+         * Use it before reading the arrays a header of the file points to: the check does not overflow, whatever the header says.
+         * The array needs to be aligned as its elements
+         * 
+         * @tparam T type of the elements of the array
+         * @param offset number of bytes from the beginning of the file where the array starts
+         * @param count number of elements in the array
+         * @return true if we can read the whole array from ::getData
+         * @return false otherwise
+         */
+        template <typename T>
+        bool containsSection(uint64_t offset, uint64_t count) const {
+            const uint64_t fileSize = this->bytes;
+            return offset % alignof(T) == 0 && offset <= fileSize && count <= (fileSize - offset) / sizeof(T);
+        }
+    private:
+        void unmap();
+    };
+
+}
+
+#endif
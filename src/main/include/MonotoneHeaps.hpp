@@ -0,0 +1,397 @@
+#ifndef _CPP_UTILS_MONOTONE_HEAPS_HEADER__
+#define _CPP_UTILS_MONOTONE_HEAPS_HEADER__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "ICleanable.hpp"
+
+/**
+ * @file
+ * @brief indexed min heaps for monotone integer keys
+ *
+ * In Dijkstra with non negative integer weights, a key pushed is never smaller than the last key popped, and it exceeds
+ * it by at most the maximum edge weight. The heaps here exploit it and beat comparison based heaps (e.g., kway_min_id_heap):
+ * pushes and decrease-keys are O(1). They have the same interface of kway_min_id_heap (but for pushOrIncrease) and can
+ * be used as the heap of DijkstraSearch:
+ *
+ * @code
+ * DijkstraSearch<GRAPH, long, ZeroHeuristic<long>, radix_min_id_heap<nodeid_t, long>> dijkstra{graph};
+ * @endcode
+ *
+ * A* with a consistent heuristic yields monotone keys as well.
+ */
+
+namespace cpp_utils {
+
+/**
+ * @brief a radix heap (Ahuja, Mehlhorn, Orlin, Tarjan)
+ *
+ * An entry goes in the bucket given by the most significant bit where its key differs from the last key popped. When
+ * the bucket of the minimum is empty, the first non empty bucket is redistributed in the lower ones: each entry moves at
+ * most once per bit of the key, hence pop is amortized O(bits of the key) whatever the spread of the keys.
+ *
+ * Decrease-keys push a new entry and leave the old one behind: it is discarded when met.
+ *
+ * @pre
+ *  @li every key pushed (or decreased to) is not smaller than the last key popped since the last cleanup
+ *
+ * @tparam idT type of the ids. Ids range from 0 to the number of ids given in the constructor
+ * @tparam keyT type of the keys. An integer, never negative
+ */
+template<typename idT, class keyT>
+class radix_min_id_heap: public ICleanable {
+	static_assert(std::is_integral<keyT>::value, "radix heaps need integer keys");
+public:
+	typedef idT id_type;
+	typedef keyT key_type;
+private:
+	typedef typename std::make_unsigned<keyT>::type unsigned_key_type;
+	/**
+	 * @brief bucket 0 contains the keys equal to the last popped one, bucket i the ones whose bit i-1 is the first one differing
+	 *
+	 */
+	static constexpr int bucket_count = std::numeric_limits<unsigned_key_type>::digits + 1;
+
+	struct id_key_pair {
+		id_type id;
+		key_type key;
+	};
+private:
+	mutable std::vector<id_key_pair>buckets[bucket_count];
+	/**
+	 * @brief the last key popped. Every key in the heap is not smaller than it
+	 *
+	 */
+	mutable key_type last;
+	std::vector<key_type>key_of;
+	std::vector<uint8_t>in_heap;
+	std::size_t element_count;
+public:
+	explicit radix_min_id_heap(std::size_t id_count = 0):
+		last(0), key_of(id_count), in_heap(id_count, 0), element_count(0) {
+	}
+public:
+	bool isEmpty() const{
+		return element_count == 0;
+	}
+	bool contains(id_type id) const{
+		assert(0 <= id && id < (id_type)in_heap.size() && "id is in range");
+		return in_heap[id] != 0;
+	}
+	bool pushOrDecrease(id_type id, key_type key){
+		assert(0 <= id && id < (id_type)in_heap.size() && "id is in range");
+		assert(!(key < last) && "keys are monotone");
+
+		if(in_heap[id]){
+			if(!(key < key_of[id])){
+				return false;
+			}
+		}else{
+			in_heap[id] = 1;
+			++element_count;
+		}
+		key_of[id] = key;
+		buckets[bucket_of(key)].push_back(id_key_pair{id, key});
+		return true;
+	}
+	key_type peekKey() const {
+		assert(!isEmpty() && "heap is not empty");
+		settle();
+		return last;
+	}
+	id_type peekId() const {
+		assert(!isEmpty() && "heap is not empty");
+		settle();
+		return buckets[0].back().id;
+	}
+	id_type pop(){
+		assert(!isEmpty() && "heap is not empty");
+		settle();
+		const id_type result = buckets[0].back().id;
+		buckets[0].pop_back();
+		in_heap[result] = 0;
+		--element_count;
+		return result;
+	}
+	const key_type& get_key(id_type id)const{
+		assert(contains(id) && "id is contained");
+		return key_of[id];
+	}
+	/**
+	 * @brief empty the heap
+	 *
+	 * It takes O(entries in the heap), stale ones included, rather than O(id_count)
+	 */
+	void cleanup() {
+		for(auto& bucket : buckets){
+			for(auto& entry : bucket){
+				in_heap[entry.id] = 0;
+			}
+			bucket.clear();
+		}
+		last = 0;
+		element_count = 0;
+	}
+	void reset(std::size_t new_id_count = 0){
+		cleanup();
+		key_of.resize(new_id_count);
+		in_heap.assign(new_id_count, 0);
+	}
+private:
+	int bucket_of(key_type key) const{
+		const unsigned_key_type difference = static_cast<unsigned_key_type>(key) ^ static_cast<unsigned_key_type>(last);
+		if(difference == 0){
+			return 0;
+		}
+		return std::numeric_limits<unsigned long long>::digits - __builtin_clzll(static_cast<unsigned long long>(difference));
+	}
+	bool is_valid(const id_key_pair& entry) const{
+		return in_heap[entry.id] && key_of[entry.id] == entry.key;
+	}
+	/**
+	 * @brief ensure the last entry of bucket 0 is a valid entry with the minimum key
+	 *
+	 */
+	void settle() const{
+		for(;;){
+			while(!buckets[0].empty() && !is_valid(buckets[0].back())){
+				buckets[0].pop_back();
+			}
+			if(!buckets[0].empty()){
+				return;
+			}
+			int i = 1;
+			while(buckets[i].empty()){
+				++i;
+			}
+			bool found = false;
+			key_type minimum = 0;
+			for(auto& entry : buckets[i]){
+				if(is_valid(entry) && (!found || entry.key < minimum)){
+					minimum = entry.key;
+					found = true;
+				}
+			}
+			if(found){
+				//every valid entry of the bucket now differs from the minimum in a lower bit
+				last = minimum;
+				for(auto& entry : buckets[i]){
+					if(is_valid(entry)){
+						buckets[bucket_of(entry.key)].push_back(entry);
+					}
+				}
+			}
+			buckets[i].clear();
+		}
+	}
+};
+
+/**
+ * @brief a bucket queue (Dial) with circular buckets
+ *
+ * A key @c c goes in the bucket `c mod B`. In Dijkstra every key in the heap is between the last popped key and that plus
+ * the maximum edge weight, so B larger than the maximum edge weight is enough to never mix different keys in a bucket.
+ * B grows (to the next power of 2) whenever the keys in the heap span more than B, so the number of buckets can be
+ * omitted when the maximum weight is not known. Keys need not be monotone: only their span matters.
+ *
+ * Each bucket is a doubly linked list threaded through arrays indexed by id: push, decrease-key and pop unlink in O(1),
+ * while pop scans O(B) empty buckets at most. Hence it wins when the weights are small.
+ *
+ * @tparam idT type of the ids. Ids range from 0 to the number of ids given in the constructor
+ * @tparam keyT type of the keys. An integer, never negative
+ */
+template<typename idT, class keyT>
+class bucket_min_id_heap: public ICleanable {
+	static_assert(std::is_integral<keyT>::value, "bucket queues need integer keys");
+public:
+	typedef idT id_type;
+	typedef keyT key_type;
+private:
+	static constexpr id_type NO_ID = std::numeric_limits<id_type>::max();
+private:
+	/**
+	 * @brief the first id in each bucket, or NO_ID
+	 *
+	 */
+	std::vector<id_type>heads;
+	std::vector<id_type>next;
+	std::vector<id_type>previous;
+	std::vector<key_type>key_of;
+	std::vector<uint8_t>in_heap;
+	/**
+	 * @brief the number of buckets minus 1. The number of buckets is a power of 2
+	 *
+	 */
+	std::size_t mask;
+	/**
+	 * @brief a lower bound of the keys in the heap: the buckets before it are empty
+	 *
+	 */
+	mutable key_type current;
+	/**
+	 * @brief an upper bound of the keys in the heap. The heap holds keys from ::current to ::highest, so they need to fit in the buckets
+	 *
+	 */
+	key_type highest;
+	std::size_t element_count;
+public:
+	/**
+	 * @brief create an empty heap
+	 *
+	 * @param id_count number of ids
+	 * @param max_weight the maximum difference between the keys in the heap at the same time (in Dijkstra, the maximum edge weight). The heap grows if it is exceeded
+	 */
+	explicit bucket_min_id_heap(std::size_t id_count = 0, std::size_t max_weight = 63):
+		heads(), next(id_count, NO_ID), previous(id_count, NO_ID), key_of(id_count), in_heap(id_count, 0), mask(0), current(0), highest(0), element_count(0) {
+		std::size_t buckets = 1;
+		while(buckets <= max_weight){
+			buckets *= 2;
+		}
+		heads.assign(buckets, NO_ID);
+		mask = buckets - 1;
+	}
+public:
+	bool isEmpty() const{
+		return element_count == 0;
+	}
+	bool contains(id_type id) const{
+		assert(0 <= id && id < (id_type)in_heap.size() && "id is in range");
+		return in_heap[id] != 0;
+	}
+	bool pushOrDecrease(id_type id, key_type key){
+		assert(0 <= id && id < (id_type)in_heap.size() && "id is in range");
+
+		if(in_heap[id]){
+			if(!(key < key_of[id])){
+				return false;
+			}
+			unlink(id);
+		}else{
+			if(element_count == 0){
+				//nothing else constrains where the keys start
+				current = key;
+				highest = key;
+			}
+			in_heap[id] = 1;
+			++element_count;
+		}
+		if(key < current){
+			current = key;
+		}
+		if(highest < key){
+			highest = key;
+		}
+		if(static_cast<std::size_t>(highest - current) > mask){
+			grow(static_cast<std::size_t>(highest - current));
+		}
+		key_of[id] = key;
+		link(id);
+		return true;
+	}
+	key_type peekKey() const {
+		assert(!isEmpty() && "heap is not empty");
+		return key_of[heads[first_bucket()]];
+	}
+	id_type peekId() const {
+		assert(!isEmpty() && "heap is not empty");
+		return heads[first_bucket()];
+	}
+	id_type pop(){
+		assert(!isEmpty() && "heap is not empty");
+		const id_type result = heads[first_bucket()];
+		unlink(result);
+		in_heap[result] = 0;
+		--element_count;
+		return result;
+	}
+	const key_type& get_key(id_type id)const{
+		assert(contains(id) && "id is contained");
+		return key_of[id];
+	}
+	/**
+	 * @brief empty the heap
+	 *
+	 * It takes O(buckets + size of the heap) rather than O(id_count)
+	 */
+	void cleanup() {
+		for(auto& head : heads){
+			for(id_type id=head; id!=NO_ID; id=next[id]){
+				in_heap[id] = 0;
+			}
+			head = NO_ID;
+		}
+		current = 0;
+		highest = 0;
+		element_count = 0;
+	}
+	void reset(std::size_t new_id_count = 0){
+		cleanup();
+		next.assign(new_id_count, NO_ID);
+		previous.assign(new_id_count, NO_ID);
+		key_of.resize(new_id_count);
+		in_heap.assign(new_id_count, 0);
+	}
+	/**
+	 * @brief the number of buckets
+	 *
+	 */
+	std::size_t getBuckets() const{
+		return mask + 1;
+	}
+private:
+	std::size_t first_bucket() const{
+		while(heads[static_cast<std::size_t>(current) & mask] == NO_ID){
+			++current;
+		}
+		return static_cast<std::size_t>(current) & mask;
+	}
+	void link(id_type id){
+		id_type& head = heads[static_cast<std::size_t>(key_of[id]) & mask];
+		previous[id] = NO_ID;
+		next[id] = head;
+		if(head != NO_ID){
+			previous[head] = id;
+		}
+		head = id;
+	}
+	void unlink(id_type id){
+		if(previous[id] != NO_ID){
+			next[previous[id]] = next[id];
+		}else{
+			heads[static_cast<std::size_t>(key_of[id]) & mask] = next[id];
+		}
+		if(next[id] != NO_ID){
+			previous[next[id]] = previous[id];
+		}
+	}
+	/**
+	 * @brief increase the number of buckets so that keys up to @c current + @c span fit, and move the ids accordingly
+	 *
+	 */
+	void grow(std::size_t span){
+		std::vector<id_type>ids{};
+		for(auto& head : heads){
+			for(id_type id=head; id!=NO_ID; id=next[id]){
+				ids.push_back(id);
+			}
+		}
+		std::size_t buckets = mask + 1;
+		while(buckets <= span){
+			buckets *= 2;
+		}
+		heads.assign(buckets, NO_ID);
+		mask = buckets - 1;
+		for(auto id : ids){
+			link(id);
+		}
+	}
+};
+
+}
+
+#endif
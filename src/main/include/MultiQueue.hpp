@@ -0,0 +1,350 @@
+#ifndef _CPP_UTILS_MULTIQUEUE_HEADER__
+#define _CPP_UTILS_MULTIQUEUE_HEADER__
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "KHeaps.hpp"
+
+/**
+ * @file
+ * @brief a relaxed priority queue several threads can use at once
+ *
+ * A parallel best-first search can share a single MultiQueue among its threads:
+ *
+ * @code
+ * MultiQueue<long, nodeid_t> queue{threads};
+ * queue.push(0, 0, source);
+ * parallelForBlocks(0, threads, threads, [&](std::size_t threadId, std::size_t, std::size_t) {
+ *  long distance;
+ *  nodeid_t vertex;
+ *  while (queue.tryPop(threadId, distance, vertex)) {
+ *      //skip the label if it is stale, otherwise relax the out edges of vertex, pushing with threadId
+ *  }
+ * });
+ * @endcode
+ *
+ * Since pops are relaxed, a label-setting search becomes label-correcting: a vertex can be popped before its final
+ * distance is known, hence its labels need to be checked (and possibly pushed again) as in Bellman-Ford.
+ */
+
+namespace cpp_utils {
+
+    namespace internal {
+
+        /**
+         * @brief a sequential k-ary min heap of key-value pairs, without decrease key
+         *
+         * @tparam KEY type of the keys
+         * @tparam VALUE type of the values
+         * @tparam K number of children of a node
+         */
+        template <typename KEY, typename VALUE, int K>
+        class KaryPairHeap {
+            static_assert(K >= 2, "a heap node needs at least 2 children");
+        public:
+            using key_value_pair = std::pair<KEY, VALUE>;
+        private:
+            std::vector<key_value_pair> heap;
+        public:
+            KaryPairHeap(): heap{} {
+
+            }
+        public:
+            bool isEmpty() const {
+                return this->heap.empty();
+            }
+            std::size_t size() const {
+                return this->heap.size();
+            }
+            const key_value_pair& peek() const {
+                assert(!this->heap.empty());
+                return this->heap[0];
+            }
+            void push(const KEY& key, const VALUE& value) {
+                std::size_t hole = this->heap.size();
+                this->heap.emplace_back(key, value);
+                while (hole > 0) {
+                    std::size_t parent = (hole - 1) / K;
+                    if (!(key < this->heap[parent].first)) {
+                        break;
+                    }
+                    this->heap[hole] = std::move(this->heap[parent]);
+                    hole = parent;
+                }
+                this->heap[hole] = key_value_pair{key, value};
+            }
+            key_value_pair pop() {
+                assert(!this->heap.empty());
+                key_value_pair result = std::move(this->heap[0]);
+                key_value_pair last = std::move(this->heap.back());
+                this->heap.pop_back();
+                const std::size_t size = this->heap.size();
+                if (size > 0) {
+                    std::size_t hole = 0;
+                    for (;;) {
+                        std::size_t first = hole * K + 1;
+                        if (first >= size) {
+                            break;
+                        }
+                        std::size_t end = first + K < size ? first + K : size;
+                        std::size_t best = first;
+                        for (std::size_t child = first + 1; child < end; ++child) {
+                            if (this->heap[child].first < this->heap[best].first) {
+                                best = child;
+                            }
+                        }
+                        if (!(this->heap[best].first < last.first)) {
+                            break;
+                        }
+                        this->heap[hole] = std::move(this->heap[best]);
+                        hole = best;
+                    }
+                    this->heap[hole] = std::move(last);
+                }
+                return result;
+            }
+            void clear() {
+                this->heap.clear();
+            }
+        };
+
+    }
+
+    /**
+     * @brief a MultiQueue (Rihani, Sanders, Dementiev): a relaxed concurrent min priority queue
+     *
+     * The queue is made of @c c times @c p sequential k-ary heaps, where @c p is the number of threads, each one protected by
+     * a lock. A push puts the pair in a random heap; a pop looks at the minimum of two random heaps and pops from the
+     * better one. A thread never waits for a lock: if a heap is busy, it just picks other random heaps.
+     *
+     * Hence the queue scales with the number of threads, but a pop does not always return the minimum: the rank of the popped
+     * key among the ones in the queue is expected to be O(c p). With a single heap (`threads * queuesPerThread == 1`)
+     * the queue is exact.
+     *
+     * Each thread is identified by an id from 0 to the number of threads (excluded), e.g., the one of ::parallelForBlocks:
+     * the id selects the random generator of the thread, so 2 threads can't use the same id at the same time.
+     *
+     * @pre
+     *  @li keys are smaller than `std::numeric_limits<KEY>::max()`, which marks empty heaps
+     *
+     * @tparam KEY type of the keys. An arithmetic type, since the minimum of each heap is published atomically
+     * @tparam VALUE type of the values
+     * @tparam K number of children of a node of each heap
+     */
+    template <typename KEY, typename VALUE, int K = 4>
+    class MultiQueue {
+        static_assert(std::is_arithmetic<KEY>::value, "the keys of a MultiQueue need to be arithmetic");
+    public:
+        using This = MultiQueue<KEY, VALUE, K>;
+    private:
+        /**
+         * @brief the key we publish as minimum of an empty heap
+         *
+         */
+        static constexpr KEY EMPTY = std::numeric_limits<KEY>::max();
+
+        /**
+         * @brief a heap with its lock. Each one is in its own cache lines, so threads working on different heaps do not contend
+         *
+         */
+        struct alignas(HEAP_CACHE_LINE) LockedHeap {
+            std::atomic<bool> locked{false};
+            /**
+             * @brief the minimum key in ::heap, or ::EMPTY. Read without locking to choose the heap to pop from
+             *
+             */
+            std::atomic<KEY> minimum{EMPTY};
+            internal::KaryPairHeap<KEY, VALUE, K> heap{};
+
+            bool tryLock() {
+                return !this->locked.load(std::memory_order_relaxed) && !this->locked.exchange(true, std::memory_order_acquire);
+            }
+            void unlock() {
+                this->minimum.store(this->heap.isEmpty() ? EMPTY : this->heap.peek().first, std::memory_order_relaxed);
+                this->locked.store(false, std::memory_order_release);
+            }
+        };
+
+        /**
+         * @brief the xorshift state of a thread
+         *
+         */
+        struct alignas(HEAP_CACHE_LINE) ThreadState {
+            uint64_t random;
+        };
+    private:
+        std::vector<LockedHeap> heaps;
+        std::vector<ThreadState> threadStates;
+    public:
+        /**
+         * @brief create an empty queue
+         *
+         * @param threads number of threads using the queue
+         * @param queuesPerThread the @c c of the MultiQueue: more heaps per thread mean less contention but worse pops
+         * @param seed seed of the random choices of the threads
+         */
+        explicit MultiQueue(std::size_t threads, std::size_t queuesPerThread = 2, uint64_t seed = 0): heaps(threads * queuesPerThread), threadStates(threads) {
+            if (threads == 0 || queuesPerThread == 0) {
+                throw exceptions::InvalidArgumentException{"a MultiQueue needs at least a thread and a queue per thread"};
+            }
+            for (std::size_t threadId=0; threadId<threads; ++threadId) {
+                //splitmix64, so that close seeds yield unrelated states (and never 0)
+                uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (threadId + 1);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                this->threadStates[threadId].random = (z ^ (z >> 31)) | 1;
+            }
+        }
+        MultiQueue(const This& o) = delete;
+        This& operator=(const This& o) = delete;
+    public:
+        /**
+         * @brief add a pair to the queue
+         *
+         * @param threadId id of the calling thread
+         * @param key the key of the pair
+         * @param value the value of the pair
+         */
+        void push(std::size_t threadId, const KEY& key, const VALUE& value) {
+            assert(key < EMPTY);
+            for (;;) {
+                LockedHeap& locked = this->heaps[this->randomHeap(threadId)];
+                if (locked.tryLock()) {
+                    locked.heap.push(key, value);
+                    locked.unlock();
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief remove a pair with a small key from the queue
+         *
+         * The pair is the minimum of the better of 2 random heaps. If they look empty for a while, every heap is checked.
+         *
+         * @note
+         * With other threads pushing, the queue may not be empty anymore right after the call returned false.
+         *
+         * @param threadId id of the calling thread
+         * @param key where to store the key of the popped pair
+         * @param value where to store the value of the popped pair
+         * @return true if a pair has been popped
+         * @return false if every heap was empty
+         */
+        bool tryPop(std::size_t threadId, KEY& key, VALUE& value) {
+            std::size_t emptyChoices = 0;
+            for (;;) {
+                std::size_t first = this->randomHeap(threadId);
+                std::size_t second = this->randomHeap(threadId);
+                KEY firstMinimum = this->heaps[first].minimum.load(std::memory_order_relaxed);
+                KEY secondMinimum = this->heaps[second].minimum.load(std::memory_order_relaxed);
+                LockedHeap& locked = this->heaps[secondMinimum < firstMinimum ? second : first];
+                if (firstMinimum == EMPTY && secondMinimum == EMPTY) {
+                    //few heaps may be non empty: stop guessing
+                    emptyChoices += 1;
+                    if (emptyChoices >= this->heaps.size()) {
+                        return this->popFromAnyHeap(key, value);
+                    }
+                    continue;
+                }
+                if (!locked.tryLock()) {
+                    continue;
+                }
+                if (locked.heap.isEmpty()) {
+                    locked.unlock();
+                    continue;
+                }
+                std::tie(key, value) = locked.heap.pop();
+                locked.unlock();
+                return true;
+            }
+        }
+
+        /**
+         * @brief check if every heap is empty
+         *
+         * @note
+         * Exact only if no other thread is using the queue
+         */
+        bool isEmpty() const {
+            for (auto& locked : this->heaps) {
+                if (locked.minimum.load(std::memory_order_relaxed) != EMPTY) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief number of sequential heaps of the queue
+         *
+         */
+        std::size_t numberOfHeaps() const {
+            return this->heaps.size();
+        }
+
+        /**
+         * @brief number of threads which can use the queue
+         *
+         */
+        std::size_t numberOfThreads() const {
+            return this->threadStates.size();
+        }
+
+        /**
+         * @brief remove every pair
+         *
+         * @pre
+         *  @li no other thread is using the queue
+         */
+        void clear() {
+            for (auto& locked : this->heaps) {
+                locked.heap.clear();
+                locked.minimum.store(EMPTY, std::memory_order_relaxed);
+            }
+        }
+    private:
+        std::size_t randomHeap(std::size_t threadId) {
+            assert(threadId < this->threadStates.size());
+            uint64_t& x = this->threadStates[threadId].random;
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            //maps the high 32 bits in [0, heaps) with a multiplication rather than a modulo
+            return static_cast<std::size_t>(((x >> 32) * this->heaps.size()) >> 32);
+        }
+
+        /**
+         * @brief pop from the first non empty heap, waiting for its lock
+         *
+         */
+        bool popFromAnyHeap(KEY& key, VALUE& value) {
+            for (auto& locked : this->heaps) {
+                if (locked.minimum.load(std::memory_order_relaxed) == EMPTY) {
+                    continue;
+                }
+                while (!locked.tryLock()) {
+                }
+                if (!locked.heap.isEmpty()) {
+                    std::tie(key, value) = locked.heap.pop();
+                    locked.unlock();
+                    return true;
+                }
+                locked.unlock();
+            }
+            return false;
+        }
+    };
+
+}
+
+#endif
@@ -1,11 +1,21 @@
 #ifndef _ADJACENTGRAPH_HEADER__
 #define _ADJACENTGRAPH_HEADER__
 
+#include <algorithm>
 #include <vector>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
 #include "igraph.hpp"
 #include "serializers.hpp"
 #include "iterator.hpp"
 #include "assertions.hpp"
+#include "span.hpp"
+#include "parallel.hpp"
 
 namespace cpp_utils::graphs {
 
@@ -14,6 +24,123 @@ class AdjacentGraph;
 
 }
 
+namespace cpp_utils::graphs::internal {
+
+    /**
+     * @brief version of the on-disk layout generated by cpp_utils::serializers::saveToMappableFile
+     * 
+     * Increase it every time MappedAdjacentGraphHeader or the section order change
+     */
+    constexpr uint32_t MAPPED_ADJACENT_GRAPH_VERSION = 1;
+    /**
+     * @brief every section in the on-disk layout of a mappable graph starts at an offset multiple of this number
+     * 
+     * It is a cache line, hence each array in the file is aligned for every primitive type
+     */
+    constexpr uint64_t MAPPED_ADJACENT_GRAPH_ALIGNMENT = 64;
+    /**
+     * @brief bit in MappedAdjacentGraphHeader::flags set if the file contains the reverse index of the in edges
+     * 
+     */
+    constexpr uint32_t MAPPED_ADJACENT_GRAPH_HAS_IN_EDGES_INDEX = 0x1;
+    /**
+     * @brief bit in MappedAdjacentGraphHeader::flags set if the out edges of each vertex are sorted by sink
+     * 
+     */
+    constexpr uint32_t MAPPED_ADJACENT_GRAPH_OUT_EDGES_SORTED_BY_SINK = 0x2;
+
+    /**
+     * @brief first bytes of a file containing a graph that can be directly mapped in memory
+     * 
+     * Every offset is in bytes from the beginning of the file. The file contains (in order):
+     * @li the header;
+     * @li the vertex payloads (`V[numberOfVertices]`);
+     * @li the out edges begin (`uint64_t[numberOfVertices + 1]`);
+     * @li the sinks of the out edges (`nodeid_t[numberOfEdges]`);
+     * @li the payloads of the out edges (`E[numberOfEdges]`);
+     * @li (optional) the in edges begin (`uint64_t[numberOfVertices + 1]`);
+     * @li (optional) the sources of the in edges (`nodeid_t[numberOfEdges]`);
+     * @li (optional) the out edge index of each in edge (`uint64_t[numberOfEdges]`);
+     * @li the payload of the graph, stored via cpp_utils::serializers::saveToFile
+     * 
+     * Sinks and payloads are in 2 different arrays since OutEdge has a virtual table we cannot put on the disk.
+     */
+    struct MappedAdjacentGraphHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t flags;
+        uint64_t sizeOfVertexPayload;
+        uint64_t sizeOfEdgePayload;
+        uint64_t numberOfVertices;
+        uint64_t numberOfEdges;
+        uint64_t vertexPayloadOffset;
+        uint64_t outEdgesBeginOffset;
+        uint64_t outEdgesSinkOffset;
+        uint64_t outEdgesPayloadOffset;
+        uint64_t inEdgesBeginOffset;
+        uint64_t inEdgesSourceOffset;
+        uint64_t inEdgesOutEdgeIndexOffset;
+        uint64_t graphPayloadOffset;
+    };
+
+    /**
+     * @brief magic number every mappable graph file starts with
+     * 
+     */
+    constexpr char MAPPED_ADJACENT_GRAPH_MAGIC[8] = {'C', 'U', 'A', 'D', 'J', 'G', 'R', 'P'};
+
+    /**
+     * @brief the first offset after @c offset which is aligned
+     * 
+     * @param offset an offset in the file
+     * @return uint64_t the aligned offset
+     */
+    inline uint64_t alignMappedOffset(uint64_t offset) {
+        return ((offset + MAPPED_ADJACENT_GRAPH_ALIGNMENT - 1) / MAPPED_ADJACENT_GRAPH_ALIGNMENT) * MAPPED_ADJACENT_GRAPH_ALIGNMENT;
+    }
+
+    /**
+     * @brief write a section of a mappable graph file
+     * 
+     * The function pads the file with 0 until @c offset and then writes @c count elements generated by @c getter.
+     * Elements are written in chunks, so we never duplicate the whole section in memory
+     * 
+     * @tparam T type of each element in the section
+     * @tparam GETTER type of the function generating the i-th element
+     * @param f file to write into
+     * @param position number of bytes written so far in the file. Updated
+     * @param offset where the section needs to start
+     * @param count number of elements in the section
+     * @param getter function generating the i-th element
+     */
+    template <typename T, typename GETTER>
+    void writeMappedSection(FILE* f, uint64_t& position, uint64_t offset, uint64_t count, GETTER getter) {
+        static const char zeros[MAPPED_ADJACENT_GRAPH_ALIGNMENT] = {0};
+        if (position > offset) {
+            throw cpp_utils::exceptions::ImpossibleException{"section offset", offset, "is before the current position", position};
+        }
+        if (std::fwrite(zeros, 1, offset - position, f) != (offset - position)) {
+            throw cpp_utils::exceptions::FileOpeningException{recoverFilename(f)};
+        }
+        position = offset;
+
+        //not a std::vector: std::vector<bool> does not store its elements contiguously
+        const uint64_t chunkSize = 4096;
+        std::unique_ptr<T[]> buffer{new T[std::min(chunkSize, count)]};
+        for (uint64_t i=0; i<count; ) {
+            uint64_t used = 0;
+            for (; (i<count) && (used < chunkSize); ++i, ++used) {
+                buffer[used] = getter(i);
+            }
+            if (std::fwrite(buffer.get(), sizeof(T), used, f) != used) {
+                throw cpp_utils::exceptions::FileOpeningException{recoverFilename(f)};
+            }
+            position += sizeof(T) * used;
+        }
+    }
+
+}
+
 namespace cpp_utils::serializers {
 
     /**
@@ -38,6 +165,9 @@ namespace cpp_utils::serializers {
     /**
      * Load a graph from a file in the filesystem
      *
+     * The reverse index of the in edges and whether the out edges are sorted by sink are not in the file (which keeps the
+     * layout of the files generated before they existed): they are computed from the out edges in \f$O(V+E)\f$
+     *
      * @pre
      *  @li @c f open in "rb";
      * @post
@@ -52,10 +182,87 @@ namespace cpp_utils::serializers {
         loadFromFile(f, result.vertexPayload);
         loadFromFile<cpp_utils::graphs::OutEdge<E>>(f, result.edges);
         loadFromFile<int>(f, result.outEdgesOfvertexBegin);
+        result.outEdgesSortedBySink = result.areOutEdgesSortedBySink();
+        result.buildInEdgesIndex();
+        //every weight may have changed
+        result.forgetWeightChanges();
 
         return result;
     }
 
+    /**
+     * @brief Save the graph in a versioned, aligned layout that can be mapped in memory by cpp_utils::graphs::MappedAdjacentGraph
+     * 
+     * Unlike ::saveToFile, loading the generated file does not read anything: the vertex and edge arrays
+     * are used straight from the mapped pages.
+     * 
+     * @pre
+     *  @li @c f open with "wb";
+     *  @li @c f is empty: the graph starts at the beginning of the file;
+     *  @li @c V and @c E are trivially copyable;
+     * @post
+     *  @li @c f modified;
+     *  @li @c f cursor modified;
+     * 
+     * @param[in] f the file to save the graph into
+     * @param[in] g the graph to save
+     */
+    template <typename G, typename V, typename E>
+    void saveToMappableFile(FILE* f, const cpp_utils::graphs::AdjacentGraph<G,V,E>& g) {
+        static_assert(std::is_trivially_copyable<V>::value, "vertex payload needs to be trivially copyable to be mapped");
+        static_assert(std::is_trivially_copyable<E>::value, "edge payload needs to be trivially copyable to be mapped");
+        using namespace cpp_utils::graphs;
+        using namespace cpp_utils::graphs::internal;
+
+        const uint64_t vertices = g.vertexPayload.size();
+        const uint64_t edges = g.edges.size();
+        const bool hasInEdgesIndex = g.hasInEdgesIndex();
+
+        MappedAdjacentGraphHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAPPED_ADJACENT_GRAPH_MAGIC, sizeof(header.magic));
+        header.version = MAPPED_ADJACENT_GRAPH_VERSION;
+        header.flags = 0;
+        if (hasInEdgesIndex) {
+            header.flags |= MAPPED_ADJACENT_GRAPH_HAS_IN_EDGES_INDEX;
+        }
+        if (g.isSortedBySink()) {
+            header.flags |= MAPPED_ADJACENT_GRAPH_OUT_EDGES_SORTED_BY_SINK;
+        }
+        header.sizeOfVertexPayload = sizeof(V);
+        header.sizeOfEdgePayload = sizeof(E);
+        header.numberOfVertices = vertices;
+        header.numberOfEdges = edges;
+        header.vertexPayloadOffset = alignMappedOffset(sizeof(header));
+        header.outEdgesBeginOffset = alignMappedOffset(header.vertexPayloadOffset + sizeof(V) * vertices);
+        header.outEdgesSinkOffset = alignMappedOffset(header.outEdgesBeginOffset + sizeof(uint64_t) * (vertices + 1));
+        header.outEdgesPayloadOffset = alignMappedOffset(header.outEdgesSinkOffset + sizeof(nodeid_t) * edges);
+        uint64_t next = alignMappedOffset(header.outEdgesPayloadOffset + sizeof(E) * edges);
+        if (hasInEdgesIndex) {
+            header.inEdgesBeginOffset = next;
+            header.inEdgesSourceOffset = alignMappedOffset(header.inEdgesBeginOffset + sizeof(uint64_t) * (vertices + 1));
+            header.inEdgesOutEdgeIndexOffset = alignMappedOffset(header.inEdgesSourceOffset + sizeof(nodeid_t) * edges);
+            next = alignMappedOffset(header.inEdgesOutEdgeIndexOffset + sizeof(uint64_t) * edges);
+        }
+        header.graphPayloadOffset = next;
+
+        uint64_t position = 0;
+        writeMappedSection<MappedAdjacentGraphHeader>(f, position, 0, 1, [&](uint64_t i) { return header; });
+        writeMappedSection<V>(f, position, header.vertexPayloadOffset, vertices, [&](uint64_t i) { return g.vertexPayload[i]; });
+        writeMappedSection<uint64_t>(f, position, header.outEdgesBeginOffset, vertices + 1, [&](uint64_t i) { 
+            return (vertices == 0) ? static_cast<uint64_t>(0) : static_cast<uint64_t>(g.outEdgesOfvertexBegin[i]); 
+        });
+        writeMappedSection<nodeid_t>(f, position, header.outEdgesSinkOffset, edges, [&](uint64_t i) { return g.edges[i].getSinkId(); });
+        writeMappedSection<E>(f, position, header.outEdgesPayloadOffset, edges, [&](uint64_t i) { return g.edges[i].getPayload(); });
+        if (hasInEdgesIndex) {
+            writeMappedSection<uint64_t>(f, position, header.inEdgesBeginOffset, vertices + 1, [&](uint64_t i) { return static_cast<uint64_t>(g.inEdgesOfVertexBegin[i]); });
+            writeMappedSection<nodeid_t>(f, position, header.inEdgesSourceOffset, edges, [&](uint64_t i) { return g.inEdgesSource[i]; });
+            writeMappedSection<uint64_t>(f, position, header.inEdgesOutEdgeIndexOffset, edges, [&](uint64_t i) { return static_cast<uint64_t>(g.inEdgesOutEdgeIndex[i]); });
+        }
+        writeMappedSection<char>(f, position, header.graphPayloadOffset, 0, [&](uint64_t i) { return 0; });
+        saveToFile(f, g.payload);
+    }
+
 }
 
 namespace cpp_utils::graphs {
@@ -104,15 +311,12 @@ namespace cpp_utils::graphs {
         }
 
         cpp_utils::graphs::Edge<E>& operator*() const {
-            debug("vertex is", this->vertex, "move", this->move);
-            this->tmp = Edge<E>{this->vertex, this->graph.getOutEdge(this->vertex, this->move)};
-            debug("edge is", tmp);
+            this->tmp = Edge<E>{this->vertex, this->graph.edges[this->graph.outEdgesOfvertexBegin[this->vertex] + this->move]};
             return tmp;
         }
 
         cpp_utils::graphs::Edge<E>* operator->() const {
-            this->tmp = Edge<E>{this->vertex, this->graph.getOutEdge(this->vertex, this->move)};
-            return &tmp;
+            return &(this->operator*());
         }
     protected:
         void computeNext() {
@@ -162,12 +366,139 @@ namespace cpp_utils::graphs {
         }
     };
 
+    /**
+     * @brief a non polymorphic iterator over all the edges of an AdjacentGraph
+     * 
+     * Unlike AdjacentGraphEdgesIterator, it is not allocated in the heap and it has no virtual method: it linearly scans the
+     * array of the edges, hence the compiler can inline the whole loop. Edges are yielded ordered by source.
+     * 
+     * @code
+     * for (auto it=graph.beginFastEdges(); it!=graph.endFastEdges(); ++it) {
+     *  Edge<E> edge = *it;
+     * }
+     * @endcode
+     * 
+     * @tparam E custom payload of each edge
+     */
+    template <typename E>
+    class AdjacentGraphFastEdgeIterator {
+        typedef AdjacentGraphFastEdgeIterator<E> This;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Edge<E>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Edge<E>*;
+        using reference = Edge<E>;
+    private:
+        /**
+         * @brief for each vertex, the index of its first out edge in ::edges
+         * 
+         */
+        const int* outEdgesOfVertexBegin;
+        const OutEdge<E>* edges;
+        /**
+         * @brief source of the edge the iterator is pointing to
+         * 
+         */
+        nodeid_t vertex;
+        /**
+         * @brief index in ::edges of the edge the iterator is pointing to
+         * 
+         */
+        int edge;
+        /**
+         * @brief number of edges. When ::edge reaches it, the iterator has ended
+         * 
+         */
+        int numberOfEdges;
+    public:
+        AdjacentGraphFastEdgeIterator(const int* outEdgesOfVertexBegin, const OutEdge<E>* edges, int edge, int numberOfEdges): outEdgesOfVertexBegin{outEdgesOfVertexBegin}, edges{edges}, vertex{0}, edge{edge}, numberOfEdges{numberOfEdges} {
+            this->skipVerticesWithoutEdges();
+        }
+    public:
+        Edge<E> operator*() const {
+            return Edge<E>{this->vertex, this->edges[this->edge]};
+        }
+        This& operator++() {
+            this->edge += 1;
+            this->skipVerticesWithoutEdges();
+            return *this;
+        }
+        This operator++(int) {
+            This result{*this};
+            ++(*this);
+            return result;
+        }
+        /**
+         * @brief the source of the edge the iterator is pointing to
+         * 
+         * @return nodeid_t the source. Cheaper than `(*it).getSourceId()`
+         */
+        nodeid_t getSourceId() const {
+            return this->vertex;
+        }
+        /**
+         * @brief the edge the iterator is pointing to, without its source
+         * 
+         * @return const OutEdge<E>& the edge stored in the graph. No copy is done
+         */
+        const OutEdge<E>& getOutEdge() const {
+            return this->edges[this->edge];
+        }
+        friend bool operator ==(const This& a, const This& b) {
+            return a.edge == b.edge;
+        }
+        friend bool operator !=(const This& a, const This& b) {
+            return a.edge != b.edge;
+        }
+    private:
+        /**
+         * @brief make sure ::vertex is the source of ::edge
+         * 
+         */
+        void skipVerticesWithoutEdges() {
+            if (this->edge >= this->numberOfEdges) {
+                return;
+            }
+            while (this->outEdgesOfVertexBegin[this->vertex + 1] <= this->edge) {
+                this->vertex += 1;
+            }
+        }
+    };
+
+    /**
+     * @brief an edge whose weight has been changed (see AdjacentGraph::getWeightChangesSince)
+     * 
+     * @tparam E custom payload of each edge
+     */
+    template <typename E>
+    struct EdgeWeightChange {
+        /**
+         * @brief the version of the weights of the graph the change has produced
+         * 
+         */
+        uint64_t version;
+        nodeid_t sourceId;
+        nodeid_t sinkId;
+        /**
+         * @brief the index of the changed edge among the out edges of ::sourceId
+         * 
+         * Useful to tell apart parallel edges
+         */
+        moveid_t index;
+        E oldPayload;
+        E newPayload;
+    };
+
     /**
      * @brief A graph which encodes its edges in an adjacent vector
      * 
      * It contains 2 vectors: one contains the actual edges where each edge with the same source is in a contiguous zone of the vector while
      * the other contains, for each vertex, the index of such contiguous zone.
      * 
+     * Optionally (see ::finalizeGraph) the graph contains a reverse index as well (compressed sparse row of the in edges): with it
+     * ::getInDegree, ::hasPredecessors and ::getInEdges takes \f$O(indegree)\f$ rather than \f$O(V+E)\f$.
+     * 
      * @tparam G custom payload of the whole graph
      * @tparam V custom payload of each vertex
      * @tparam E custom payload of each edge
@@ -178,6 +509,7 @@ namespace cpp_utils::graphs {
         using This = AdjacentGraph<G,V,E>;
         using Super = INonExtendableGraph<G,V,E>;
         using const_vertex_iterator = PairNumberContainerBasedConstIterator<std::vector<V>, nodeid_t, V>;
+        using const_fast_edge_iterator = AdjacentGraphFastEdgeIterator<E>;
         using Super::changeVertexPayload;
         friend IImmutableGraph<G,V,E>;
     private:
@@ -194,12 +526,64 @@ namespace cpp_utils::graphs {
          * 
          */
         std::vector<int> outEdgesOfvertexBegin;
+        /**
+         * @brief vector, as long as AdjacentGraph::outEdgesOfvertexBegin, representing the index where
+         * in AdjacentGraph::inEdgesSource the edges going into the particular vertex starts
+         * 
+         * Empty if the reverse index has not been built (see ::finalizeGraph)
+         */
+        std::vector<int> inEdgesOfVertexBegin;
+        /**
+         * @brief for each in edge, the id of the source vertex of the edge
+         * 
+         * In edges going into the same vertex are in a contiguous zone and are sorted by source id
+         */
+        std::vector<nodeid_t> inEdgesSource;
+        /**
+         * @brief for each in edge, the index in AdjacentGraph::edges of the out edge it represents
+         * 
+         * We store the back reference rather than the payload itself, so changing the weights of the graph does not invalidate the index
+         */
+        std::vector<int> inEdgesOutEdgeIndex;
+        /**
+         * @brief true if the out edges of each vertex are sorted by sink id
+         * 
+         * If so, ::hasEdge, ::getEdge, ::containsEdge and ::changeWeightEdge use a binary search rather than a linear scan
+         * (see ::sortOutEdgesBySink)
+         */
+        bool outEdgesSortedBySink;
+        /**
+         * @brief ::changeWeightEdges looks for the edges of vertices with at most this out degree one update at a time
+         * 
+         */
+        static constexpr int LINEAR_SCAN_DEGREE = 16;
+        /**
+         * @brief incremented each time some edge weights change (see ::getWeightsVersion)
+         * 
+         */
+        uint64_t weightsVersion;
+        /**
+         * @brief the most recent weight changes, sorted by version
+         * 
+         */
+        std::vector<EdgeWeightChange<E>> weightChanges;
+        /**
+         * @brief the number of weight changes ::getWeightChangesSince is guaranteed to remember. 0 disables the log
+         * 
+         */
+        size_t weightChangesCapacity;
+        /**
+         * @brief ::weightChanges contains every change whose version is greater than this one
+         * 
+         */
+        uint64_t weightChangesSince;
     public:
         friend void cpp_utils::serializers::saveToFile<>(FILE* f, const This& g);
         friend This& cpp_utils::serializers::loadFromFile<>(FILE* f, This& result);
+        friend void cpp_utils::serializers::saveToMappableFile<>(FILE* f, const This& g);
         friend class AdjacentGraphEdgesIterator<G, V, E>;
     public:
-        AdjacentGraph(): payload{}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{} {
+        AdjacentGraph(): payload{}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{}, inEdgesOfVertexBegin{}, inEdgesSource{}, inEdgesOutEdgeIndex{}, outEdgesSortedBySink{false}, weightsVersion{0}, weightChanges{}, weightChangesCapacity{0}, weightChangesSince{0} {
 
         }
         /**
@@ -207,7 +591,7 @@ namespace cpp_utils::graphs {
          * 
          * @param payload value attached to the whole graph
          */
-        AdjacentGraph(const G& payload): payload{payload}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{} {
+        AdjacentGraph(const G& payload): payload{payload}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{}, inEdgesOfVertexBegin{}, inEdgesSource{}, inEdgesOutEdgeIndex{}, outEdgesSortedBySink{false}, weightsVersion{0}, weightChanges{}, weightChangesCapacity{0}, weightChangesSince{0} {
 
         }
         /**
@@ -215,23 +599,40 @@ namespace cpp_utils::graphs {
          * 
          * Use it ony when you know what you are doing. Otherwise, ignore this constructor
          * 
+         * The reverse index of the in edges is automatically built
+         * 
          * @param payload 
          * @param vertexPayload 
          * @param edges 
          * @param outEdgesOfvertexBegin 
          */
-        AdjacentGraph(const G& payload, const std::vector<V>& vertexPayload, const std::vector<OutEdge<E>>& edges, const std::vector<int>& outEdgesOfvertexBegin): payload{payload}, vertexPayload{vertexPayload}, edges{edges}, outEdgesOfvertexBegin{outEdgesOfvertexBegin} {
+        AdjacentGraph(const G& payload, const std::vector<V>& vertexPayload, const std::vector<OutEdge<E>>& edges, const std::vector<int>& outEdgesOfvertexBegin): payload{payload}, vertexPayload{vertexPayload}, edges{edges}, outEdgesOfvertexBegin{outEdgesOfvertexBegin}, inEdgesOfVertexBegin{}, inEdgesSource{}, inEdgesOutEdgeIndex{}, outEdgesSortedBySink{false}, weightsVersion{0}, weightChanges{}, weightChangesCapacity{0}, weightChangesSince{0} {
+            this->buildInEdgesIndex();
+        }
+        /**
+         * @brief like the previous constructor, but the components are moved into the graph rather than copied
+         *
+         * @param payload
+         * @param vertexPayload
+         * @param edges
+         * @param outEdgesOfvertexBegin
+         * @param withInEdgesIndex if true we build the reverse index of the in edges as well (see ::finalizeGraph)
+         */
+        AdjacentGraph(G&& payload, std::vector<V>&& vertexPayload, std::vector<OutEdge<E>>&& edges, std::vector<int>&& outEdgesOfvertexBegin, bool withInEdgesIndex): payload{::std::move(payload)}, vertexPayload{::std::move(vertexPayload)}, edges{::std::move(edges)}, outEdgesOfvertexBegin{::std::move(outEdgesOfvertexBegin)}, inEdgesOfVertexBegin{}, inEdgesSource{}, inEdgesOutEdgeIndex{}, outEdgesSortedBySink{false}, weightsVersion{0}, weightChanges{}, weightChangesCapacity{0}, weightChangesSince{0} {
+            if (withInEdgesIndex) {
+                this->buildInEdgesIndex();
+            }
         }
         /**
          * @brief Construct a new Adjacent Graph< G, V, E> object
          * 
          * @param other another graph. It's mandatory that the ids of `other` are **contiguous** and they start from 0!
          */
-        AdjacentGraph(const IImmutableGraph<G,V,E>& other) : payload{other.getPayload()}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{} {
+        AdjacentGraph(const IImmutableGraph<G,V,E>& other) : payload{other.getPayload()}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{}, inEdgesOfVertexBegin{}, inEdgesSource{}, inEdgesOutEdgeIndex{}, outEdgesSortedBySink{false}, weightsVersion{0}, weightChanges{}, weightChangesCapacity{0}, weightChangesSince{0} {
             info("the payload is ", this->payload);
             this->init(other);
         }
-        AdjacentGraph(IImmutableGraph<G,V,E>&& other) : payload{other.getPayload()}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{} {
+        AdjacentGraph(IImmutableGraph<G,V,E>&& other) : payload{other.getPayload()}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{}, inEdgesOfVertexBegin{}, inEdgesSource{}, inEdgesOutEdgeIndex{}, outEdgesSortedBySink{false}, weightsVersion{0}, weightChanges{}, weightChangesCapacity{0}, weightChangesSince{0} {
             this->init(other);
         }
         /**
@@ -244,16 +645,16 @@ namespace cpp_utils::graphs {
          * 
          * @param other the unique_pointer whose ownership we need to transfer
          */
-        AdjacentGraph(std::unique_ptr<IImmutableGraph<G,V,E>>&& other): payload{other->getPayload()}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{} {
+        AdjacentGraph(std::unique_ptr<IImmutableGraph<G,V,E>>&& other): payload{other->getPayload()}, vertexPayload{}, edges{}, outEdgesOfvertexBegin{}, inEdgesOfVertexBegin{}, inEdgesSource{}, inEdgesOutEdgeIndex{}, outEdgesSortedBySink{false}, weightsVersion{0}, weightChanges{}, weightChangesCapacity{0}, weightChangesSince{0} {
             auto* ptr = other.release();
             this->init(*ptr);
             delete ptr;
         }
-        AdjacentGraph(const AdjacentGraph<G, V,E>& other): payload{other.payload}, vertexPayload{other.vertexPayload}, edges{other.edges}, outEdgesOfvertexBegin{other.outEdgesOfvertexBegin} {
+        AdjacentGraph(const AdjacentGraph<G, V,E>& other): payload{other.payload}, vertexPayload{other.vertexPayload}, edges{other.edges}, outEdgesOfvertexBegin{other.outEdgesOfvertexBegin}, inEdgesOfVertexBegin{other.inEdgesOfVertexBegin}, inEdgesSource{other.inEdgesSource}, inEdgesOutEdgeIndex{other.inEdgesOutEdgeIndex}, outEdgesSortedBySink{other.outEdgesSortedBySink}, weightsVersion{other.weightsVersion}, weightChanges{other.weightChanges}, weightChangesCapacity{other.weightChangesCapacity}, weightChangesSince{other.weightChangesSince} {
 
         }
         
-        AdjacentGraph(AdjacentGraph<G, V,E>&& other): payload{::std::move(other.payload)}, vertexPayload{::std::move(other.vertexPayload)}, edges{::std::move(other.edges)}, outEdgesOfvertexBegin{::std::move(other.outEdgesOfvertexBegin)} {
+        AdjacentGraph(AdjacentGraph<G, V,E>&& other): payload{::std::move(other.payload)}, vertexPayload{::std::move(other.vertexPayload)}, edges{::std::move(other.edges)}, outEdgesOfvertexBegin{::std::move(other.outEdgesOfvertexBegin)}, inEdgesOfVertexBegin{::std::move(other.inEdgesOfVertexBegin)}, inEdgesSource{::std::move(other.inEdgesSource)}, inEdgesOutEdgeIndex{::std::move(other.inEdgesOutEdgeIndex)}, outEdgesSortedBySink{other.outEdgesSortedBySink}, weightsVersion{other.weightsVersion}, weightChanges{::std::move(other.weightChanges)}, weightChangesCapacity{other.weightChangesCapacity}, weightChangesSince{other.weightChangesSince} {
             
         }
         AdjacentGraph& operator = (const This& o) {
@@ -261,6 +662,14 @@ namespace cpp_utils::graphs {
             this->vertexPayload = o.vertexPayload;
             this->edges = o.edges;
             this->outEdgesOfvertexBegin = o.outEdgesOfvertexBegin;
+            this->inEdgesOfVertexBegin = o.inEdgesOfVertexBegin;
+            this->inEdgesSource = o.inEdgesSource;
+            this->inEdgesOutEdgeIndex = o.inEdgesOutEdgeIndex;
+            this->outEdgesSortedBySink = o.outEdgesSortedBySink;
+            this->weightsVersion = o.weightsVersion;
+            this->weightChanges = o.weightChanges;
+            this->weightChangesCapacity = o.weightChangesCapacity;
+            this->weightChangesSince = o.weightChangesSince;
             return *this;
         }
         This& operator = (This&& o) {
@@ -268,11 +677,145 @@ namespace cpp_utils::graphs {
             this->vertexPayload = ::std::move(o.vertexPayload);
             this->edges = ::std::move(o.edges);
             this->outEdgesOfvertexBegin = ::std::move(o.outEdgesOfvertexBegin);
+            this->inEdgesOfVertexBegin = ::std::move(o.inEdgesOfVertexBegin);
+            this->inEdgesSource = ::std::move(o.inEdgesSource);
+            this->inEdgesOutEdgeIndex = ::std::move(o.inEdgesOutEdgeIndex);
+            this->outEdgesSortedBySink = o.outEdgesSortedBySink;
+            this->weightsVersion = o.weightsVersion;
+            this->weightChanges = ::std::move(o.weightChanges);
+            this->weightChangesCapacity = o.weightChangesCapacity;
+            this->weightChangesSince = o.weightChangesSince;
             return *this;
         }
         virtual ~AdjacentGraph() {
 
         }
+    public:
+        /**
+         * @brief build a graph from an unsorted list of edges
+         * 
+         * Unlike ::addEdgeTail, edges do not need to be sorted by source. The graph is built in 2 parallel passes over the edges
+         * (a counting sort over the source ids) and the array of the edges is allocated exactly once.
+         * Edges with the same source keep the order they have in @c edges.
+         * 
+         * @param payload the payload of the whole graph
+         * @param vertexPayload the payload of each vertex. The id of a vertex is its index in the vector
+         * @param edges the edges of the graph, in any order
+         * @param threads number of threads to use. If 0, we use cpp_utils::getDefaultNumberOfThreads
+         * @param withInEdgesIndex true if we need to build the reverse index of the in edges as well (see ::finalizeGraph)
+         * @return This the graph built. It is already finalized
+         * @throw cpp_utils::exceptions::InvalidArgumentException if an edge refers to a vertex not in @c vertexPayload
+         */
+        static This fromEdges(const G& payload, const std::vector<V>& vertexPayload, const std::vector<Edge<E>>& edges, size_t threads = 0, bool withInEdgesIndex = true) {
+            return This::fromEdgeBuffers(payload, vertexPayload, std::vector<ConstSpan<Edge<E>>>{ConstSpan<Edge<E>>{edges.data(), edges.size()}}, threads, withInEdgesIndex);
+        }
+        /**
+         * @brief build a graph from several unsorted lists of edges
+         * 
+         * Useful when the edges are generated by several threads, each of them with its own buffer: buffers are not merged together.
+         * Edges with the same source keep the order they have in the concatenation of @c edgeBuffers.
+         * 
+         * @param payload the payload of the whole graph
+         * @param vertexPayload the payload of each vertex. The id of a vertex is its index in the vector
+         * @param edgeBuffers the edges of the graph, in any order
+         * @param threads number of threads to use. If 0, we use cpp_utils::getDefaultNumberOfThreads
+         * @param withInEdgesIndex true if we need to build the reverse index of the in edges as well (see ::finalizeGraph)
+         * @return This the graph built. It is already finalized
+         * @throw cpp_utils::exceptions::InvalidArgumentException if an edge refers to a vertex not in @c vertexPayload
+         */
+        static This fromEdges(const G& payload, const std::vector<V>& vertexPayload, const std::vector<std::vector<Edge<E>>>& edgeBuffers, size_t threads = 0, bool withInEdgesIndex = true) {
+            std::vector<ConstSpan<Edge<E>>> spans{};
+            spans.reserve(edgeBuffers.size());
+            for (auto& buffer : edgeBuffers) {
+                spans.push_back(ConstSpan<Edge<E>>{buffer.data(), buffer.size()});
+            }
+            return This::fromEdgeBuffers(payload, vertexPayload, spans, threads, withInEdgesIndex);
+        }
+    private:
+        static This fromEdgeBuffers(const G& payload, const std::vector<V>& vertexPayload, const std::vector<ConstSpan<Edge<E>>>& edgeBuffers, size_t threads, bool withInEdgesIndex) {
+            This result{payload};
+            result.vertexPayload = vertexPayload;
+            const size_t vertices = vertexPayload.size();
+
+            //index of the first edge of each buffer if all the buffers were concatenated
+            std::vector<size_t> bufferBegin{0};
+            for (auto& buffer : edgeBuffers) {
+                bufferBegin.push_back(bufferBegin.back() + buffer.size());
+            }
+            const size_t totalEdges = bufferBegin.back();
+            if (totalEdges > static_cast<size_t>(std::numeric_limits<int>::max())) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"the graph can contain at most", std::numeric_limits<int>::max(), "edges, but we have", totalEdges};
+            }
+            if (threads == 0) {
+                threads = cpp_utils::getDefaultNumberOfThreads();
+            }
+            threads = std::max<size_t>(1, std::min(threads, totalEdges));
+
+            //apply a function over the edges in [globalBegin, globalEnd) of the concatenation of the buffers
+            auto visitEdges = [&](size_t globalBegin, size_t globalEnd, auto lambda) {
+                size_t buffer = std::upper_bound(bufferBegin.begin(), bufferBegin.end(), globalBegin) - bufferBegin.begin() - 1;
+                for (size_t i=globalBegin; i<globalEnd; ++i) {
+                    while (i >= bufferBegin[buffer + 1]) {
+                        buffer += 1;
+                    }
+                    lambda(edgeBuffers[buffer][i - bufferBegin[buffer]]);
+                }
+            };
+
+            //first pass: each thread counts the out degree of each vertex in its own block
+            std::vector<std::vector<int>> positions(threads);
+            cpp_utils::parallelForBlocks(0, totalEdges, threads, [&](size_t threadId, size_t begin, size_t end) {
+                auto& counts = positions[threadId];
+                counts.assign(vertices, 0);
+                visitEdges(begin, end, [&](const Edge<E>& edge) {
+                    if (edge.getSourceId() >= vertices || edge.getSinkId() >= vertices) {
+                        throw cpp_utils::exceptions::InvalidArgumentException{"edge", edge.getSourceId(), "->", edge.getSinkId(), "refers to a vertex not in the graph. Vertices are", vertices};
+                    }
+                    counts[edge.getSourceId()] += 1;
+                });
+            });
+
+            //prefix sum: where each thread needs to put the out edges of each vertex
+            result.outEdgesOfvertexBegin.assign(vertices + 1, 0);
+            cpp_utils::parallelForBlocks(0, vertices, threads, [&](size_t threadId, size_t begin, size_t end) {
+                for (size_t id=begin; id<end; ++id) {
+                    int outDegree = 0;
+                    for (auto& counts : positions) {
+                        outDegree += counts[id];
+                    }
+                    result.outEdgesOfvertexBegin[id + 1] = outDegree;
+                }
+            });
+            for (size_t id=0; id<vertices; ++id) {
+                result.outEdgesOfvertexBegin[id + 1] += result.outEdgesOfvertexBegin[id];
+            }
+            cpp_utils::parallelForBlocks(0, vertices, threads, [&](size_t threadId, size_t begin, size_t end) {
+                for (size_t id=begin; id<end; ++id) {
+                    int position = result.outEdgesOfvertexBegin[id];
+                    for (auto& counts : positions) {
+                        int count = counts[id];
+                        counts[id] = position;
+                        position += count;
+                    }
+                }
+            });
+
+            //second pass: each thread scatters the edges of its block in the position computed before
+            result.edges.resize(totalEdges);
+            cpp_utils::parallelForBlocks(0, totalEdges, threads, [&](size_t threadId, size_t begin, size_t end) {
+                auto& nextPosition = positions[threadId];
+                visitEdges(begin, end, [&](const Edge<E>& edge) {
+                    result.edges[nextPosition[edge.getSourceId()]++] = OutEdge<E>{edge.getSinkId(), edge.getPayload()};
+                });
+            });
+
+            if (withInEdgesIndex) {
+                result.buildInEdgesIndex();
+            } else {
+                result.clearInEdgesIndex();
+            }
+            return result;
+        }
     public:
         virtual size_t size() const {
             return this->vertexPayload.size();
@@ -319,14 +862,36 @@ namespace cpp_utils::graphs {
             //const_edge_iterator* it = new const_edge_iterator{const_edge_iterator{true, 0, 0, *this}};
             return typename IImmutableGraph<G,V,E>::const_edge_iterator{it};
         }
+        /**
+         * @brief first edge of the graph, for a non allocating iteration
+         * 
+         * @note
+         * Unlike ::beginEdges, the iterator is a value type without virtual calls. Prefer it (or ::forEachEdge) when you
+         * need to scan the whole graph
+         * 
+         * @return const_fast_edge_iterator iterator to the first edge
+         */
+        const_fast_edge_iterator beginFastEdges() const {
+            return const_fast_edge_iterator{this->outEdgesOfvertexBegin.data(), this->edges.data(), 0, static_cast<int>(this->edges.size())};
+        }
+        /**
+         * @brief the iterator after the last edge of the graph
+         * 
+         * @return const_fast_edge_iterator the ended iterator
+         */
+        const_fast_edge_iterator endFastEdges() const {
+            return const_fast_edge_iterator{this->outEdgesOfvertexBegin.data(), this->edges.data(), static_cast<int>(this->edges.size()), static_cast<int>(this->edges.size())};
+        }
+        virtual void forEachEdge(const std::function<void(nodeid_t, nodeid_t, const E&)>& lambda) const {
+            cpp_utils::graphs::forEachEdge(*this, lambda);
+        }
         virtual const V& getVertex(nodeid_t id) const {
             return this->vertexPayload[id];
         }
         virtual const E& getEdge(nodeid_t sourceId, nodeid_t sinkId) const {
-            for (auto i=this->outEdgesOfvertexBegin[sourceId]; i<this->outEdgesOfvertexBegin[sourceId+1]; ++i) {
-                if (this->edges[i].getSinkId() == sinkId) {
-                    return this->edges[i].getPayload();
-                }
+            int i = this->findOutEdge(sourceId, sinkId);
+            if (i >= 0) {
+                return this->edges[i].getPayload();
             }
             throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, AdjacentGraph<G,V,E>>{sinkId, *this};
         }
@@ -337,12 +902,13 @@ namespace cpp_utils::graphs {
             return this->payload;
         }
         virtual size_t getInDegree(nodeid_t id) const {
+            if (this->hasInEdgesIndex()) {
+                return this->inEdgesOfVertexBegin[id+1] - this->inEdgesOfVertexBegin[id];
+            }
+            //like the index, each parallel edge counts (see IImmutableGraph::getInDegree)
             size_t result = 0;
-            debug("new computation!");
-            for (auto it=this->beginVertices(); it!=this->endVertices(); ++it) {
-                debug("it is ", it->first, "paylaod is ", it->second);
-                if (this->hasEdge(it->first, id)) {
-                    debug("there is an edge from ", id, " to", it->first);
+            for (auto& outEdge : this->edges) {
+                if (outEdge.getSinkId() == id) {
                     result += 1;
                 }
             }
@@ -358,6 +924,14 @@ namespace cpp_utils::graphs {
             return this->getOutDegree(id) > 0;
         }
         virtual bool hasPredecessors(nodeid_t id) const {
+            if (this->hasInEdgesIndex()) {
+                for (auto i=this->inEdgesOfVertexBegin[id]; i<this->inEdgesOfVertexBegin[id+1]; ++i) {
+                    if (this->inEdgesSource[i] != id) {
+                        return true;
+                    }
+                }
+                return false;
+            }
             for (auto sourceId=0; sourceId<this->vertexPayload.size(); ++sourceId) {
                 if (sourceId == id) {
                     continue;
@@ -375,15 +949,20 @@ namespace cpp_utils::graphs {
             return this->edges[this->outEdgesOfvertexBegin[id] + index];
         }
         virtual bool hasEdge(nodeid_t sourceId, nodeid_t sinkId) const {
-            for (auto i=this->outEdgesOfvertexBegin[sourceId]; i<this->outEdgesOfvertexBegin[sourceId+1]; ++i) {
-                if (this->edges[i].getSinkId() == sinkId) {
-                    return true;
-                }
-            }
-            return false;
+            return this->findOutEdge(sourceId, sinkId) >= 0;
         }
         virtual std::vector<InEdge<E>> getInEdges(nodeid_t id) const {
             std::vector<InEdge<E>> result{};
+
+            if (this->hasInEdgesIndex()) {
+                for (auto i=this->inEdgesOfVertexBegin[id]; i<this->inEdgesOfVertexBegin[id+1]; ++i) {
+                    if (this->inEdgesSource[i] == id) {
+                        continue;
+                    }
+                    result.push_back(InEdge<E>{this->inEdgesSource[i], this->edges[this->inEdgesOutEdgeIndex[i]].getPayload()});
+                }
+                return result;
+            }
         
             for (nodeid_t sourceId=0; sourceId<this->vertexPayload.size(); ++sourceId) {
                 if (sourceId == id) {
@@ -398,12 +977,8 @@ namespace cpp_utils::graphs {
             return result;
         }
         virtual std::vector<OutEdge<E>> getOutEdges(nodeid_t id) const {
-            std::vector<OutEdge<E>> result{};
-            for (auto i=0; i<this->getOutDegree(id); ++i) {
-                result.push_back(this->edges[this->outEdgesOfvertexBegin[id] + i]);
-            }
-
-            return result;
+            auto range = this->outEdgeRange(id);
+            return std::vector<OutEdge<E>>{range.begin(), range.end()};
         }
         virtual bool isEmpty() const {
             return this->vertexPayload.size() == 0;
@@ -415,20 +990,47 @@ namespace cpp_utils::graphs {
             return id < this->vertexPayload.size();
         }
         virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId, const E& payload) const {
-            for (auto i=this->outEdgesOfvertexBegin[sourceId]; i<this->outEdgesOfvertexBegin[sourceId+1]; ++i) {
+            int first = this->findOutEdge(sourceId, sinkId);
+            if (first < 0) {
+                return false;
+            }
+            for (auto i=first; i<this->outEdgesOfvertexBegin[sourceId+1]; ++i) {
                 if (this->edges[i].getSinkId() == sinkId && this->edges[i].getPayload() == payload) {
                     return true;
                 }
+                if (this->outEdgesSortedBySink && this->edges[i].getSinkId() != sinkId) {
+                    //parallel edges are contiguous
+                    break;
+                }
             }
             return false;
         }
         virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId) const {
-            for (auto i=this->outEdgesOfvertexBegin[sourceId]; i<this->outEdgesOfvertexBegin[sourceId+1]; ++i) {
-                if (this->edges[i].getSinkId() == sinkId) {
-                    return true;
-                }
-            }
-            return false;
+            return this->findOutEdge(sourceId, sinkId) >= 0;
+        }
+    public:
+        /**
+         * @brief the out edges of a vertex, without copying them
+         * 
+         * Unlike ::getOutEdges, nothing is allocated; unlike ::getOutEdge, there is no virtual call per edge:
+         * the range points directly to the edges stored in the graph. Use it (or cpp_utils::graphs::forEachOutEdge)
+         * in hot loops.
+         * 
+         * @note
+         * the range is invalidated if the graph is modified (e.g., via ::addEdgeTail or ::reorderVertices)
+         * 
+         * @code
+         * for (auto& outEdge : graph.outEdgeRange(id)) {
+         *  ...
+         * }
+         * @endcode
+         * 
+         * @param id the vertex involved
+         * @return ConstSpan<OutEdge<E>> the out edges of @c id, in the same order of ::getOutEdge
+         */
+        ConstSpan<OutEdge<E>> outEdgeRange(nodeid_t id) const {
+            const OutEdge<E>* base = this->edges.data();
+            return ConstSpan<OutEdge<E>>{base + this->outEdgesOfvertexBegin[id], base + this->outEdgesOfvertexBegin[id + 1]};
         }
     protected:
         virtual nodeid_t getLastVertexId() const {
@@ -439,21 +1041,260 @@ namespace cpp_utils::graphs {
             this->vertexPayload[vertexId] = payload;
         }
         virtual void changeWeightEdge(nodeid_t sourceId, nodeid_t sinkId, const E& newPayload) {
-            for (auto i=this->outEdgesOfvertexBegin[sourceId]; i<this->outEdgesOfvertexBegin[sourceId+1]; ++i) {
-                if (this->edges[i].getSinkId() == sinkId) {
-                    this->edges[i].setPayload(newPayload);
-                    return;
-                }
+            int i = this->findOutEdge(sourceId, sinkId);
+            if (i >= 0) {
+                this->weightsVersion += 1;
+                this->setEdgeWeight(sourceId, i, newPayload);
+                this->trimWeightChanges();
+                return;
             }
             throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, AdjacentGraph<G,V,E>>{sinkId, *this};
         }
         virtual void changeWeightOutEdge(nodeid_t sourceId, moveid_t index, const E& newPayload) {
             assertInRange(0, index, this->getOutDegree(sourceId), true, false);
-            this->edges[this->outEdgesOfvertexBegin[sourceId] + index].setPayload(newPayload);
+            this->weightsVersion += 1;
+            this->setEdgeWeight(sourceId, this->outEdgesOfvertexBegin[sourceId] + index, newPayload);
+            this->trimWeightChanges();
+        }
+        /**
+         * @brief change the weights of several edges in a single pass
+         * 
+         * The updates involving sources with many successors are sorted by source and sink, so the out edges of each of those sources
+         * are scanned only once (or binary searched, if the graph ::isSortedBySink), rather than once per update. The others are
+         * handled one by one, since scanning a handful of out edges is cheaper than sorting.
+         * Either every update is applied or none is: if an edge does not exist, nothing is changed.
+         * The whole batch counts as a single change of ::getWeightsVersion.
+         * 
+         * @code
+         * graph.setWeightChangeLogCapacity(10000);
+         * uint64_t version = graph.getWeightsVersion();
+         * graph.changeWeightEdges(std::vector<Edge<int>>{{0, 1, 5}, {3, 2, 7}});
+         * std::vector<EdgeWeightChange<int>> changes;
+         * if (graph.getWeightChangesSince(version, changes)) {
+         *  //update a cache with the 2 changes only
+         * }
+         * @endcode
+         * 
+         * @param updates for each edge to alter, its source, its sink and its new value. As in ::changeWeightEdge,
+         *  if there are parallel edges only the first one is changed. If an edge appears several times, the last update wins
+         * @throw cpp_utils::exceptions::ElementNotFoundException if an edge does not exist
+         */
+        virtual void changeWeightEdges(const std::vector<Edge<E>>& updates) {
+            if (updates.empty()) {
+                return;
+            }
+            //find every edge before touching any of them.
+            //Low degree sources are cheap to scan: only the updates of the others are sorted and handled together
+            std::vector<int> edgeIndex(updates.size(), -1);
+            std::vector<size_t> order{};
+            for (size_t i=0; i<updates.size(); ++i) {
+                const nodeid_t sourceId = updates[i].getSourceId();
+                if (sourceId >= this->vertexPayload.size()) {
+                    throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, AdjacentGraph<G,V,E>>{sourceId, *this};
+                }
+                if ((this->outEdgesOfvertexBegin[sourceId + 1] - this->outEdgesOfvertexBegin[sourceId]) <= LINEAR_SCAN_DEGREE) {
+                    edgeIndex[i] = this->findOutEdge(sourceId, updates[i].getSinkId());
+                    if (edgeIndex[i] < 0) {
+                        throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, AdjacentGraph<G,V,E>>{updates[i].getSinkId(), *this};
+                    }
+                } else {
+                    order.push_back(i);
+                }
+            }
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                if (updates[a].getSourceId() != updates[b].getSourceId()) {
+                    return updates[a].getSourceId() < updates[b].getSourceId();
+                }
+                return updates[a].getSinkId() < updates[b].getSinkId();
+            });
+
+            for (size_t groupBegin=0; groupBegin<order.size(); ) {
+                const nodeid_t sourceId = updates[order[groupBegin]].getSourceId();
+                size_t groupEnd = groupBegin;
+                while (groupEnd < order.size() && updates[order[groupEnd]].getSourceId() == sourceId) {
+                    ++groupEnd;
+                }
+                const int begin = this->outEdgesOfvertexBegin[sourceId];
+                const int end = this->outEdgesOfvertexBegin[sourceId + 1];
+                if (this->outEdgesSortedBySink) {
+                    //sinks of the updates are sorted as well: each binary search starts where the previous one ended
+                    auto it = this->edges.begin() + begin;
+                    for (size_t i=groupBegin; i<groupEnd; ++i) {
+                        const nodeid_t sinkId = updates[order[i]].getSinkId();
+                        it = std::lower_bound(it, this->edges.begin() + end, sinkId, [](const OutEdge<E>& outEdge, nodeid_t id) {
+                            return outEdge.getSinkId() < id;
+                        });
+                        if (it != (this->edges.begin() + end) && it->getSinkId() == sinkId) {
+                            edgeIndex[order[i]] = static_cast<int>(it - this->edges.begin());
+                        }
+                    }
+                } else if (groupEnd - groupBegin == 1) {
+                    edgeIndex[order[groupBegin]] = this->findOutEdge(sourceId, updates[order[groupBegin]].getSinkId());
+                } else {
+                    //scan the out edges once and look for each sink among the (sorted) updates
+                    for (int i=end - 1; i>=begin; --i) {
+                        const nodeid_t sinkId = this->edges[i].getSinkId();
+                        auto first = std::lower_bound(order.begin() + groupBegin, order.begin() + groupEnd, sinkId, [&](size_t update, nodeid_t id) {
+                            return updates[update].getSinkId() < id;
+                        });
+                        //going backwards, the last assignment is the first parallel edge
+                        for (; first != (order.begin() + groupEnd) && updates[*first].getSinkId() == sinkId; ++first) {
+                            edgeIndex[*first] = i;
+                        }
+                    }
+                }
+                for (size_t i=groupBegin; i<groupEnd; ++i) {
+                    if (edgeIndex[order[i]] < 0) {
+                        throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, AdjacentGraph<G,V,E>>{updates[order[i]].getSinkId(), *this};
+                    }
+                }
+                groupBegin = groupEnd;
+            }
+
+            this->weightsVersion += 1;
+            for (size_t i=0; i<updates.size(); ++i) {
+                this->setEdgeWeight(updates[i].getSourceId(), edgeIndex[i], updates[i].getPayload());
+            }
+            this->trimWeightChanges();
+        }
+    public:
+        /**
+         * @brief a number which changes each time some edge weights change
+         * 
+         * Structures precomputed from the weights (heuristics, path caches, ...) can store the version they have been built with:
+         * if it is still the current one, they are up to date; otherwise ::getWeightChangesSince tells them which edges have changed.
+         * 
+         * @note
+         * changes made via the non const ::getOutEdge are not tracked
+         * 
+         * @return uint64_t the version of the weights of the graph
+         */
+        uint64_t getWeightsVersion() const {
+            return this->weightsVersion;
+        }
+        /**
+         * @brief set how many weight changes the graph remembers
+         * 
+         * The log is disabled by default: only ::getWeightsVersion is updated. Changing the capacity forgets the changes
+         * logged so far.
+         * 
+         * @param capacity the number of the most recent changes ::getWeightChangesSince is guaranteed to return.
+         *  The log uses at most twice as many entries
+         */
+        void setWeightChangeLogCapacity(size_t capacity) {
+            this->weightChangesCapacity = capacity;
+            this->weightChanges.clear();
+            this->weightChanges.shrink_to_fit();
+            this->weightChangesSince = this->weightsVersion;
+        }
+        size_t getWeightChangeLogCapacity() const {
+            return this->weightChangesCapacity;
+        }
+        /**
+         * @brief the edge weight changes happened after a given version
+         * 
+         * @param version a version previously returned by ::getWeightsVersion
+         * @param result vector where we append the changes, from the oldest to the newest. An edge changed several times appears several times
+         * @return true if @c result contains every change happened after @c version
+         * @return false if the log does not reach @c version anymore (or it is disabled): the caller needs to rebuild whatever depends on the weights.
+         *  @c result is not modified
+         */
+        bool getWeightChangesSince(uint64_t version, std::vector<EdgeWeightChange<E>>& result) const {
+            if (version == this->weightsVersion) {
+                return true;
+            }
+            if (version < this->weightChangesSince || version > this->weightsVersion) {
+                return false;
+            }
+            auto first = std::upper_bound(this->weightChanges.begin(), this->weightChanges.end(), version, [](uint64_t v, const EdgeWeightChange<E>& change) {
+                return v < change.version;
+            });
+            result.insert(result.end(), first, this->weightChanges.end());
+            return true;
+        }
+    private:
+        void setEdgeWeight(nodeid_t sourceId, int edgeIndex, const E& newPayload) {
+            if (this->weightChangesCapacity > 0) {
+                this->weightChanges.push_back(EdgeWeightChange<E>{
+                    this->weightsVersion, sourceId, this->edges[edgeIndex].getSinkId(), 
+                    static_cast<moveid_t>(edgeIndex - this->outEdgesOfvertexBegin[sourceId]), this->edges[edgeIndex].getPayload(), newPayload
+                });
+            } else {
+                this->weightChangesSince = this->weightsVersion;
+            }
+            this->edges[edgeIndex].setPayload(newPayload);
+        }
+        /**
+         * @brief drop the oldest changes once the log is twice its capacity, so each change is moved \f$O(1)\f$ times
+         * 
+         */
+        void trimWeightChanges() {
+            if (this->weightChangesCapacity == 0 || this->weightChanges.size() < 2 * this->weightChangesCapacity) {
+                return;
+            }
+            const size_t toRemove = this->weightChanges.size() - this->weightChangesCapacity;
+            this->weightChangesSince = this->weightChanges[toRemove - 1].version;
+            this->weightChanges.erase(this->weightChanges.begin(), this->weightChanges.begin() + toRemove);
+        }
+        /**
+         * @brief declare that every weight may have changed
+         * 
+         */
+        void forgetWeightChanges() {
+            this->weightsVersion += 1;
+            this->weightChanges.clear();
+            this->weightChangesSince = this->weightsVersion;
+        }
+    public:
+        /**
+         * @brief like IImmutableGraph::reorderVertices, but it directly relabels the arrays of the graph
+         * 
+         * It takes \f$O(V+E)\f$: no vector is allocated per vertex and no edge is accessed via virtual calls.
+         * The reverse index of the in edges is built in the new graph if this graph has it.
+         * 
+         * @param fromOldToNew a vector where each index is the id of a vertex in the old coordinate system while the associated cell represents the id of the same vertex in the new coordinate system.
+         * @param fromNewToOld a vector where each index is the id of a vertex in the new coordinate system while the associated cell represents the id of the same vertex in the old coordinate system
+         * @return a new graph where each vertex has been ordered as specified by the parameters
+         */
+        virtual std::unique_ptr<IImmutableGraph<G,V,E>> reorderVertices(const std::vector<nodeid_t>& fromOldToNew, const std::vector<nodeid_t>& fromNewToOld) const {
+            const size_t vertices = this->vertexPayload.size();
+            if (fromOldToNew.size() != vertices || fromNewToOld.size() != vertices) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"permutations have size", fromOldToNew.size(), "and", fromNewToOld.size(), "but the graph has", vertices, "vertices"};
+            }
+            auto result = std::make_unique<This>(this->payload);
+
+            result->vertexPayload.reserve(vertices);
+            result->outEdgesOfvertexBegin.reserve(vertices + 1);
+            result->edges.reserve(this->edges.size());
+            result->outEdgesOfvertexBegin.push_back(0);
+            for (nodeid_t newSourceId=0; newSourceId<vertices; ++newSourceId) {
+                nodeid_t oldSourceId = fromNewToOld[newSourceId];
+                result->vertexPayload.push_back(this->vertexPayload[oldSourceId]);
+                for (const auto& outEdge : this->outEdgeRange(oldSourceId)) {
+                    result->edges.push_back(OutEdge<E>{fromOldToNew[outEdge.getSinkId()], outEdge.getPayload()});
+                }
+                result->outEdgesOfvertexBegin.push_back(static_cast<int>(result->edges.size()));
+            }
+
+            if (this->outEdgesSortedBySink) {
+                result->sortOutEdgesBySink();
+            }
+            if (this->hasInEdgesIndex()) {
+                result->buildInEdgesIndex();
+            }
+            return std::unique_ptr<IImmutableGraph<G,V,E>>{result.release()};
         }
     public:
         virtual MemoryConsumption getByteMemoryOccupied() const {
-            return MemoryConsumption{sizeof(*this), MemoryConsumptionEnum::BYTE};
+            size_t result = sizeof(*this);
+            result += sizeof(V) * this->vertexPayload.capacity();
+            result += sizeof(OutEdge<E>) * this->edges.capacity();
+            result += sizeof(int) * this->outEdgesOfvertexBegin.capacity();
+            result += sizeof(int) * this->inEdgesOfVertexBegin.capacity();
+            result += sizeof(nodeid_t) * this->inEdgesSource.capacity();
+            result += sizeof(int) * this->inEdgesOutEdgeIndex.capacity();
+            result += sizeof(EdgeWeightChange<E>) * this->weightChanges.capacity();
+            return MemoryConsumption{result, MemoryConsumptionEnum::BYTE};
         }
     public:
         // /**
@@ -471,6 +1312,7 @@ namespace cpp_utils::graphs {
         //  * @param payload paylaod of the edge
         //  */
         void addEdgeTail(nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+            this->outEdgesSortedBySink = false;
             if (this->outEdgesOfvertexBegin.size() == 0) {
                 nodeid_t lastSourceId = 0;
                 //we need to add in outEdgesOfvertexBegin the data for the vertices which do not have any outEdges as well!
@@ -501,7 +1343,15 @@ namespace cpp_utils::graphs {
                 } 
             }
         }
-        void finalizeGraph() {
+        /**
+         * @brief stop the add edge procedure
+         * 
+         * @param withInEdgesIndex if true we will build the reverse index of the in edges as well. It costs
+         *  additional memory but in edges queries will take \f$O(indegree)\f$ instead of \f$O(V+E)\f$
+         * @param sortBySink if true we will sort the out edges of each vertex by sink (see ::sortOutEdgesBySink). The order
+         *  of the out edges (hence the meaning of each moveid_t) changes, but edge lookups will take \f$O(\log outdegree)\f$
+         */
+        void finalizeGraph(bool withInEdgesIndex = true, bool sortBySink = false) {
             debug("in finalize this->outEdgesOfvertexBegin ", this->outEdgesOfvertexBegin);
             debug("in finalize this->edges ", this->edges);
 
@@ -520,6 +1370,109 @@ namespace cpp_utils::graphs {
             }
             //add final value to have correct semantic of getOutEdge()
             this->outEdgesOfvertexBegin.push_back(this->edges.size());
+
+            this->outEdgesSortedBySink = false;
+            if (sortBySink) {
+                this->sortOutEdgesBySink();
+            }
+            if (withInEdgesIndex) {
+                this->buildInEdgesIndex();
+            } else {
+                this->clearInEdgesIndex();
+            }
+        }
+
+        /**
+         * @brief sort the out edges of each vertex by sink id
+         * 
+         * Afterwards, ::hasEdge, ::getEdge, ::containsEdge and ::changeWeightEdge perform a binary search over the out edges
+         * of the source, rather than a linear scan: useful for graphs with hubs, namely vertices with thousands of successors.
+         * Parallel edges keep their relative order. If present, the reverse index of the in edges is rebuilt.
+         * 
+         * @note
+         * the moveid_t of the out edges change!
+         * 
+         * @pre
+         *  @li the graph has been finalized;
+         */
+        void sortOutEdgesBySink() {
+            for (nodeid_t id=0; id<this->vertexPayload.size(); ++id) {
+                std::stable_sort(
+                    this->edges.begin() + this->outEdgesOfvertexBegin[id], 
+                    this->edges.begin() + this->outEdgesOfvertexBegin[id + 1], 
+                    [](const OutEdge<E>& a, const OutEdge<E>& b) { return a.getSinkId() < b.getSinkId(); }
+                );
+            }
+            this->outEdgesSortedBySink = true;
+            if (this->hasInEdgesIndex()) {
+                this->buildInEdgesIndex();
+            }
+        }
+
+        /**
+         * @brief check if the out edges of each vertex are sorted by sink
+         * 
+         * @return true if edge lookups take \f$O(\log outdegree)\f$
+         * @return false if edge lookups take \f$O(outdegree)\f$
+         */
+        bool isSortedBySink() const {
+            return this->outEdgesSortedBySink;
+        }
+
+        /**
+         * @brief check if the graph has the reverse index of the in edges
+         * 
+         * @return true if in edges queries take \f$O(indegree)\f$
+         * @return false if in edges queries need to scan the whole graph
+         */
+        bool hasInEdgesIndex() const {
+            return !this->inEdgesOfVertexBegin.empty();
+        }
+
+        /**
+         * @brief build the reverse compressed sparse row of the in edges
+         * 
+         * It is a counting sort over the sinks of the edges, hence it takes \f$O(V+E)\f$.
+         * In edges of the same vertex will be sorted by source id
+         * 
+         * @pre
+         *  @li the graph has been finalized;
+         */
+        void buildInEdgesIndex() {
+            const nodeid_t vertices = this->vertexPayload.size();
+
+            this->inEdgesOfVertexBegin.assign(vertices + 1, 0);
+            this->inEdgesSource.resize(this->edges.size());
+            this->inEdgesOutEdgeIndex.resize(this->edges.size());
+
+            //count the in degree of each vertex. Cell i+1 contains the in degree of i
+            for (auto i=0; i<this->edges.size(); ++i) {
+                this->inEdgesOfVertexBegin[this->edges[i].getSinkId() + 1] += 1;
+            }
+            //prefix sum
+            for (nodeid_t id=0; id<vertices; ++id) {
+                this->inEdgesOfVertexBegin[id + 1] += this->inEdgesOfVertexBegin[id];
+            }
+            //fill. Since we scan the sources in order, in edges are sorted by source
+            std::vector<int> nextFree{this->inEdgesOfVertexBegin.begin(), this->inEdgesOfVertexBegin.end() - 1};
+            for (nodeid_t sourceId=0; sourceId<vertices; ++sourceId) {
+                for (auto i=this->outEdgesOfvertexBegin[sourceId]; i<this->outEdgesOfvertexBegin[sourceId+1]; ++i) {
+                    int& position = nextFree[this->edges[i].getSinkId()];
+                    this->inEdgesSource[position] = sourceId;
+                    this->inEdgesOutEdgeIndex[position] = i;
+                    position += 1;
+                }
+            }
+        }
+
+        /**
+         * @brief remove the reverse index of the in edges, freeing its memory
+         * 
+         */
+        void clearInEdgesIndex() {
+            this->inEdgesOfVertexBegin = std::vector<int>{};
+            this->inEdgesSource = std::vector<nodeid_t>{};
+            this->inEdgesOutEdgeIndex = std::vector<int>{};
         }
 
         long addVertex(const V& vertex) {
@@ -547,6 +1500,48 @@ namespace cpp_utils::graphs {
             }
             throw cpp_utils::exceptions::ImpossibleException{};
         }
+        /**
+         * @brief check if the out edges of each vertex happen to be sorted by sink, whether or not ::sortOutEdgesBySink sorted them
+         * 
+         * @return true if edge lookups can perform a binary search
+         * @return false otherwise
+         */
+        bool areOutEdgesSortedBySink() const {
+            for (nodeid_t id=0; id<this->vertexPayload.size(); ++id) {
+                for (auto i=this->outEdgesOfvertexBegin[id] + 1; i<this->outEdgesOfvertexBegin[id + 1]; ++i) {
+                    if (this->edges[i].getSinkId() < this->edges[i - 1].getSinkId()) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+        /**
+         * @brief the index in ::edges of the first out edge from @c sourceId to @c sinkId
+         * 
+         * @param sourceId the source of the edge
+         * @param sinkId the sink of the edge
+         * @return int the index of the edge, -1 if there is no such edge
+         */
+        int findOutEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            const int begin = this->outEdgesOfvertexBegin[sourceId];
+            const int end = this->outEdgesOfvertexBegin[sourceId + 1];
+            if (this->outEdgesSortedBySink) {
+                auto it = std::lower_bound(this->edges.begin() + begin, this->edges.begin() + end, sinkId, [](const OutEdge<E>& outEdge, nodeid_t id) {
+                    return outEdge.getSinkId() < id;
+                });
+                if (it != (this->edges.begin() + end) && it->getSinkId() == sinkId) {
+                    return static_cast<int>(it - this->edges.begin());
+                }
+                return -1;
+            }
+            for (int i=begin; i<end; ++i) {
+                if (this->edges[i].getSinkId() == sinkId) {
+                    return i;
+                }
+            }
+            return -1;
+        }
         void init(const IImmutableGraph<G,V,E>& other) {
             //nodes
             debug("adding vertices");
@@ -555,11 +1550,9 @@ namespace cpp_utils::graphs {
             }
 
             debug("handling edges...");
-            for (auto it=other.beginEdges(); it!=other.endEdges(); ++it) {
-                debug("hello");
-                debug("edge to add is ", *it);
-                this->addEdgeTail(it->getSourceId(), it->getSinkId(), it->getPayload());
-            }
+            other.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                this->addEdgeTail(sourceId, sinkId, payload);
+            });
             this->finalizeGraph();
             debug("outside copy edges!");
 
@@ -573,10 +1566,9 @@ namespace cpp_utils::graphs {
                 
             }
 
-            for (auto it=other.beginEdges(); it!=other.endEdges(); ++it) {
-                debug("edge to add is ", *it);
-                this->addEdgeTail(it->getSourceId(), it->getSinkId(), it->getPayload());
-            }
+            other.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                this->addEdgeTail(sourceId, sinkId, payload);
+            });
             this->finalizeGraph();
 
             debug("this->outEdgesOfvertexBegin ", this->outEdgesOfvertexBegin);
@@ -144,7 +144,7 @@
  * 
  */
 #define assertInRange(lb, x, ub, lb_included, ub_included) \
-    if ((!ub_included) && ((x) == (lb))) { \
+    if ((!lb_included) && ((x) == (lb))) { \
         assertionFailed(TO_STRING(x), "==", TO_STRING(lb), "but ", TO_STRING(lb), "is not in range!"); \
     } \
     if ((!ub_included) && ((x) == (ub))) { \
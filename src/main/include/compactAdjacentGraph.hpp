@@ -0,0 +1,510 @@
+#ifndef _CPP_UTILS_COMPACTADJACENTGRAPH_HEADER__
+#define _CPP_UTILS_COMPACTADJACENTGRAPH_HEADER__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "igraph.hpp"
+#include "iterator.hpp"
+#include "span.hpp"
+
+namespace cpp_utils::graphs {
+
+    template <typename G, typename V, typename E>
+    class CompactAdjacentGraph;
+
+    /**
+     * @brief iterator over all the edges of a CompactAdjacentGraph
+     *
+     * It scans the out edges arrays linearly
+     */
+    template <typename G, typename V, typename E>
+    class CompactAdjacentGraphEdgesIterator: public ::cpp_utils::AbstractConstIterator<Edge<E>&, Edge<E>*> {
+        typedef CompactAdjacentGraphEdgesIterator<G, V, E> This;
+    private:
+        const CompactAdjacentGraph<G, V, E>& graph;
+        /**
+         * @brief source of the edge the iterator is pointing to
+         *
+         */
+        nodeid_t vertex;
+        /**
+         * @brief index of the edge the iterator is pointing to. If it is equal to the number of edges, the iterator has ended
+         *
+         */
+        uint32_t edge;
+        mutable Edge<E> tmp;
+    public:
+        CompactAdjacentGraphEdgesIterator(nodeid_t vertex, uint32_t edge, const CompactAdjacentGraph<G, V, E>& graph): graph{graph}, vertex{vertex}, edge{edge}, tmp{} {
+            this->skipVerticesWithoutEdges();
+        }
+        virtual ~CompactAdjacentGraphEdgesIterator() {
+
+        }
+    public:
+        This& operator++() {
+            if (!this->isEnded()) {
+                this->edge += 1;
+                this->skipVerticesWithoutEdges();
+            }
+            return *this;
+        }
+        cpp_utils::graphs::Edge<E>& operator*() const {
+            this->tmp = Edge<E>{this->vertex, this->graph.edgeSinks[this->edge], this->graph.edgePayloads[this->edge]};
+            return this->tmp;
+        }
+        cpp_utils::graphs::Edge<E>* operator->() const {
+            return &(this->operator*());
+        }
+        bool isEnded() const {
+            return this->edge >= this->graph.numberOfEdges();
+        }
+        bool isEqualTo(const AbstractConstIterator<Edge<E>&, Edge<E>*>* o) const {
+            auto b = static_cast<const This*>(o);
+            if (this->isEnded() || b->isEnded()) {
+                return this->isEnded() == b->isEnded();
+            }
+            return this->edge == b->edge;
+        }
+    private:
+        /**
+         * @brief make sure ::vertex is the source of ::edge
+         *
+         */
+        void skipVerticesWithoutEdges() {
+            if (this->isEnded()) {
+                return;
+            }
+            while (this->graph.outEdgesOfVertexBegin[this->vertex + 1] <= this->edge) {
+                this->vertex += 1;
+            }
+        }
+    };
+
+    /**
+     * @brief an AdjacentGraph whose out edges are stored as a struct of arrays
+     *
+     * AdjacentGraph stores a vector of OutEdge: since OutEdge has a virtual destructor, each edge carries a vtable pointer
+     * beside its sink and its payload (e.g., 24 bytes for an `int` payload). Here the sinks (as 32 bit ids) and the payloads
+     * are kept in 2 separate arrays, without any per edge overhead: an edge with an `int` payload takes 8 bytes and a scan
+     * reading only the successors of a vertex (see cpp_utils::graphs::forEachSuccessor) touches 4 bytes per edge.
+     *
+     * The graph can hold at most \f$2^{32}-1\f$ vertices and \f$2^{32}-1\f$ edges. Like AdjacentGraph, the graph cannot be
+     * extended, but the payloads of vertices and edges can be changed.
+     *
+     * @code
+     * CompactAdjacentGraph<G, V, E> compact{adjacentGraph};
+     * forEachSuccessor(compact, id, [&](nodeid_t sinkId) {
+     *  ...
+     * });
+     * @endcode
+     *
+     * @tparam G custom payload of the whole graph
+     * @tparam V custom payload of each vertex
+     * @tparam E custom payload of each edge
+     */
+    template <typename G, typename V, typename E>
+    class CompactAdjacentGraph: public INonExtendableGraph<G, V, E> {
+    public:
+        using This = CompactAdjacentGraph<G, V, E>;
+        using Super = INonExtendableGraph<G, V, E>;
+        using const_vertex_iterator = PairNumberContainerBasedConstIterator<std::vector<V>, nodeid_t, V>;
+        using Super::changeVertexPayload;
+        friend class CompactAdjacentGraphEdgesIterator<G, V, E>;
+    private:
+        /**
+         * @brief the value attached to the whole graph. Owned by the graph itself
+         *
+         */
+        G payload;
+        std::vector<V> vertexPayload;
+        /**
+         * @brief as long as the number of vertices plus 1. Index where in ::edgeSinks the out edges of each vertex start
+         *
+         */
+        std::vector<uint32_t> outEdgesOfVertexBegin;
+        std::vector<uint32_t> edgeSinks;
+        /**
+         * @brief the payload of the edge whose sink is in the same cell of ::edgeSinks
+         *
+         */
+        std::vector<E> edgePayloads;
+        /**
+         * @brief as long as the number of vertices plus 1. Index where in ::inEdgesSource the in edges of each vertex start
+         *
+         * empty if the graph has no reverse index of the in edges
+         */
+        std::vector<uint32_t> inEdgesOfVertexBegin;
+        std::vector<uint32_t> inEdgesSource;
+        /**
+         * @brief index in ::edgePayloads of each in edge
+         *
+         */
+        std::vector<uint32_t> inEdgesOutEdgeIndex;
+        /**
+         * @brief true if the out edges of each vertex are sorted by sink. If so, edge lookups perform a binary search
+         *
+         */
+        bool outEdgesSortedBySink;
+    public:
+        CompactAdjacentGraph(): payload{}, vertexPayload{}, outEdgesOfVertexBegin{0}, edgeSinks{}, edgePayloads{},
+            inEdgesOfVertexBegin{}, inEdgesSource{}, inEdgesOutEdgeIndex{}, outEdgesSortedBySink{false} {
+
+        }
+        /**
+         * @brief copy any graph
+         *
+         * The out edges of each vertex keep the order they have in @c other. If they are sorted by sink, the graph
+         * detects it and edge lookups will perform a binary search.
+         *
+         * @param other the graph to copy. Its vertex ids need to be contiguous
+         * @param withInEdgesIndex if true we will build the reverse index of the in edges as well
+         * @throw cpp_utils::exceptions::InvalidArgumentException if @c other has too many vertices or edges
+         */
+        explicit CompactAdjacentGraph(const IImmutableGraph<G, V, E>& other, bool withInEdgesIndex = true): payload{other.getPayload()},
+            vertexPayload{}, outEdgesOfVertexBegin{}, edgeSinks{}, edgePayloads{},
+            inEdgesOfVertexBegin{}, inEdgesSource{}, inEdgesOutEdgeIndex{}, outEdgesSortedBySink{false} {
+
+            const size_t vertices = other.numberOfVertices();
+            const size_t edges = other.numberOfEdges();
+            if (vertices >= std::numeric_limits<uint32_t>::max() || edges >= std::numeric_limits<uint32_t>::max()) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"the graph can contain at most", std::numeric_limits<uint32_t>::max() - 1, "vertices and edges, but we have", vertices, "vertices and", edges, "edges"};
+            }
+
+            this->vertexPayload.reserve(vertices);
+            this->outEdgesOfVertexBegin.reserve(vertices + 1);
+            this->outEdgesOfVertexBegin.push_back(0);
+            for (nodeid_t id=0; id<vertices; ++id) {
+                this->vertexPayload.push_back(other.getVertex(id));
+                this->outEdgesOfVertexBegin.push_back(this->outEdgesOfVertexBegin.back() + static_cast<uint32_t>(other.getOutDegree(id)));
+            }
+
+            //other may yield the edges in any order: each source has its own cursor
+            this->edgeSinks.resize(edges);
+            this->edgePayloads.resize(edges);
+            std::vector<uint32_t> cursor{this->outEdgesOfVertexBegin.begin(), this->outEdgesOfVertexBegin.end() - 1};
+            other.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                auto i = cursor[sourceId]++;
+                this->edgeSinks[i] = static_cast<uint32_t>(sinkId);
+                this->edgePayloads[i] = payload;
+            });
+
+            this->outEdgesSortedBySink = true;
+            for (nodeid_t id=0; id<vertices && this->outEdgesSortedBySink; ++id) {
+                auto sinks = this->outEdgeSinks(id);
+                this->outEdgesSortedBySink = std::is_sorted(sinks.begin(), sinks.end());
+            }
+            if (withInEdgesIndex) {
+                this->buildInEdgesIndex();
+            }
+        }
+        CompactAdjacentGraph(const This& other) = default;
+        CompactAdjacentGraph(This&& other) = default;
+        This& operator =(const This& other) = default;
+        This& operator =(This&& other) = default;
+        virtual ~CompactAdjacentGraph() {
+
+        }
+    public:
+        /**
+         * @brief the sinks of the out edges of a vertex
+         *
+         * @param id the vertex involved
+         * @return ConstSpan<uint32_t> the sinks, in the same order of IImmutableGraph::getOutEdge
+         */
+        ConstSpan<uint32_t> outEdgeSinks(nodeid_t id) const {
+            return ConstSpan<uint32_t>{this->edgeSinks.data() + this->outEdgesOfVertexBegin[id], this->edgeSinks.data() + this->outEdgesOfVertexBegin[id + 1]};
+        }
+        /**
+         * @brief the payloads of the out edges of a vertex
+         *
+         * @param id the vertex involved
+         * @return ConstSpan<E> the payloads, in the same order of ::outEdgeSinks
+         */
+        ConstSpan<E> outEdgePayloads(nodeid_t id) const {
+            return ConstSpan<E>{this->edgePayloads.data() + this->outEdgesOfVertexBegin[id], this->edgePayloads.data() + this->outEdgesOfVertexBegin[id + 1]};
+        }
+        /**
+         * @brief check if the graph has the reverse index of the in edges
+         *
+         * @return true if in edges queries take \f$O(indegree)\f$
+         * @return false otherwise
+         */
+        bool hasInEdgesIndex() const {
+            return !this->inEdgesOfVertexBegin.empty();
+        }
+        /**
+         * @brief build the reverse index of the in edges
+         *
+         * A counting sort over the sinks: it takes \f$O(V+E)\f$
+         */
+        void buildInEdgesIndex() {
+            const size_t vertices = this->vertexPayload.size();
+            this->inEdgesOfVertexBegin.assign(vertices + 1, 0);
+            for (auto sinkId : this->edgeSinks) {
+                this->inEdgesOfVertexBegin[sinkId + 1] += 1;
+            }
+            for (size_t id=0; id<vertices; ++id) {
+                this->inEdgesOfVertexBegin[id + 1] += this->inEdgesOfVertexBegin[id];
+            }
+            this->inEdgesSource.resize(this->edgeSinks.size());
+            this->inEdgesOutEdgeIndex.resize(this->edgeSinks.size());
+            std::vector<uint32_t> cursor{this->inEdgesOfVertexBegin.begin(), this->inEdgesOfVertexBegin.end() - 1};
+            for (uint32_t sourceId=0; sourceId<vertices; ++sourceId) {
+                for (auto i=this->outEdgesOfVertexBegin[sourceId]; i<this->outEdgesOfVertexBegin[sourceId + 1]; ++i) {
+                    auto j = cursor[this->edgeSinks[i]]++;
+                    this->inEdgesSource[j] = sourceId;
+                    this->inEdgesOutEdgeIndex[j] = i;
+                }
+            }
+        }
+        /**
+         * @brief remove the reverse index of the in edges, freeing its memory
+         *
+         */
+        void clearInEdgesIndex() {
+            std::vector<uint32_t>{}.swap(this->inEdgesOfVertexBegin);
+            std::vector<uint32_t>{}.swap(this->inEdgesSource);
+            std::vector<uint32_t>{}.swap(this->inEdgesOutEdgeIndex);
+        }
+        /**
+         * @brief sort the out edges of each vertex by sink id
+         *
+         * Afterwards edge lookups perform a binary search over ::edgeSinks. Parallel edges keep their relative order.
+         * If present, the reverse index of the in edges is rebuilt.
+         *
+         * @note
+         * the moveid_t of the out edges change!
+         */
+        void sortOutEdgesBySink() {
+            std::vector<uint32_t> order{};
+            std::vector<uint32_t> sinks{};
+            std::vector<E> payloads{};
+            for (nodeid_t id=0; id<this->vertexPayload.size(); ++id) {
+                const uint32_t begin = this->outEdgesOfVertexBegin[id];
+                const uint32_t end = this->outEdgesOfVertexBegin[id + 1];
+                order.resize(end - begin);
+                std::iota(order.begin(), order.end(), begin);
+                std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return this->edgeSinks[a] < this->edgeSinks[b]; });
+                sinks.clear();
+                payloads.clear();
+                for (auto i : order) {
+                    sinks.push_back(this->edgeSinks[i]);
+                    payloads.push_back(this->edgePayloads[i]);
+                }
+                std::copy(sinks.begin(), sinks.end(), this->edgeSinks.begin() + begin);
+                std::copy(payloads.begin(), payloads.end(), this->edgePayloads.begin() + begin);
+            }
+            this->outEdgesSortedBySink = true;
+            if (this->hasInEdgesIndex()) {
+                this->buildInEdgesIndex();
+            }
+        }
+        /**
+         * @brief check if the out edges of each vertex are sorted by sink
+         *
+         * @return true if edge lookups take \f$O(\log outdegree)\f$
+         * @return false if edge lookups take \f$O(outdegree)\f$
+         */
+        bool isSortedBySink() const {
+            return this->outEdgesSortedBySink;
+        }
+    private:
+        /**
+         * @brief the index in ::edgeSinks of the first out edge from @c sourceId to @c sinkId
+         *
+         * @return size_t the index of the edge, the number of edges if there is no such edge
+         */
+        size_t findOutEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            const uint32_t begin = this->outEdgesOfVertexBegin[sourceId];
+            const uint32_t end = this->outEdgesOfVertexBegin[sourceId + 1];
+            if (this->outEdgesSortedBySink) {
+                auto first = this->edgeSinks.begin() + begin;
+                auto last = this->edgeSinks.begin() + end;
+                auto it = std::lower_bound(first, last, sinkId, [](uint32_t a, nodeid_t b) { return a < b; });
+                if (it != last && *it == sinkId) {
+                    return static_cast<size_t>(it - this->edgeSinks.begin());
+                }
+                return this->edgeSinks.size();
+            }
+            for (auto i=begin; i<end; ++i) {
+                if (this->edgeSinks[i] == sinkId) {
+                    return i;
+                }
+            }
+            return this->edgeSinks.size();
+        }
+    public:
+        virtual size_t size() const {
+            return this->vertexPayload.size();
+        }
+        virtual size_t numberOfVertices() const {
+            return this->vertexPayload.size();
+        }
+        virtual size_t numberOfEdges() const {
+            return this->edgeSinks.size();
+        }
+        virtual typename Super::const_vertex_iterator beginVertices() const {
+            auto it = new const_vertex_iterator{0, this->vertexPayload};
+            return typename Super::const_vertex_iterator{it};
+        }
+        virtual typename Super::const_vertex_iterator endVertices() const {
+            auto it = new const_vertex_iterator{-1, this->vertexPayload};
+            return typename Super::const_vertex_iterator{it};
+        }
+        virtual typename Super::const_edge_iterator beginEdges() const {
+            auto it = new CompactAdjacentGraphEdgesIterator<G, V, E>{0, 0, *this};
+            return typename Super::const_edge_iterator{it};
+        }
+        virtual typename Super::const_edge_iterator endEdges() const {
+            auto it = new CompactAdjacentGraphEdgesIterator<G, V, E>{0, static_cast<uint32_t>(this->edgeSinks.size()), *this};
+            return typename Super::const_edge_iterator{it};
+        }
+        virtual void forEachEdge(const std::function<void(nodeid_t, nodeid_t, const E&)>& lambda) const {
+            cpp_utils::graphs::forEachEdge(*this, lambda);
+        }
+        virtual const V& getVertex(nodeid_t id) const {
+            return this->vertexPayload[id];
+        }
+        virtual bool containsVertex(nodeid_t id) const {
+            return id < this->vertexPayload.size();
+        }
+        virtual const E& getEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            auto i = this->findOutEdge(sourceId, sinkId);
+            if (i < this->edgeSinks.size()) {
+                return this->edgePayloads[i];
+            }
+            throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, This>{sinkId, *this};
+        }
+        virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId, const E& payload) const {
+            for (auto i=this->findOutEdge(sourceId, sinkId); i<this->outEdgesOfVertexBegin[sourceId + 1]; ++i) {
+                if (this->edgeSinks[i] == sinkId && this->edgePayloads[i] == payload) {
+                    return true;
+                }
+                if (this->outEdgesSortedBySink && this->edgeSinks[i] != sinkId) {
+                    //parallel edges are contiguous
+                    break;
+                }
+            }
+            return false;
+        }
+        virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            return this->hasEdge(sourceId, sinkId);
+        }
+        virtual const G& getPayload() const {
+            return this->payload;
+        }
+        virtual G& getPayload() {
+            return this->payload;
+        }
+        virtual size_t getInDegree(nodeid_t id) const {
+            if (this->hasInEdgesIndex()) {
+                return this->inEdgesOfVertexBegin[id + 1] - this->inEdgesOfVertexBegin[id];
+            }
+            //like the index, each parallel edge counts (see IImmutableGraph::getInDegree)
+            return static_cast<size_t>(std::count(this->edgeSinks.begin(), this->edgeSinks.end(), static_cast<uint32_t>(id)));
+        }
+        virtual size_t getOutDegree(nodeid_t id) const {
+            return this->outEdgesOfVertexBegin[id + 1] - this->outEdgesOfVertexBegin[id];
+        }
+        virtual size_t getDegree(nodeid_t id) const {
+            return this->getOutDegree(id) + this->getInDegree(id);
+        }
+        virtual bool hasSuccessors(nodeid_t id) const {
+            return this->getOutDegree(id) > 0;
+        }
+        virtual bool hasPredecessors(nodeid_t id) const {
+            if (this->hasInEdgesIndex()) {
+                for (auto i=this->inEdgesOfVertexBegin[id]; i<this->inEdgesOfVertexBegin[id + 1]; ++i) {
+                    if (this->inEdgesSource[i] != id) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            for (nodeid_t sourceId=0; sourceId<this->numberOfVertices(); ++sourceId) {
+                if (sourceId != id && this->hasEdge(sourceId, id)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        virtual OutEdge<E> getOutEdge(nodeid_t id, moveid_t index) const {
+            auto i = this->outEdgesOfVertexBegin[id] + index;
+            return OutEdge<E>{this->edgeSinks[i], this->edgePayloads[i]};
+        }
+        virtual bool hasEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            return this->findOutEdge(sourceId, sinkId) < this->edgeSinks.size();
+        }
+        virtual std::vector<InEdge<E>> getInEdges(nodeid_t id) const {
+            std::vector<InEdge<E>> result{};
+            if (this->hasInEdgesIndex()) {
+                for (auto i=this->inEdgesOfVertexBegin[id]; i<this->inEdgesOfVertexBegin[id + 1]; ++i) {
+                    if (this->inEdgesSource[i] != id) {
+                        result.push_back(InEdge<E>{this->inEdgesSource[i], this->edgePayloads[this->inEdgesOutEdgeIndex[i]]});
+                    }
+                }
+                return result;
+            }
+            for (nodeid_t sourceId=0; sourceId<this->numberOfVertices(); ++sourceId) {
+                if (sourceId == id) {
+                    continue;
+                }
+                for (auto i=this->outEdgesOfVertexBegin[sourceId]; i<this->outEdgesOfVertexBegin[sourceId + 1]; ++i) {
+                    if (this->edgeSinks[i] == id) {
+                        result.push_back(InEdge<E>{sourceId, this->edgePayloads[i]});
+                    }
+                }
+            }
+            return result;
+        }
+        virtual std::vector<OutEdge<E>> getOutEdges(nodeid_t id) const {
+            std::vector<OutEdge<E>> result{};
+            result.reserve(this->getOutDegree(id));
+            for (auto i=this->outEdgesOfVertexBegin[id]; i<this->outEdgesOfVertexBegin[id + 1]; ++i) {
+                result.push_back(OutEdge<E>{this->edgeSinks[i], this->edgePayloads[i]});
+            }
+            return result;
+        }
+        virtual bool isEmpty() const {
+            return this->vertexPayload.empty();
+        }
+    public:
+        virtual void changeVertexPayload(nodeid_t vertexId, const V& payload) {
+            this->vertexPayload[vertexId] = payload;
+        }
+        virtual void changeWeightEdge(nodeid_t sourceId, nodeid_t sinkId, const E& newPayload) {
+            auto i = this->findOutEdge(sourceId, sinkId);
+            if (i < this->edgeSinks.size()) {
+                this->edgePayloads[i] = newPayload;
+                return;
+            }
+            throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, This>{sinkId, *this};
+        }
+        virtual void changeWeightOutEdge(nodeid_t sourceId, moveid_t index, const E& newPayload) {
+            this->edgePayloads[this->outEdgesOfVertexBegin[sourceId] + index] = newPayload;
+        }
+    protected:
+        virtual nodeid_t getLastVertexId() const {
+            return this->vertexPayload.size() - 1;
+        }
+    public:
+        virtual MemoryConsumption getByteMemoryOccupied() const {
+            size_t result = sizeof(*this);
+            result += sizeof(V) * this->vertexPayload.capacity();
+            result += sizeof(uint32_t) * this->outEdgesOfVertexBegin.capacity();
+            result += sizeof(uint32_t) * this->edgeSinks.capacity();
+            result += sizeof(E) * this->edgePayloads.capacity();
+            result += sizeof(uint32_t) * this->inEdgesOfVertexBegin.capacity();
+            result += sizeof(uint32_t) * this->inEdgesSource.capacity();
+            result += sizeof(uint32_t) * this->inEdgesOutEdgeIndex.capacity();
+            return MemoryConsumption{result, MemoryConsumptionEnum::BYTE};
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,350 @@
+#ifndef _CPP_UTILS_COMPONENTS_HEADER__
+#define _CPP_UTILS_COMPONENTS_HEADER__
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "igraph.hpp"
+#include "exceptions.hpp"
+#include "parallel.hpp"
+
+namespace cpp_utils::graphs {
+
+    namespace internal {
+
+        /**
+         * @brief the position reached while scanning the successors of a vertex, which can be resumed later
+         *
+         * Used by the iterative visits, which interleave the scans of several vertices. The generic version
+         * goes through IImmutableGraph::getOutEdge.
+         */
+        template <typename GRAPH, typename = void>
+        class SuccessorCursor {
+        private:
+            nodeid_t id;
+            size_t next;
+            size_t outDegree;
+        public:
+            SuccessorCursor(const GRAPH& graph, nodeid_t id): id{id}, next{0}, outDegree{graph.getOutDegree(id)} {
+
+            }
+            nodeid_t getId() const {
+                return this->id;
+            }
+            bool hasNext() const {
+                return this->next < this->outDegree;
+            }
+            nodeid_t nextSuccessor(const GRAPH& graph) {
+                return graph.getOutEdge(this->id, static_cast<moveid_t>(this->next++)).getSinkId();
+            }
+        };
+
+        /**
+         * @brief a SuccessorCursor over a graph with `outEdgeRange` (see cpp_utils::graphs::has_out_edge_range)
+         *
+         */
+        template <typename GRAPH>
+        class SuccessorCursor<GRAPH, std::enable_if_t<has_out_edge_range<GRAPH>::value>> {
+            using iterator = decltype(std::declval<const GRAPH&>().outEdgeRange(std::declval<nodeid_t>()).begin());
+        private:
+            nodeid_t id;
+            iterator current;
+            iterator end;
+        public:
+            SuccessorCursor(const GRAPH& graph, nodeid_t id): id{id}, current{graph.outEdgeRange(id).begin()}, end{graph.outEdgeRange(id).end()} {
+
+            }
+            nodeid_t getId() const {
+                return this->id;
+            }
+            bool hasNext() const {
+                return this->current != this->end;
+            }
+            nodeid_t nextSuccessor(const GRAPH& graph) {
+                nodeid_t result = (*this->current).getSinkId();
+                ++this->current;
+                return result;
+            }
+        };
+
+        /**
+         * @brief a SuccessorCursor over a graph with `outEdgeSinks` (see cpp_utils::graphs::has_out_edge_arrays)
+         *
+         */
+        template <typename GRAPH>
+        class SuccessorCursor<GRAPH, std::enable_if_t<!has_out_edge_range<GRAPH>::value && has_out_edge_arrays<GRAPH>::value>> {
+            using sinks_t = decltype(std::declval<const GRAPH&>().outEdgeSinks(std::declval<nodeid_t>()));
+        private:
+            nodeid_t id;
+            size_t next;
+            sinks_t sinks;
+        public:
+            SuccessorCursor(const GRAPH& graph, nodeid_t id): id{id}, next{0}, sinks{graph.outEdgeSinks(id)} {
+
+            }
+            nodeid_t getId() const {
+                return this->id;
+            }
+            bool hasNext() const {
+                return this->next < this->sinks.size();
+            }
+            nodeid_t nextSuccessor(const GRAPH& graph) {
+                return static_cast<nodeid_t>(this->sinks[this->next++]);
+            }
+        };
+
+        /**
+         * @brief throw if the vertices of a graph cannot be labelled with a uint32_t
+         *
+         */
+        inline void checkComponentLabelsFit(size_t vertices) {
+            if (vertices >= std::numeric_limits<uint32_t>::max()) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"graph has", vertices, "vertices, but component labels are 32 bit"};
+            }
+        }
+
+    }
+
+    /**
+     * @brief the strongly connected components of a graph, computed via Tarjan's algorithm
+     *
+     * The visit is iterative, so it does not overflow the stack however long the paths of the graph are. It takes
+     * \f$O(V+E)\f$ time and 3 integers per vertex.
+     *
+     * Components are labelled in the order Tarjan's algorithm completes them, which is a reverse topological order of the
+     * condensation of the graph: if there is an edge from a vertex labelled @c a to a vertex labelled @c b, then
+     * \f$a \geq b\f$. Hence, if `labels[s] < labels[t]`, @c t is not reachable from @c s.
+     *
+     * @code
+     * auto labels = getStronglyConnectedComponents(graph);
+     * if (labels[start] < labels[goal]) {
+     *  //no path, no need to search
+     * }
+     * @endcode
+     *
+     * @tparam GRAPH type of the graph (pass the concrete one, see cpp_utils::graphs::forEachOutEdge)
+     * @param graph the graph to consider
+     * @return std::vector<uint32_t> for each vertex, the label of its component. Labels go from 0 to the number of components (excluded)
+     */
+    template <typename GRAPH>
+    std::vector<uint32_t> getStronglyConnectedComponents(const GRAPH& graph) {
+        using Cursor = internal::SuccessorCursor<GRAPH>;
+        constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+        const size_t vertices = graph.numberOfVertices();
+        internal::checkComponentLabelsFit(vertices);
+
+        //a vertex is on the stack of Tarjan iff it has an index but no label yet
+        std::vector<uint32_t> labels(vertices, NONE);
+        std::vector<uint32_t> index(vertices, NONE);
+        std::vector<uint32_t> lowLink(vertices, NONE);
+        std::vector<nodeid_t> stack{};
+        std::vector<Cursor> visit{};
+        uint32_t nextIndex = 0;
+        uint32_t nextLabel = 0;
+
+        auto open = [&](nodeid_t id) {
+            index[id] = nextIndex;
+            lowLink[id] = nextIndex;
+            nextIndex += 1;
+            stack.push_back(id);
+            visit.emplace_back(graph, id);
+        };
+
+        for (nodeid_t root=0; root<vertices; ++root) {
+            if (index[root] != NONE) {
+                continue;
+            }
+            open(root);
+            while (!visit.empty()) {
+                Cursor& cursor = visit.back();
+                const nodeid_t id = cursor.getId();
+                if (cursor.hasNext()) {
+                    const nodeid_t successor = cursor.nextSuccessor(graph);
+                    if (index[successor] == NONE) {
+                        //cursor is invalidated here
+                        open(successor);
+                    } else if (labels[successor] == NONE) {
+                        lowLink[id] = std::min(lowLink[id], index[successor]);
+                    }
+                    continue;
+                }
+
+                visit.pop_back();
+                if (lowLink[id] == index[id]) {
+                    nodeid_t member;
+                    do {
+                        member = stack.back();
+                        stack.pop_back();
+                        labels[member] = nextLabel;
+                    } while (member != id);
+                    nextLabel += 1;
+                }
+                if (!visit.empty()) {
+                    const nodeid_t parent = visit.back().getId();
+                    lowLink[parent] = std::min(lowLink[parent], lowLink[id]);
+                }
+            }
+        }
+        return labels;
+    }
+
+    /**
+     * @brief the weakly connected components of a graph (namely, the components of the graph where edges have no direction)
+     *
+     * We use a lock-free union find: each thread links the endpoints of the out edges of a block of vertices, by hooking the
+     * root with the greater id under the one with the smaller id via compare and swap. Finds halve the paths they walk on.
+     * Since edges are handled from their source only, the graph does not need the in edges.
+     *
+     * Components are labelled by their smallest vertex: the component containing vertex 0 has label 0, the component containing
+     * the smallest vertex not in component 0 has label 1, and so on. Hence, the labels do not depend on the number of threads.
+     *
+     * @tparam GRAPH type of the graph (pass the concrete one, see cpp_utils::graphs::forEachOutEdge)
+     * @param graph the graph to consider
+     * @param threads number of threads to use. If 0, we use cpp_utils::getDefaultNumberOfThreads
+     * @return std::vector<uint32_t> for each vertex, the label of its component. Labels go from 0 to the number of components (excluded)
+     */
+    template <typename GRAPH>
+    std::vector<uint32_t> getWeaklyConnectedComponents(const GRAPH& graph, size_t threads = 0) {
+        const size_t vertices = graph.numberOfVertices();
+        internal::checkComponentLabelsFit(vertices);
+
+        std::unique_ptr<std::atomic<uint32_t>[]> parent{new std::atomic<uint32_t>[vertices]};
+        parallelForBlocks(0, vertices, threads, [&](size_t threadId, size_t begin, size_t end) {
+            for (size_t id=begin; id<end; ++id) {
+                parent[id].store(static_cast<uint32_t>(id), std::memory_order_relaxed);
+            }
+        });
+
+        auto find = [&](uint32_t id) {
+            while (true) {
+                uint32_t p = parent[id].load(std::memory_order_acquire);
+                uint32_t grandParent = parent[p].load(std::memory_order_acquire);
+                if (p == grandParent) {
+                    return p;
+                }
+                //path halving: if someone else has changed the parent meanwhile, it is still an ancestor
+                parent[id].compare_exchange_weak(p, grandParent, std::memory_order_acq_rel);
+                id = grandParent;
+            }
+        };
+        auto link = [&](uint32_t a, uint32_t b) {
+            while (true) {
+                uint32_t rootA = find(a);
+                uint32_t rootB = find(b);
+                if (rootA == rootB) {
+                    return;
+                }
+                if (rootA < rootB) {
+                    std::swap(rootA, rootB);
+                }
+                //hook the greater root under the smaller one, unless it is no longer a root
+                if (parent[rootA].compare_exchange_strong(rootA, rootB, std::memory_order_acq_rel)) {
+                    return;
+                }
+            }
+        };
+
+        parallelForBlocks(0, vertices, threads, [&](size_t threadId, size_t begin, size_t end) {
+            for (size_t id=begin; id<end; ++id) {
+                forEachSuccessor(graph, id, [&](nodeid_t sinkId) {
+                    link(static_cast<uint32_t>(id), static_cast<uint32_t>(sinkId));
+                });
+            }
+        });
+
+        //each root is the smallest vertex of its component: it is met before any other vertex of the component
+        std::vector<uint32_t> labels(vertices);
+        uint32_t nextLabel = 0;
+        for (size_t id=0; id<vertices; ++id) {
+            const uint32_t root = find(static_cast<uint32_t>(id));
+            labels[id] = (root == id) ? nextLabel++ : labels[root];
+        }
+        return labels;
+    }
+
+    /**
+     * @brief the components of a graph, as computed by getStronglyConnectedComponents or getWeaklyConnectedComponents
+     *
+     * Search engines can call ::sameComponent before running a query: with the weak components, vertices in different
+     * components are not connected at all; with the strong components, see ::mayReach.
+     *
+     * @code
+     * ComponentLabels components{getWeaklyConnectedComponents(graph)};
+     * if (!components.sameComponent(start, goal)) {
+     *  //no path, no need to search
+     * }
+     * @endcode
+     */
+    class ComponentLabels {
+    private:
+        std::vector<uint32_t> labels;
+        uint32_t components;
+    public:
+        /**
+         * @brief wrap some labels
+         *
+         * @param labels for each vertex, the label of its component. Labels are dense: they go from 0 to the number of components (excluded)
+         */
+        explicit ComponentLabels(std::vector<uint32_t>&& labels): labels{std::move(labels)}, components{0} {
+            for (auto label : this->labels) {
+                this->components = std::max(this->components, label + 1);
+            }
+        }
+        ComponentLabels(const ComponentLabels& o) = default;
+        ComponentLabels(ComponentLabels&& o) = default;
+        ComponentLabels& operator=(const ComponentLabels& o) = default;
+        ComponentLabels& operator=(ComponentLabels&& o) = default;
+        virtual ~ComponentLabels() {
+
+        }
+    public:
+        uint32_t numberOfComponents() const {
+            return this->components;
+        }
+        uint32_t getLabel(nodeid_t id) const {
+            return this->labels[id];
+        }
+        const std::vector<uint32_t>& getLabels() const {
+            return this->labels;
+        }
+        /**
+         * @brief check if 2 vertices belong to the same component
+         *
+         * @param a the first vertex
+         * @param b the second vertex
+         * @return true if @c a and @c b are in the same component
+         * @return false otherwise
+         */
+        bool sameComponent(nodeid_t a, nodeid_t b) const {
+            return this->labels[a] == this->labels[b];
+        }
+        /**
+         * @brief a necessary condition for @c b to be reachable from @c a, valid only for the labels of getStronglyConnectedComponents
+         *
+         * @return false if @c b is certainly not reachable from @c a
+         * @return true if @c b may be reachable from @c a
+         */
+        bool mayReach(nodeid_t a, nodeid_t b) const {
+            return this->labels[a] >= this->labels[b];
+        }
+        /**
+         * @brief the number of vertices in each component
+         *
+         * @return std::vector<size_t> the cell @c i is the number of vertices labelled @c i
+         */
+        std::vector<size_t> getComponentSizes() const {
+            std::vector<size_t> result(this->components, 0);
+            for (auto label : this->labels) {
+                result[label] += 1;
+            }
+            return result;
+        }
+    };
+
+}
+
+#endif
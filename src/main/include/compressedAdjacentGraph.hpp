@@ -0,0 +1,510 @@
+#ifndef _CPP_UTILS_COMPRESSEDADJACENTGRAPH_HEADER__
+#define _CPP_UTILS_COMPRESSEDADJACENTGRAPH_HEADER__
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "igraph.hpp"
+#include "iterator.hpp"
+#include "varint.hpp"
+
+namespace cpp_utils::graphs {
+
+    template <typename G, typename V, typename E>
+    class CompressedAdjacentGraph;
+
+    /**
+     * @brief iterator over the out edges of a vertex of a CompressedAdjacentGraph
+     *
+     * The sinks are decoded one at a time, while the iterator advances. Dereferencing yields an OutEdge by value.
+     *
+     * @tparam E payload of each edge
+     */
+    template <typename E>
+    class CompressedOutEdgeIterator {
+        typedef CompressedOutEdgeIterator<E> This;
+    private:
+        /**
+         * @brief the first byte of the sink of the next out edge
+         *
+         */
+        const uint8_t* position;
+        /**
+         * @brief payload of the out edge the iterator is pointing to
+         *
+         */
+        const E* payload;
+        /**
+         * @brief payload after the one of the last out edge
+         *
+         */
+        const E* lastPayload;
+        /**
+         * @brief sink of the out edge the iterator is pointing to
+         *
+         */
+        nodeid_t sinkId;
+    public:
+        /**
+         * @brief an iterator pointing to the first out edge of a vertex
+         *
+         * @param sourceId the vertex whose out edges we iterate over
+         * @param position the first byte of the encoded sinks of @c sourceId
+         * @param payload the payload of the first out edge
+         * @param lastPayload the payload after the one of the last out edge
+         */
+        CompressedOutEdgeIterator(nodeid_t sourceId, const uint8_t* position, const E* payload, const E* lastPayload): position{position}, payload{payload}, lastPayload{lastPayload}, sinkId{0} {
+            if (this->payload != this->lastPayload) {
+                //the first sink is stored relative to the source
+                this->sinkId = static_cast<nodeid_t>(static_cast<int64_t>(sourceId) + zigzagDecode(readVarint(this->position)));
+            }
+        }
+        /**
+         * @brief an iterator pointing after the last out edge of a vertex
+         *
+         * @param lastPayload the payload after the one of the last out edge
+         */
+        explicit CompressedOutEdgeIterator(const E* lastPayload): position{nullptr}, payload{lastPayload}, lastPayload{lastPayload}, sinkId{0} {
+
+        }
+    public:
+        This& operator++() {
+            this->payload += 1;
+            if (this->payload != this->lastPayload) {
+                this->sinkId += readVarint(this->position);
+            }
+            return *this;
+        }
+        OutEdge<E> operator*() const {
+            return OutEdge<E>{this->sinkId, *this->payload};
+        }
+        bool operator ==(const This& o) const {
+            return this->payload == o.payload;
+        }
+        bool operator !=(const This& o) const {
+            return this->payload != o.payload;
+        }
+        /**
+         * @brief the sink of the out edge the iterator is pointing to, without reading the payload
+         *
+         * @return nodeid_t the sink of the out edge
+         */
+        nodeid_t getSinkId() const {
+            return this->sinkId;
+        }
+        /**
+         * @brief the payload of the out edge the iterator is pointing to
+         *
+         * @return const E& the payload of the out edge
+         */
+        const E& getPayload() const {
+            return *this->payload;
+        }
+    };
+
+    /**
+     * @brief the out edges of a vertex of a CompressedAdjacentGraph, decoded while they are iterated
+     *
+     * @tparam E payload of each edge
+     */
+    template <typename E>
+    class CompressedOutEdgeRange {
+    private:
+        CompressedOutEdgeIterator<E> first;
+        CompressedOutEdgeIterator<E> last;
+    public:
+        CompressedOutEdgeRange(const CompressedOutEdgeIterator<E>& first, const CompressedOutEdgeIterator<E>& last): first{first}, last{last} {
+
+        }
+    public:
+        CompressedOutEdgeIterator<E> begin() const {
+            return this->first;
+        }
+        CompressedOutEdgeIterator<E> end() const {
+            return this->last;
+        }
+    };
+
+    /**
+     * @brief iterator over all the edges of a CompressedAdjacentGraph
+     *
+     * It decodes the sinks linearly
+     */
+    template <typename G, typename V, typename E>
+    class CompressedAdjacentGraphEdgesIterator: public ::cpp_utils::AbstractConstIterator<Edge<E>&, Edge<E>*> {
+        typedef CompressedAdjacentGraphEdgesIterator<G, V, E> This;
+    private:
+        const CompressedAdjacentGraph<G, V, E>& graph;
+        /**
+         * @brief source of the edge the iterator is pointing to
+         *
+         */
+        nodeid_t vertex;
+        /**
+         * @brief index of the edge the iterator is pointing to. If it is equal to the number of edges, the iterator has ended
+         *
+         */
+        uint64_t edge;
+        /**
+         * @brief the first byte of the sink of the next edge
+         *
+         */
+        const uint8_t* position;
+        nodeid_t sinkId;
+        mutable Edge<E> tmp;
+    public:
+        CompressedAdjacentGraphEdgesIterator(uint64_t edge, const CompressedAdjacentGraph<G, V, E>& graph): graph{graph}, vertex{0}, edge{edge}, position{graph.encodedSinks.data()}, sinkId{0}, tmp{} {
+            if (this->edge == 0) {
+                this->decodeSink();
+            }
+        }
+        virtual ~CompressedAdjacentGraphEdgesIterator() {
+
+        }
+    public:
+        This& operator++() {
+            if (!this->isEnded()) {
+                this->edge += 1;
+                this->decodeSink();
+            }
+            return *this;
+        }
+        cpp_utils::graphs::Edge<E>& operator*() const {
+            this->tmp = Edge<E>{this->vertex, this->sinkId, this->graph.edgePayloads[this->edge]};
+            return this->tmp;
+        }
+        cpp_utils::graphs::Edge<E>* operator->() const {
+            return &(this->operator*());
+        }
+        bool isEnded() const {
+            return this->edge >= this->graph.numberOfEdges();
+        }
+        bool isEqualTo(const AbstractConstIterator<Edge<E>&, Edge<E>*>* o) const {
+            auto b = static_cast<const This*>(o);
+            if (this->isEnded() || b->isEnded()) {
+                return this->isEnded() == b->isEnded();
+            }
+            return this->edge == b->edge;
+        }
+    private:
+        /**
+         * @brief decode the sink of ::edge, updating ::vertex if ::edge is the first out edge of a vertex
+         *
+         * The sinks of all the vertices are contiguous, hence ::position never jumps
+         */
+        void decodeSink() {
+            if (this->isEnded()) {
+                return;
+            }
+            if (this->graph.outEdgesOfVertexBegin[this->vertex + 1] > this->edge && this->edge > this->graph.outEdgesOfVertexBegin[this->vertex]) {
+                this->sinkId += readVarint(this->position);
+                return;
+            }
+            while (this->graph.outEdgesOfVertexBegin[this->vertex + 1] <= this->edge) {
+                this->vertex += 1;
+            }
+            this->sinkId = static_cast<nodeid_t>(static_cast<int64_t>(this->vertex) + zigzagDecode(readVarint(this->position)));
+        }
+    };
+
+    /**
+     * @brief an immutable graph whose neighbour lists are delta encoded
+     *
+     * The out edges of each vertex are sorted by sink. The first sink is stored as its (signed) difference from the source,
+     * the other ones as their difference from the previous sink; every difference is a varint (see varint.hpp). In graphs
+     * with locality (e.g., grids, road networks or graphs reordered via vertexOrdering.hpp) most differences take 1 byte,
+     * instead of the 8 bytes of a nodeid_t. The payloads of the edges are stored uncompressed in a separate array.
+     *
+     * Offsets are 64 bit, so the graph has no limit on the number of edges. The sinks are decoded lazily by ::outEdgeRange,
+     * so cpp_utils::graphs::forEachOutEdge and cpp_utils::graphs::forEachEdge scan the graph without allocations.
+     *
+     * @note
+     * there is no reverse index of the in edges (the graph is meant to save memory): in edges queries take \f$O(V+E)\f$.
+     * IImmutableGraph::getOutEdge takes \f$O(outdegree)\f$
+     *
+     * @tparam G custom payload of the whole graph
+     * @tparam V custom payload of each vertex
+     * @tparam E custom payload of each edge
+     */
+    template <typename G, typename V, typename E>
+    class CompressedAdjacentGraph: public IImmutableGraph<G, V, E> {
+    public:
+        using This = CompressedAdjacentGraph<G, V, E>;
+        using Super = IImmutableGraph<G, V, E>;
+        using const_vertex_iterator = PairNumberContainerBasedConstIterator<std::vector<V>, nodeid_t, V>;
+        friend class CompressedAdjacentGraphEdgesIterator<G, V, E>;
+    private:
+        /**
+         * @brief the value attached to the whole graph. Owned by the graph itself
+         *
+         */
+        G payload;
+        std::vector<V> vertexPayload;
+        /**
+         * @brief as long as the number of vertices plus 1. Index where in ::edgePayloads the out edges of each vertex start
+         *
+         */
+        std::vector<uint64_t> outEdgesOfVertexBegin;
+        /**
+         * @brief as long as the number of vertices plus 1. Index where in ::encodedSinks the out edges of each vertex start
+         *
+         */
+        std::vector<uint64_t> encodedSinksOfVertexBegin;
+        std::vector<uint8_t> encodedSinks;
+        std::vector<E> edgePayloads;
+    public:
+        CompressedAdjacentGraph(): payload{}, vertexPayload{}, outEdgesOfVertexBegin{0}, encodedSinksOfVertexBegin{0}, encodedSinks{}, edgePayloads{} {
+
+        }
+        /**
+         * @brief compress any graph
+         *
+         * Parallel edges keep their relative order.
+         *
+         * @param other the graph to compress. Its vertex ids need to be contiguous
+         */
+        explicit CompressedAdjacentGraph(const IImmutableGraph<G, V, E>& other): payload{other.getPayload()}, vertexPayload{},
+            outEdgesOfVertexBegin{}, encodedSinksOfVertexBegin{}, encodedSinks{}, edgePayloads{} {
+
+            const size_t vertices = other.numberOfVertices();
+            this->vertexPayload.reserve(vertices);
+            this->outEdgesOfVertexBegin.reserve(vertices + 1);
+            this->outEdgesOfVertexBegin.push_back(0);
+            for (nodeid_t id=0; id<vertices; ++id) {
+                this->vertexPayload.push_back(other.getVertex(id));
+                this->outEdgesOfVertexBegin.push_back(this->outEdgesOfVertexBegin.back() + other.getOutDegree(id));
+            }
+
+            //other may yield the edges in any order: each source has its own cursor
+            const uint64_t edges = this->outEdgesOfVertexBegin.back();
+            std::vector<nodeid_t> sinks(edges);
+            std::vector<E> payloads(edges);
+            std::vector<uint64_t> cursor{this->outEdgesOfVertexBegin.begin(), this->outEdgesOfVertexBegin.end() - 1};
+            other.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                auto i = cursor[sourceId]++;
+                sinks[i] = sinkId;
+                payloads[i] = payload;
+            });
+
+            this->encodedSinks.reserve(edges + vertices);
+            this->encodedSinksOfVertexBegin.reserve(vertices + 1);
+            this->encodedSinksOfVertexBegin.push_back(0);
+            this->edgePayloads.reserve(edges);
+            std::vector<uint64_t> order{};
+            for (nodeid_t id=0; id<vertices; ++id) {
+                order.resize(this->outEdgesOfVertexBegin[id + 1] - this->outEdgesOfVertexBegin[id]);
+                std::iota(order.begin(), order.end(), this->outEdgesOfVertexBegin[id]);
+                std::stable_sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b) { return sinks[a] < sinks[b]; });
+                nodeid_t previous = id;
+                bool first = true;
+                for (auto i : order) {
+                    if (first) {
+                        appendVarint(this->encodedSinks, zigzagEncode(static_cast<int64_t>(sinks[i]) - static_cast<int64_t>(id)));
+                        first = false;
+                    } else {
+                        appendVarint(this->encodedSinks, sinks[i] - previous);
+                    }
+                    previous = sinks[i];
+                    this->edgePayloads.push_back(payloads[i]);
+                }
+                this->encodedSinksOfVertexBegin.push_back(this->encodedSinks.size());
+            }
+            this->encodedSinks.shrink_to_fit();
+        }
+        CompressedAdjacentGraph(const This& other) = default;
+        CompressedAdjacentGraph(This&& other) = default;
+        This& operator =(const This& other) = default;
+        This& operator =(This&& other) = default;
+        virtual ~CompressedAdjacentGraph() {
+
+        }
+    public:
+        /**
+         * @brief the out edges of a vertex, decoded while they are iterated
+         *
+         * @param id the vertex involved
+         * @return CompressedOutEdgeRange<E> the out edges of @c id, sorted by sink
+         */
+        CompressedOutEdgeRange<E> outEdgeRange(nodeid_t id) const {
+            const E* lastPayload = this->edgePayloads.data() + this->outEdgesOfVertexBegin[id + 1];
+            return CompressedOutEdgeRange<E>{
+                CompressedOutEdgeIterator<E>{id, this->encodedSinks.data() + this->encodedSinksOfVertexBegin[id], this->edgePayloads.data() + this->outEdgesOfVertexBegin[id], lastPayload},
+                CompressedOutEdgeIterator<E>{lastPayload}
+            };
+        }
+        /**
+         * @brief average number of bytes used to encode the sink of an edge
+         *
+         * @return double bytes per edge of the encoded sinks (the payloads are excluded)
+         */
+        double getBytesPerSink() const {
+            if (this->edgePayloads.empty()) {
+                return 0;
+            }
+            return static_cast<double>(this->encodedSinks.size()) / this->edgePayloads.size();
+        }
+    private:
+        /**
+         * @brief the index in ::edgePayloads of the first out edge from @c sourceId to @c sinkId
+         *
+         * @return uint64_t the index of the edge, the number of edges if there is no such edge
+         */
+        uint64_t findOutEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            auto range = this->outEdgeRange(sourceId);
+            for (auto it=range.begin(); it!=range.end(); ++it) {
+                if (it.getSinkId() == sinkId) {
+                    return static_cast<uint64_t>(&it.getPayload() - this->edgePayloads.data());
+                }
+                if (it.getSinkId() > sinkId) {
+                    break;
+                }
+            }
+            return this->edgePayloads.size();
+        }
+    public:
+        virtual size_t size() const {
+            return this->vertexPayload.size();
+        }
+        virtual size_t numberOfVertices() const {
+            return this->vertexPayload.size();
+        }
+        virtual size_t numberOfEdges() const {
+            return this->edgePayloads.size();
+        }
+        virtual typename Super::const_vertex_iterator beginVertices() const {
+            auto it = new const_vertex_iterator{0, this->vertexPayload};
+            return typename Super::const_vertex_iterator{it};
+        }
+        virtual typename Super::const_vertex_iterator endVertices() const {
+            auto it = new const_vertex_iterator{-1, this->vertexPayload};
+            return typename Super::const_vertex_iterator{it};
+        }
+        virtual typename Super::const_edge_iterator beginEdges() const {
+            auto it = new CompressedAdjacentGraphEdgesIterator<G, V, E>{0, *this};
+            return typename Super::const_edge_iterator{it};
+        }
+        virtual typename Super::const_edge_iterator endEdges() const {
+            auto it = new CompressedAdjacentGraphEdgesIterator<G, V, E>{this->edgePayloads.size(), *this};
+            return typename Super::const_edge_iterator{it};
+        }
+        virtual void forEachEdge(const std::function<void(nodeid_t, nodeid_t, const E&)>& lambda) const {
+            cpp_utils::graphs::forEachEdge(*this, lambda);
+        }
+        virtual const V& getVertex(nodeid_t id) const {
+            return this->vertexPayload[id];
+        }
+        virtual bool containsVertex(nodeid_t id) const {
+            return id < this->vertexPayload.size();
+        }
+        virtual const E& getEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            auto i = this->findOutEdge(sourceId, sinkId);
+            if (i < this->edgePayloads.size()) {
+                return this->edgePayloads[i];
+            }
+            throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, This>{sinkId, *this};
+        }
+        virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId, const E& payload) const {
+            for (const auto& outEdge : this->outEdgeRange(sourceId)) {
+                if (outEdge.getSinkId() == sinkId && outEdge.getPayload() == payload) {
+                    return true;
+                }
+                if (outEdge.getSinkId() > sinkId) {
+                    break;
+                }
+            }
+            return false;
+        }
+        virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            return this->hasEdge(sourceId, sinkId);
+        }
+        virtual const G& getPayload() const {
+            return this->payload;
+        }
+        virtual G& getPayload() {
+            return this->payload;
+        }
+        virtual size_t getInDegree(nodeid_t id) const {
+            //each parallel edge counts (see IImmutableGraph::getInDegree)
+            size_t result = 0;
+            for (nodeid_t sourceId=0; sourceId<this->numberOfVertices(); ++sourceId) {
+                cpp_utils::graphs::forEachSuccessor(*this, sourceId, [&](nodeid_t sinkId) {
+                    if (sinkId == id) {
+                        result += 1;
+                    }
+                });
+            }
+            return result;
+        }
+        virtual size_t getOutDegree(nodeid_t id) const {
+            return this->outEdgesOfVertexBegin[id + 1] - this->outEdgesOfVertexBegin[id];
+        }
+        virtual size_t getDegree(nodeid_t id) const {
+            return this->getOutDegree(id) + this->getInDegree(id);
+        }
+        virtual bool hasSuccessors(nodeid_t id) const {
+            return this->getOutDegree(id) > 0;
+        }
+        virtual bool hasPredecessors(nodeid_t id) const {
+            for (nodeid_t sourceId=0; sourceId<this->numberOfVertices(); ++sourceId) {
+                if (sourceId != id && this->hasEdge(sourceId, id)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        virtual OutEdge<E> getOutEdge(nodeid_t id, moveid_t index) const {
+            auto it = this->outEdgeRange(id).begin();
+            for (moveid_t i=0; i<index; ++i) {
+                ++it;
+            }
+            return *it;
+        }
+        virtual bool hasEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            return this->findOutEdge(sourceId, sinkId) < this->edgePayloads.size();
+        }
+        virtual std::vector<InEdge<E>> getInEdges(nodeid_t id) const {
+            std::vector<InEdge<E>> result{};
+            for (nodeid_t sourceId=0; sourceId<this->numberOfVertices(); ++sourceId) {
+                if (sourceId == id) {
+                    continue;
+                }
+                for (const auto& outEdge : this->outEdgeRange(sourceId)) {
+                    if (outEdge.getSinkId() == id) {
+                        result.push_back(InEdge<E>{sourceId, outEdge.getPayload()});
+                    }
+                }
+            }
+            return result;
+        }
+        virtual std::vector<OutEdge<E>> getOutEdges(nodeid_t id) const {
+            std::vector<OutEdge<E>> result{};
+            result.reserve(this->getOutDegree(id));
+            for (const auto& outEdge : this->outEdgeRange(id)) {
+                result.push_back(outEdge);
+            }
+            return result;
+        }
+        virtual bool isEmpty() const {
+            return this->vertexPayload.empty();
+        }
+    protected:
+        virtual nodeid_t getLastVertexId() const {
+            return this->vertexPayload.size() - 1;
+        }
+    public:
+        virtual MemoryConsumption getByteMemoryOccupied() const {
+            size_t result = sizeof(*this);
+            result += sizeof(V) * this->vertexPayload.capacity();
+            result += sizeof(uint64_t) * this->outEdgesOfVertexBegin.capacity();
+            result += sizeof(uint64_t) * this->encodedSinksOfVertexBegin.capacity();
+            result += sizeof(uint8_t) * this->encodedSinks.capacity();
+            result += sizeof(E) * this->edgePayloads.capacity();
+            return MemoryConsumption{result, MemoryConsumptionEnum::BYTE};
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,719 @@
+#ifndef _CPP_UTILS_CONTRACTIONHIERARCHY_HEADER__
+#define _CPP_UTILS_CONTRACTIONHIERARCHY_HEADER__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "igraph.hpp"
+#include "KHeaps.hpp"
+#include "exceptions.hpp"
+#include "serializers.hpp"
+#include "span.hpp"
+
+namespace cpp_utils::graphs {
+
+    template <typename E>
+    class ContractionHierarchy;
+
+    /**
+     * @brief an edge of a ContractionHierarchy
+     *
+     * The edge is either an edge of the original graph or a shortcut replacing the path `source -> middle -> sink`.
+     *
+     * @tparam E type of the weight of the edge
+     */
+    template <typename E>
+    struct ContractionHierarchyEdge {
+        /**
+         * @brief value of ::middle when the edge is in the original graph
+         *
+         */
+        static constexpr uint32_t NO_MIDDLE = std::numeric_limits<uint32_t>::max();
+        /**
+         * @brief the other endpoint of the edge: the sink for upward edges, the source for downward edges
+         *
+         */
+        uint32_t other;
+        /**
+         * @brief the vertex the shortcut skips. ::NO_MIDDLE if the edge is not a shortcut
+         *
+         */
+        uint32_t middle;
+        E weight;
+
+        bool isShortcut() const {
+            return this->middle != NO_MIDDLE;
+        }
+    };
+
+}
+
+namespace cpp_utils::serializers {
+
+    /**
+     * Save a contraction hierarchy into a file
+     *
+     * @pre
+     *  @li @c f open with "wb";
+     * @post
+     *  @li @c f modified;
+     *  @li @c f cursor modified;
+     *
+     * @param[in] f the file to save the hierarchy into
+     * @param[in] ch the hierarchy to save
+     */
+    template <typename E>
+    void saveToFile(FILE* f, const cpp_utils::graphs::ContractionHierarchy<E>& ch) {
+        static_assert(std::is_trivially_copyable<E>::value, "edge weight needs to be trivially copyable to be saved");
+        saveToFile(f, ch.ranks);
+        saveToFile(f, ch.upwardEdgesBegin);
+        saveToFile(f, ch.upwardEdges);
+        saveToFile(f, ch.downwardEdgesBegin);
+        saveToFile(f, ch.downwardEdges);
+    }
+
+    /**
+     * Load a contraction hierarchy from a file
+     *
+     * @pre
+     *  @li @c f open in "rb";
+     * @post
+     *  @li @c f cursor modified;
+     *
+     * @param[in] f the file to read the hierarchy from;
+     * @return the hierarchy loaded
+     */
+    template <typename E>
+    cpp_utils::graphs::ContractionHierarchy<E>& loadFromFile(FILE* f, cpp_utils::graphs::ContractionHierarchy<E>& result) {
+        loadFromFile(f, result.ranks);
+        loadFromFile(f, result.upwardEdgesBegin);
+        loadFromFile(f, result.upwardEdges);
+        loadFromFile(f, result.downwardEdgesBegin);
+        loadFromFile(f, result.downwardEdges);
+
+        return result;
+    }
+
+}
+
+namespace cpp_utils::graphs::internal {
+
+    /**
+     * @brief the state needed while contracting the vertices of a graph
+     *
+     * The builder keeps a mutable adjacency list of the vertices not contracted yet. Contracting a vertex @c v moves its
+     * edges into the hierarchy (they all lead to vertices with a higher rank) and adds the shortcuts `u -> x` needed to
+     * preserve the distances between the neighbours of @c v. A shortcut is not needed if a witness search from @c u
+     * which avoids @c v finds a path to @c x which is not longer.
+     *
+     * @tparam E type of the weight of the edges
+     */
+    template <typename E>
+    class ContractionHierarchyBuilder {
+        using Arc = ContractionHierarchyEdge<E>;
+        struct Shortcut {
+            uint32_t source;
+            uint32_t sink;
+            E weight;
+        };
+    public:
+        std::vector<uint32_t> ranks;
+        std::vector<std::vector<Arc>> upward;
+        std::vector<std::vector<Arc>> downward;
+    private:
+        std::vector<std::vector<Arc>> outArcs;
+        std::vector<std::vector<Arc>> inArcs;
+        std::vector<uint32_t> contractedNeighbours;
+        std::vector<Shortcut> shortcuts;
+        size_t witnessSearchLimit;
+
+        kway_min_id_heap<nodeid_t, E, 4> witnessHeap;
+        std::vector<E> witnessDistance;
+        std::vector<uint32_t> witnessQuery;
+        uint32_t query;
+        /**
+         * @brief cell @c x is @c v if @c x is a sink of an edge of @c v, the vertex whose shortcuts we are looking for
+         *
+         * Outside ::findShortcuts every cell is Arc::NO_MIDDLE: a stale mark equal to the vertex avoided by a later witness
+         * search would make it stop before reaching its actual targets
+         */
+        std::vector<uint32_t> targetOf;
+    public:
+        ContractionHierarchyBuilder(size_t vertices, size_t witnessSearchLimit): ranks(vertices, 0), upward(vertices), downward(vertices),
+            outArcs(vertices), inArcs(vertices), contractedNeighbours(vertices, 0), shortcuts{}, witnessSearchLimit{witnessSearchLimit},
+            witnessHeap{vertices}, witnessDistance(vertices, 0), witnessQuery(vertices, 0), query{0},
+            targetOf(vertices, Arc::NO_MIDDLE) {
+
+        }
+    public:
+        /**
+         * @brief add an edge of the original graph. Self loops are ignored and, among parallel edges, only the lightest is kept
+         *
+         */
+        void addEdge(uint32_t source, uint32_t sink, E weight) {
+            if (source != sink) {
+                this->addArc(source, sink, weight, Arc::NO_MIDDLE);
+            }
+        }
+        /**
+         * @brief contract every vertex, from the least important one
+         *
+         * The importance of a vertex is its edge difference (shortcuts added minus edges removed by its contraction)
+         * plus the number of its neighbours already contracted, which spreads the contraction evenly over the graph.
+         * Importances are updated lazily: a vertex is contracted only if its updated importance is still the minimum one.
+         * Recomputing the importance of the neighbours after each contraction gives about the same hierarchy, but it
+         * makes the contraction roughly 3 times slower.
+         */
+        void contractAll() {
+            const uint32_t vertices = static_cast<uint32_t>(this->ranks.size());
+            kway_min_id_heap<nodeid_t, int, 4> queue{vertices};
+            for (uint32_t v=0; v<vertices; ++v) {
+                queue.pushOrDecrease(v, this->computeImportance(v));
+            }
+
+            std::vector<uint32_t> neighbours{};
+            uint32_t rank = 0;
+            while (!queue.isEmpty()) {
+                const uint32_t v = static_cast<uint32_t>(queue.pop());
+                //computeImportance fills shortcuts with the ones v needs
+                const int importance = this->computeImportance(v);
+                if (!queue.isEmpty() && importance > queue.peekKey()) {
+                    queue.pushOrDecrease(v, importance);
+                    continue;
+                }
+
+                neighbours.clear();
+                for (auto& arc : this->outArcs[v]) {
+                    neighbours.push_back(arc.other);
+                }
+                for (auto& arc : this->inArcs[v]) {
+                    neighbours.push_back(arc.other);
+                }
+                std::sort(neighbours.begin(), neighbours.end());
+                neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+                this->contract(v);
+                this->ranks[v] = rank;
+                rank += 1;
+
+                //the importance of the neighbours is not recomputed here: it is updated lazily, when they are popped
+                for (auto neighbour : neighbours) {
+                    this->contractedNeighbours[neighbour] += 1;
+                }
+            }
+        }
+    private:
+        /**
+         * @brief add an edge between 2 vertices not contracted yet. If the edge is already present, keep the lighter one
+         *
+         */
+        void addArc(uint32_t source, uint32_t sink, E weight, uint32_t middle) {
+            for (auto& arc : this->outArcs[source]) {
+                if (arc.other == sink) {
+                    if (weight < arc.weight) {
+                        arc.weight = weight;
+                        arc.middle = middle;
+                        for (auto& inArc : this->inArcs[sink]) {
+                            if (inArc.other == source) {
+                                inArc.weight = weight;
+                                inArc.middle = middle;
+                                break;
+                            }
+                        }
+                    }
+                    return;
+                }
+            }
+            this->outArcs[source].push_back(Arc{sink, middle, weight});
+            this->inArcs[sink].push_back(Arc{source, middle, weight});
+        }
+        static void removeArc(std::vector<Arc>& arcs, uint32_t other) {
+            arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [&](const Arc& arc) { return arc.other == other; }), arcs.end());
+        }
+        /**
+         * @brief compute the importance of a vertex and the shortcuts its contraction would need
+         *
+         * @post
+         *  @li ::shortcuts contains the shortcuts needed to contract @c v;
+         */
+        int computeImportance(uint32_t v) {
+            this->findShortcuts(v);
+            const int edgeDifference = static_cast<int>(this->shortcuts.size()) - static_cast<int>(this->outArcs[v].size() + this->inArcs[v].size());
+            return edgeDifference + static_cast<int>(this->contractedNeighbours[v]);
+        }
+        /**
+         * @brief fill ::shortcuts with the shortcuts needed to contract @c v
+         *
+         */
+        void findShortcuts(uint32_t v) {
+            this->shortcuts.clear();
+            if (this->outArcs[v].empty()) {
+                return;
+            }
+            for (auto& out : this->outArcs[v]) {
+                this->targetOf[out.other] = v;
+            }
+            for (auto& in : this->inArcs[v]) {
+                E maxCost = 0;
+                for (auto& out : this->outArcs[v]) {
+                    if (out.other != in.other) {
+                        maxCost = std::max(maxCost, static_cast<E>(in.weight + out.weight));
+                    }
+                }
+                this->witnessSearch(in.other, v, maxCost, this->outArcs[v].size());
+                for (auto& out : this->outArcs[v]) {
+                    if (out.other == in.other) {
+                        continue;
+                    }
+                    const E viaV = in.weight + out.weight;
+                    if (this->getWitnessDistance(out.other) > viaV) {
+                        this->shortcuts.push_back(Shortcut{in.other, out.other, viaV});
+                    }
+                }
+            }
+            for (auto& out : this->outArcs[v]) {
+                this->targetOf[out.other] = Arc::NO_MIDDLE;
+            }
+        }
+        /**
+         * @brief remove a vertex from the graph, moving its edges into the hierarchy and adding the shortcuts in ::shortcuts
+         *
+         */
+        void contract(uint32_t v) {
+            for (auto& shortcut : this->shortcuts) {
+                this->addArc(shortcut.source, shortcut.sink, shortcut.weight, v);
+            }
+            for (auto& arc : this->outArcs[v]) {
+                removeArc(this->inArcs[arc.other], v);
+            }
+            for (auto& arc : this->inArcs[v]) {
+                removeArc(this->outArcs[arc.other], v);
+            }
+            this->upward[v] = std::move(this->outArcs[v]);
+            this->downward[v] = std::move(this->inArcs[v]);
+            this->outArcs[v] = std::vector<Arc>{};
+            this->inArcs[v] = std::vector<Arc>{};
+        }
+        E getWitnessDistance(uint32_t id) const {
+            return this->witnessQuery[id] == this->query ? this->witnessDistance[id] : std::numeric_limits<E>::max();
+        }
+        /**
+         * @brief a Dijkstra search from @c source which avoids @c avoid and ignores paths longer than @c maxCost
+         *
+         * The search stops once every sink of the edges of @c avoid has been settled. It settles at most ::witnessSearchLimit
+         * vertices anyway: missing a witness only adds an unnecessary shortcut
+         */
+        void witnessSearch(uint32_t source, uint32_t avoid, E maxCost, size_t targets) {
+            this->query += 1;
+            if (this->query == 0) {
+                std::fill(this->witnessQuery.begin(), this->witnessQuery.end(), 0);
+                this->query = 1;
+            }
+            this->witnessHeap.cleanup();
+            this->witnessQuery[source] = this->query;
+            this->witnessDistance[source] = 0;
+            this->witnessHeap.pushOrDecrease(source, 0);
+
+            size_t settled = 0;
+            while (!this->witnessHeap.isEmpty() && this->witnessHeap.peekKey() <= maxCost && settled < this->witnessSearchLimit) {
+                const uint32_t id = static_cast<uint32_t>(this->witnessHeap.pop());
+                settled += 1;
+                if (this->targetOf[id] == avoid) {
+                    targets -= 1;
+                    if (targets == 0) {
+                        return;
+                    }
+                }
+                const E distance = this->witnessDistance[id];
+                for (auto& arc : this->outArcs[id]) {
+                    if (arc.other == avoid) {
+                        continue;
+                    }
+                    const E newDistance = distance + arc.weight;
+                    if (newDistance < this->getWitnessDistance(arc.other)) {
+                        this->witnessQuery[arc.other] = this->query;
+                        this->witnessDistance[arc.other] = newDistance;
+                        this->witnessHeap.pushOrDecrease(arc.other, newDistance);
+                    }
+                }
+            }
+        }
+    };
+
+}
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief a Contraction Hierarchy built over a static weighted graph
+     *
+     * The vertices are contracted one at a time, from the least important one (see internal::ContractionHierarchyBuilder),
+     * and the order of contraction is the rank of a vertex. Each edge of the original graph and each shortcut added while
+     * contracting goes from a vertex to one with a higher rank (an upward edge) or from a vertex with a higher rank
+     * (a downward edge). The 2 sets of edges are stored in 2 CSR arrays:
+     *  @li the upward edges of @c v are the edges `v -> x` with `rank(x) > rank(v)`: ::getUpwardEdges(v) contains the sinks;
+     *  @li the downward edges of @c v are the edges `u -> v` with `rank(u) > rank(v)`: ::getDownwardEdges(v) contains the sources;
+     *
+     * So a shortest path query becomes a bidirectional Dijkstra which only goes up in both directions
+     * (see ContractionHierarchySearch). Vertices keep their ids from the original graph.
+     *
+     * @code
+     * ContractionHierarchy<int> ch{graph};
+     * ContractionHierarchySearch<int> search{ch};
+     * int distance = search.search(start, goal);
+     * std::vector<nodeid_t> path = search.getPath();
+     * @endcode
+     *
+     * The hierarchy can be stored via cpp_utils::serializers::saveToFile and loaded via cpp_utils::serializers::loadFromFile.
+     *
+     * @tparam E type of the weight of the edges. It needs to be an arithmetic type and the weights need to be non negative
+     */
+    template <typename E>
+    class ContractionHierarchy {
+        static_assert(std::is_arithmetic<E>::value, "the weight of the edges needs to be a number");
+        using This = ContractionHierarchy<E>;
+    private:
+        /**
+         * @brief cell @c i is the order of contraction of vertex @c i
+         *
+         */
+        std::vector<uint32_t> ranks;
+        /**
+         * @brief the upward edges of vertex @c i are in `upwardEdges[upwardEdgesBegin[i]..upwardEdgesBegin[i+1]]`
+         *
+         */
+        std::vector<uint32_t> upwardEdgesBegin;
+        std::vector<ContractionHierarchyEdge<E>> upwardEdges;
+        /**
+         * @brief the downward edges of vertex @c i are in `downwardEdges[downwardEdgesBegin[i]..downwardEdgesBegin[i+1]]`
+         *
+         */
+        std::vector<uint32_t> downwardEdgesBegin;
+        std::vector<ContractionHierarchyEdge<E>> downwardEdges;
+    public:
+        /**
+         * @brief an empty hierarchy. Use it to load a hierarchy via cpp_utils::serializers::loadFromFile
+         *
+         */
+        ContractionHierarchy(): ranks{}, upwardEdgesBegin{0}, upwardEdges{}, downwardEdgesBegin{0}, downwardEdges{} {
+
+        }
+        /**
+         * @brief contract a graph
+         *
+         * @param graph the graph to contract. The payload of each edge is its weight and it needs to be non negative
+         * @param witnessSearchLimit maximum number of vertices settled by each witness search. Smaller values speed up the
+         *  contraction but may add useless shortcuts
+         * @throw cpp_utils::exceptions::InvalidArgumentException if @c graph or the hierarchy have too many vertices or edges
+         */
+        template <typename G, typename V>
+        explicit ContractionHierarchy(const IImmutableGraph<G, V, E>& graph, size_t witnessSearchLimit = 1000): ContractionHierarchy{} {
+            const size_t vertices = graph.numberOfVertices();
+            const size_t edges = graph.numberOfEdges();
+            if (vertices >= std::numeric_limits<uint32_t>::max() || edges >= std::numeric_limits<uint32_t>::max()) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"the graph can contain at most", std::numeric_limits<uint32_t>::max() - 1, "vertices and edges, but we have", vertices, "vertices and", edges, "edges"};
+            }
+
+            internal::ContractionHierarchyBuilder<E> builder{vertices, witnessSearchLimit};
+            graph.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                builder.addEdge(static_cast<uint32_t>(sourceId), static_cast<uint32_t>(sinkId), payload);
+            });
+            builder.contractAll();
+
+            this->ranks = std::move(builder.ranks);
+            toCSR(builder.upward, this->upwardEdgesBegin, this->upwardEdges);
+            toCSR(builder.downward, this->downwardEdgesBegin, this->downwardEdges);
+        }
+        ContractionHierarchy(const This& o) = default;
+        ContractionHierarchy(This&& o) = default;
+        This& operator=(const This& o) = default;
+        This& operator=(This&& o) = default;
+        virtual ~ContractionHierarchy() {
+
+        }
+    public:
+        size_t numberOfVertices() const {
+            return this->ranks.size();
+        }
+        /**
+         * @brief number of edges in the hierarchy, shortcuts included
+         *
+         */
+        size_t numberOfEdges() const {
+            return this->upwardEdges.size() + this->downwardEdges.size();
+        }
+        /**
+         * @brief number of shortcuts added while contracting the graph
+         *
+         * A shortcut lighter than an edge of the original graph replaces it
+         *
+         */
+        size_t numberOfShortcuts() const {
+            auto isShortcut = [&](auto& e) { return e.isShortcut(); };
+            return static_cast<size_t>(std::count_if(this->upwardEdges.begin(), this->upwardEdges.end(), isShortcut) + std::count_if(this->downwardEdges.begin(), this->downwardEdges.end(), isShortcut));
+        }
+        /**
+         * @brief the order in which the vertex has been contracted. Higher ranks are more important vertices
+         *
+         */
+        uint32_t getRank(nodeid_t id) const {
+            return this->ranks[id];
+        }
+        /**
+         * @brief the edges going from @c id to vertices with a higher rank
+         *
+         * @param id the vertex involved
+         * @return cpp_utils::ConstSpan<ContractionHierarchyEdge<E>> the edges. cpp_utils::graphs::ContractionHierarchyEdge::other is the sink
+         */
+        cpp_utils::ConstSpan<ContractionHierarchyEdge<E>> getUpwardEdges(nodeid_t id) const {
+            return cpp_utils::ConstSpan<ContractionHierarchyEdge<E>>{
+                this->upwardEdges.data() + this->upwardEdgesBegin[id],
+                this->upwardEdges.data() + this->upwardEdgesBegin[id + 1]
+            };
+        }
+        /**
+         * @brief the edges coming in @c id from vertices with a higher rank
+         *
+         * @param id the vertex involved
+         * @return cpp_utils::ConstSpan<ContractionHierarchyEdge<E>> the edges. cpp_utils::graphs::ContractionHierarchyEdge::other is the source
+         */
+        cpp_utils::ConstSpan<ContractionHierarchyEdge<E>> getDownwardEdges(nodeid_t id) const {
+            return cpp_utils::ConstSpan<ContractionHierarchyEdge<E>>{
+                this->downwardEdges.data() + this->downwardEdgesBegin[id],
+                this->downwardEdges.data() + this->downwardEdgesBegin[id + 1]
+            };
+        }
+        /**
+         * @brief replace an edge of the hierarchy with the vertices of the path in the original graph it represents
+         *
+         * @param source the source of the edge
+         * @param sink the sink of the edge
+         * @param middle the cpp_utils::graphs::ContractionHierarchyEdge::middle of the edge
+         * @param path vector where we append the vertices of the path, @c source excluded and @c sink included
+         */
+        void unpackEdge(nodeid_t source, nodeid_t sink, uint32_t middle, std::vector<nodeid_t>& path) const {
+            if (middle == ContractionHierarchyEdge<E>::NO_MIDDLE) {
+                path.push_back(sink);
+                return;
+            }
+            //middle has been contracted before source and sink, so the 2 halves of the shortcut are both stored in middle
+            this->unpackEdge(source, middle, this->findEdge(this->getDownwardEdges(middle), source).middle, path);
+            this->unpackEdge(middle, sink, this->findEdge(this->getUpwardEdges(middle), sink).middle, path);
+        }
+    private:
+        static const ContractionHierarchyEdge<E>& findEdge(cpp_utils::ConstSpan<ContractionHierarchyEdge<E>> edges, nodeid_t other) {
+            for (auto& edge : edges) {
+                if (edge.other == other) {
+                    return edge;
+                }
+            }
+            throw cpp_utils::exceptions::ImpossibleException{"the half of a shortcut involving", other, "is missing from the hierarchy"};
+        }
+        static void toCSR(std::vector<std::vector<ContractionHierarchyEdge<E>>>& lists, std::vector<uint32_t>& begin, std::vector<ContractionHierarchyEdge<E>>& edges) {
+            begin.clear();
+            begin.reserve(lists.size() + 1);
+            size_t total = 0;
+            for (auto& list : lists) {
+                begin.push_back(static_cast<uint32_t>(total));
+                total += list.size();
+                if (total >= std::numeric_limits<uint32_t>::max()) {
+                    throw cpp_utils::exceptions::InvalidArgumentException{"the hierarchy needs more than", std::numeric_limits<uint32_t>::max() - 1, "edges"};
+                }
+            }
+            begin.push_back(static_cast<uint32_t>(total));
+            edges.clear();
+            edges.reserve(total);
+            for (auto& list : lists) {
+                edges.insert(edges.end(), list.begin(), list.end());
+                list = std::vector<ContractionHierarchyEdge<E>>{};
+            }
+        }
+    private:
+        friend void cpp_utils::serializers::saveToFile<>(FILE* f, const This& ch);
+        friend This& cpp_utils::serializers::loadFromFile<>(FILE* f, This& result);
+    };
+
+    /**
+     * @brief a reusable bidirectional query over a ContractionHierarchy
+     *
+     * The forward search from the start scans only upward edges while the backward search from the goal scans only
+     * downward edges (backwards): the 2 searches meet in the vertex with the highest rank of the shortest path.
+     * A vertex whose distance can be improved via an edge coming from a higher vertex is not expanded (stall-on-demand).
+     *
+     * As in DijkstraSearch, the state of the vertices is tagged with the number of the query, so starting a new query
+     * takes \f$O(1)\f$.
+     *
+     * @tparam E type of the weight of the edges of the hierarchy
+     */
+    template <typename E>
+    class ContractionHierarchySearch {
+        using This = ContractionHierarchySearch<E>;
+    public:
+        /**
+         * @brief the distance between 2 vertices not connected
+         *
+         */
+        static constexpr E INFINITE_COST = std::numeric_limits<E>::max();
+    private:
+        static constexpr int FORWARD = 0;
+        static constexpr int BACKWARD = 1;
+        struct VertexState {
+            uint32_t query;
+            E distance;
+            uint32_t parent;
+            uint32_t parentMiddle;
+        };
+    private:
+        const ContractionHierarchy<E>& hierarchy;
+        kway_min_id_heap<nodeid_t, E, 4> heaps[2];
+        std::vector<VertexState> states[2];
+        uint32_t query;
+        nodeid_t start;
+        nodeid_t goal;
+        nodeid_t meeting;
+        E best;
+        size_t expandedVertices;
+    public:
+        /**
+         * @brief setup a query over a hierarchy
+         *
+         * @param hierarchy the hierarchy to query. It needs to outlive the search
+         */
+        explicit ContractionHierarchySearch(const ContractionHierarchy<E>& hierarchy): hierarchy{hierarchy},
+            heaps{kway_min_id_heap<nodeid_t, E, 4>{hierarchy.numberOfVertices()}, kway_min_id_heap<nodeid_t, E, 4>{hierarchy.numberOfVertices()}},
+            states{std::vector<VertexState>(hierarchy.numberOfVertices(), VertexState{0, INFINITE_COST, 0, 0}), std::vector<VertexState>(hierarchy.numberOfVertices(), VertexState{0, INFINITE_COST, 0, 0})},
+            query{0}, start{0}, goal{0}, meeting{0}, best{INFINITE_COST}, expandedVertices{0} {
+
+        }
+        ContractionHierarchySearch(const This& o) = default;
+        ContractionHierarchySearch(This&& o) = default;
+        virtual ~ContractionHierarchySearch() {
+
+        }
+    public:
+        /**
+         * @brief cost of the shortest path between 2 vertices
+         *
+         * @param start the source of the path
+         * @param goal the target of the path
+         * @return E the cost of the shortest path. ::INFINITE_COST if @c goal is unreachable
+         */
+        E search(nodeid_t start, nodeid_t goal) {
+            this->newQuery();
+            this->start = start;
+            this->goal = goal;
+            this->best = INFINITE_COST;
+            this->meeting = start;
+            this->expandedVertices = 0;
+            this->heaps[FORWARD].cleanup();
+            this->heaps[BACKWARD].cleanup();
+            this->reach(FORWARD, start, 0, start, ContractionHierarchyEdge<E>::NO_MIDDLE);
+            this->reach(BACKWARD, goal, 0, goal, ContractionHierarchyEdge<E>::NO_MIDDLE);
+
+            int direction = FORWARD;
+            while (true) {
+                const bool forwardDone = this->heaps[FORWARD].isEmpty() || this->heaps[FORWARD].peekKey() >= this->best;
+                const bool backwardDone = this->heaps[BACKWARD].isEmpty() || this->heaps[BACKWARD].peekKey() >= this->best;
+                if (forwardDone && backwardDone) {
+                    break;
+                }
+                if (forwardDone) {
+                    direction = BACKWARD;
+                } else if (backwardDone) {
+                    direction = FORWARD;
+                }
+                this->expand(direction);
+                direction = 1 - direction;
+            }
+            return this->best;
+        }
+        /**
+         * @brief the shortest path found by the last query, in the original graph
+         *
+         * @return std::vector<nodeid_t> the vertices of the path, from the start to the goal
+         * @throw cpp_utils::exceptions::InvalidArgumentException if the last query has not found any path
+         */
+        std::vector<nodeid_t> getPath() const {
+            if (this->best == INFINITE_COST) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"there is no path from", this->start, "to", this->goal};
+            }
+            //the path from the start to the meeting vertex, in the hierarchy, backwards
+            std::vector<nodeid_t> upPath{};
+            for (nodeid_t id = this->meeting; id != this->start; id = this->states[FORWARD][id].parent) {
+                upPath.push_back(id);
+            }
+            upPath.push_back(this->start);
+            std::reverse(upPath.begin(), upPath.end());
+
+            std::vector<nodeid_t> result{};
+            result.push_back(this->start);
+            for (size_t i=1; i<upPath.size(); ++i) {
+                this->hierarchy.unpackEdge(upPath[i - 1], upPath[i], this->states[FORWARD][upPath[i]].parentMiddle, result);
+            }
+            for (nodeid_t id = this->meeting; id != this->goal; id = this->states[BACKWARD][id].parent) {
+                this->hierarchy.unpackEdge(id, this->states[BACKWARD][id].parent, this->states[BACKWARD][id].parentMiddle, result);
+            }
+            return result;
+        }
+        /**
+         * @brief number of vertices expanded by the last query, in both directions
+         *
+         */
+        size_t getExpandedVertices() const {
+            return this->expandedVertices;
+        }
+    private:
+        void newQuery() {
+            this->query += 1;
+            if (this->query == 0) {
+                for (auto& states : this->states) {
+                    for (auto& state : states) {
+                        state.query = 0;
+                    }
+                }
+                this->query = 1;
+            }
+        }
+        E getDistance(int direction, nodeid_t id) const {
+            const VertexState& state = this->states[direction][id];
+            return state.query == this->query ? state.distance : INFINITE_COST;
+        }
+        void reach(int direction, nodeid_t id, E distance, nodeid_t parent, uint32_t parentMiddle) {
+            this->states[direction][id] = VertexState{this->query, distance, static_cast<uint32_t>(parent), parentMiddle};
+            this->heaps[direction].pushOrDecrease(id, distance);
+        }
+        void expand(int direction) {
+            const nodeid_t id = this->heaps[direction].pop();
+            const E distance = this->states[direction][id].distance;
+            this->expandedVertices += 1;
+
+            const E otherDistance = this->getDistance(1 - direction, id);
+            if (otherDistance != INFINITE_COST && distance + otherDistance < this->best) {
+                this->best = distance + otherDistance;
+                this->meeting = id;
+            }
+
+            const auto forwardEdges = direction == FORWARD ? this->hierarchy.getUpwardEdges(id) : this->hierarchy.getDownwardEdges(id);
+            const auto stallEdges = direction == FORWARD ? this->hierarchy.getDownwardEdges(id) : this->hierarchy.getUpwardEdges(id);
+            for (auto& edge : stallEdges) {
+                const E higherDistance = this->getDistance(direction, edge.other);
+                if (higherDistance != INFINITE_COST && higherDistance + edge.weight < distance) {
+                    //a vertex with a higher rank reaches id with a shorter path: the shortest path does not go through here
+                    return;
+                }
+            }
+            for (auto& edge : forwardEdges) {
+                const E newDistance = distance + edge.weight;
+                if (newDistance < this->getDistance(direction, edge.other)) {
+                    this->reach(direction, edge.other, newDistance, id, edge.middle);
+                }
+            }
+        }
+    };
+
+}
+
+#endif
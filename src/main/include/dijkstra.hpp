@@ -0,0 +1,329 @@
+#ifndef _CPP_UTILS_DIJKSTRA_HEADER__
+#define _CPP_UTILS_DIJKSTRA_HEADER__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "igraph.hpp"
+#include "KHeaps.hpp"
+#include "exceptions.hpp"
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief the heuristic turning A* into Dijkstra
+     *
+     * @tparam COST type of the cost of a path
+     */
+    template <typename COST>
+    struct ZeroHeuristic {
+        COST operator()(nodeid_t id, nodeid_t goal) const {
+            return 0;
+        }
+    };
+
+    /**
+     * @brief a reusable Dijkstra/A* search over a graph
+     *
+     * The search is meant to be created once and queried many times: the state of each vertex (distance, parent, closed)
+     * is tagged with the number of the query which wrote it, so starting a new query takes \f$O(1)\f$ rather than
+     * \f$O(V)\f$. The heap is reset in \f$O(heap size)\f$ as well.
+     *
+     * The search supports several modes:
+     *  @li ::search(start, goal): single source, single target (A* if @c HEURISTIC is not ZeroHeuristic);
+     *  @li ::search(start, goals): one to many. The search stops once every goal has been reached;
+     *  @li ::searchAll(start): one to all;
+     *  @li ::searchUntil(start, lambda): early termination. @c lambda is called each time a vertex is expanded and it can stop the search;
+     *
+     * After a query, ::getDistance, ::getParent and ::getPath inspect the vertices reached.
+     *
+     * @code
+     * DijkstraSearch<AdjacentGraph<G, V, int>, long> dijkstra{graph};
+     * long distance = dijkstra.search(start, goal);
+     * if (distance != dijkstra.INFINITE_COST) {
+     *  auto path = dijkstra.getPath(goal);
+     * }
+     * @endcode
+     *
+     * The edges are scanned via cpp_utils::graphs::forEachOutEdge, so pass the concrete type of the graph as @c GRAPH.
+     * The payload of each edge is the weight of the edge: it needs to be non negative and convertible to @c COST.
+     *
+     * @tparam GRAPH type of the graph to search
+     * @tparam COST type of the cost of a path
+     * @tparam HEURISTIC callable accepting a vertex and the goal and returning an admissible and consistent estimate of the cost
+     *  from the vertex to the goal
+     * @tparam HEAP indexed heap of vertex ids sorted by cost (needs the interface of kway_min_id_heap)
+     */
+    template <typename GRAPH, typename COST, typename HEURISTIC = ZeroHeuristic<COST>, typename HEAP = kway_min_id_heap<nodeid_t, COST, 4>>
+    class DijkstraSearch {
+    public:
+        using This = DijkstraSearch<GRAPH, COST, HEURISTIC, HEAP>;
+        /**
+         * @brief the distance of a vertex not reached by the last query
+         *
+         */
+        static constexpr COST INFINITE_COST = std::numeric_limits<COST>::max();
+    private:
+        /**
+         * @brief what the search knows about a vertex
+         *
+         * The fields are meaningful only if ::query is the query currently running
+         */
+        struct VertexState {
+            uint32_t query;
+            bool closed;
+            bool goal;
+            COST distance;
+            nodeid_t parent;
+        };
+    private:
+        const GRAPH& graph;
+        HEURISTIC heuristic;
+        HEAP heap;
+        std::vector<VertexState> states;
+        /**
+         * @brief the number of the query running (or which has just run). 0 is never used
+         *
+         */
+        uint32_t query;
+        nodeid_t start;
+        size_t expandedVertices;
+    public:
+        /**
+         * @brief setup a search over a graph
+         *
+         * @param graph the graph to search. It needs to outlive the search and not to change its vertices
+         * @param heuristic the heuristic to use in ::search(start, goal)
+         */
+        explicit DijkstraSearch(const GRAPH& graph, HEURISTIC heuristic = HEURISTIC{}): graph{graph}, heuristic{heuristic},
+            heap{graph.numberOfVertices()}, states(graph.numberOfVertices(), VertexState{0, false, false, INFINITE_COST, 0}),
+            query{0}, start{0}, expandedVertices{0} {
+
+        }
+        DijkstraSearch(const This& o) = default;
+        DijkstraSearch(This&& o) = default;
+        virtual ~DijkstraSearch() {
+
+        }
+    public:
+        /**
+         * @brief cost of the shortest path between 2 vertices
+         *
+         * The search stops as soon as @c goal is expanded
+         *
+         * @param start the source of the path
+         * @param goal the target of the path
+         * @return COST the cost of the shortest path. ::INFINITE_COST if @c goal is unreachable
+         */
+        COST search(nodeid_t start, nodeid_t goal) {
+            this->run<true>(start, goal, [&](nodeid_t id, COST distance) { return id == goal; });
+            return this->getDistance(goal);
+        }
+        /**
+         * @brief cost of the shortest paths between a vertex and several others
+         *
+         * The search stops as soon as each goal has been expanded
+         *
+         * @param start the source of the paths
+         * @param goals the targets of the paths
+         * @return std::vector<COST> the cell @c i contains the cost of the shortest path to `goals[i]`
+         */
+        std::vector<COST> search(nodeid_t start, const std::vector<nodeid_t>& goals) {
+            this->newQuery();
+            size_t remainingGoals = 0;
+            for (auto goal : goals) {
+                VertexState& state = this->getState(goal);
+                if (!state.goal) {
+                    state.goal = true;
+                    remainingGoals += 1;
+                }
+            }
+            this->run<false>(start, start, [&](nodeid_t id, COST distance) {
+                if (this->states[id].goal) {
+                    remainingGoals -= 1;
+                }
+                return remainingGoals == 0;
+            }, false);
+
+            std::vector<COST> result{};
+            result.reserve(goals.size());
+            for (auto goal : goals) {
+                result.push_back(this->getDistance(goal));
+            }
+            return result;
+        }
+        /**
+         * @brief cost of the shortest paths between a vertex and every other vertex
+         *
+         * @param start the source of the paths
+         */
+        void searchAll(nodeid_t start) {
+            this->run<false>(start, start, [&](nodeid_t id, COST distance) { return false; });
+        }
+        /**
+         * @brief a search which can be interrupted by the user
+         *
+         * @code
+         * //expand the vertices whose distance is at most 100
+         * dijkstra.searchUntil(start, [&](nodeid_t id, long distance) { return distance > 100; });
+         * @endcode
+         *
+         * @tparam LAMBDA callable accepting the vertex being expanded and its (final) distance from @c start. Returns
+         *  true if the search has to stop
+         * @param start the source of the search
+         * @param shouldStop function called each time a vertex is expanded, by increasing distance
+         */
+        template <typename LAMBDA>
+        void searchUntil(nodeid_t start, LAMBDA shouldStop) {
+            this->run<false>(start, start, shouldStop);
+        }
+    public:
+        /**
+         * @brief the distance of a vertex from the start of the last query
+         *
+         * @note
+         * the distance is the optimal one only if the vertex has been expanded (see ::isExpanded)
+         *
+         * @param id the vertex involved
+         * @return COST the distance of the vertex. ::INFINITE_COST if the last query has not reached it
+         */
+        COST getDistance(nodeid_t id) const {
+            const VertexState& state = this->states[id];
+            return state.query == this->query ? state.distance : INFINITE_COST;
+        }
+        /**
+         * @brief check if the last query has expanded a vertex
+         *
+         * @param id the vertex involved
+         * @return true if ::getDistance of @c id is optimal
+         * @return false otherwise
+         */
+        bool isExpanded(nodeid_t id) const {
+            const VertexState& state = this->states[id];
+            return state.query == this->query && state.closed;
+        }
+        /**
+         * @brief the predecessor of a vertex in the shortest path from the start of the last query
+         *
+         * @param id the vertex involved. It needs to be reached by the last query
+         * @return nodeid_t the predecessor of @c id. The start of the query has itself as predecessor
+         */
+        nodeid_t getParent(nodeid_t id) const {
+            if (this->getDistance(id) == INFINITE_COST) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"vertex", id, "has not been reached by the last search"};
+            }
+            return this->states[id].parent;
+        }
+        /**
+         * @brief the shortest path from the start of the last query to a vertex
+         *
+         * @param goal the last vertex of the path. It needs to be reached by the last query
+         * @return std::vector<nodeid_t> the vertices of the path, from the start to @c goal
+         */
+        std::vector<nodeid_t> getPath(nodeid_t goal) const {
+            std::vector<nodeid_t> result{};
+            nodeid_t id = goal;
+            result.push_back(id);
+            while (id != this->start) {
+                id = this->getParent(id);
+                result.push_back(id);
+            }
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+        /**
+         * @brief number of vertices expanded by the last query
+         *
+         * @return size_t the number of vertices expanded
+         */
+        size_t getExpandedVertices() const {
+            return this->expandedVertices;
+        }
+    private:
+        /**
+         * @brief invalidate the state of every vertex in \f$O(1)\f$
+         *
+         */
+        void newQuery() {
+            this->query += 1;
+            if (this->query == 0) {
+                //the counter wrapped around: the old tags may be mistaken for the new ones
+                for (auto& state : this->states) {
+                    state.query = 0;
+                }
+                this->query = 1;
+            }
+        }
+        /**
+         * @brief the state of a vertex, initialized if the current query has not touched it yet
+         *
+         */
+        VertexState& getState(nodeid_t id) {
+            VertexState& state = this->states[id];
+            if (state.query != this->query) {
+                state = VertexState{this->query, false, false, INFINITE_COST, id};
+            }
+            return state;
+        }
+        /**
+         * @brief the actual search
+         *
+         * @tparam USE_HEURISTIC true if the keys of the heap need to include the estimate of the cost to @c goal
+         * @param start the source of the search
+         * @param goal the target of the search (used only by the heuristic)
+         * @param shouldStop function called after each expansion. If it returns true, the search stops
+         * @param startNewQuery false if the caller has already called ::newQuery
+         */
+        template <bool USE_HEURISTIC, typename LAMBDA>
+        void run(nodeid_t start, nodeid_t goal, LAMBDA shouldStop, bool startNewQuery = true) {
+            if (startNewQuery) {
+                this->newQuery();
+            }
+            this->heap.cleanup();
+            this->start = start;
+            this->expandedVertices = 0;
+
+            VertexState& startState = this->getState(start);
+            startState.distance = 0;
+            startState.parent = start;
+            this->heap.pushOrDecrease(start, this->getKey(start, goal, 0, std::integral_constant<bool, USE_HEURISTIC>{}));
+
+            while (!this->heap.isEmpty()) {
+                nodeid_t id = this->heap.pop();
+                VertexState& state = this->states[id];
+                state.closed = true;
+                this->expandedVertices += 1;
+                const COST distance = state.distance;
+                if (shouldStop(id, distance)) {
+                    return;
+                }
+
+                forEachOutEdge(this->graph, id, [&](const auto& outEdge) {
+                    const nodeid_t sinkId = outEdge.getSinkId();
+                    VertexState& sinkState = this->getState(sinkId);
+                    if (sinkState.closed) {
+                        return;
+                    }
+                    const COST newDistance = distance + static_cast<COST>(outEdge.getPayload());
+                    if (newDistance < sinkState.distance) {
+                        sinkState.distance = newDistance;
+                        sinkState.parent = id;
+                        this->heap.pushOrDecrease(sinkId, this->getKey(sinkId, goal, newDistance, std::integral_constant<bool, USE_HEURISTIC>{}));
+                    }
+                });
+            }
+        }
+        COST getKey(nodeid_t id, nodeid_t goal, COST distance, std::true_type useHeuristic) const {
+            return distance + this->heuristic(id, goal);
+        }
+        COST getKey(nodeid_t id, nodeid_t goal, COST distance, std::false_type useHeuristic) const {
+            return distance;
+        }
+    };
+
+}
+
+#endif
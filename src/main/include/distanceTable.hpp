@@ -0,0 +1,139 @@
+#ifndef _CPP_UTILS_DISTANCETABLE_HEADER__
+#define _CPP_UTILS_DISTANCETABLE_HEADER__
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "igraph.hpp"
+#include "dijkstra.hpp"
+#include "parallel.hpp"
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief the distances between a set of sources and a set of targets
+     *
+     * The distances are stored in a flat array, row by row: the row @c i contains the distances from the source @c i
+     * to every target.
+     *
+     * @tparam COST type of the cost of a path
+     */
+    template <typename COST>
+    class DistanceTable {
+        using This = DistanceTable<COST>;
+    private:
+        std::size_t rows;
+        std::size_t columns;
+        std::vector<COST> distances;
+    public:
+        DistanceTable(std::size_t rows, std::size_t columns, COST value): rows{rows}, columns{columns}, distances(rows * columns, value) {
+
+        }
+        DistanceTable(const This& o) = default;
+        DistanceTable(This&& o) = default;
+        This& operator=(const This& o) = default;
+        This& operator=(This&& o) = default;
+        virtual ~DistanceTable() {
+
+        }
+    public:
+        std::size_t numberOfRows() const {
+            return this->rows;
+        }
+        std::size_t numberOfColumns() const {
+            return this->columns;
+        }
+        /**
+         * @brief the distance from the source @c row to the target @c column
+         *
+         */
+        const COST& get(std::size_t row, std::size_t column) const {
+            return this->distances[row * this->columns + column];
+        }
+        COST& get(std::size_t row, std::size_t column) {
+            return this->distances[row * this->columns + column];
+        }
+        /**
+         * @brief the first cell of the row @c row. The row contains ::numberOfColumns cells
+         *
+         */
+        const COST* getRow(std::size_t row) const {
+            return this->distances.data() + row * this->columns;
+        }
+        COST* getRow(std::size_t row) {
+            return this->distances.data() + row * this->columns;
+        }
+        /**
+         * @brief the whole table, row by row
+         *
+         */
+        const std::vector<COST>& getData() const {
+            return this->distances;
+        }
+    };
+
+    /**
+     * @brief compute the distances between several sources and several targets in parallel
+     *
+     * Each thread owns a DijkstraSearch (and so its heap and its vertex states), which is reused for all the sources
+     * the thread handles: a query costs only the vertices it touches. Threads pick the next source dynamically
+     * (see cpp_utils::parallelForEach), so sources far from the targets do not unbalance the work.
+     * Each search stops as soon as every target has been reached.
+     *
+     * @code
+     * auto table = computeDistanceTable<AdjacentGraph<G, V, int>, long>(graph, depots, depots);
+     * long d = table.get(i, j); //distance from depots[i] to depots[j]
+     * @endcode
+     *
+     * @tparam GRAPH type of the graph (pass the concrete one, see cpp_utils::graphs::forEachOutEdge)
+     * @tparam COST type of the cost of a path
+     * @param graph the graph where to compute the distances. It needs not to change while the function runs
+     * @param sources the sources of the paths. They are the rows of the table
+     * @param targets the targets of the paths. They are the columns of the table
+     * @param threads number of threads to use. If 0, we use cpp_utils::getDefaultNumberOfThreads
+     * @return DistanceTable<COST> the distances. Unreachable targets have DijkstraSearch::INFINITE_COST
+     */
+    template <typename GRAPH, typename COST>
+    DistanceTable<COST> computeDistanceTable(const GRAPH& graph, const std::vector<nodeid_t>& sources, const std::vector<nodeid_t>& targets, std::size_t threads = 0) {
+        using Search = DijkstraSearch<GRAPH, COST>;
+        if (threads == 0) {
+            threads = getDefaultNumberOfThreads();
+        }
+        threads = std::max<std::size_t>(1, std::min(threads, sources.size()));
+
+        DistanceTable<COST> result{sources.size(), targets.size(), Search::INFINITE_COST};
+        //searches are created by the threads themselves, so their memory is local to the thread using it
+        std::vector<std::unique_ptr<Search>> searches(threads);
+        parallelForEach(0, sources.size(), threads, [&](std::size_t threadId, std::size_t i) {
+            if (searches[threadId] == nullptr) {
+                searches[threadId].reset(new Search{graph});
+            }
+            auto distances = searches[threadId]->search(sources[i], targets);
+            std::copy(distances.begin(), distances.end(), result.getRow(i));
+        });
+        return result;
+    }
+
+    /**
+     * @brief compute the distances between every pair of vertices in parallel
+     *
+     * @tparam GRAPH type of the graph
+     * @tparam COST type of the cost of a path
+     * @param graph the graph where to compute the distances
+     * @param threads number of threads to use. If 0, we use cpp_utils::getDefaultNumberOfThreads
+     * @return DistanceTable<COST> the distances: the cell `(i, j)` is the distance from vertex @c i to vertex @c j
+     */
+    template <typename GRAPH, typename COST>
+    DistanceTable<COST> computeAllPairsDistances(const GRAPH& graph, std::size_t threads = 0) {
+        std::vector<nodeid_t> vertices(graph.numberOfVertices());
+        for (nodeid_t id=0; id<vertices.size(); ++id) {
+            vertices[id] = id;
+        }
+        return computeDistanceTable<GRAPH, COST>(graph, vertices, vertices, threads);
+    }
+
+}
+
+#endif
@@ -0,0 +1,465 @@
+#ifndef _CPP_UTILS_DYNAMICGRAPH_HEADER__
+#define _CPP_UTILS_DYNAMICGRAPH_HEADER__
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "igraph.hpp"
+#include "adjacentGraph.hpp"
+#include "exceptions.hpp"
+#include "iterator.hpp"
+#include "span.hpp"
+
+namespace cpp_utils::graphs {
+
+    template <typename G, typename V, typename E>
+    class DynamicGraph;
+
+    /**
+     * @brief an iterator over all the edges of a DynamicGraph, ordered by source
+     *
+     * @tparam G custom payload of the whole graph
+     * @tparam V custom payload of each vertex
+     * @tparam E custom payload of each edge
+     */
+    template <typename G, typename V, typename E>
+    class DynamicGraphEdgesIterator: public ::cpp_utils::AbstractConstIterator<Edge<E>&, Edge<E>*> {
+        typedef DynamicGraphEdgesIterator<G, V, E> This;
+    private:
+        const DynamicGraph<G, V, E>* graph;
+        iterator_state_t state;
+        nodeid_t vertex;
+        size_t move;
+        mutable Edge<E> tmp;
+    public:
+        DynamicGraphEdgesIterator(iterator_state_t state, const DynamicGraph<G, V, E>& graph): graph{&graph}, state{state}, vertex{0}, move{0}, tmp{} {
+            this->computeNext();
+        }
+        DynamicGraphEdgesIterator(const This& o) = default;
+        DynamicGraphEdgesIterator(This&& o) = default;
+        This& operator=(const This& o) = default;
+        This& operator=(This&& o) = default;
+        virtual ~DynamicGraphEdgesIterator() {
+
+        }
+        This& operator++() {
+            this->computeNext();
+            return *this;
+        }
+        cpp_utils::graphs::Edge<E>& operator*() const {
+            this->tmp = Edge<E>{this->vertex, this->graph->vertices[this->vertex].outEdges[this->move]};
+            return this->tmp;
+        }
+        cpp_utils::graphs::Edge<E>* operator->() const {
+            return &(this->operator*());
+        }
+    protected:
+        void computeNext() {
+            switch (this->state) {
+                case iterator_state_t::ENDED: {
+                    return;
+                }
+                case iterator_state_t::STARTED: {
+                    this->move += 1;
+                    //no break!
+                }
+                case iterator_state_t::NOT_INITIALIZED: {
+                    while (this->vertex < this->graph->numberOfVertices()) {
+                        if (this->move < this->graph->vertices[this->vertex].outEdges.size()) {
+                            this->state = iterator_state_t::STARTED;
+                            return;
+                        }
+                        this->vertex += 1;
+                        this->move = 0;
+                    }
+                    this->state = iterator_state_t::ENDED;
+                    return;
+                }
+            }
+        }
+    public:
+        bool isEnded() const {
+            return this->state == iterator_state_t::ENDED;
+        }
+        bool isEqualTo(const AbstractConstIterator<Edge<E>&, Edge<E>*>* o) const {
+            auto b = static_cast<const This*>(o);
+
+            if (this->isEnded() && b->isEnded()) {
+                return true;
+            } else if (this->isEnded() || b->isEnded()) {
+                return false;
+            } else {
+                return this->vertex == b->vertex && this->move == b->move;
+            }
+        }
+    };
+
+    /**
+     * @brief a graph meant to be modified: edges can be added and removed in \f$O(1)\f$
+     *
+     * Each vertex owns 2 vectors: its out edges (sink and payload) and its in edges (source and position of the edge among
+     * the out edges of the source). Each out edge knows its position among the in edges of its sink as well, so both
+     * lists can be updated in \f$O(1)\f$ when an edge goes away: the removed edge is replaced by the last one of the list.
+     * Hence:
+     *  @li ::addEdge takes amortized \f$O(1)\f$;
+     *  @li ::removeOutEdge takes \f$O(1)\f$, ::removeEdge \f$O(outdegree)\f$ since it needs to look for the edge first;
+     *  @li ::getOutDegree, ::getInDegree, ::getOutEdge take \f$O(1)\f$, ::getEdge and ::hasEdge \f$O(outdegree)\f$;
+     *
+     * Unlike ListGraph, edges can be added in any order.
+     *
+     * @note
+     * removing an edge changes the moveid_t of the last out edge of its source
+     *
+     * Once the graph does not need to change anymore, ::freeze turns it into an AdjacentGraph, which is faster to visit:
+     * @code
+     * DynamicGraph<int, int, int> g{0};
+     * ...
+     * AdjacentGraph<int, int, int> frozen = g.freeze();
+     * @endcode
+     *
+     * @tparam G custom payload of the whole graph
+     * @tparam V custom payload of each vertex
+     * @tparam E custom payload of each edge
+     */
+    template <typename G, typename V, typename E>
+    class DynamicGraph: public IVertexExtendableGraph<G, V, E> {
+    public:
+        using This = DynamicGraph<G, V, E>;
+        using const_vertex_iterator = PairNumberContainerBasedConstIterator<std::vector<V>, nodeid_t, V>;
+        friend class DynamicGraphEdgesIterator<G, V, E>;
+    private:
+        /**
+         * @brief an in edge of a vertex
+         *
+         */
+        struct DynamicInEdge {
+            nodeid_t sourceId;
+            /**
+             * @brief the position of the edge among the out edges of ::sourceId
+             *
+             */
+            uint32_t outIndex;
+        };
+        /**
+         * @brief the edges touching a vertex
+         *
+         */
+        struct VertexAdjacency {
+            std::vector<OutEdge<E>> outEdges;
+            /**
+             * @brief for each out edge, its position among the in edges of its sink
+             *
+             */
+            std::vector<uint32_t> outEdgesInIndex;
+            std::vector<DynamicInEdge> inEdges;
+        };
+    private:
+        G payload;
+        std::vector<V> vertexPayload;
+        std::vector<VertexAdjacency> vertices;
+        size_t edges;
+    public:
+        /**
+         * @brief create an empty graph
+         *
+         * @param payload value attached to the whole graph
+         */
+        DynamicGraph(const G& payload): payload{payload}, vertexPayload{}, vertices{}, edges{0} {
+
+        }
+        /**
+         * @brief copy another graph
+         *
+         * @param other another graph. It's mandatory that the ids of `other` are **contiguous** and they start from 0!
+         */
+        DynamicGraph(const IImmutableGraph<G,V,E>& other): DynamicGraph{other.getPayload()} {
+            for (nodeid_t id=0; id<other.numberOfVertices(); ++id) {
+                this->addVertex(other.getVertex(id));
+            }
+            other.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                this->addEdge(sourceId, sinkId, payload);
+            });
+        }
+        DynamicGraph(const This& o) = default;
+        DynamicGraph(This&& o) = default;
+        This& operator=(const This& o) = default;
+        This& operator=(This&& o) = default;
+        virtual ~DynamicGraph() {
+
+        }
+    public:
+        virtual size_t size() const {
+            return this->vertexPayload.size();
+        }
+        virtual size_t numberOfVertices() const {
+            return this->vertexPayload.size();
+        }
+        virtual size_t numberOfEdges() const {
+            return this->edges;
+        }
+        virtual typename IImmutableGraph<G,V,E>::const_vertex_iterator beginVertices() const {
+            auto it = new const_vertex_iterator{0, this->vertexPayload};
+            return typename IImmutableGraph<G,V,E>::const_vertex_iterator{it};
+        }
+        virtual typename IImmutableGraph<G,V,E>::const_vertex_iterator endVertices() const {
+            auto it = new const_vertex_iterator{-1, this->vertexPayload};
+            return typename IImmutableGraph<G,V,E>::const_vertex_iterator{it};
+        }
+        virtual typename IImmutableGraph<G,V,E>::const_edge_iterator beginEdges() const {
+            return typename IImmutableGraph<G,V,E>::const_edge_iterator{new DynamicGraphEdgesIterator<G, V, E>{iterator_state_t::NOT_INITIALIZED, *this}};
+        }
+        virtual typename IImmutableGraph<G,V,E>::const_edge_iterator endEdges() const {
+            return typename IImmutableGraph<G,V,E>::const_edge_iterator{new DynamicGraphEdgesIterator<G, V, E>{iterator_state_t::ENDED, *this}};
+        }
+        virtual void forEachEdge(const std::function<void(nodeid_t, nodeid_t, const E&)>& lambda) const {
+            for (nodeid_t sourceId=0; sourceId<this->vertices.size(); ++sourceId) {
+                for (const auto& outEdge : this->vertices[sourceId].outEdges) {
+                    lambda(sourceId, outEdge.getSinkId(), outEdge.getPayload());
+                }
+            }
+        }
+        virtual const V& getVertex(nodeid_t id) const {
+            return this->vertexPayload[id];
+        }
+        virtual bool containsVertex(nodeid_t id) const {
+            return id < this->vertexPayload.size();
+        }
+        virtual const E& getEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            int i = this->findOutEdge(sourceId, sinkId);
+            if (i >= 0) {
+                return this->vertices[sourceId].outEdges[i].getPayload();
+            }
+            throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, This>{sinkId, *this};
+        }
+        virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId, const E& payload) const {
+            for (const auto& outEdge : this->vertices[sourceId].outEdges) {
+                if (outEdge.getSinkId() == sinkId && outEdge.getPayload() == payload) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            return this->findOutEdge(sourceId, sinkId) >= 0;
+        }
+        virtual const G& getPayload() const {
+            return this->payload;
+        }
+        virtual G& getPayload() {
+            return this->payload;
+        }
+        virtual size_t getInDegree(nodeid_t id) const {
+            return this->vertices[id].inEdges.size();
+        }
+        virtual size_t getOutDegree(nodeid_t id) const {
+            return this->vertices[id].outEdges.size();
+        }
+        virtual size_t getDegree(nodeid_t id) const {
+            return this->getInDegree(id) + this->getOutDegree(id);
+        }
+        virtual bool hasSuccessors(nodeid_t id) const {
+            return !this->vertices[id].outEdges.empty();
+        }
+        virtual bool hasPredecessors(nodeid_t id) const {
+            return !this->vertices[id].inEdges.empty();
+        }
+        virtual OutEdge<E> getOutEdge(nodeid_t id, moveid_t index) const {
+            return this->vertices[id].outEdges[index];
+        }
+        virtual bool hasEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            return this->findOutEdge(sourceId, sinkId) >= 0;
+        }
+        virtual std::vector<InEdge<E>> getInEdges(nodeid_t id) const {
+            std::vector<InEdge<E>> result{};
+            result.reserve(this->vertices[id].inEdges.size());
+            for (const auto& inEdge : this->vertices[id].inEdges) {
+                result.push_back(InEdge<E>{inEdge.sourceId, this->vertices[inEdge.sourceId].outEdges[inEdge.outIndex].getPayload()});
+            }
+            return result;
+        }
+        virtual std::vector<OutEdge<E>> getOutEdges(nodeid_t id) const {
+            return this->vertices[id].outEdges;
+        }
+        virtual bool isEmpty() const {
+            return this->vertexPayload.empty();
+        }
+        virtual nodeid_t getLastVertexId() const {
+            return this->vertexPayload.size() - 1;
+        }
+        virtual MemoryConsumption getByteMemoryOccupied() const {
+            size_t result = sizeof(*this);
+            result += sizeof(V) * this->vertexPayload.capacity();
+            result += sizeof(VertexAdjacency) * this->vertices.capacity();
+            for (const auto& adjacency : this->vertices) {
+                result += sizeof(OutEdge<E>) * adjacency.outEdges.capacity();
+                result += sizeof(uint32_t) * adjacency.outEdgesInIndex.capacity();
+                result += sizeof(DynamicInEdge) * adjacency.inEdges.capacity();
+            }
+            return MemoryConsumption{result, MemoryConsumptionEnum::BYTE};
+        }
+    public:
+        /**
+         * @brief the out edges of a vertex, without copying them (see cpp_utils::graphs::forEachOutEdge)
+         *
+         * @note
+         * the range is invalidated if the graph is modified
+         *
+         * @param id the vertex involved
+         * @return ConstSpan<OutEdge<E>> the out edges of @c id, in the same order of ::getOutEdge
+         */
+        ConstSpan<OutEdge<E>> outEdgeRange(nodeid_t id) const {
+            const auto& outEdges = this->vertices[id].outEdges;
+            return ConstSpan<OutEdge<E>>{outEdges.data(), outEdges.size()};
+        }
+    public:
+        virtual void changeVertexPayload(nodeid_t vertexId, const V& payload) {
+            this->vertexPayload[vertexId] = payload;
+        }
+        virtual void changeWeightEdge(nodeid_t sourceId, nodeid_t sinkId, const E& newPayload) {
+            int i = this->findOutEdge(sourceId, sinkId);
+            if (i >= 0) {
+                this->vertices[sourceId].outEdges[i].setPayload(newPayload);
+                return;
+            }
+            throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, This>{sinkId, *this};
+        }
+        virtual void changeWeightOutEdge(nodeid_t sourceId, moveid_t index, const E& newPayload) {
+            this->vertices[sourceId].outEdges[index].setPayload(newPayload);
+        }
+    public:
+        virtual nodeid_t addVertex(const V& payload) {
+            this->vertexPayload.push_back(payload);
+            this->vertices.emplace_back();
+            return this->vertexPayload.size() - 1;
+        }
+        /**
+         * @brief add an edge. Parallel edges are allowed
+         *
+         * Takes amortized \f$O(1)\f$
+         *
+         * @param sourceId the source of the new edge. It needs to be in the graph
+         * @param sinkId the sink of the new edge. It needs to be in the graph
+         * @param payload the payload of the new edge
+         */
+        virtual void addEdge(nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+            if (sourceId >= this->vertices.size() || sinkId >= this->vertices.size()) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"edge", sourceId, "->", sinkId, "but the graph has", this->vertices.size(), "vertices"};
+            }
+            VertexAdjacency& source = this->vertices[sourceId];
+            VertexAdjacency& sink = this->vertices[sinkId];
+            source.outEdges.push_back(OutEdge<E>{sinkId, payload});
+            source.outEdgesInIndex.push_back(static_cast<uint32_t>(sink.inEdges.size()));
+            sink.inEdges.push_back(DynamicInEdge{sourceId, static_cast<uint32_t>(source.outEdges.size() - 1)});
+            this->edges += 1;
+        }
+        /**
+         * @brief remove every edge going from @c sourceId to @c sinkId
+         *
+         * Takes \f$O(outdegree)\f$. Removing an absent edge does nothing
+         *
+         * @param sourceId the source of the edges to remove
+         * @param sinkId the sink of the edges to remove
+         */
+        virtual void removeEdge(nodeid_t sourceId, nodeid_t sinkId) {
+            const auto& outEdges = this->vertices[sourceId].outEdges;
+            //backwards, so the edges moved in place of the removed ones have been checked already
+            for (size_t i=outEdges.size(); i>0; --i) {
+                if (outEdges[i - 1].getSinkId() == sinkId) {
+                    this->removeOutEdge(sourceId, static_cast<moveid_t>(i - 1));
+                }
+            }
+        }
+        /**
+         * @brief remove an out edge of a vertex in \f$O(1)\f$
+         *
+         * The last out edge of @c sourceId takes the moveid_t of the removed edge
+         *
+         * @param sourceId the source of the edge to remove
+         * @param index the index of the edge among the out edges of @c sourceId
+         */
+        void removeOutEdge(nodeid_t sourceId, moveid_t index) {
+            VertexAdjacency& source = this->vertices[sourceId];
+            const nodeid_t sinkId = source.outEdges[index].getSinkId();
+
+            //remove the in edge from the sink
+            std::vector<DynamicInEdge>& inEdges = this->vertices[sinkId].inEdges;
+            const uint32_t inIndex = source.outEdgesInIndex[index];
+            if (inIndex + 1 != inEdges.size()) {
+                inEdges[inIndex] = inEdges.back();
+                this->vertices[inEdges[inIndex].sourceId].outEdgesInIndex[inEdges[inIndex].outIndex] = inIndex;
+            }
+            inEdges.pop_back();
+
+            //remove the out edge from the source
+            const size_t last = source.outEdges.size() - 1;
+            if (index != last) {
+                source.outEdges[index] = ::std::move(source.outEdges[last]);
+                source.outEdgesInIndex[index] = source.outEdgesInIndex[last];
+                this->vertices[source.outEdges[index].getSinkId()].inEdges[source.outEdgesInIndex[index]].outIndex = index;
+            }
+            source.outEdges.pop_back();
+            source.outEdgesInIndex.pop_back();
+            this->edges -= 1;
+        }
+        virtual void removeAllEdges() {
+            for (auto& adjacency : this->vertices) {
+                adjacency.outEdges.clear();
+                adjacency.outEdgesInIndex.clear();
+                adjacency.inEdges.clear();
+            }
+            this->edges = 0;
+        }
+        /**
+         * @brief turn this graph into an AdjacentGraph
+         *
+         * The payloads are moved, not copied: the vertex payloads are moved as a whole and each edge payload is moved once
+         * into the edge array of the new graph. The out edges of each vertex keep their order.
+         *
+         * @post
+         *  @li this graph has no vertices and no edges left;
+         *
+         * @param withInEdgesIndex if true, the new graph has the reverse index of the in edges (see AdjacentGraph::finalizeGraph)
+         * @return AdjacentGraph<G, V, E> a graph with the same vertices and edges
+         */
+        AdjacentGraph<G, V, E> freeze(bool withInEdgesIndex = true) {
+            std::vector<OutEdge<E>> outEdges{};
+            outEdges.reserve(this->edges);
+            std::vector<int> outEdgesOfVertexBegin{};
+            outEdgesOfVertexBegin.reserve(this->vertices.size() + 1);
+            for (auto& adjacency : this->vertices) {
+                outEdgesOfVertexBegin.push_back(static_cast<int>(outEdges.size()));
+                for (auto& outEdge : adjacency.outEdges) {
+                    outEdges.push_back(::std::move(outEdge));
+                }
+                //release the memory as we go, so the peak is not twice the graph
+                adjacency = VertexAdjacency{};
+            }
+            outEdgesOfVertexBegin.push_back(static_cast<int>(outEdges.size()));
+
+            AdjacentGraph<G, V, E> result{::std::move(this->payload), ::std::move(this->vertexPayload), ::std::move(outEdges), ::std::move(outEdgesOfVertexBegin), withInEdgesIndex};
+            this->vertexPayload.clear();
+            this->vertices.clear();
+            this->edges = 0;
+            return result;
+        }
+    private:
+        /**
+         * @brief the index of the first out edge from @c sourceId to @c sinkId
+         *
+         * @return int the index of the edge among the out edges of @c sourceId, -1 if there is no such edge
+         */
+        int findOutEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            const auto& outEdges = this->vertices[sourceId].outEdges;
+            for (size_t i=0; i<outEdges.size(); ++i) {
+                if (outEdges[i].getSinkId() == sinkId) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,371 @@
+#ifndef _CPP_UTILS_FIRSTMOVEDATABASE_HEADER__
+#define _CPP_UTILS_FIRSTMOVEDATABASE_HEADER__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "igraph.hpp"
+#include "dijkstra.hpp"
+#include "exceptions.hpp"
+#include "MappedFile.hpp"
+#include "parallel.hpp"
+#include "span.hpp"
+#include "vertexOrdering.hpp"
+
+namespace cpp_utils::graphs {
+
+    class FirstMoveDatabase;
+
+}
+
+namespace cpp_utils::serializers {
+
+    /**
+     * @brief Save a first move database in a layout that can be mapped in memory by cpp_utils::graphs::FirstMoveDatabase
+     *
+     * @pre
+     *  @li @c f open with "wb";
+     *  @li @c f is empty: the database starts at the beginning of the file;
+     * @post
+     *  @li @c f modified;
+     *  @li @c f cursor modified;
+     *
+     * @param[in] f the file to save the database into
+     * @param[in] db the database to save
+     */
+    void saveToMappableFile(FILE* f, const cpp_utils::graphs::FirstMoveDatabase& db);
+
+}
+
+namespace cpp_utils::graphs::internal {
+
+    /**
+     * @brief version of the on-disk layout generated by cpp_utils::serializers::saveToMappableFile
+     *
+     * Increase it every time MappedFirstMoveDatabaseHeader or the section order change
+     */
+    constexpr uint32_t MAPPED_FIRST_MOVE_DATABASE_VERSION = 1;
+
+    /**
+     * @brief magic number every mappable first move database starts with
+     *
+     */
+    constexpr char MAPPED_FIRST_MOVE_DATABASE_MAGIC[8] = {'C', 'U', 'F', 'M', 'O', 'V', 'D', 'B'};
+
+    /**
+     * @brief first bytes of a file containing a first move database
+     *
+     * Every offset is in bytes from the beginning of the file and it is aligned to
+     * cpp_utils::graphs::internal::MAPPED_ADJACENT_GRAPH_ALIGNMENT. The file contains (in order):
+     * @li the header;
+     * @li the position of each vertex in the depth first order (`uint32_t[numberOfVertices]`);
+     * @li the runs begin of each source (`uint64_t[numberOfVertices + 1]`);
+     * @li the first target of each run (`uint32_t[numberOfRuns]`);
+     * @li the move of each run (`moveid_t[numberOfRuns]`);
+     */
+    struct MappedFirstMoveDatabaseHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t flags;
+        uint64_t numberOfVertices;
+        uint64_t numberOfRuns;
+        uint64_t orderOffset;
+        uint64_t runsBeginOffset;
+        uint64_t runStartsOffset;
+        uint64_t runMovesOffset;
+    };
+
+}
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief a compressed path database: for each pair of vertices, the first move of a shortest path between them
+     *
+     * The first move from @c source to @c target is the index of the out edge of @c source (see IImmutableGraph::getOutEdge)
+     * starting a shortest path to @c target. Extracting a path needs no search at all: we follow the first move of
+     * each vertex until we reach the target (see ::getPath).
+     *
+     * The table of each source is indexed by target and compressed with a run length encoding. Targets are not indexed
+     * by their id, but by their position in a depth first order of the graph: vertices close in such an order tend to
+     * share the same first move, so the runs are long. A lookup is a binary search among the runs of the source.
+     *
+     * The database can be built (in parallel) from a graph or mapped from a file generated by
+     * cpp_utils::serializers::saveToMappableFile. Mapping only validates the index of the runs of each vertex: the runs
+     * themselves are read when a lookup needs them:
+     *
+     * @code
+     * FirstMoveDatabase db{graph};
+     * FILE* f = fopen("cpd.dat", "wb");
+     * cpp_utils::serializers::saveToMappableFile(f, db);
+     * fclose(f);
+     *
+     * FirstMoveDatabase mapped{boost::filesystem::path{"cpd.dat"}};
+     * auto path = mapped.getPath(graph, start, goal);
+     * @endcode
+     *
+     * @note
+     * the database needs \f$O(V^2)\f$ time to be built, since it runs a Dijkstra search from every vertex
+     */
+    class FirstMoveDatabase {
+        using This = FirstMoveDatabase;
+    public:
+        /**
+         * @brief the first move towards an unreachable target (or towards the source itself)
+         *
+         */
+        static constexpr moveid_t NO_MOVE = std::numeric_limits<moveid_t>::max();
+    private:
+        /**
+         * @brief the file the database is mapped from. nullptr if the database is in memory
+         *
+         */
+        std::unique_ptr<MappedFile> file;
+        std::vector<uint32_t> ownedOrder;
+        std::vector<uint64_t> ownedRunsBegin;
+        std::vector<uint32_t> ownedRunStarts;
+        std::vector<moveid_t> ownedRunMoves;
+        /**
+         * @brief cell @c i is the position of vertex @c i in the depth first order
+         *
+         */
+        ConstSpan<uint32_t> order;
+        /**
+         * @brief the runs of the source @c i are in `runStarts[runsBegin[i]..runsBegin[i+1]]`
+         *
+         */
+        ConstSpan<uint64_t> runsBegin;
+        /**
+         * @brief position (in the depth first order) of the first target of each run
+         *
+         */
+        ConstSpan<uint32_t> runStarts;
+        /**
+         * @brief the first move shared by the targets of each run
+         *
+         */
+        ConstSpan<moveid_t> runMoves;
+    public:
+        /**
+         * @brief build the database of a graph
+         *
+         * @tparam GRAPH type of the graph (pass the concrete one, see cpp_utils::graphs::forEachOutEdge)
+         * @param graph the graph to consider. The payload of each edge is its weight and it needs to be non negative
+         * @param threads number of threads to use. If 0, we use cpp_utils::getDefaultNumberOfThreads
+         * @throw cpp_utils::exceptions::InvalidArgumentException if @c graph has too many vertices or a vertex has too many out edges
+         */
+        template <typename GRAPH>
+        explicit FirstMoveDatabase(const GRAPH& graph, size_t threads = 0): file{nullptr} {
+            using E = std::decay_t<decltype(graph.getOutEdge(0, 0).getPayload())>;
+            using COST = std::conditional_t<std::is_integral<E>::value, long long, double>;
+            using Search = DijkstraSearch<GRAPH, COST>;
+            struct Run {
+                uint32_t start;
+                moveid_t move;
+            };
+
+            const size_t vertices = graph.numberOfVertices();
+            if (vertices >= std::numeric_limits<uint32_t>::max()) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"the graph can contain at most", std::numeric_limits<uint32_t>::max() - 1, "vertices, but we have", vertices};
+            }
+            for (nodeid_t id=0; id<vertices; ++id) {
+                if (graph.getOutDegree(id) >= NO_MOVE) {
+                    throw cpp_utils::exceptions::InvalidArgumentException{"vertex", id, "has", graph.getOutDegree(id), "out edges, more than", NO_MOVE - 1};
+                }
+            }
+
+            auto fromNewToOld = getDFSOrder(graph);
+            this->ownedOrder.resize(vertices);
+            for (nodeid_t i=0; i<vertices; ++i) {
+                this->ownedOrder[fromNewToOld[i]] = static_cast<uint32_t>(i);
+            }
+
+            if (threads == 0) {
+                threads = getDefaultNumberOfThreads();
+            }
+            threads = std::max<size_t>(1, std::min(threads, vertices));
+            std::vector<std::vector<Run>> runs(vertices);
+            //the state of each thread, created by the thread itself
+            struct Worker {
+                Search search;
+                std::vector<nodeid_t> expanded;
+                std::vector<moveid_t> firstMoves;
+                std::vector<moveid_t> table;
+            };
+            std::vector<std::unique_ptr<Worker>> workers(threads);
+            parallelForEach(0, vertices, threads, [&](size_t threadId, size_t i) {
+                if (workers[threadId] == nullptr) {
+                    workers[threadId].reset(new Worker{Search{graph}, std::vector<nodeid_t>{}, std::vector<moveid_t>(vertices), std::vector<moveid_t>(vertices)});
+                }
+                Worker& worker = *workers[threadId];
+                const nodeid_t source = static_cast<nodeid_t>(i);
+
+                //the vertices by increasing distance: the parent of a vertex always comes before it
+                worker.expanded.clear();
+                worker.search.searchUntil(source, [&](nodeid_t id, COST distance) {
+                    worker.expanded.push_back(id);
+                    return false;
+                });
+
+                std::fill(worker.table.begin(), worker.table.end(), NO_MOVE);
+                for (size_t j=1; j<worker.expanded.size(); ++j) {
+                    const nodeid_t id = worker.expanded[j];
+                    const nodeid_t parent = worker.search.getParent(id);
+                    const moveid_t move = (parent == source) ? getLightestMove(graph, source, id) : worker.firstMoves[parent];
+                    worker.firstMoves[id] = move;
+                    worker.table[this->ownedOrder[id]] = move;
+                }
+                //we never look up the source in its own table, so it can extend whichever run is next to it
+                const uint32_t sourcePosition = this->ownedOrder[source];
+                if (sourcePosition > 0) {
+                    worker.table[sourcePosition] = worker.table[sourcePosition - 1];
+                } else if (vertices > 1) {
+                    worker.table[sourcePosition] = worker.table[sourcePosition + 1];
+                }
+
+                std::vector<Run>& sourceRuns = runs[source];
+                for (uint32_t target=0; target<vertices; ++target) {
+                    if (target == 0 || worker.table[target] != worker.table[target - 1]) {
+                        sourceRuns.push_back(Run{target, worker.table[target]});
+                    }
+                }
+                sourceRuns.shrink_to_fit();
+            });
+
+            this->ownedRunsBegin.reserve(vertices + 1);
+            uint64_t totalRuns = 0;
+            for (auto& sourceRuns : runs) {
+                this->ownedRunsBegin.push_back(totalRuns);
+                totalRuns += sourceRuns.size();
+            }
+            this->ownedRunsBegin.push_back(totalRuns);
+            this->ownedRunStarts.reserve(totalRuns);
+            this->ownedRunMoves.reserve(totalRuns);
+            for (auto& sourceRuns : runs) {
+                for (auto& run : sourceRuns) {
+                    this->ownedRunStarts.push_back(run.start);
+                    this->ownedRunMoves.push_back(run.move);
+                }
+                sourceRuns = std::vector<Run>{};
+            }
+            this->useOwnedArrays();
+        }
+        /**
+         * @brief map a database generated by cpp_utils::serializers::saveToMappableFile
+         *
+         * @param path the file containing the database
+         * @throw cpp_utils::exceptions::InvalidFormatException if the file is not a first move database, or it is truncated or corrupted
+         */
+        explicit FirstMoveDatabase(const boost::filesystem::path& path);
+        FirstMoveDatabase(const This& o) = delete;
+        FirstMoveDatabase(This&& o) = default;
+        This& operator =(const This& o) = delete;
+        This& operator =(This&& o) = default;
+        virtual ~FirstMoveDatabase() {
+
+        }
+    public:
+        size_t numberOfVertices() const {
+            return this->order.size();
+        }
+        /**
+         * @brief total number of runs in the tables of all the sources
+         *
+         * Without compression, the database would contain ::numberOfVertices squared moves
+         */
+        size_t numberOfRuns() const {
+            return this->runStarts.size();
+        }
+        /**
+         * @brief check if the database is mapped from a file
+         *
+         */
+        bool isMapped() const {
+            return this->file != nullptr;
+        }
+        /**
+         * @brief the first move of a shortest path between 2 vertices
+         *
+         * @param source the first vertex of the path
+         * @param target the last vertex of the path
+         * @return moveid_t the index of the out edge of @c source to follow. ::NO_MOVE if @c source is @c target or
+         *  if @c target is unreachable
+         */
+        moveid_t getFirstMove(nodeid_t source, nodeid_t target) const {
+            if (source == target) {
+                return NO_MOVE;
+            }
+            const uint32_t* begin = this->runStarts.data() + this->runsBegin.data()[source];
+            const uint32_t* end = this->runStarts.data() + this->runsBegin.data()[source + 1];
+            //the first run of each source starts at 0, so there is always a run before the upper bound
+            const uint32_t* run = std::upper_bound(begin, end, this->order.data()[target]) - 1;
+            return this->runMoves.data()[run - this->runStarts.data()];
+        }
+        /**
+         * @brief a shortest path between 2 vertices
+         *
+         * @tparam GRAPH type of the graph
+         * @param graph the graph the database has been built from
+         * @param source the first vertex of the path
+         * @param target the last vertex of the path
+         * @return std::vector<nodeid_t> the vertices of the path from @c source to @c target. Empty if @c target is unreachable
+         * @throw cpp_utils::exceptions::ImpossibleException if @c graph is not the one the database has been built from
+         */
+        template <typename GRAPH>
+        std::vector<nodeid_t> getPath(const GRAPH& graph, nodeid_t source, nodeid_t target) const {
+            std::vector<nodeid_t> result{};
+            result.push_back(source);
+            nodeid_t id = source;
+            while (id != target) {
+                const moveid_t move = this->getFirstMove(id, target);
+                if (move == NO_MOVE) {
+                    return std::vector<nodeid_t>{};
+                }
+                id = graph.getOutEdge(id, move).getSinkId();
+                result.push_back(id);
+                if (result.size() > this->numberOfVertices()) {
+                    throw cpp_utils::exceptions::ImpossibleException{"the path from", source, "to", target, "has a loop: the database does not belong to the graph"};
+                }
+            }
+            return result;
+        }
+    private:
+        /**
+         * @brief point the spans to the arrays owned by the database
+         *
+         */
+        void useOwnedArrays() {
+            this->order = ConstSpan<uint32_t>{this->ownedOrder.data(), this->ownedOrder.size()};
+            this->runsBegin = ConstSpan<uint64_t>{this->ownedRunsBegin.data(), this->ownedRunsBegin.size()};
+            this->runStarts = ConstSpan<uint32_t>{this->ownedRunStarts.data(), this->ownedRunStarts.size()};
+            this->runMoves = ConstSpan<moveid_t>{this->ownedRunMoves.data(), this->ownedRunMoves.size()};
+        }
+        /**
+         * @brief the lightest out edge from @c source to @c sink, the one a Dijkstra search follows
+         *
+         */
+        template <typename GRAPH>
+        static moveid_t getLightestMove(const GRAPH& graph, nodeid_t source, nodeid_t sink) {
+            moveid_t result = NO_MOVE;
+            moveid_t move = 0;
+            forEachOutEdge(graph, source, [&](const auto& outEdge) {
+                if (outEdge.getSinkId() == sink && (result == NO_MOVE || outEdge.getPayload() < graph.getOutEdge(source, result).getPayload())) {
+                    result = move;
+                }
+                move += 1;
+            });
+            return result;
+        }
+    private:
+        friend void cpp_utils::serializers::saveToMappableFile(FILE* f, const This& db);
+    };
+
+}
+
+#endif
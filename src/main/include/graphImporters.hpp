@@ -0,0 +1,498 @@
+#ifndef _CPP_UTILS_GRAPH_IMPORTERS_HEADER__
+#define _CPP_UTILS_GRAPH_IMPORTERS_HEADER__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "igraph.hpp"
+#include "adjacentGraph.hpp"
+#include "exceptions.hpp"
+#include "MappedFile.hpp"
+#include "span.hpp"
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief an edge of a raw binary edge list, as stored in the file
+     *
+     * The file is just a sequence of these records, in the native byte order and layout (there is no header).
+     *
+     * @tparam E type of the weight of an edge
+     */
+    template <typename E>
+    struct BinaryEdgeRecord {
+        uint32_t sourceId;
+        uint32_t sinkId;
+        E payload;
+    };
+
+}
+
+namespace cpp_utils::serializers {
+
+    /**
+     * Save the edges of a graph as a raw binary edge list (see cpp_utils::graphs::importBinaryEdgeList)
+     *
+     * @pre
+     *  @li @c f open with "wb";
+     * @post
+     *  @li @c f modified;
+     *  @li @c f cursor modified;
+     *
+     * @param[in] f the file to save the edges into
+     * @param[in] graph the graph whose edges we need to save. Ids need to fit in 32 bits
+     */
+    template <typename G, typename V, typename E>
+    void saveToBinaryEdgeList(FILE* f, const cpp_utils::graphs::IImmutableGraph<G, V, E>& graph) {
+        static_assert(std::is_trivially_copyable<E>::value, "edge payload needs to be trivially copyable to be saved");
+        std::vector<cpp_utils::graphs::BinaryEdgeRecord<E>> buffer{};
+        buffer.reserve(4096);
+        auto flush = [&]() {
+            if (std::fwrite(buffer.data(), sizeof(cpp_utils::graphs::BinaryEdgeRecord<E>), buffer.size(), f) != buffer.size()) {
+                throw cpp_utils::exceptions::FileOpeningException{recoverFilename(f)};
+            }
+            buffer.clear();
+        };
+        graph.forEachEdge([&](cpp_utils::graphs::nodeid_t sourceId, cpp_utils::graphs::nodeid_t sinkId, const E& payload) {
+            buffer.push_back(cpp_utils::graphs::BinaryEdgeRecord<E>{static_cast<uint32_t>(sourceId), static_cast<uint32_t>(sinkId), payload});
+            if (buffer.size() == buffer.capacity()) {
+                flush();
+            }
+        });
+        flush();
+    }
+
+}
+
+namespace cpp_utils::graphs::internal {
+
+    /**
+     * @brief a hand written reader of the lines of a text file mapped in memory
+     *
+     * It keeps track of the current line, so that errors can tell where they are. Every number is parsed by hand: there
+     * are no streams, no locales and no allocations involved.
+     */
+    class GraphTextReader {
+    private:
+        const boost::filesystem::path& path;
+        const char* current;
+        const char* end;
+        size_t line;
+    public:
+        GraphTextReader(const MappedFile& file): path{file.getPath()}, current{file.getData()}, end{file.getData() + file.size()}, line{1} {
+
+        }
+    public:
+        size_t getLine() const {
+            return this->line;
+        }
+        bool isOver() const {
+            return this->current == this->end;
+        }
+        /**
+         * @brief the next character of the current line, without consuming it
+         *
+         * @return char the character. '\n' if the line (or the file) is over
+         */
+        char peek() const {
+            return (this->current == this->end) ? '\n' : *this->current;
+        }
+        void skipSpaces() {
+            while (this->current != this->end && (*this->current == ' ' || *this->current == '\t' || *this->current == '\r')) {
+                ++this->current;
+            }
+        }
+        /**
+         * @brief check if the current line has nothing left but spaces
+         *
+         */
+        bool isLineOver() {
+            this->skipSpaces();
+            return this->peek() == '\n';
+        }
+        /**
+         * @brief go to the beginning of the next line, ignoring whatever is left in the current one
+         *
+         */
+        void skipLine() {
+            const char* newLine = static_cast<const char*>(std::memchr(this->current, '\n', this->end - this->current));
+            if (newLine == nullptr) {
+                this->current = this->end;
+            } else {
+                this->current = newLine + 1;
+                this->line += 1;
+            }
+        }
+        /**
+         * @brief go to the beginning of the next line, requiring the current one to have nothing left
+         *
+         */
+        void endLine() {
+            if (!this->isLineOver()) {
+                this->fail("unexpected content at the end of the line");
+            }
+            this->skipLine();
+        }
+        /**
+         * @brief consume a word made of non space characters
+         *
+         * @param expected the word we expect
+         */
+        void expectWord(const char* expected) {
+            this->skipSpaces();
+            const size_t length = std::strlen(expected);
+            if (static_cast<size_t>(this->end - this->current) < length || std::memcmp(this->current, expected, length) != 0) {
+                this->fail(std::string{"expected \""} + expected + "\"");
+            }
+            this->current += length;
+            if (this->peek() != ' ' && this->peek() != '\t' && this->peek() != '\r' && this->peek() != '\n') {
+                this->fail(std::string{"expected \""} + expected + "\"");
+            }
+        }
+        /**
+         * @brief consume a non negative integer in the current line
+         *
+         * @param what what the number represents, used in the error message
+         */
+        uint64_t parseUnsigned(const char* what) {
+            this->skipSpaces();
+            uint64_t result = 0;
+            const char* start = this->current;
+            while (this->current != this->end && static_cast<unsigned char>(*this->current - '0') < 10) {
+                const uint64_t digit = *this->current - '0';
+                if (result > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+                    this->fail(std::string{what} + " is too large");
+                }
+                result = result * 10 + digit;
+                ++this->current;
+            }
+            if (start == this->current) {
+                this->fail(std::string{"expected "} + what);
+            }
+            return result;
+        }
+        /**
+         * @brief consume an integer in the current line, possibly negative
+         *
+         * @param what what the number represents, used in the error message
+         */
+        int64_t parseInteger(const char* what) {
+            this->skipSpaces();
+            const bool negative = this->peek() == '-';
+            if (negative) {
+                ++this->current;
+            }
+            const uint64_t magnitude = this->parseUnsigned(what);
+            if (magnitude > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                this->fail(std::string{what} + " is too large");
+            }
+            return negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+        }
+        /**
+         * @brief consume an id of a vertex, stored starting from 1 like in DIMACS and METIS
+         *
+         * @param vertices the number of vertices of the graph
+         * @return nodeid_t the id, starting from 0
+         */
+        nodeid_t parseVertex(const char* what, size_t vertices) {
+            const uint64_t id = this->parseUnsigned(what);
+            if (id == 0 || id > vertices) {
+                this->fail(std::string{what} + " " + std::to_string(id) + " is not between 1 and " + std::to_string(vertices));
+            }
+            return id - 1;
+        }
+        /**
+         * @brief consume the weight of an edge
+         *
+         */
+        template <typename E>
+        E parseWeight(const char* what) {
+            const int64_t weight = this->parseInteger(what);
+            if constexpr (std::is_integral<E>::value) {
+                if (weight < static_cast<int64_t>(std::numeric_limits<E>::min()) || (weight > 0 && static_cast<uint64_t>(weight) > static_cast<uint64_t>(std::numeric_limits<E>::max()))) {
+                    this->fail(std::string{what} + " " + std::to_string(weight) + " does not fit the weights of the graph");
+                }
+            }
+            return static_cast<E>(weight);
+        }
+        /**
+         * @brief throw an exception about the current line
+         *
+         * @param description what went wrong
+         * @throw cpp_utils::exceptions::InvalidFormatException always
+         */
+        [[noreturn]] void fail(const std::string& description) const {
+            throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{this->path.native() + ":" + std::to_string(this->line), description};
+        }
+    };
+
+    /**
+     * @brief build the CSR of a graph from edges grouped by nothing, via a counting sort over the sources
+     *
+     * Edges with the same source keep their order.
+     *
+     * @param edges the edges, with valid ids
+     */
+    template <typename G, typename V, typename E>
+    AdjacentGraph<G, V, E> buildFromEdgeRecords(const G& payload, size_t vertices, ConstSpan<BinaryEdgeRecord<E>> edges, bool withInEdgesIndex) {
+        if (edges.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+            throw cpp_utils::exceptions::InvalidArgumentException{"the graph can contain at most", std::numeric_limits<int>::max(), "edges, but we have", edges.size()};
+        }
+        std::vector<int> outEdgesBegin(vertices + 1, 0);
+        for (const auto& edge : edges) {
+            outEdgesBegin[edge.sourceId + 1] += 1;
+        }
+        for (size_t id=0; id<vertices; ++id) {
+            outEdgesBegin[id + 1] += outEdgesBegin[id];
+        }
+        std::vector<int> next{outEdgesBegin.begin(), outEdgesBegin.end() - 1};
+        std::vector<OutEdge<E>> outEdges(edges.size());
+        for (const auto& edge : edges) {
+            outEdges[next[edge.sourceId]++] = OutEdge<E>{edge.sinkId, edge.payload};
+        }
+        return AdjacentGraph<G, V, E>{G{payload}, std::vector<V>(vertices), std::move(outEdges), std::move(outEdgesBegin), withInEdgesIndex};
+    }
+
+}
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief read a graph in the format of the 9th DIMACS implementation challenge (`.gr` files)
+     *
+     * The file contains a problem line `p sp <vertices> <arcs>` followed by the arcs, one per line as `a <source> <sink> <weight>`.
+     * Ids start from 1 in the file and from 0 in the graph. Lines starting with `c` are comments.
+     *
+     * The file is mapped in memory and parsed in a single pass; then the arcs are counting sorted by source straight into
+     * the arrays of the graph. Arcs with the same source keep their order in the file.
+     *
+     * @code
+     * auto graph = importDimacsGraph<int, int, long>("USA-road-d.USA.gr");
+     * @endcode
+     *
+     * @tparam G type of the payload of the graph
+     * @tparam V type of the payload of each vertex. Each vertex has a default constructed payload
+     * @tparam E type of the weight of an edge
+     * @param path the file to read
+     * @param payload the payload of the graph
+     * @param withInEdgesIndex true if we need to build the reverse index of the in edges as well (see AdjacentGraph::finalizeGraph)
+     * @return AdjacentGraph<G, V, E> the graph read
+     * @throw cpp_utils::exceptions::FileOpeningException if the file cannot be read
+     * @throw cpp_utils::exceptions::InvalidFormatException if the file is malformed. The message contains the line involved
+     */
+    template <typename G, typename V, typename E>
+    AdjacentGraph<G, V, E> importDimacsGraph(const boost::filesystem::path& path, const G& payload = G{}, bool withInEdgesIndex = true) {
+        MappedFile file{path};
+        internal::GraphTextReader reader{file};
+        bool hasProblem = false;
+        size_t vertices = 0;
+        size_t arcs = 0;
+        std::vector<BinaryEdgeRecord<E>> edges{};
+
+        while (!reader.isOver()) {
+            switch (reader.peek()) {
+                case 'a': {
+                    if (!hasProblem) {
+                        reader.fail("arc before the problem line");
+                    }
+                    reader.expectWord("a");
+                    const nodeid_t sourceId = reader.parseVertex("arc source", vertices);
+                    const nodeid_t sinkId = reader.parseVertex("arc sink", vertices);
+                    const E weight = reader.parseWeight<E>("arc weight");
+                    edges.push_back(BinaryEdgeRecord<E>{static_cast<uint32_t>(sourceId), static_cast<uint32_t>(sinkId), weight});
+                    reader.endLine();
+                    break;
+                }
+                case 'c': {
+                    reader.skipLine();
+                    break;
+                }
+                case 'p': {
+                    if (hasProblem) {
+                        reader.fail("second problem line");
+                    }
+                    reader.expectWord("p");
+                    reader.expectWord("sp");
+                    vertices = reader.parseUnsigned("number of vertices");
+                    arcs = reader.parseUnsigned("number of arcs");
+                    if (vertices >= std::numeric_limits<uint32_t>::max()) {
+                        reader.fail("too many vertices");
+                    }
+                    if (arcs > static_cast<size_t>(std::numeric_limits<int>::max())) {
+                        reader.fail("too many arcs");
+                    }
+                    reader.endLine();
+                    hasProblem = true;
+                    //an arc takes at least 8 bytes ("a 1 1 0\n"): don't trust a problem line declaring more arcs than the file can hold
+                    edges.reserve(std::min<size_t>(arcs, file.size() / 8 + 1));
+                    break;
+                }
+                default: {
+                    if (!reader.isLineOver()) {
+                        reader.fail("unknown line");
+                    }
+                    reader.skipLine();
+                }
+            }
+        }
+        if (!hasProblem) {
+            reader.fail("no problem line");
+        }
+        if (edges.size() != arcs) {
+            reader.fail("the problem line declares " + std::to_string(arcs) + " arcs, but there are " + std::to_string(edges.size()));
+        }
+        return internal::buildFromEdgeRecords<G, V, E>(payload, vertices, ConstSpan<BinaryEdgeRecord<E>>{edges.data(), edges.size()}, withInEdgesIndex);
+    }
+
+    /**
+     * @brief read a graph in the format of METIS
+     *
+     * The first line is `<vertices> <edges> [<fmt> [<ncon>]]`; then line @c i lists the neighbours of vertex @c i (starting
+     * from 1) and, if @c fmt requires them, the size and the @c ncon weights of the vertex (ignored) and the weight of each edge.
+     * Lines starting with `%` are comments. METIS graphs are undirected: each edge is listed by both its endpoints, and
+     * the graph contains both directions.
+     *
+     * Since the neighbours are grouped by vertex, they are written directly in the arrays of the graph.
+     *
+     * @tparam G type of the payload of the graph
+     * @tparam V type of the payload of each vertex. Each vertex has a default constructed payload
+     * @tparam E type of the weight of an edge. If the file has no edge weights, every edge weights 1
+     * @param path the file to read
+     * @param payload the payload of the graph
+     * @param withInEdgesIndex true if we need to build the reverse index of the in edges as well (see AdjacentGraph::finalizeGraph)
+     * @return AdjacentGraph<G, V, E> the graph read
+     * @throw cpp_utils::exceptions::FileOpeningException if the file cannot be read
+     * @throw cpp_utils::exceptions::InvalidFormatException if the file is malformed. The message contains the line involved
+     */
+    template <typename G, typename V, typename E>
+    AdjacentGraph<G, V, E> importMetisGraph(const boost::filesystem::path& path, const G& payload = G{}, bool withInEdgesIndex = true) {
+        MappedFile file{path};
+        internal::GraphTextReader reader{file};
+        auto skipComments = [&]() {
+            while (!reader.isOver() && reader.peek() == '%') {
+                reader.skipLine();
+            }
+        };
+
+        skipComments();
+        if (reader.isOver()) {
+            reader.fail("no header");
+        }
+        const uint64_t vertices = reader.parseUnsigned("number of vertices");
+        const uint64_t edges = reader.parseUnsigned("number of edges");
+        uint64_t format = 0;
+        uint64_t constraints = 1;
+        if (!reader.isLineOver()) {
+            format = reader.parseUnsigned("format");
+            if (!reader.isLineOver()) {
+                constraints = reader.parseUnsigned("number of vertex weights");
+            }
+        }
+        if (format != 0 && format != 1 && format != 10 && format != 11 && format != 100 && format != 101 && format != 110 && format != 111) {
+            reader.fail("unknown format " + std::to_string(format));
+        }
+        if (vertices >= std::numeric_limits<uint32_t>::max()) {
+            reader.fail("too many vertices");
+        }
+        if (edges > static_cast<uint64_t>(std::numeric_limits<int>::max()) / 2) {
+            reader.fail("too many edges");
+        }
+        const bool hasVertexSizes = (format / 100) % 10 == 1;
+        const bool hasVertexWeights = (format / 10) % 10 == 1;
+        const bool hasEdgeWeights = format % 10 == 1;
+        reader.endLine();
+
+        //don't trust a header declaring more than the file can hold: each vertex takes at least a line ("\n") and each
+        //neighbour at least 2 bytes ("1 ")
+        std::vector<int> outEdgesBegin{};
+        outEdgesBegin.reserve(std::min<uint64_t>(vertices, file.size()) + 1);
+        outEdgesBegin.push_back(0);
+        std::vector<OutEdge<E>> outEdges{};
+        outEdges.reserve(std::min<uint64_t>(2 * edges, file.size() / 2 + 1));
+        for (nodeid_t id=0; id<vertices; ++id) {
+            skipComments();
+            if (reader.isOver()) {
+                reader.fail("the header declares " + std::to_string(vertices) + " vertices, but there are " + std::to_string(id));
+            }
+            if (hasVertexSizes) {
+                reader.parseUnsigned("vertex size");
+            }
+            if (hasVertexWeights) {
+                for (uint64_t i=0; i<constraints; ++i) {
+                    reader.parseInteger("vertex weight");
+                }
+            }
+            while (!reader.isLineOver()) {
+                const nodeid_t sinkId = reader.parseVertex("neighbour", vertices);
+                const E weight = hasEdgeWeights ? reader.parseWeight<E>("edge weight") : static_cast<E>(1);
+                if (outEdges.size() == 2 * edges) {
+                    reader.fail("the header declares " + std::to_string(edges) + " edges, but there are more");
+                }
+                outEdges.emplace_back(sinkId, weight);
+            }
+            outEdgesBegin.push_back(static_cast<int>(outEdges.size()));
+            reader.skipLine();
+        }
+        while (!reader.isOver()) {
+            skipComments();
+            if (!reader.isOver()) {
+                if (!reader.isLineOver()) {
+                    reader.fail("the header declares " + std::to_string(vertices) + " vertices, but there are more");
+                }
+                reader.skipLine();
+            }
+        }
+        if (outEdges.size() != 2 * edges) {
+            reader.fail("the header declares " + std::to_string(edges) + " edges, but there are " + std::to_string(outEdges.size()) + " neighbours (each edge is listed twice)");
+        }
+        return AdjacentGraph<G, V, E>{G{payload}, std::vector<V>(vertices), std::move(outEdges), std::move(outEdgesBegin), withInEdgesIndex};
+    }
+
+    /**
+     * @brief read a raw binary edge list, namely a sequence of BinaryEdgeRecord (see cpp_utils::serializers::saveToBinaryEdgeList)
+     *
+     * The file is mapped in memory and the records are counting sorted by source straight into the arrays of the graph,
+     * without any intermediate copy. Edges with the same source keep their order in the file.
+     *
+     * @tparam G type of the payload of the graph
+     * @tparam V type of the payload of each vertex. Each vertex has a default constructed payload
+     * @tparam E type of the weight of an edge. It needs to be the same type the file was written with
+     * @param path the file to read
+     * @param vertices the number of vertices of the graph. If 0, it is the greatest id in the file plus 1
+     * @param payload the payload of the graph
+     * @param withInEdgesIndex true if we need to build the reverse index of the in edges as well (see AdjacentGraph::finalizeGraph)
+     * @return AdjacentGraph<G, V, E> the graph read
+     * @throw cpp_utils::exceptions::FileOpeningException if the file cannot be read
+     * @throw cpp_utils::exceptions::InvalidFormatException if the file is malformed. The message contains the record involved
+     */
+    template <typename G, typename V, typename E>
+    AdjacentGraph<G, V, E> importBinaryEdgeList(const boost::filesystem::path& path, size_t vertices = 0, const G& payload = G{}, bool withInEdgesIndex = true) {
+        static_assert(std::is_trivially_copyable<E>::value, "edge payload needs to be trivially copyable to be loaded");
+        MappedFile file{path};
+        if (file.size() % sizeof(BinaryEdgeRecord<E>) != 0) {
+            throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native() + ":" + std::to_string(file.size() / sizeof(BinaryEdgeRecord<E>) + 1), "truncated record"};
+        }
+        ConstSpan<BinaryEdgeRecord<E>> edges{reinterpret_cast<const BinaryEdgeRecord<E>*>(file.getData()), file.size() / sizeof(BinaryEdgeRecord<E>)};
+
+        const bool countVertices = vertices == 0;
+        for (size_t i=0; i<edges.size(); ++i) {
+            const uint32_t maxId = std::max(edges[i].sourceId, edges[i].sinkId);
+            if (countVertices) {
+                vertices = std::max<size_t>(vertices, static_cast<size_t>(maxId) + 1);
+            } else if (maxId >= vertices) {
+                throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native() + ":" + std::to_string(i + 1), "vertex " + std::to_string(maxId) + " is not in the graph"};
+            }
+        }
+        return internal::buildFromEdgeRecords<G, V, E>(payload, vertices, edges, withInEdgesIndex);
+    }
+
+}
+
+#endif
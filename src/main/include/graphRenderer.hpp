@@ -0,0 +1,172 @@
+#ifndef _CPP_UTILS_GRAPHRENDERER_HEADER__
+#define _CPP_UTILS_GRAPHRENDERER_HEADER__
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Color.hpp"
+#include "ppmImage.hpp"
+
+/**
+ * @file
+ * @brief draw graphs directly into a PPMImage, without external programs
+ *
+ * Graphs embedded in a plane (e.g., grid maps or road networks) can be drawn with their own coordinates:
+ *
+ * @code
+ * PPMImage image{1024, 1024};
+ * drawGraph(image, graph, [&](const xyLoc& loc) { return std::make_pair(loc.x, loc.y); });
+ * image.savePPM("frame001");
+ * @endcode
+ *
+ * The others need a layout first (see ::getForceDirectedLayout). Since the image is just overwritten, a single PPMImage
+ * can be reused to generate one frame per iteration of an algorithm.
+ */
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief how to draw a graph
+     *
+     */
+    struct GraphRenderingStyle {
+        /**
+         * @brief color the whole image is cleared with
+         *
+         */
+        color_t background{color_t::WHITE};
+        /**
+         * @brief color of the segments representing the edges
+         *
+         */
+        color_t edgeColor{color_t::GREY};
+        /**
+         * @brief color of the squares representing the vertices
+         *
+         */
+        color_t vertexColor{color_t::BLACK};
+        /**
+         * @brief half the side of the square of a vertex. 0 draws a vertex as a single pixel
+         *
+         */
+        size_t vertexRadius{1};
+        /**
+         * @brief pixels left empty on each side of the image
+         *
+         */
+        size_t margin{4};
+    };
+
+}
+
+namespace cpp_utils::graphs::internal {
+
+    /**
+     * @brief compute a force directed layout of a graph
+     *
+     * Edges are Eades' logarithmic springs, pulling (or pushing) their endpoints with a force \f$ \log(d/k) \f$, where @c k
+     * is the ideal length of an edge. Every pair of vertices repels with the Fruchterman-Reingold force \f$ k^2/d \f$, and
+     * the maximum movement of a vertex cools down linearly as in Fruchterman-Reingold.
+     *
+     * Repulsive forces are computed only between vertices in adjacent cells of a uniform grid, so each iteration costs
+     * roughly \f$ O(|V| + |E|) \f$.
+     *
+     * @param vertices number of vertices of the graph
+     * @param edges the edges of the graph, as pairs of vertex ids. The direction is ignored
+     * @param iterations number of iterations of the simulation
+     * @param seed seed of the random initial placement
+     * @return std::vector<std::pair<double, double>> the position of each vertex
+     */
+    std::vector<std::pair<double, double>> computeForceDirectedLayout(uint32_t vertices, const std::vector<std::pair<uint32_t, uint32_t>>& edges, size_t iterations, uint32_t seed);
+
+    /**
+     * @brief scale the positions to fit the image and draw the edges and then the vertices
+     *
+     * @param image the image to draw into. It is cleared with the background color
+     * @param positions the position of each vertex, in any unit
+     * @param edges the edges of the graph, as pairs of vertex ids
+     * @param style how to draw the graph
+     */
+    void rasterizeGraph(PPMImage& image, const std::vector<std::pair<double, double>>& positions, const std::vector<std::pair<uint32_t, uint32_t>>& edges, const GraphRenderingStyle& style);
+
+    /**
+     * @brief the edges of a graph, as pairs of vertex ids
+     *
+     * @tparam GRAPH type of the graph
+     * @param graph the graph to consider
+     * @return std::vector<std::pair<uint32_t, uint32_t>> an element per edge
+     */
+    template <typename GRAPH>
+    std::vector<std::pair<uint32_t, uint32_t>> getEdgePairs(const GRAPH& graph) {
+        std::vector<std::pair<uint32_t, uint32_t>> result{};
+        result.reserve(graph.numberOfEdges());
+        graph.forEachEdge([&](auto sourceId, auto sinkId, const auto& payload) {
+            result.push_back(std::make_pair(static_cast<uint32_t>(sourceId), static_cast<uint32_t>(sinkId)));
+        });
+        return result;
+    }
+
+}
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief compute a position for each vertex of a graph without coordinates
+     *
+     * We use a spring embedder: edges are logarithmic springs (as in Eades) keeping their endpoints at an ideal distance,
+     * while nearby vertices push away each other (as in Fruchterman-Reingold). The result is deterministic for a given seed.
+     *
+     * @tparam GRAPH type of the graph
+     * @param graph the graph to lay out
+     * @param iterations number of iterations of the simulation. More iterations yield a more relaxed layout
+     * @param seed seed of the random initial placement
+     * @return std::vector<std::pair<double, double>> the position of each vertex, indexed by vertex id
+     */
+    template <typename GRAPH>
+    std::vector<std::pair<double, double>> getForceDirectedLayout(const GRAPH& graph, size_t iterations = 100, uint32_t seed = 0) {
+        return internal::computeForceDirectedLayout(static_cast<uint32_t>(graph.numberOfVertices()), internal::getEdgePairs(graph), iterations, seed);
+    }
+
+    /**
+     * @brief draw a graph whose vertices have the given positions
+     *
+     * The positions are scaled (keeping the aspect ratio) to fill the image. The image is cleared first.
+     *
+     * @tparam GRAPH type of the graph
+     * @param image the image to draw into
+     * @param graph the graph to draw
+     * @param positions the position of each vertex, indexed by vertex id (e.g., the output of ::getForceDirectedLayout)
+     * @param style how to draw the graph
+     */
+    template <typename GRAPH>
+    void drawGraph(PPMImage& image, const GRAPH& graph, const std::vector<std::pair<double, double>>& positions, const GraphRenderingStyle& style = GraphRenderingStyle{}) {
+        internal::rasterizeGraph(image, positions, internal::getEdgePairs(graph), style);
+    }
+
+    /**
+     * @brief draw a graph whose vertices carry their coordinates
+     *
+     * The coordinates are scaled (keeping the aspect ratio) to fill the image. The image is cleared first.
+     *
+     * @tparam GRAPH type of the graph
+     * @tparam COORDINATES callable which, given the payload of a vertex, yields a pair of numeric coordinates
+     * @param image the image to draw into
+     * @param graph the graph to draw
+     * @param coordinatesOf function generating the coordinates of a vertex
+     * @param style how to draw the graph
+     */
+    template <typename GRAPH, typename COORDINATES>
+    void drawGraph(PPMImage& image, const GRAPH& graph, COORDINATES coordinatesOf, const GraphRenderingStyle& style = GraphRenderingStyle{}) {
+        std::vector<std::pair<double, double>> positions{};
+        positions.reserve(graph.numberOfVertices());
+        for (decltype(graph.numberOfVertices()) id=0; id<graph.numberOfVertices(); ++id) {
+            auto xy = coordinatesOf(graph.getVertex(id));
+            positions.push_back(std::make_pair(static_cast<double>(xy.first), static_cast<double>(xy.second)));
+        }
+        internal::rasterizeGraph(image, positions, internal::getEdgePairs(graph), style);
+    }
+
+}
+
+#endif
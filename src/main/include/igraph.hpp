@@ -1,7 +1,10 @@
 #ifndef _CPP_UTILS_IGRAPH_HEADER__
 #define _CPP_UTILS_IGRAPH_HEADER__
 
+#include <algorithm>
+#include <cmath>
 #include <tuple>
+#include <type_traits>
 #include <climits>
 #include <vector>
 #include <utility>
@@ -18,6 +21,7 @@
 #include "log.hpp"
 #include "Random.hpp"
 #include "functional.hpp"
+#include "graphRenderer.hpp"
 
 namespace cpp_utils::graphs {
 
@@ -229,9 +233,15 @@ namespace cpp_utils::graphs {
             return ss;
         }
     public:
-        E getPayload();
-        const E& getPayload() const;
-        nodeid_t getSourceId() const;
+        E& getPayload() {
+            return this->payload;
+        }
+        const E& getPayload() const {
+            return this->payload;
+        }
+        nodeid_t getSourceId() const {
+            return this->sourceId;
+        }
     private:
         E payload;
         nodeid_t sourceId;
@@ -340,14 +350,14 @@ namespace cpp_utils::graphs {
             }
 
             //edges
-            for (auto it=a.beginEdges(); it!= a.endEdges(); ++it) {
-                Edge<E> e = *it;
-                if (!b.containsEdge(e.getSourceId(), e.getSinkId(), e.getPayload())) {
-                    return false;
+            bool result = true;
+            a.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                if (result && !b.containsEdge(sourceId, sinkId, payload)) {
+                    result = false;
                 }
-            }
+            });
 
-            return true;
+            return result;
         }
     public:
         using const_vertex_iterator = ConstIteratorWrapper<std::pair<nodeid_t, const V&>, std::pair<nodeid_t, const V&>*>;
@@ -382,6 +392,22 @@ namespace cpp_utils::graphs {
         virtual This::const_vertex_iterator endVertices() const = 0;
         virtual This::const_edge_iterator beginEdges() const = 0;
         virtual This::const_edge_iterator endEdges() const = 0;
+        /**
+         * @brief apply a function over every edge of the graph
+         * 
+         * The default implementation relies on ::beginEdges. Graphs which can scan their edges faster (e.g., AdjacentGraph)
+         * override it: hence, prefer this over ::beginEdges when you need to visit the whole graph.
+         * 
+         * @note
+         * if you know the concrete type of the graph, cpp_utils::graphs::forEachEdge avoids even the std::function indirection
+         * 
+         * @param lambda function to call for each edge. It accepts the source, the sink and the payload of the edge
+         */
+        virtual void forEachEdge(const std::function<void(nodeid_t, nodeid_t, const E&)>& lambda) const {
+            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
+                lambda(it->getSourceId(), it->getSinkId(), it->getPayload());
+            }
+        }
         /**
          * @brief the maximum number of edges you can have in this graph
          * 
@@ -608,20 +634,16 @@ namespace cpp_utils::graphs {
         SetPlus<Edge<E>> getEdgeSet(bool ignore_opposites) const {
             SetPlus<std::tuple<nodeid_t, nodeid_t>> tmp;
             SetPlus<Edge<E>> result{};
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                debug("edge is", *it);
-                nodeid_t sourceId = it->getSourceId();
-                nodeid_t sinkId = it->getSinkId();
+            this->forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
                 if (ignore_opposites) {
-                    auto oppositeTuple = std::make_tuple<nodeid_t, nodeid_t>(std::move(sinkId), std::move(sourceId));
+                    auto oppositeTuple = std::make_tuple(sinkId, sourceId);
                     if (!tmp.contains(oppositeTuple)) {
-                        tmp.add(std::make_tuple<nodeid_t, nodeid_t>(::std::move(sourceId), ::std::move(sinkId)));
+                        tmp.add(std::make_tuple(sourceId, sinkId));
                     }
                 } else {
-                    result.add(*it);
+                    result.add(Edge<E>{sourceId, sinkId, payload});
                 }
-            }
-            debug("result is", result);
+            });
 
             if (ignore_opposites) {
                 return tmp.map<Edge<E>>([&] (const std::tuple<nodeid_t, nodeid_t>& t) {
@@ -671,9 +693,9 @@ namespace cpp_utils::graphs {
             }
 
             //edges
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                result->addEdgeTail(it->getSourceId(), it->getSinkId(), edgeMapper(it->getPayload()));
-            }
+            this->forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                result->addEdgeTail(sourceId, sinkId, edgeMapper(payload));
+            });
             result->finalizeGraph();
 
             return result;
@@ -704,9 +726,9 @@ namespace cpp_utils::graphs {
             }
 
             //edges
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                result->addEdgeTail(it->getSourceId(), it->getSinkId(), mapper(it->getPayload()));
-            }
+            this->forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                result->addEdgeTail(sourceId, sinkId, mapper(payload));
+            });
             result->finalizeGraph();
 
             return result;
@@ -722,9 +744,9 @@ namespace cpp_utils::graphs {
             }
 
             //edges
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                result->addEdgeTail(it->getSourceId(), it->getSinkId(), it->getPayload());
-            }
+            this->forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                result->addEdgeTail(sourceId, sinkId, payload);
+            });
             result->finalizeGraph();
 
             return result;
@@ -740,9 +762,9 @@ namespace cpp_utils::graphs {
             }
 
             //edges
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                result->addEdgeTail(it->getSourceId(), it->getSinkId(), edgeMapper(it->getPayload()));
-            }
+            this->forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                result->addEdgeTail(sourceId, sinkId, edgeMapper(payload));
+            });
             result->finalizeGraph();
 
             return result;
@@ -853,8 +875,10 @@ namespace cpp_utils::graphs {
 
             //edges
             for (nodeid_t newSourceId=0; newSourceId<this->numberOfVertices(); ++newSourceId) {
-                debug("reordering ", newSourceId, "out of ", this->numberOfVertices());
-                for (auto outEdge: this->getOutEdges(fromNewToOld[newSourceId])) {
+                nodeid_t oldSourceId = fromNewToOld[newSourceId];
+                const size_t outDegree = this->getOutDegree(oldSourceId);
+                for (size_t i=0; i<outDegree; ++i) {
+                    auto outEdge = this->getOutEdge(oldSourceId, static_cast<moveid_t>(i));
                     result->addEdgeTail(
                         newSourceId,
                         fromOldToNew[outEdge.getSinkId()], 
@@ -875,32 +899,18 @@ namespace cpp_utils::graphs {
 
             return std::unique_ptr<AdjacentGraph<G,V,E>>{result};
         }
+        /**
+         * @brief draw the graph with a force directed layout
+         * 
+         * The image is generated in process (see graphRenderer.hpp). If the vertices carry coordinates, use cpp_utils::graphs::drawGraph instead.
+         * 
+         * @return PPMImage* an image sized after the number of vertices
+         */
         virtual PPMImage* getPPM() const {
-            callRm("rm -f /tmp/getPPM.png /tmp/getPPM.ppm /tmp/getPPM.dot");
-
-            std::ofstream f;
-            f.open("/tmp/getPPM.dot", std::ofstream::out | std::ofstream::trunc);
-
-            f << "digraph {\n";
-            finer("iterate over vertices...");
-            for (auto it=this->beginVertices(); it!=this->endVertices(); ++it) {
-                finest("drawing vertex", it->first);
-                f << "N" << it->first << " [label=\"id:" << it->first << "\\n" << it->second << "\"];\n";
-            }
-
-            finer("iterate over edges...");
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                finest("drawing edge", it->getSourceId(), "->", it->getSinkId());
-                f << "N" << it->getSourceId() << " -> N" << it->getSinkId() << " [label=\"" << it->getPayload() << "\"];\n";
-            }
-            f << "}\n";
-
-            f.close();
-
-            callDot("dot -Tpng -o \"/tmp/getPPM.png\" \"/tmp/getPPM.dot\"");
-            //https://askubuntu.com/a/84415/703658
-            callConvert("convert -depth 8 -compress none \"/tmp/getPPM.png\" \"/tmp/getPPM.ppm\"");
-            PPMImage* result = new PPMImage{"/tmp/getPPM.ppm"};
+            const size_t side = std::min<size_t>(2048, std::max<size_t>(256, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(this->numberOfVertices())))) * 16));
+            PPMImage* result = new PPMImage{side, side};
+            finer("computing the layout of", this->numberOfVertices(), "vertices...");
+            drawGraph(*result, *this, getForceDirectedLayout(*this));
             return result;
         }
         /**
@@ -942,6 +952,19 @@ namespace cpp_utils::graphs {
          */
         virtual void changeWeightEdge(nodeid_t sourceId, nodeid_t sinkId, const E& newPayload) = 0;
         virtual void changeWeightOutEdge(nodeid_t sourceId, moveid_t index, const E& newPayload) = 0;
+        /**
+         * @brief Change the label of several edges at once
+         *
+         * Each update is handled like ::changeWeightEdge. If the same edge appears several times, the last update wins.
+         * Implementations may override it to apply the updates in a single pass.
+         *
+         * @param updates for each edge to alter, its source, its sink and its new value
+         */
+        virtual void changeWeightEdges(const std::vector<Edge<E>>& updates) {
+            for (const auto& update : updates) {
+                this->changeWeightEdge(update.getSourceId(), update.getSinkId(), update.getPayload());
+            }
+        }
 
         /**
          * @brief function used to update the payload of a vertex by using the rpevious one
@@ -1006,6 +1029,158 @@ namespace cpp_utils::graphs {
         virtual void removeAllEdges() = 0;
     };
 
+    /**
+     * @brief std::true_type if @c GRAPH exposes the out edges of a vertex as a range via `outEdgeRange(nodeid_t)`
+     * 
+     * The range may be contiguous (e.g., AdjacentGraph) or decoded while it is iterated (e.g., CompressedAdjacentGraph)
+     * 
+     * @tparam GRAPH the type of the graph to check
+     */
+    template <typename GRAPH, typename = void>
+    struct has_out_edge_range: std::false_type {
+    };
+
+    template <typename GRAPH>
+    struct has_out_edge_range<GRAPH, std::void_t<decltype(std::declval<const GRAPH&>().outEdgeRange(std::declval<nodeid_t>()))>>: std::true_type {
+    };
+
+    /**
+     * @brief true if @c GRAPH stores the sinks and the payloads of the out edges of a vertex in 2 separate arrays
+     * 
+     * Such graphs (e.g., CompactAdjacentGraph, MappedAdjacentGraph) expose `outEdgeSinks(nodeid_t)` and `outEdgePayloads(nodeid_t)`, 2 spans as long
+     * as the out degree of the vertex
+     * 
+     * @tparam GRAPH the type of the graph to check
+     */
+    template <typename GRAPH, typename = void>
+    struct has_out_edge_arrays: std::false_type {
+    };
+
+    template <typename GRAPH>
+    struct has_out_edge_arrays<GRAPH, std::void_t<
+        decltype(std::declval<const GRAPH&>().outEdgeSinks(std::declval<nodeid_t>())),
+        decltype(std::declval<const GRAPH&>().outEdgePayloads(std::declval<nodeid_t>()))
+    >>: std::true_type {
+    };
+
+    /**
+     * @brief apply a function over each out edge of a vertex
+     * 
+     * The dispatch happens at compile time: if @c GRAPH has `outEdgeRange` (e.g., AdjacentGraph) we directly scan the
+     * edges stored in the graph, so the whole loop (@c lambda included) can be inlined. If @c GRAPH has `outEdgeSinks` and
+     * `outEdgePayloads` (e.g., CompactAdjacentGraph) we scan both arrays. Otherwise we fall back to
+     * IImmutableGraph::getOutDegree and IImmutableGraph::getOutEdge.
+     * 
+     * Use it in hot loops (e.g., the expansion of a search) instead of IImmutableGraph::getOutEdges, which allocates a vector
+     * at each call.
+     * 
+     * @note
+     * the dispatch is done on the static type of @c graph: pass the concrete graph, not a reference to IImmutableGraph
+     * 
+     * @code
+     * forEachOutEdge(graph, id, [&](const OutEdge<E>& outEdge) {
+     *  ...
+     * });
+     * @endcode
+     * 
+     * @tparam GRAPH type of the graph
+     * @tparam LAMBDA a callable accepting a `const OutEdge<E>&`
+     * @param graph the graph to consider
+     * @param id the vertex whose out edges we need to scan
+     * @param lambda function to call for each out edge of @c id, in the same order of IImmutableGraph::getOutEdge
+     */
+    template <typename GRAPH, typename LAMBDA>
+    void forEachOutEdge(const GRAPH& graph, nodeid_t id, LAMBDA lambda) {
+        if constexpr (has_out_edge_range<GRAPH>::value) {
+            for (const auto& outEdge : graph.outEdgeRange(id)) {
+                lambda(outEdge);
+            }
+        } else if constexpr (has_out_edge_arrays<GRAPH>::value) {
+            auto sinks = graph.outEdgeSinks(id);
+            auto payloads = graph.outEdgePayloads(id);
+            using E = typename decltype(payloads)::value_type;
+            for (size_t i=0; i<sinks.size(); ++i) {
+                lambda(OutEdge<E>{static_cast<nodeid_t>(sinks[i]), payloads[i]});
+            }
+        } else {
+            const size_t outDegree = graph.getOutDegree(id);
+            for (size_t i=0; i<outDegree; ++i) {
+                lambda(graph.getOutEdge(id, static_cast<moveid_t>(i)));
+            }
+        }
+    }
+
+    /**
+     * @brief apply a function over each successor of a vertex
+     * 
+     * Like cpp_utils::graphs::forEachOutEdge, but the payloads of the edges are not needed: if @c GRAPH has `outEdgeSinks` 
+     * (e.g., CompactAdjacentGraph) we read only the array of the sinks. Useful for unweighted visits (e.g., breadth first).
+     * 
+     * @code
+     * forEachSuccessor(graph, id, [&](nodeid_t sinkId) {
+     *  ...
+     * });
+     * @endcode
+     * 
+     * @tparam GRAPH type of the graph
+     * @tparam LAMBDA a callable accepting a `nodeid_t`
+     * @param graph the graph to consider
+     * @param id the vertex whose successors we need to scan
+     * @param lambda function to call for the sink of each out edge of @c id, in the same order of IImmutableGraph::getOutEdge
+     */
+    template <typename GRAPH, typename LAMBDA>
+    void forEachSuccessor(const GRAPH& graph, nodeid_t id, LAMBDA lambda) {
+        if constexpr (has_out_edge_arrays<GRAPH>::value) {
+            for (auto sinkId : graph.outEdgeSinks(id)) {
+                lambda(static_cast<nodeid_t>(sinkId));
+            }
+        } else {
+            forEachOutEdge(graph, id, [&](const auto& outEdge) {
+                lambda(outEdge.getSinkId());
+            });
+        }
+    }
+
+    /**
+     * @brief apply a function over every edge of a graph
+     * 
+     * Like cpp_utils::graphs::forEachOutEdge, the dispatch happens at compile time: if @c GRAPH has `outEdgeRange` (or `outEdgeSinks`)
+     * we linearly scan its edges, without any allocation nor virtual call per edge. Otherwise we use IImmutableGraph::forEachEdge.
+     * 
+     * @code
+     * forEachEdge(graph, [&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+     *  ...
+     * });
+     * @endcode
+     * 
+     * @tparam GRAPH type of the graph
+     * @tparam LAMBDA a callable accepting a `nodeid_t`, a `nodeid_t` and a `const E&`
+     * @param graph the graph to consider
+     * @param lambda function to call for each edge, with the source, the sink and the payload of the edge
+     */
+    template <typename GRAPH, typename LAMBDA>
+    void forEachEdge(const GRAPH& graph, LAMBDA lambda) {
+        if constexpr (has_out_edge_range<GRAPH>::value) {
+            const size_t vertices = graph.numberOfVertices();
+            for (nodeid_t sourceId=0; sourceId<vertices; ++sourceId) {
+                for (const auto& outEdge : graph.outEdgeRange(sourceId)) {
+                    lambda(sourceId, outEdge.getSinkId(), outEdge.getPayload());
+                }
+            }
+        } else if constexpr (has_out_edge_arrays<GRAPH>::value) {
+            const size_t vertices = graph.numberOfVertices();
+            for (nodeid_t sourceId=0; sourceId<vertices; ++sourceId) {
+                auto sinks = graph.outEdgeSinks(sourceId);
+                auto payloads = graph.outEdgePayloads(sourceId);
+                for (size_t i=0; i<sinks.size(); ++i) {
+                    lambda(sourceId, static_cast<nodeid_t>(sinks[i]), payloads[i]);
+                }
+            }
+        } else {
+            graph.forEachEdge(lambda);
+        }
+    }
+
 }
 
 namespace std {
@@ -1047,4 +1222,4 @@ namespace std {
 
 }
 
-#endif
\ No newline at end of file
+#endif
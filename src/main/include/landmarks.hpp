@@ -0,0 +1,565 @@
+#ifndef _CPP_UTILS_LANDMARKS_HEADER__
+#define _CPP_UTILS_LANDMARKS_HEADER__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "igraph.hpp"
+#include "adjacentGraph.hpp"
+#include "dijkstra.hpp"
+#include "exceptions.hpp"
+#include "parallel.hpp"
+#include "serializers.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cpp_utils::graphs {
+
+    template <typename COST>
+    class Landmarks;
+
+    /**
+     * @brief how Landmarks chooses its landmarks
+     *
+     */
+    enum class LandmarkSelection {
+        /**
+         * @brief each landmark is the vertex farthest from the landmarks already chosen
+         */
+        FARTHEST,
+        /**
+         * @brief each landmark is a leaf of the shortest path tree of a random vertex, in the subtree where the landmarks
+         * already chosen give the worst lower bounds (Goldberg and Werneck's "avoid")
+         */
+        AVOID
+    };
+
+}
+
+namespace cpp_utils::serializers {
+
+    /**
+     * Save the landmarks and their distance tables into a file
+     *
+     * @pre
+     *  @li @c f open with "wb";
+     * @post
+     *  @li @c f modified;
+     *  @li @c f cursor modified;
+     *
+     * @param[in] f the file to save the landmarks into
+     * @param[in] landmarks the landmarks to save
+     */
+    template <typename COST>
+    void saveToFile(FILE* f, const cpp_utils::graphs::Landmarks<COST>& landmarks) {
+        static_assert(std::is_trivially_copyable<COST>::value, "cost needs to be trivially copyable to be saved");
+        saveToFile(f, landmarks.landmarks);
+        saveToFile(f, landmarks.fromLandmarks);
+        saveToFile(f, landmarks.toLandmarks);
+    }
+
+    /**
+     * Load landmarks from a file
+     *
+     * @pre
+     *  @li @c f open in "rb";
+     * @post
+     *  @li @c f cursor modified;
+     *
+     * @param[in] f the file to read the landmarks from;
+     * @return the landmarks loaded
+     */
+    template <typename COST>
+    cpp_utils::graphs::Landmarks<COST>& loadFromFile(FILE* f, cpp_utils::graphs::Landmarks<COST>& result) {
+        loadFromFile(f, result.landmarks);
+        loadFromFile(f, result.fromLandmarks);
+        loadFromFile(f, result.toLandmarks);
+        //older files mark unreachable landmarks with the infinite cost
+        result.markUnreachable(result.fromLandmarks);
+        result.markUnreachable(result.toLandmarks);
+
+        return result;
+    }
+
+}
+
+namespace cpp_utils::graphs::internal {
+
+    /**
+     * @brief \f$ \max(0, \max_i \max(idTo_i - goalTo_i, fromToGoal_i - fromToId_i)) \f$, one landmark at a time
+     *
+     * The body is just subtractions and maximums, so the compiler vectorizes it when the instruction set has a vector
+     * maximum of COST (e.g., SSE2 for 32 bits integers, SSE4.2 for 64 bits ones).
+     */
+    template <typename COST>
+    struct ScalarLandmarkBound {
+        static COST compute(const COST* fromToId, const COST* fromToGoal, const COST* idTo, const COST* goalTo, size_t k) {
+            COST result = 0;
+            for (size_t i=0; i<k; ++i) {
+                const COST forward = idTo[i] - goalTo[i];
+                const COST backward = fromToGoal[i] - fromToId[i];
+                result = result < forward ? forward : result;
+                result = result < backward ? backward : result;
+            }
+            return result;
+        }
+    };
+
+    /**
+     * @brief the lower bound given by the landmarks of Landmarks::getLowerBound
+     *
+     * Specialized with SSE2 for the costs the compiler cannot vectorize by itself with SSE2 only
+     */
+    template <typename COST, typename ENABLE = void>
+    struct LandmarkBound: ScalarLandmarkBound<COST> {
+    };
+
+#if defined(__SSE2__)
+
+    /**
+     * @brief SSE2 bound for 64 bits integers
+     *
+     * SSE2 has no 64 bits comparison. Since the operands are in `[-INFINITE_COST/2, INFINITE_COST/2]`, their difference
+     * does not overflow and its sign tells the maximum: `max(a, b) = b + max(a - b, 0)`
+     */
+    template <typename COST>
+    struct LandmarkBound<COST, typename std::enable_if<std::is_integral<COST>::value && std::is_signed<COST>::value && sizeof(COST) == 8>::type> {
+        static __m128i max(__m128i a, __m128i b) {
+            const __m128i difference = _mm_sub_epi64(a, b);
+            //the sign of the high half of each lane, spread over the whole lane
+            const __m128i negative = _mm_shuffle_epi32(_mm_srai_epi32(difference, 31), _MM_SHUFFLE(3, 3, 1, 1));
+            return _mm_add_epi64(b, _mm_andnot_si128(negative, difference));
+        }
+        static __m128i load(const COST* values) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+        }
+        static COST compute(const COST* fromToId, const COST* fromToGoal, const COST* idTo, const COST* goalTo, size_t k) {
+            //2 accumulators, so that consecutive maximums do not wait for each other
+            __m128i result = _mm_setzero_si128();
+            __m128i other = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i+4<=k; i+=4) {
+                result = max(result, max(_mm_sub_epi64(load(idTo + i), load(goalTo + i)), _mm_sub_epi64(load(fromToGoal + i), load(fromToId + i))));
+                other = max(other, max(_mm_sub_epi64(load(idTo + i + 2), load(goalTo + i + 2)), _mm_sub_epi64(load(fromToGoal + i + 2), load(fromToId + i + 2))));
+            }
+            for (; i+2<=k; i+=2) {
+                result = max(result, max(_mm_sub_epi64(load(idTo + i), load(goalTo + i)), _mm_sub_epi64(load(fromToGoal + i), load(fromToId + i))));
+            }
+            result = max(result, other);
+            result = max(result, _mm_unpackhi_epi64(result, result));
+            const COST vectorized = static_cast<COST>(_mm_cvtsi128_si64(result));
+            const COST tail = ScalarLandmarkBound<COST>::compute(fromToId + i, fromToGoal + i, idTo + i, goalTo + i, k - i);
+            return std::max(vectorized, tail);
+        }
+    };
+
+    /**
+     * @brief SSE2 bound for doubles
+     *
+     * The compiler does not vectorize a maximum of doubles, since it is not associative when NaNs are around
+     */
+    template <>
+    struct LandmarkBound<double> {
+        static double compute(const double* fromToId, const double* fromToGoal, const double* idTo, const double* goalTo, size_t k) {
+            __m128d result = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i+2<=k; i+=2) {
+                result = _mm_max_pd(result, _mm_sub_pd(_mm_loadu_pd(idTo + i), _mm_loadu_pd(goalTo + i)));
+                result = _mm_max_pd(result, _mm_sub_pd(_mm_loadu_pd(fromToGoal + i), _mm_loadu_pd(fromToId + i)));
+            }
+            result = _mm_max_sd(result, _mm_unpackhi_pd(result, result));
+            const double tail = ScalarLandmarkBound<double>::compute(fromToId + i, fromToGoal + i, idTo + i, goalTo + i, k - i);
+            return std::max(_mm_cvtsd_f64(result), tail);
+        }
+    };
+
+#endif
+
+}
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief the ALT heuristic of a Landmarks, as a callable DijkstraSearch accepts
+     *
+     * It is just a pointer to the landmarks, so it is cheap to copy. The landmarks need to outlive it.
+     *
+     * @tparam COST type of the cost of a path
+     */
+    template <typename COST>
+    class LandmarkHeuristic {
+    private:
+        const Landmarks<COST>* landmarks;
+    public:
+        explicit LandmarkHeuristic(const Landmarks<COST>& landmarks): landmarks{&landmarks} {
+
+        }
+        COST operator()(nodeid_t id, nodeid_t goal) const {
+            return this->landmarks->getLowerBound(id, goal);
+        }
+    };
+
+    /**
+     * @brief lower bounds on the distances of a graph computed via landmarks and the triangle inequality (ALT)
+     *
+     * For each landmark @c L we store the distances from @c L to every vertex and from every vertex to @c L. Then, for
+     * each pair of vertices:
+     * \f[
+     *  d(v, t) \geq \max_{L} \max(d(v, L) - d(t, L), d(L, t) - d(L, v))
+     * \f]
+     * which is an admissible and consistent heuristic for A* (see ::getHeuristic).
+     *
+     * Tables are stored vertex-major: the distances of a vertex from (or to) all the landmarks are contiguous, so
+     * evaluating the heuristic touches 4 contiguous blocks of memory. Unreachable landmarks are stored as ::UNREACHABLE,
+     * a finite cost no path reaches, rather than checked at each evaluation: the loop over the landmarks is just
+     * subtractions and maximums, done with SIMD instructions (see internal::LandmarkBound).
+     *
+     * @code
+     * Landmarks<int> landmarks{graph, 16};
+     * DijkstraSearch<AdjacentGraph<G, V, int>, int, LandmarkHeuristic<int>> astar{graph, landmarks.getHeuristic()};
+     * astar.search(start, goal);
+     * @endcode
+     *
+     * The landmarks can be stored via cpp_utils::serializers::saveToFile and loaded via cpp_utils::serializers::loadFromFile.
+     *
+     * @tparam COST type of the cost of a path. A signed type. Edge weights need to be non negative
+     */
+    template <typename COST>
+    class Landmarks {
+        static_assert(std::is_signed<COST>::value, "the differences between the distances need a signed cost");
+        using This = Landmarks<COST>;
+    public:
+        /**
+         * @brief the distance between 2 vertices not connected
+         *
+         */
+        static constexpr COST INFINITE_COST = std::numeric_limits<COST>::max();
+        /**
+         * @brief how the tables store the distance between 2 vertices not connected. Distances need to be smaller
+         *
+         * A difference involving it is either very negative (hence ignored) or very positive, but then the 2 vertices
+         * of the bound are not connected either (e.g., if @c v can't reach @c L while @c t can, @c v can't reach @c t):
+         * the bound stays admissible and consistent, and adding it to a distance does not overflow.
+         */
+        static constexpr COST UNREACHABLE = INFINITE_COST / 2;
+    private:
+        std::vector<nodeid_t> landmarks;
+        /**
+         * @brief cell `v * k + i` is the distance from the landmark @c i to the vertex @c v
+         *
+         */
+        std::vector<COST> fromLandmarks;
+        /**
+         * @brief cell `v * k + i` is the distance from the vertex @c v to the landmark @c i
+         *
+         */
+        std::vector<COST> toLandmarks;
+    public:
+        /**
+         * @brief no landmarks at all. Use it to load landmarks via cpp_utils::serializers::loadFromFile
+         *
+         */
+        Landmarks(): landmarks{}, fromLandmarks{}, toLandmarks{} {
+
+        }
+        /**
+         * @brief choose the landmarks of a graph and compute their distances
+         *
+         * @tparam GRAPH type of the graph (pass the concrete one, see cpp_utils::graphs::forEachOutEdge)
+         * @param graph the graph to consider
+         * @param k the number of landmarks. If the graph has less vertices, each vertex is a landmark
+         * @param selection the strategy to choose the landmarks
+         * @param threads number of threads to use while computing the distances. If 0, we use cpp_utils::getDefaultNumberOfThreads
+         * @param seed seed of the random choices of the strategy
+         */
+        template <typename GRAPH>
+        Landmarks(const GRAPH& graph, size_t k, LandmarkSelection selection = LandmarkSelection::AVOID, size_t threads = 0, unsigned int seed = 0):
+            Landmarks{graph, chooseLandmarks(graph, std::min(k, graph.numberOfVertices()), selection, seed), threads} {
+
+        }
+        /**
+         * @brief compute the distances of some landmarks chosen by the user
+         *
+         * @tparam GRAPH type of the graph (pass the concrete one, see cpp_utils::graphs::forEachOutEdge)
+         * @param graph the graph to consider
+         * @param landmarks the landmarks to use
+         * @param threads number of threads to use. If 0, we use cpp_utils::getDefaultNumberOfThreads
+         */
+        template <typename GRAPH>
+        Landmarks(const GRAPH& graph, const std::vector<nodeid_t>& landmarks, size_t threads = 0): landmarks{landmarks},
+            fromLandmarks(graph.numberOfVertices() * landmarks.size(), INFINITE_COST), toLandmarks(graph.numberOfVertices() * landmarks.size(), INFINITE_COST) {
+
+            using E = std::decay_t<decltype(graph.getOutEdge(0, 0).getPayload())>;
+            using ReversedGraph = AdjacentGraph<int, int, E>;
+            const size_t k = landmarks.size();
+            const size_t vertices = graph.numberOfVertices();
+
+            //the distances to a landmark are the distances from the landmark in the reversed graph
+            std::vector<Edge<E>> reversedEdges{};
+            reversedEdges.reserve(graph.numberOfEdges());
+            graph.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                reversedEdges.emplace_back(sinkId, sourceId, payload);
+            });
+            ReversedGraph reversed = ReversedGraph::fromEdges(0, std::vector<int>(vertices, 0), reversedEdges, threads, false);
+            reversedEdges = std::vector<Edge<E>>{};
+
+            //task i < k computes the distances from landmark i, task k + i the distances to landmark i
+            parallelForEach(0, 2 * k, threads, [&](size_t threadId, size_t task) {
+                const size_t landmark = task % k;
+                std::vector<COST>& table = (task < k) ? this->fromLandmarks : this->toLandmarks;
+                auto fill = [&](const auto& search) {
+                    for (nodeid_t id=0; id<vertices; ++id) {
+                        const COST distance = search.getDistance(id);
+                        if (distance != INFINITE_COST && !(distance < UNREACHABLE)) {
+                            throw cpp_utils::exceptions::InvalidArgumentException{"a distance from landmark", landmarks[landmark], "exceeds half the maximum cost"};
+                        }
+                        table[id * k + landmark] = distance == INFINITE_COST ? UNREACHABLE : distance;
+                    }
+                };
+                if (task < k) {
+                    DijkstraSearch<GRAPH, COST> search{graph};
+                    search.searchAll(landmarks[landmark]);
+                    fill(search);
+                } else {
+                    DijkstraSearch<ReversedGraph, COST> search{reversed};
+                    search.searchAll(landmarks[landmark]);
+                    fill(search);
+                }
+            });
+        }
+        Landmarks(const This& o) = default;
+        Landmarks(This&& o) = default;
+        This& operator=(const This& o) = default;
+        This& operator=(This&& o) = default;
+        virtual ~Landmarks() {
+
+        }
+    public:
+        size_t numberOfLandmarks() const {
+            return this->landmarks.size();
+        }
+        const std::vector<nodeid_t>& getLandmarks() const {
+            return this->landmarks;
+        }
+        /**
+         * @brief the distance from a landmark to a vertex
+         *
+         * @param landmark the index of the landmark (not its id)
+         * @param id the vertex involved
+         * @return COST the distance. ::INFINITE_COST if the vertex is not reachable from the landmark
+         */
+        COST getDistanceFromLandmark(size_t landmark, nodeid_t id) const {
+            const COST result = this->fromLandmarks[id * this->landmarks.size() + landmark];
+            return result == UNREACHABLE ? INFINITE_COST : result;
+        }
+        /**
+         * @brief the distance from a vertex to a landmark
+         *
+         * @param landmark the index of the landmark (not its id)
+         * @param id the vertex involved
+         * @return COST the distance. ::INFINITE_COST if the landmark is not reachable from the vertex
+         */
+        COST getDistanceToLandmark(size_t landmark, nodeid_t id) const {
+            const COST result = this->toLandmarks[id * this->landmarks.size() + landmark];
+            return result == UNREACHABLE ? INFINITE_COST : result;
+        }
+        /**
+         * @brief a lower bound of the distance between 2 vertices
+         *
+         * If no path goes from @c id to @c goal, the bound may be as large as ::UNREACHABLE.
+         *
+         * @param id the source of the path
+         * @param goal the target of the path
+         * @return COST a lower bound of the distance from @c id to @c goal. 0 if we have no landmarks
+         */
+        COST getLowerBound(nodeid_t id, nodeid_t goal) const {
+            const size_t k = this->landmarks.size();
+            const COST* fromToId = this->fromLandmarks.data() + id * k;
+            const COST* fromToGoal = this->fromLandmarks.data() + goal * k;
+            const COST* idTo = this->toLandmarks.data() + id * k;
+            const COST* goalTo = this->toLandmarks.data() + goal * k;
+            return internal::LandmarkBound<COST>::compute(fromToId, fromToGoal, idTo, goalTo, k);
+        }
+        /**
+         * @brief the heuristic to give to DijkstraSearch
+         *
+         * @return LandmarkHeuristic<COST> a functor referring to these landmarks. It is valid as long as the landmarks are
+         */
+        LandmarkHeuristic<COST> getHeuristic() const {
+            return LandmarkHeuristic<COST>{*this};
+        }
+    private:
+        template <typename GRAPH>
+        static std::vector<nodeid_t> chooseLandmarks(const GRAPH& graph, size_t k, LandmarkSelection selection, unsigned int seed) {
+            switch (selection) {
+                case LandmarkSelection::FARTHEST: return chooseFarthestLandmarks(graph, k, seed);
+                case LandmarkSelection::AVOID: return chooseAvoidLandmarks(graph, k, seed);
+                default: throw cpp_utils::exceptions::InvalidScenarioException{"landmark selection", static_cast<int>(selection)};
+            }
+        }
+        /**
+         * @brief each landmark is the vertex farthest from the landmarks already chosen. The first one is the
+         * farthest from a random vertex
+         *
+         */
+        template <typename GRAPH>
+        static std::vector<nodeid_t> chooseFarthestLandmarks(const GRAPH& graph, size_t k, unsigned int seed) {
+            const size_t vertices = graph.numberOfVertices();
+            std::vector<nodeid_t> result{};
+            k = std::min(k, vertices);
+            if (k == 0) {
+                return result;
+            }
+            std::mt19937 generator{seed};
+            DijkstraSearch<GRAPH, COST> search{graph};
+            //distance of each vertex from the closest landmark
+            std::vector<COST> closest(vertices, INFINITE_COST);
+            nodeid_t next = std::uniform_int_distribution<nodeid_t>{0, vertices - 1}(generator);
+            search.searchAll(next);
+            while (result.size() < k) {
+                //the farthest vertex reached by the last search
+                nodeid_t farthest = next;
+                COST farthestDistance = -1;
+                for (nodeid_t id=0; id<vertices; ++id) {
+                    const COST distance = std::min(closest[id], search.getDistance(id));
+                    if (distance != INFINITE_COST && distance > farthestDistance && std::find(result.begin(), result.end(), id) == result.end()) {
+                        farthest = id;
+                        farthestDistance = distance;
+                    }
+                }
+                if (farthestDistance <= 0) {
+                    //each vertex reachable is a landmark already (or at distance 0 from one): restart from a vertex no
+                    //landmark reaches or, failing that, from any vertex which is not a landmark
+                    farthest = std::find(closest.begin(), closest.end(), INFINITE_COST) - closest.begin();
+                    if (farthest >= vertices) {
+                        farthest = 0;
+                        while (std::find(result.begin(), result.end(), farthest) != result.end()) {
+                            farthest += 1;
+                        }
+                    }
+                }
+                result.push_back(farthest);
+                next = farthest;
+                search.searchAll(farthest);
+                for (nodeid_t id=0; id<vertices; ++id) {
+                    closest[id] = std::min(closest[id], search.getDistance(id));
+                }
+            }
+            return result;
+        }
+        /**
+         * @brief the "avoid" strategy of Goldberg and Werneck
+         *
+         * We build the shortest path tree of a random vertex @c r. The weight of a vertex @c v is the gap between
+         * `d(r, v)` and the lower bound the landmarks chosen so far give. The size of a vertex is the sum of the weights in
+         * its subtree (0 if the subtree contains a landmark). Starting from the vertex with maximum size, we go down to
+         * the child with maximum size until we reach a leaf, which becomes the new landmark.
+         */
+        template <typename GRAPH>
+        static std::vector<nodeid_t> chooseAvoidLandmarks(const GRAPH& graph, size_t k, unsigned int seed) {
+            const size_t vertices = graph.numberOfVertices();
+            std::vector<nodeid_t> result{};
+            k = std::min(k, vertices);
+            if (k == 0) {
+                return result;
+            }
+            std::mt19937 generator{seed};
+            std::uniform_int_distribution<nodeid_t> distribution{0, vertices - 1};
+            DijkstraSearch<GRAPH, COST> search{graph};
+            //distances from the landmarks chosen so far, landmark-major
+            std::vector<std::vector<COST>> fromChosen{};
+            std::vector<bool> isLandmark(vertices, false);
+            std::vector<nodeid_t> expanded{};
+            std::vector<double> size(vertices, 0);
+            std::vector<bool> containsLandmark(vertices, false);
+            std::vector<nodeid_t> heaviestChild(vertices, 0);
+
+            while (result.size() < k) {
+                const nodeid_t root = distribution(generator);
+                expanded.clear();
+                search.searchUntil(root, [&](nodeid_t id, COST distance) {
+                    expanded.push_back(id);
+                    return false;
+                });
+
+                for (auto id : expanded) {
+                    size[id] = 0;
+                    containsLandmark[id] = isLandmark[id];
+                    heaviestChild[id] = id;
+                }
+                //children come after their parents: visit the tree bottom up
+                for (size_t i=expanded.size(); i>0; --i) {
+                    const nodeid_t id = expanded[i - 1];
+                    if (containsLandmark[id]) {
+                        size[id] = 0;
+                    } else {
+                        COST lowerBound = 0;
+                        for (auto& distances : fromChosen) {
+                            if (distances[root] != INFINITE_COST && distances[id] != INFINITE_COST) {
+                                lowerBound = std::max(lowerBound, static_cast<COST>(distances[id] - distances[root]));
+                            }
+                        }
+                        size[id] += static_cast<double>(search.getDistance(id) - lowerBound);
+                    }
+                    if (id != root) {
+                        const nodeid_t parent = search.getParent(id);
+                        containsLandmark[parent] = containsLandmark[parent] || containsLandmark[id];
+                        size[parent] += size[id];
+                        if (heaviestChild[parent] == parent || size[id] > size[heaviestChild[parent]]) {
+                            heaviestChild[parent] = id;
+                        }
+                    }
+                }
+                for (auto id : expanded) {
+                    if (containsLandmark[id]) {
+                        size[id] = 0;
+                    }
+                }
+
+                nodeid_t landmark = *std::max_element(expanded.begin(), expanded.end(), [&](nodeid_t a, nodeid_t b) { return size[a] < size[b]; });
+                if (size[landmark] <= 0) {
+                    //the tree of root is covered by the landmarks already: try another root, unless every vertex is covered
+                    if (std::find(isLandmark.begin(), isLandmark.end(), false) == isLandmark.end()) {
+                        break;
+                    }
+                    landmark = root;
+                    if (isLandmark[landmark]) {
+                        continue;
+                    }
+                } else {
+                    while (heaviestChild[landmark] != landmark && !containsLandmark[heaviestChild[landmark]]) {
+                        landmark = heaviestChild[landmark];
+                    }
+                }
+
+                result.push_back(landmark);
+                isLandmark[landmark] = true;
+                search.searchAll(landmark);
+                fromChosen.emplace_back(vertices);
+                for (nodeid_t id=0; id<vertices; ++id) {
+                    fromChosen.back()[id] = search.getDistance(id);
+                }
+            }
+            return result;
+        }
+    private:
+        static void markUnreachable(std::vector<COST>& table) {
+            for (auto& distance : table) {
+                distance = std::min(distance, UNREACHABLE);
+            }
+        }
+    private:
+        friend void cpp_utils::serializers::saveToFile<>(FILE* f, const This& landmarks);
+        friend This& cpp_utils::serializers::loadFromFile<>(FILE* f, This& result);
+    };
+
+}
+
+#endif
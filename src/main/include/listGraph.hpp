@@ -78,18 +78,18 @@ namespace cpp_utils::graphs {
             debug("calling endEdges...");
             return typename IImmutableGraph<G,V,E>::const_edge_iterator{new DefaultNumberContainerBasedConstIterator<std::vector<Edge<E>>, Edge<E>>{-1, this->edges}};
         }
+        virtual void forEachEdge(const std::function<void(nodeid_t, nodeid_t, const E&)>& lambda) const {
+            for (auto& edge : this->edges) {
+                lambda(edge.getSourceId(), edge.getSinkId(), edge.getPayload());
+            }
+        }
         virtual const V& getVertex(nodeid_t id) const {
             return this->vertexPayload[id];
         }
         virtual const E& getEdge(nodeid_t sourceId, nodeid_t sinkId) const {
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                if (it->getSourceId() > sourceId) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (it->isCompliant(sourceId, sinkId)) {
-                    return (*it).getPayload();
+            for (auto i=this->getFirstEdgeOf(sourceId); i<this->edges.size() && this->edges[i].hasSource(sourceId); ++i) {
+                if (this->edges[i].hasSink(sinkId)) {
+                    return this->edges[i].getPayload();
                 }
             }
             throw exceptions::ElementNotFoundException<std::pair<nodeid_t, nodeid_t>, const G&>{std::pair<nodeid_t, nodeid_t>{sourceId, sinkId}, this->getPayload()};
@@ -112,18 +112,7 @@ namespace cpp_utils::graphs {
             return result;
         }
         virtual size_t getOutDegree(nodeid_t id) const {
-            size_t result = 0;
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                if (it->getSourceId() > id) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (it->getSourceId() == id) {
-                    result += 1;
-                }
-            }
-            return result;
+            return this->getFirstEdgeOf(id + 1) - this->getFirstEdgeOf(id);
         }
         virtual size_t getDegree(nodeid_t id) const {
             size_t result = 0;
@@ -135,17 +124,8 @@ namespace cpp_utils::graphs {
             return result;
         }
         virtual bool hasSuccessors(nodeid_t id) const {
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                if (it->getSourceId() > id) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (it->getSourceId() == id) {
-                    return true;
-                }
-            }
-            return false;
+            auto i = this->getFirstEdgeOf(id);
+            return i < this->edges.size() && this->edges[i].hasSource(id);
         }
         virtual bool hasPredecessors(nodeid_t id) const {
             for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
@@ -156,35 +136,15 @@ namespace cpp_utils::graphs {
             return false;
         }
         virtual OutEdge<E> getOutEdge(nodeid_t id, moveid_t index) const {
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                if (it->getSourceId() > id) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (it->getSourceId() == id) {
-                    if (index == 0) {
-                        return OutEdge<E>{it->getSinkId(), it->getPayload()};
-                    } else {
-                        index -= 1;
-                    }
-                }
+            auto i = this->getFirstEdgeOf(id) + index;
+            if (i < this->edges.size() && this->edges[i].hasSource(id)) {
+                return OutEdge<E>{this->edges[i].getSinkId(), this->edges[i].getPayload()};
             }
             throw exceptions::ElementNotFoundException<std::pair<nodeid_t, int>, const G&>{std::pair<nodeid_t, nodeid_t>{id, index}, this->getPayload()};
         }
         
         virtual bool hasEdge(nodeid_t sourceId, nodeid_t sinkId) const {
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                if (it->getSourceId() > sourceId) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (it->isCompliant(sourceId, sinkId)) {
-                    return true;
-                }
-            }
-            return false;
+            return this->containsEdge(sourceId, sinkId);
         }
         virtual std::vector<InEdge<E>> getInEdges(nodeid_t id) const {
             std::vector<InEdge<E>> result{};
@@ -197,15 +157,8 @@ namespace cpp_utils::graphs {
         }
         virtual std::vector<OutEdge<E>> getOutEdges(nodeid_t id) const {
             std::vector<OutEdge<E>> result{};
-            for (auto it=this->beginEdges(); it!=this->endEdges(); ++it) {
-                if (it->getSourceId() > id) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (it->hasSource(id)) {
-                    result.push_back(OutEdge<E>{*it});
-                }
+            for (auto i=this->getFirstEdgeOf(id); i<this->edges.size() && this->edges[i].hasSource(id); ++i) {
+                result.push_back(OutEdge<E>{this->edges[i]});
             }
             return result;
         }
@@ -216,13 +169,8 @@ namespace cpp_utils::graphs {
             return id < this->size();
         }
         virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId, const E& payload) const {
-            for (auto i=0; i<this->edges.size(); ++i) {
-                if (this->edges[i].getSourceId() > sourceId) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (this->edges[i].isCompliant(sourceId, sinkId) && this->edges[i].getPayload() == payload) {
+            for (auto i=this->getFirstEdgeOf(sourceId); i<this->edges.size() && this->edges[i].hasSource(sourceId); ++i) {
+                if (this->edges[i].hasSink(sinkId) && this->edges[i].getPayload() == payload) {
                     return true;
                 }
             }
@@ -230,13 +178,8 @@ namespace cpp_utils::graphs {
         }
         //FIXME remove HasEdge from the interface... containsEdge is the same!
         virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkid) const {
-            for (auto i=0; i<this->edges.size(); ++i) {
-                if (this->edges[i].getSourceId() > sourceId) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (this->edges[i].isCompliant(sourceId, sinkid)) {
+            for (auto i=this->getFirstEdgeOf(sourceId); i<this->edges.size() && this->edges[i].hasSource(sourceId); ++i) {
+                if (this->edges[i].hasSink(sinkid)) {
                     return true;
                 }
             }
@@ -251,31 +194,16 @@ namespace cpp_utils::graphs {
             this->vertexPayload[vertexId] = payload;
         }
         virtual void changeWeightEdge(nodeid_t sourceId, nodeid_t sinkId, const E& newPayload) {
-            for (auto i=0; i<this->edges.size(); ++i) {
-                if (this->edges[i].getSourceId() > sourceId) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (this->edges[i].isCompliant(sourceId, sinkId)) {
+            for (auto i=this->getFirstEdgeOf(sourceId); i<this->edges.size() && this->edges[i].hasSource(sourceId); ++i) {
+                if (this->edges[i].hasSink(sinkId)) {
                     this->edges[i].setPayload(newPayload);
                 }
             }
         }
         virtual void changeWeightOutEdge(nodeid_t sourceId, moveid_t index, const E& newPayload) {
-            for (auto i=0; i<this->edges.size(); ++i) {
-                if (this->edges[i].getSourceId() > sourceId) {
-                    //since in the list graph the edges are sorted from sourceId, as soon we find an edge which sourceId is greater than id
-                    // we can safely stop
-                    break;
-                }
-                if (this->edges[i].hasSource(sourceId)) {
-                    if (index == 0) {
-                        this->edges[i].setPayload(newPayload);
-                    } else {
-                        index -= 1;
-                    }
-                }
+            auto i = this->getFirstEdgeOf(sourceId) + index;
+            if (i < this->edges.size() && this->edges[i].hasSource(sourceId)) {
+                this->edges[i].setPayload(newPayload);
             }
         }
     public:
@@ -293,7 +221,7 @@ namespace cpp_utils::graphs {
         virtual void removeEdge(nodeid_t sourceId, nodeid_t sinkId) {
             this->edges.erase(std::remove_if(this->edges.begin(), this->edges.end(), [&sourceId,&sinkId](const Edge<E>& x) {
                 return x.isCompliant(sourceId, sinkId);
-            }));
+            }), this->edges.end());
         }
         virtual void removeAllEdges() {
             this->edges.clear();
@@ -302,6 +230,21 @@ namespace cpp_utils::graphs {
         MemoryConsumption getByteMemoryOccupied() const {
             return MemoryConsumption{sizeof(*this), MemoryConsumptionEnum::BYTE};
         }
+    private:
+        /**
+         * @brief index in ::edges of the first edge whose source is @c sourceId
+         * 
+         * Since edges are sorted by source, it is a binary search.
+         * 
+         * @param sourceId the source to look for
+         * @return size_t the index of the first edge whose source is at least @c sourceId. The size of ::edges if there is none
+         */
+        size_t getFirstEdgeOf(nodeid_t sourceId) const {
+            auto it = std::lower_bound(this->edges.begin(), this->edges.end(), sourceId, [](const Edge<E>& edge, nodeid_t id) {
+                return edge.getSourceId() < id;
+            });
+            return static_cast<size_t>(it - this->edges.begin());
+        }
     };
 
 }
@@ -0,0 +1,471 @@
+#ifndef _CPP_UTILS_MAPPEDADJACENTGRAPH_HEADER__
+#define _CPP_UTILS_MAPPEDADJACENTGRAPH_HEADER__
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <boost/filesystem.hpp>
+
+#include "adjacentGraph.hpp"
+#include "igraph.hpp"
+#include "iterator.hpp"
+#include "MappedFile.hpp"
+#include "serializers.hpp"
+#include "span.hpp"
+
+namespace cpp_utils::graphs {
+
+    template <typename G, typename V, typename E>
+    class MappedAdjacentGraph;
+
+    /**
+     * @brief iterator over all the edges of a MappedAdjacentGraph
+     *
+     * It scans the out edges arrays linearly
+     */
+    template <typename G, typename V, typename E>
+    class MappedAdjacentGraphEdgesIterator: public ::cpp_utils::AbstractConstIterator<Edge<E>&, Edge<E>*> {
+        typedef MappedAdjacentGraphEdgesIterator<G, V, E> This;
+    private:
+        const MappedAdjacentGraph<G, V, E>& graph;
+        /**
+         * @brief source of the edge the iterator is pointing to
+         *
+         */
+        nodeid_t vertex;
+        /**
+         * @brief index of the edge the iterator is pointing to. If it is equal to the number of edges, the iterator has ended
+         *
+         */
+        uint64_t edge;
+        mutable Edge<E> tmp;
+    public:
+        MappedAdjacentGraphEdgesIterator(nodeid_t vertex, uint64_t edge, const MappedAdjacentGraph<G, V, E>& graph): graph{graph}, vertex{vertex}, edge{edge}, tmp{} {
+            this->skipVerticesWithoutEdges();
+        }
+        virtual ~MappedAdjacentGraphEdgesIterator() {
+
+        }
+    public:
+        This& operator++() {
+            if (!this->isEnded()) {
+                this->edge += 1;
+                this->skipVerticesWithoutEdges();
+            }
+            return *this;
+        }
+        cpp_utils::graphs::Edge<E>& operator*() const {
+            this->tmp = Edge<E>{this->vertex, this->graph.edgeSinks[this->edge], this->graph.edgePayloads[this->edge]};
+            return this->tmp;
+        }
+        cpp_utils::graphs::Edge<E>* operator->() const {
+            return &(this->operator*());
+        }
+        bool isEnded() const {
+            return this->edge >= this->graph.numberOfEdges();
+        }
+        bool isEqualTo(const AbstractConstIterator<Edge<E>&, Edge<E>*>* o) const {
+            auto b = static_cast<const This*>(o);
+            if (this->isEnded() || b->isEnded()) {
+                return this->isEnded() == b->isEnded();
+            }
+            return this->edge == b->edge;
+        }
+    private:
+        /**
+         * @brief make sure ::vertex is the source of ::edge
+         *
+         */
+        void skipVerticesWithoutEdges() {
+            if (this->isEnded()) {
+                return;
+            }
+            while (this->graph.outEdgesOfVertexBegin[this->vertex + 1] <= this->edge) {
+                this->vertex += 1;
+            }
+        }
+    };
+
+    /**
+     * @brief a read only AdjacentGraph whose arrays are directly mapped from a file
+     *
+     * The file needs to be generated by cpp_utils::serializers::saveToMappableFile. Opening the graph does not read the
+     * vertices nor the edges: they are used straight from the mapped pages, hence opening the graph takes milliseconds
+     * regardless of its size and several processes opening the same file share one copy of it in the page cache.
+     *
+     * Only the payload of the whole graph is loaded (via cpp_utils::serializers::loadFromFile) in memory.
+     *
+     * @code
+     * FILE* f = fopen("graph.mapped", "wb");
+     * cpp_utils::serializers::saveToMappableFile(f, adjacentGraph);
+     * fclose(f);
+     *
+     * MappedAdjacentGraph<G, V, E> g{"graph.mapped"};
+     * @endcode
+     *
+     * @tparam G custom payload of the whole graph
+     * @tparam V custom payload of each vertex. Needs to be trivially copyable
+     * @tparam E custom payload of each edge. Needs to be trivially copyable
+     */
+    template <typename G, typename V, typename E>
+    class MappedAdjacentGraph: public IImmutableGraph<G, V, E> {
+    public:
+        using This = MappedAdjacentGraph<G, V, E>;
+        using Super = IImmutableGraph<G, V, E>;
+        using const_vertex_iterator = PairNumberContainerBasedConstIterator<ConstSpan<V>, nodeid_t, V>;
+        friend class MappedAdjacentGraphEdgesIterator<G, V, E>;
+    private:
+        MappedFile file;
+        /**
+         * @brief the value attached to the whole graph. The only thing we load in memory
+         *
+         */
+        G payload;
+        ConstSpan<V> vertexPayload;
+        /**
+         * @brief as long as the number of vertices plus 1. Index where in ::edgeSinks the out edges of each vertex start
+         *
+         */
+        const uint64_t* outEdgesOfVertexBegin;
+        const nodeid_t* edgeSinks;
+        const E* edgePayloads;
+        /**
+         * @brief as long as the number of vertices plus 1. Index where in ::inEdgesSource the in edges of each vertex start
+         *
+         * nullptr if the file does not contain the reverse index of the in edges
+         */
+        const uint64_t* inEdgesOfVertexBegin;
+        const nodeid_t* inEdgesSource;
+        const uint64_t* inEdgesOutEdgeIndex;
+        uint64_t edges;
+        /**
+         * @brief true if the out edges of each vertex are sorted by sink. If so, edge lookups perform a binary search
+         *
+         */
+        bool outEdgesSortedBySink;
+    public:
+        /**
+         * @brief map a graph generated by cpp_utils::serializers::saveToMappableFile
+         *
+         * Every array the header points to needs to lie within the file, and the edges of each vertex need to be a valid range.
+         * This takes \f$O(V)\f$: the edges themselves are not read
+         *
+         * @param path the file containing the graph
+         * @throw cpp_utils::exceptions::InvalidFormatException if the file is not a mappable graph, it has been generated with different payload types
+         *  or it is truncated or corrupted
+         */
+        explicit MappedAdjacentGraph(const boost::filesystem::path& path): file{path}, payload{}, vertexPayload{},
+            outEdgesOfVertexBegin{nullptr}, edgeSinks{nullptr}, edgePayloads{nullptr},
+            inEdgesOfVertexBegin{nullptr}, inEdgesSource{nullptr}, inEdgesOutEdgeIndex{nullptr}, edges{0}, outEdgesSortedBySink{false} {
+
+            using namespace cpp_utils::graphs::internal;
+
+            if (this->file.size() < sizeof(MappedAdjacentGraphHeader)) {
+                throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "header"};
+            }
+            const MappedAdjacentGraphHeader* header = reinterpret_cast<const MappedAdjacentGraphHeader*>(this->file.getData());
+            if (std::memcmp(header->magic, MAPPED_ADJACENT_GRAPH_MAGIC, sizeof(header->magic)) != 0) {
+                throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "magic number"};
+            }
+            if (header->version != MAPPED_ADJACENT_GRAPH_VERSION) {
+                throw cpp_utils::exceptions::InvalidFormatException<std::string, uint32_t>{path.native(), header->version};
+            }
+            if (header->sizeOfVertexPayload != sizeof(V) || header->sizeOfEdgePayload != sizeof(E)) {
+                throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "payload sizes"};
+            }
+            const bool hasInEdgesIndex = (header->flags & MAPPED_ADJACENT_GRAPH_HAS_IN_EDGES_INDEX) != 0;
+            const uint64_t vertices = header->numberOfVertices;
+            const uint64_t edges = header->numberOfEdges;
+            if (vertices == std::numeric_limits<uint64_t>::max()
+                || !this->file.containsSection<V>(header->vertexPayloadOffset, vertices)
+                || !this->file.containsSection<uint64_t>(header->outEdgesBeginOffset, vertices + 1)
+                || !this->file.containsSection<nodeid_t>(header->outEdgesSinkOffset, edges)
+                || !this->file.containsSection<E>(header->outEdgesPayloadOffset, edges)
+                || (hasInEdgesIndex && !this->file.containsSection<uint64_t>(header->inEdgesBeginOffset, vertices + 1))
+                || (hasInEdgesIndex && !this->file.containsSection<nodeid_t>(header->inEdgesSourceOffset, edges))
+                || (hasInEdgesIndex && !this->file.containsSection<uint64_t>(header->inEdgesOutEdgeIndexOffset, edges))
+                || header->graphPayloadOffset > this->file.size()) {
+                throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "truncated file"};
+            }
+
+            const char* base = this->file.getData();
+            this->edges = edges;
+            this->vertexPayload = ConstSpan<V>{reinterpret_cast<const V*>(base + header->vertexPayloadOffset), vertices};
+            this->outEdgesOfVertexBegin = reinterpret_cast<const uint64_t*>(base + header->outEdgesBeginOffset);
+            this->edgeSinks = reinterpret_cast<const nodeid_t*>(base + header->outEdgesSinkOffset);
+            this->edgePayloads = reinterpret_cast<const E*>(base + header->outEdgesPayloadOffset);
+            this->outEdgesSortedBySink = (header->flags & MAPPED_ADJACENT_GRAPH_OUT_EDGES_SORTED_BY_SINK) != 0;
+            if (hasInEdgesIndex) {
+                this->inEdgesOfVertexBegin = reinterpret_cast<const uint64_t*>(base + header->inEdgesBeginOffset);
+                this->inEdgesSource = reinterpret_cast<const nodeid_t*>(base + header->inEdgesSourceOffset);
+                this->inEdgesOutEdgeIndex = reinterpret_cast<const uint64_t*>(base + header->inEdgesOutEdgeIndexOffset);
+            }
+            //queries index the edge arrays with these offsets
+            if (!areEdgesOfVertexBeginValid(this->outEdgesOfVertexBegin, vertices, edges)
+                || (hasInEdgesIndex && !areEdgesOfVertexBeginValid(this->inEdgesOfVertexBegin, vertices, edges))) {
+                throw cpp_utils::exceptions::InvalidFormatException<std::string, std::string>{path.native(), "edges of the vertices"};
+            }
+
+            //the payload of the graph is the only thing we need to actually read
+            FILE* f = std::fopen(path.native().c_str(), "rb");
+            if (f == nullptr) {
+                throw cpp_utils::exceptions::FileOpeningException{path};
+            }
+            if (std::fseek(f, header->graphPayloadOffset, SEEK_SET) != 0) {
+                std::fclose(f);
+                throw cpp_utils::exceptions::FileOpeningException{path};
+            }
+            cpp_utils::serializers::loadFromFile(f, this->payload);
+            std::fclose(f);
+        }
+        MappedAdjacentGraph(const This& o) = delete;
+        MappedAdjacentGraph(This&& o) = delete;
+        This& operator =(const This& o) = delete;
+        This& operator =(This&& o) = delete;
+        virtual ~MappedAdjacentGraph() {
+
+        }
+    public:
+        /**
+         * @brief check if the mapped file contains the reverse index of the in edges
+         *
+         * @return true if in edges queries take \f$O(indegree)\f$
+         * @return false otherwise
+         */
+        bool hasInEdgesIndex() const {
+            return this->inEdgesOfVertexBegin != nullptr;
+        }
+        /**
+         * @brief check if the out edges of each vertex are sorted by sink
+         *
+         * @return true if edge lookups take \f$O(\log outdegree)\f$
+         * @return false if edge lookups take \f$O(outdegree)\f$
+         */
+        bool isSortedBySink() const {
+            return this->outEdgesSortedBySink;
+        }
+    private:
+        /**
+         * @brief check that @c begin, an array of @c vertices plus 1 offsets, splits @c edges edges among the vertices
+         *
+         * @return true if the offsets start from 0, never decrease and end at @c edges
+         * @return false otherwise
+         */
+        static bool areEdgesOfVertexBeginValid(const uint64_t* begin, uint64_t vertices, uint64_t edges) {
+            if (begin[0] != 0 || begin[vertices] != edges) {
+                return false;
+            }
+            for (uint64_t id=0; id<vertices; ++id) {
+                if (begin[id] > begin[id + 1]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        /**
+         * @brief the index in ::edgeSinks of the first out edge from @c sourceId to @c sinkId
+         *
+         * @return uint64_t the index of the edge, ::edges if there is no such edge
+         */
+        uint64_t findOutEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            const uint64_t begin = this->outEdgesOfVertexBegin[sourceId];
+            const uint64_t end = this->outEdgesOfVertexBegin[sourceId+1];
+            if (this->outEdgesSortedBySink) {
+                const nodeid_t* it = std::lower_bound(this->edgeSinks + begin, this->edgeSinks + end, sinkId);
+                if (it != (this->edgeSinks + end) && *it == sinkId) {
+                    return static_cast<uint64_t>(it - this->edgeSinks);
+                }
+                return this->edges;
+            }
+            for (auto i=begin; i<end; ++i) {
+                if (this->edgeSinks[i] == sinkId) {
+                    return i;
+                }
+            }
+            return this->edges;
+        }
+    public:
+        virtual size_t size() const {
+            return this->vertexPayload.size();
+        }
+        virtual size_t numberOfVertices() const {
+            return this->vertexPayload.size();
+        }
+        virtual size_t numberOfEdges() const {
+            return this->edges;
+        }
+        virtual typename Super::const_vertex_iterator beginVertices() const {
+            auto it = new const_vertex_iterator{0, this->vertexPayload};
+            return typename Super::const_vertex_iterator{it};
+        }
+        virtual typename Super::const_vertex_iterator endVertices() const {
+            auto it = new const_vertex_iterator{-1, this->vertexPayload};
+            return typename Super::const_vertex_iterator{it};
+        }
+        virtual typename Super::const_edge_iterator beginEdges() const {
+            auto it = new MappedAdjacentGraphEdgesIterator<G, V, E>{0, 0, *this};
+            return typename Super::const_edge_iterator{it};
+        }
+        virtual typename Super::const_edge_iterator endEdges() const {
+            auto it = new MappedAdjacentGraphEdgesIterator<G, V, E>{0, this->edges, *this};
+            return typename Super::const_edge_iterator{it};
+        }
+        virtual void forEachEdge(const std::function<void(nodeid_t, nodeid_t, const E&)>& lambda) const {
+            for (nodeid_t sourceId=0; sourceId<this->numberOfVertices(); ++sourceId) {
+                for (auto i=this->outEdgesOfVertexBegin[sourceId]; i<this->outEdgesOfVertexBegin[sourceId+1]; ++i) {
+                    lambda(sourceId, this->edgeSinks[i], this->edgePayloads[i]);
+                }
+            }
+        }
+        virtual const V& getVertex(nodeid_t id) const {
+            return this->vertexPayload[id];
+        }
+        virtual bool containsVertex(nodeid_t id) const {
+            return id < this->vertexPayload.size();
+        }
+        virtual const E& getEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            auto i = this->findOutEdge(sourceId, sinkId);
+            if (i < this->edges) {
+                return this->edgePayloads[i];
+            }
+            throw cpp_utils::exceptions::ElementNotFoundException<nodeid_t, std::string>{sinkId, this->file.getPath().native()};
+        }
+        virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId, const E& payload) const {
+            for (auto i=this->findOutEdge(sourceId, sinkId); i<this->outEdgesOfVertexBegin[sourceId+1]; ++i) {
+                if (this->edgeSinks[i] == sinkId && this->edgePayloads[i] == payload) {
+                    return true;
+                }
+                if (this->outEdgesSortedBySink && this->edgeSinks[i] != sinkId) {
+                    //parallel edges are contiguous
+                    break;
+                }
+            }
+            return false;
+        }
+        virtual bool containsEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            return this->hasEdge(sourceId, sinkId);
+        }
+        virtual const G& getPayload() const {
+            return this->payload;
+        }
+        virtual G& getPayload() {
+            return this->payload;
+        }
+        virtual size_t getInDegree(nodeid_t id) const {
+            if (this->hasInEdgesIndex()) {
+                return this->inEdgesOfVertexBegin[id+1] - this->inEdgesOfVertexBegin[id];
+            }
+            //like the index, each parallel edge counts (see IImmutableGraph::getInDegree)
+            size_t result = 0;
+            for (uint64_t i=0; i<this->edges; ++i) {
+                if (this->edgeSinks[i] == id) {
+                    result += 1;
+                }
+            }
+            return result;
+        }
+        virtual size_t getOutDegree(nodeid_t id) const {
+            return this->outEdgesOfVertexBegin[id+1] - this->outEdgesOfVertexBegin[id];
+        }
+        virtual size_t getDegree(nodeid_t id) const {
+            return this->getOutDegree(id) + this->getInDegree(id);
+        }
+        virtual bool hasSuccessors(nodeid_t id) const {
+            return this->getOutDegree(id) > 0;
+        }
+        virtual bool hasPredecessors(nodeid_t id) const {
+            if (this->hasInEdgesIndex()) {
+                for (auto i=this->inEdgesOfVertexBegin[id]; i<this->inEdgesOfVertexBegin[id+1]; ++i) {
+                    if (this->inEdgesSource[i] != id) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            for (nodeid_t sourceId=0; sourceId<this->numberOfVertices(); ++sourceId) {
+                if (sourceId != id && this->hasEdge(sourceId, id)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        /**
+         * @brief the sinks of the out edges of a vertex, straight from the mapped pages
+         *
+         * @param id the vertex involved
+         * @return ConstSpan<nodeid_t> the sinks, in the same order of ::getOutEdge
+         */
+        ConstSpan<nodeid_t> outEdgeSinks(nodeid_t id) const {
+            return ConstSpan<nodeid_t>{this->edgeSinks + this->outEdgesOfVertexBegin[id], this->edgeSinks + this->outEdgesOfVertexBegin[id + 1]};
+        }
+        /**
+         * @brief the payloads of the out edges of a vertex, straight from the mapped pages
+         *
+         * @param id the vertex involved
+         * @return ConstSpan<E> the payloads, in the same order of ::outEdgeSinks
+         */
+        ConstSpan<E> outEdgePayloads(nodeid_t id) const {
+            return ConstSpan<E>{this->edgePayloads + this->outEdgesOfVertexBegin[id], this->edgePayloads + this->outEdgesOfVertexBegin[id + 1]};
+        }
+        virtual OutEdge<E> getOutEdge(nodeid_t id, moveid_t index) const {
+            auto i = this->outEdgesOfVertexBegin[id] + index;
+            return OutEdge<E>{this->edgeSinks[i], this->edgePayloads[i]};
+        }
+        virtual bool hasEdge(nodeid_t sourceId, nodeid_t sinkId) const {
+            return this->findOutEdge(sourceId, sinkId) < this->edges;
+        }
+        virtual std::vector<InEdge<E>> getInEdges(nodeid_t id) const {
+            std::vector<InEdge<E>> result{};
+            if (this->hasInEdgesIndex()) {
+                for (auto i=this->inEdgesOfVertexBegin[id]; i<this->inEdgesOfVertexBegin[id+1]; ++i) {
+                    if (this->inEdgesSource[i] != id) {
+                        result.push_back(InEdge<E>{this->inEdgesSource[i], this->edgePayloads[this->inEdgesOutEdgeIndex[i]]});
+                    }
+                }
+                return result;
+            }
+            for (nodeid_t sourceId=0; sourceId<this->numberOfVertices(); ++sourceId) {
+                if (sourceId == id) {
+                    continue;
+                }
+                for (auto i=this->outEdgesOfVertexBegin[sourceId]; i<this->outEdgesOfVertexBegin[sourceId+1]; ++i) {
+                    if (this->edgeSinks[i] == id) {
+                        result.push_back(InEdge<E>{sourceId, this->edgePayloads[i]});
+                    }
+                }
+            }
+            return result;
+        }
+        virtual std::vector<OutEdge<E>> getOutEdges(nodeid_t id) const {
+            std::vector<OutEdge<E>> result{};
+            result.reserve(this->getOutDegree(id));
+            for (auto i=this->outEdgesOfVertexBegin[id]; i<this->outEdgesOfVertexBegin[id+1]; ++i) {
+                result.push_back(OutEdge<E>{this->edgeSinks[i], this->edgePayloads[i]});
+            }
+            return result;
+        }
+        virtual bool isEmpty() const {
+            return this->vertexPayload.empty();
+        }
+    protected:
+        virtual nodeid_t getLastVertexId() const {
+            return this->vertexPayload.size() - 1;
+        }
+    public:
+        /**
+         * @brief memory of the graph
+         *
+         * @note
+         * the mapped file is considered as well, even if its pages might be shared with other processes
+         *
+         * @return MemoryConsumption
+         */
+        virtual MemoryConsumption getByteMemoryOccupied() const {
+            return MemoryConsumption{sizeof(*this) + this->file.size(), MemoryConsumptionEnum::BYTE};
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef _CPP_UTILS_PARALLEL_HEADER__
+#define _CPP_UTILS_PARALLEL_HEADER__
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace cpp_utils {
+
+    /**
+     * @brief number of threads to use when the user does not specify one
+     *
+     * @return std::size_t the number of hardware threads available. At least 1
+     */
+    inline std::size_t getDefaultNumberOfThreads() {
+        std::size_t result = std::thread::hardware_concurrency();
+        return result == 0 ? 1 : result;
+    }
+
+    /**
+     * @brief split a range in contiguous blocks and process each of them in a different thread
+     *
+     * The block @c i is processed by the thread @c i. The first block is processed by the calling thread itself.
+     * The function returns once every block has been processed.
+     *
+     * If @c lambda throws, the exception is rethrown in the calling thread (if several threads throw, the one of the
+     * first block is rethrown).
+     *
+     * @code
+     * parallelForBlocks(0, v.size(), 4, [&](std::size_t threadId, std::size_t begin, std::size_t end) {
+     *  for (auto i=begin; i<end; ++i) {
+     *      v[i] *= 2;
+     *  }
+     * });
+     * @endcode
+     *
+     * @tparam LAMBDA a callable accepting the id of the thread, the beginning and the end (excluded) of the block
+     * @param begin the first index of the range
+     * @param end the index after the last one of the range
+     * @param threads the number of blocks to generate. If 0, we use ::getDefaultNumberOfThreads
+     * @param lambda the function processing a block
+     */
+    template <typename LAMBDA>
+    void parallelForBlocks(std::size_t begin, std::size_t end, std::size_t threads, LAMBDA lambda) {
+        if (threads == 0) {
+            threads = getDefaultNumberOfThreads();
+        }
+        const std::size_t size = end > begin ? end - begin : 0;
+        if (threads == 1 || size <= 1) {
+            lambda(0, begin, begin + size);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(threads, nullptr);
+        auto block = [&](std::size_t threadId) {
+            try {
+                lambda(threadId, begin + (size * threadId) / threads, begin + (size * (threadId + 1)) / threads);
+            } catch (...) {
+                errors[threadId] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers{};
+        workers.reserve(threads - 1);
+        for (std::size_t threadId=1; threadId<threads; ++threadId) {
+            workers.emplace_back(block, threadId);
+        }
+        block(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (auto& error : errors) {
+            if (error != nullptr) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    /**
+     * @brief process each index of a range in one of several threads, balancing the load dynamically
+     *
+     * Unlike ::parallelForBlocks, indices are not split in advance: each thread picks the next index not processed yet,
+     * so expensive indices do not leave the other threads idle. Use it when the cost of each index varies a lot.
+     *
+     * @code
+     * parallelForEach(0, queries.size(), 4, [&](std::size_t threadId, std::size_t i) {
+     *  results[i] = searches[threadId].search(queries[i]);
+     * });
+     * @endcode
+     *
+     * @tparam LAMBDA a callable accepting the id of the thread and the index to process
+     * @param begin the first index of the range
+     * @param end the index after the last one of the range
+     * @param threads the number of threads to use. If 0, we use ::getDefaultNumberOfThreads
+     * @param lambda the function processing an index
+     */
+    template <typename LAMBDA>
+    void parallelForEach(std::size_t begin, std::size_t end, std::size_t threads, LAMBDA lambda) {
+        if (threads == 0) {
+            threads = getDefaultNumberOfThreads();
+        }
+        std::atomic<std::size_t> next{begin};
+        parallelForBlocks(0, threads, threads, [&](std::size_t threadId, std::size_t, std::size_t) {
+            for (std::size_t i = next.fetch_add(1); i < end; i = next.fetch_add(1)) {
+                lambda(threadId, i);
+            }
+        });
+    }
+
+}
+
+#endif
@@ -0,0 +1,497 @@
+#ifndef _CPP_UTILS_PARTITIONING_HEADER__
+#define _CPP_UTILS_PARTITIONING_HEADER__
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "igraph.hpp"
+#include "adjacentGraph.hpp"
+#include "dijkstra.hpp"
+#include "exceptions.hpp"
+#include "parallel.hpp"
+#include "serializers.hpp"
+
+namespace cpp_utils::graphs {
+
+    template <typename G, typename V, typename E>
+    class GraphCell;
+
+}
+
+namespace cpp_utils::serializers {
+
+    /**
+     * Save a cell of a partitioned graph into a file
+     *
+     * @pre
+     *  @li @c f open with "wb";
+     * @post
+     *  @li @c f modified;
+     *  @li @c f cursor modified;
+     *
+     * @param[in] f the file to save the cell into
+     * @param[in] cell the cell to save
+     */
+    template <typename G, typename V, typename E>
+    void saveToFile(FILE* f, const cpp_utils::graphs::GraphCell<G, V, E>& cell) {
+        saveToFile(f, cell.cellId);
+        saveToFile(f, cell.graph);
+        saveToFile(f, cell.globalIds);
+        saveToFile(f, cell.boundaryVertices);
+        saveToFile(f, cell.cutEdges);
+    }
+
+    /**
+     * Load a cell of a partitioned graph from a file
+     *
+     * @pre
+     *  @li @c f open in "rb";
+     * @post
+     *  @li @c f cursor modified;
+     *
+     * @param[in] f the file to read the cell from;
+     * @return the cell loaded
+     */
+    template <typename G, typename V, typename E>
+    cpp_utils::graphs::GraphCell<G, V, E>& loadFromFile(FILE* f, cpp_utils::graphs::GraphCell<G, V, E>& result) {
+        loadFromFile(f, result.cellId);
+        loadFromFile(f, result.graph);
+        loadFromFile(f, result.globalIds);
+        loadFromFile(f, result.boundaryVertices);
+        loadFromFile(f, result.cutEdges);
+
+        return result;
+    }
+
+}
+
+namespace cpp_utils::graphs::internal {
+
+    /**
+     * @brief the undirected, weighted graph the partitioner works on
+     *
+     * Both directions of an edge are stored. The weight of a vertex is the number of vertices of the input graph it
+     * represents, the weight of an edge the number of edges of the input graph it represents.
+     */
+    struct PartitionGraph {
+        std::vector<uint32_t> vertexWeights;
+        /**
+         * @brief the neighbours of vertex @c v are in the cells from `adjacencyBegin[v]` (included) to `adjacencyBegin[v + 1]` (excluded)
+         *
+         */
+        std::vector<uint64_t> adjacencyBegin;
+        std::vector<uint32_t> neighbours;
+        std::vector<uint32_t> edgeWeights;
+
+        uint32_t numberOfVertices() const {
+            return static_cast<uint32_t>(this->vertexWeights.size());
+        }
+        uint64_t getTotalWeight() const;
+
+        /**
+         * @brief build the graph of some directed edges
+         *
+         * Direction is ignored, self loops are dropped and parallel edges are merged into a single edge, weighted by their number.
+         *
+         * @param vertices number of vertices
+         * @param edges the edges. Shuffled by the call
+         * @return PartitionGraph the graph, where each vertex has weight 1
+         */
+        static PartitionGraph fromEdges(uint32_t vertices, std::vector<std::pair<uint32_t, uint32_t>>& edges);
+    };
+
+    /**
+     * @brief split a graph into balanced cells via multilevel recursive bisection
+     *
+     * @param graph the graph to split
+     * @param k the number of cells
+     * @param imbalance each cell weights at most `(1 + imbalance)` times the average weight of the cells (modulo rounding)
+     * @param seed seed of the random choices
+     * @return std::vector<uint32_t> the cell of each vertex
+     */
+    std::vector<uint32_t> computeRecursiveBisection(const PartitionGraph& graph, uint32_t k, double imbalance, unsigned int seed);
+
+}
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief a cell of a partitioned graph, as a graph on its own
+     *
+     * Vertices of the cell have their own ids (local ids), ordered as their ids in the whole graph (global ids). The cell
+     * contains every edge whose endpoints are both in the cell. Edges leaving the cell are kept apart, as cut edges.
+     *
+     * A cell can be stored via cpp_utils::serializers::saveToFile and loaded in another process via
+     * cpp_utils::serializers::loadFromFile: it does not need anything else to compute its part of an OverlayGraph (see ::getBoundaryDistances).
+     *
+     * @tparam G type of the payload of the graph
+     * @tparam V type of the payload of each vertex
+     * @tparam E type of the payload of each edge
+     */
+    template <typename G, typename V, typename E>
+    class GraphCell {
+        using This = GraphCell<G, V, E>;
+        friend void cpp_utils::serializers::saveToFile<>(FILE* f, const This& cell);
+        friend This& cpp_utils::serializers::loadFromFile<>(FILE* f, This& result);
+    private:
+        uint32_t cellId;
+        AdjacentGraph<G, V, E> graph;
+        /**
+         * @brief the global id of each local vertex
+         *
+         */
+        std::vector<nodeid_t> globalIds;
+        /**
+         * @brief local ids of the vertices with an edge from or to another cell, in increasing order
+         *
+         */
+        std::vector<nodeid_t> boundaryVertices;
+        /**
+         * @brief the edges from this cell to another one, with global ids
+         *
+         */
+        std::vector<Edge<E>> cutEdges;
+    public:
+        /**
+         * @brief an empty cell. Use it to load a cell via cpp_utils::serializers::loadFromFile
+         *
+         */
+        GraphCell(): cellId{0}, graph{}, globalIds{}, boundaryVertices{}, cutEdges{} {
+
+        }
+        GraphCell(uint32_t cellId, AdjacentGraph<G, V, E>&& graph, std::vector<nodeid_t>&& globalIds, std::vector<nodeid_t>&& boundaryVertices, std::vector<Edge<E>>&& cutEdges):
+            cellId{cellId}, graph{std::move(graph)}, globalIds{std::move(globalIds)}, boundaryVertices{std::move(boundaryVertices)}, cutEdges{std::move(cutEdges)} {
+
+        }
+        GraphCell(const This& o) = default;
+        GraphCell(This&& o) = default;
+        This& operator=(const This& o) = default;
+        This& operator=(This&& o) = default;
+        virtual ~GraphCell() {
+
+        }
+    public:
+        uint32_t getCellId() const {
+            return this->cellId;
+        }
+        const AdjacentGraph<G, V, E>& getGraph() const {
+            return this->graph;
+        }
+        nodeid_t getGlobalId(nodeid_t localId) const {
+            return this->globalIds[localId];
+        }
+        const std::vector<nodeid_t>& getGlobalIds() const {
+            return this->globalIds;
+        }
+        const std::vector<nodeid_t>& getBoundaryVertices() const {
+            return this->boundaryVertices;
+        }
+        const std::vector<Edge<E>>& getCutEdges() const {
+            return this->cutEdges;
+        }
+        /**
+         * @brief the distances between the boundary vertices of the cell, using only the edges of the cell
+         *
+         * These are the edges of the clique the cell contributes to an OverlayGraph.
+         *
+         * @tparam COST type of the cost of a path. Edge weights need to be non negative
+         * @return std::vector<Edge<COST>> an edge for each pair of different boundary vertices connected inside the cell, with global ids
+         */
+        template <typename COST>
+        std::vector<Edge<COST>> getBoundaryDistances() const {
+            std::vector<Edge<COST>> result{};
+            DijkstraSearch<AdjacentGraph<G, V, E>, COST> search{this->graph};
+            for (auto sourceId : this->boundaryVertices) {
+                //the search stops once every boundary vertex has been reached
+                auto distances = search.search(sourceId, this->boundaryVertices);
+                for (size_t i=0; i<this->boundaryVertices.size(); ++i) {
+                    const nodeid_t sinkId = this->boundaryVertices[i];
+                    if (sinkId != sourceId && distances[i] != search.INFINITE_COST) {
+                        result.emplace_back(this->globalIds[sourceId], this->globalIds[sinkId], distances[i]);
+                    }
+                }
+            }
+            return result;
+        }
+    };
+
+    /**
+     * @brief a split of the vertices of a graph into k balanced cells with few edges between them
+     *
+     * The partition is computed via multilevel recursive bisection (like METIS): the graph is coarsened by contracting a heavy
+     * edge matching until it is small, the coarsest graph is bisected by growing a region from several random vertices, and
+     * the bisection is projected back level by level, refining it via Fiduccia-Mattheyses at each level. Edge directions and
+     * payloads are ignored: the partition minimizes the number of edges between different cells.
+     *
+     * Once the cells are known, ::extractCells turns each of them into a GraphCell, which can be handled by a different
+     * process (or machine); the OverlayGraph of the cells answers distance queries between the boundaries of the cells.
+     *
+     * @code
+     * GraphPartition partition{graph, 16};
+     * auto cells = partition.extractCells(graph);
+     * OverlayGraph<long> overlay{cells};
+     * @endcode
+     */
+    class GraphPartition {
+    private:
+        uint32_t k;
+        std::vector<uint32_t> cells;
+        std::vector<bool> boundary;
+        size_t cutEdges;
+    public:
+        GraphPartition(): k{0}, cells{}, boundary{}, cutEdges{0} {
+
+        }
+        /**
+         * @brief partition a graph
+         *
+         * @tparam GRAPH type of the graph (pass the concrete one, see cpp_utils::graphs::forEachOutEdge)
+         * @param graph the graph to partition
+         * @param k the number of cells
+         * @param imbalance each cell contains at most `(1 + imbalance)` times the average number of vertices of the cells (modulo rounding)
+         * @param seed seed of the random choices
+         */
+        template <typename GRAPH>
+        GraphPartition(const GRAPH& graph, uint32_t k, double imbalance = 0.03, unsigned int seed = 0): k{k}, cells{}, boundary(graph.numberOfVertices(), false), cutEdges{0} {
+            const size_t vertices = graph.numberOfVertices();
+            if (k == 0) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"the number of cells needs to be positive"};
+            }
+            if (vertices >= std::numeric_limits<uint32_t>::max()) {
+                throw cpp_utils::exceptions::InvalidArgumentException{"the graph can contain at most", std::numeric_limits<uint32_t>::max() - 1, "vertices, but we have", vertices};
+            }
+
+            std::vector<std::pair<uint32_t, uint32_t>> edges{};
+            edges.reserve(graph.numberOfEdges());
+            forEachEdge(graph, [&](nodeid_t sourceId, nodeid_t sinkId, const auto& payload) {
+                edges.emplace_back(static_cast<uint32_t>(sourceId), static_cast<uint32_t>(sinkId));
+            });
+            this->cells = internal::computeRecursiveBisection(internal::PartitionGraph::fromEdges(static_cast<uint32_t>(vertices), edges), k, imbalance, seed);
+
+            forEachEdge(graph, [&](nodeid_t sourceId, nodeid_t sinkId, const auto& payload) {
+                if (this->cells[sourceId] != this->cells[sinkId]) {
+                    this->boundary[sourceId] = true;
+                    this->boundary[sinkId] = true;
+                    this->cutEdges += 1;
+                }
+            });
+        }
+        GraphPartition(const GraphPartition& o) = default;
+        GraphPartition(GraphPartition&& o) = default;
+        GraphPartition& operator=(const GraphPartition& o) = default;
+        GraphPartition& operator=(GraphPartition&& o) = default;
+        virtual ~GraphPartition() {
+
+        }
+    public:
+        uint32_t numberOfCells() const {
+            return this->k;
+        }
+        uint32_t getCell(nodeid_t id) const {
+            return this->cells[id];
+        }
+        const std::vector<uint32_t>& getCells() const {
+            return this->cells;
+        }
+        /**
+         * @brief check if a vertex has an edge from or to another cell
+         *
+         */
+        bool isBoundary(nodeid_t id) const {
+            return this->boundary[id];
+        }
+        /**
+         * @brief the number of edges whose endpoints are in different cells
+         *
+         */
+        size_t numberOfCutEdges() const {
+            return this->cutEdges;
+        }
+        /**
+         * @brief the number of vertices in each cell
+         *
+         * @return std::vector<size_t> the cell @c i is the number of vertices in cell @c i
+         */
+        std::vector<size_t> getCellSizes() const {
+            std::vector<size_t> result(this->k, 0);
+            for (auto cell : this->cells) {
+                result[cell] += 1;
+            }
+            return result;
+        }
+        /**
+         * @brief split the graph this partition was computed on into its cells
+         *
+         * @param graph the graph partitioned
+         * @param threads number of threads building the cells. If 0, we use cpp_utils::getDefaultNumberOfThreads
+         * @return std::vector<GraphCell<G, V, E>> the cell @c i contains the vertices in cell @c i. Its payload is the payload of @c graph
+         */
+        template <typename G, typename V, typename E>
+        std::vector<GraphCell<G, V, E>> extractCells(const IImmutableGraph<G, V, E>& graph, size_t threads = 0) const {
+            const size_t vertices = graph.numberOfVertices();
+            std::vector<nodeid_t> localIds(vertices);
+            std::vector<std::vector<nodeid_t>> globalIds(this->k);
+            std::vector<std::vector<V>> vertexPayloads(this->k);
+            std::vector<std::vector<nodeid_t>> boundaryVertices(this->k);
+            for (nodeid_t id=0; id<vertices; ++id) {
+                const uint32_t cell = this->cells[id];
+                localIds[id] = globalIds[cell].size();
+                if (this->boundary[id]) {
+                    boundaryVertices[cell].push_back(localIds[id]);
+                }
+                globalIds[cell].push_back(id);
+                vertexPayloads[cell].push_back(graph.getVertex(id));
+            }
+
+            std::vector<std::vector<Edge<E>>> edges(this->k);
+            std::vector<std::vector<Edge<E>>> cutEdges(this->k);
+            graph.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const E& payload) {
+                const uint32_t cell = this->cells[sourceId];
+                if (cell == this->cells[sinkId]) {
+                    edges[cell].emplace_back(localIds[sourceId], localIds[sinkId], payload);
+                } else {
+                    cutEdges[cell].emplace_back(sourceId, sinkId, payload);
+                }
+            });
+
+            std::vector<GraphCell<G, V, E>> result(this->k);
+            parallelForEach(0, this->k, threads, [&](size_t threadId, size_t cell) {
+                result[cell] = GraphCell<G, V, E>{
+                    static_cast<uint32_t>(cell),
+                    AdjacentGraph<G, V, E>::fromEdges(graph.getPayload(), vertexPayloads[cell], edges[cell], 1),
+                    std::move(globalIds[cell]),
+                    std::move(boundaryVertices[cell]),
+                    std::move(cutEdges[cell])
+                };
+                edges[cell] = std::vector<Edge<E>>{};
+            });
+            return result;
+        }
+    };
+
+    /**
+     * @brief the graph of the boundary vertices of the cells of a partition
+     *
+     * Each cell contributes a clique over its boundary vertices, whose edges are the distances inside the cell, and its cut
+     * edges. Hence, the distance between 2 boundary vertices in the overlay is the same as in the whole graph. The overlay
+     * vertices are ordered as their global ids, and the payload of each of them is its global id.
+     *
+     * The cliques can be computed wherever the cells are (see GraphCell::getBoundaryDistances) and then merged here.
+     *
+     * @tparam COST type of the cost of a path. Edge weights need to be non negative
+     */
+    template <typename COST>
+    class OverlayGraph {
+        using This = OverlayGraph<COST>;
+    public:
+        /**
+         * @brief overlay id of the vertices not in the overlay
+         *
+         */
+        static constexpr nodeid_t NO_VERTEX = std::numeric_limits<nodeid_t>::max();
+    private:
+        AdjacentGraph<int, nodeid_t, COST> graph;
+        /**
+         * @brief the overlay id of each global vertex. ::NO_VERTEX if the vertex is not a boundary one
+         *
+         */
+        std::vector<nodeid_t> overlayIds;
+    public:
+        OverlayGraph(): graph{0}, overlayIds{} {
+
+        }
+        /**
+         * @brief build the overlay of some cells, computing their cliques in parallel
+         *
+         * @param cells all the cells of a partition
+         * @param threads number of threads to use. If 0, we use cpp_utils::getDefaultNumberOfThreads
+         */
+        template <typename G, typename V, typename E>
+        OverlayGraph(const std::vector<GraphCell<G, V, E>>& cells, size_t threads = 0): OverlayGraph{countVertices(cells), collectEdges(cells, threads), threads} {
+
+        }
+        /**
+         * @brief build the overlay from edges computed elsewhere
+         *
+         * @param vertices number of vertices of the whole graph
+         * @param edgeBuffers the cliques and the cut edges of every cell, with global ids. The overlay contains every vertex involved
+         * @param threads number of threads to use. If 0, we use cpp_utils::getDefaultNumberOfThreads
+         */
+        OverlayGraph(size_t vertices, const std::vector<std::vector<Edge<COST>>>& edgeBuffers, size_t threads = 0): graph{0}, overlayIds(vertices, NO_VERTEX) {
+            for (const auto& buffer : edgeBuffers) {
+                for (const auto& edge : buffer) {
+                    this->overlayIds[edge.getSourceId()] = 0;
+                    this->overlayIds[edge.getSinkId()] = 0;
+                }
+            }
+            std::vector<nodeid_t> globalIds{};
+            for (nodeid_t id=0; id<vertices; ++id) {
+                if (this->overlayIds[id] != NO_VERTEX) {
+                    this->overlayIds[id] = globalIds.size();
+                    globalIds.push_back(id);
+                }
+            }
+
+            std::vector<std::vector<Edge<COST>>> overlayEdges(edgeBuffers.size());
+            for (size_t i=0; i<edgeBuffers.size(); ++i) {
+                overlayEdges[i].reserve(edgeBuffers[i].size());
+                for (const auto& edge : edgeBuffers[i]) {
+                    overlayEdges[i].emplace_back(this->overlayIds[edge.getSourceId()], this->overlayIds[edge.getSinkId()], edge.getPayload());
+                }
+            }
+            this->graph = AdjacentGraph<int, nodeid_t, COST>::fromEdges(0, globalIds, overlayEdges, threads);
+        }
+        OverlayGraph(const This& o) = default;
+        OverlayGraph(This&& o) = default;
+        This& operator=(const This& o) = default;
+        This& operator=(This&& o) = default;
+        virtual ~OverlayGraph() {
+
+        }
+    public:
+        const AdjacentGraph<int, nodeid_t, COST>& getGraph() const {
+            return this->graph;
+        }
+        size_t numberOfVertices() const {
+            return this->graph.numberOfVertices();
+        }
+        /**
+         * @brief the overlay id of a vertex of the whole graph
+         *
+         * @param globalId the id of the vertex in the whole graph
+         * @return nodeid_t its id in the overlay. ::NO_VERTEX if it is not a boundary vertex
+         */
+        nodeid_t getOverlayId(nodeid_t globalId) const {
+            return this->overlayIds[globalId];
+        }
+        nodeid_t getGlobalId(nodeid_t overlayId) const {
+            return this->graph.getVertex(overlayId);
+        }
+    private:
+        template <typename G, typename V, typename E>
+        static size_t countVertices(const std::vector<GraphCell<G, V, E>>& cells) {
+            size_t result = 0;
+            for (const auto& cell : cells) {
+                result += cell.getGraph().numberOfVertices();
+            }
+            return result;
+        }
+        template <typename G, typename V, typename E>
+        static std::vector<std::vector<Edge<COST>>> collectEdges(const std::vector<GraphCell<G, V, E>>& cells, size_t threads) {
+            std::vector<std::vector<Edge<COST>>> result(cells.size());
+            parallelForEach(0, cells.size(), threads, [&](size_t threadId, size_t cell) {
+                result[cell] = cells[cell].template getBoundaryDistances<COST>();
+                for (const auto& edge : cells[cell].getCutEdges()) {
+                    result[cell].emplace_back(edge.getSourceId(), edge.getSinkId(), static_cast<COST>(edge.getPayload()));
+                }
+            });
+            return result;
+        }
+    };
+
+}
+
+#endif
@@ -72,6 +72,29 @@ namespace cpp_utils {
 		void setHorizontalLine(size_t y, size_t left, size_t right, const color_t& color, bool rightIncluded = false);
 		void setVerticalLine(size_t x, size_t top, size_t bottom, const color_t& color, bool bottomIncluded = false);
 		void setAllPixels(const color_t& color);
+		/**
+		 * @brief draw a segment between 2 pixels (both included) with the Bresenham algorithm
+		 * 
+		 * Coordinates may lie outside the image: only the pixels inside it are set
+		 * 
+		 * @param x0 x of the first endpoint
+		 * @param y0 y of the first endpoint
+		 * @param x1 x of the second endpoint
+		 * @param y1 y of the second endpoint
+		 * @param color color of the segment
+		 */
+		void setLine(long x0, long y0, long x1, long y1, const color_t& color);
+		/**
+		 * @brief draw a filled square centered in a pixel
+		 * 
+		 * Coordinates may lie outside the image: only the pixels inside it are set
+		 * 
+		 * @param x x of the center
+		 * @param y y of the center
+		 * @param radius half the side of the square. 0 sets only the center
+		 * @param color color of the square
+		 */
+		void setSquare(long x, long y, size_t radius, const color_t& color);
 		void mergePixel(size_t x, size_t y, const color_t& color);
 		void merge(const PPMImage& other);
 		PPMImage& mean(const PPMImage& other);
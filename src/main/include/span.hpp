@@ -0,0 +1,72 @@
+#ifndef _CPP_UTILS_SPAN_HEADER__
+#define _CPP_UTILS_SPAN_HEADER__
+
+#include <cstddef>
+
+namespace cpp_utils {
+
+    /**
+     * @brief a read only view over a contiguous area of memory
+     * 
+     * The span does **not** own the memory it refers to: it is just a pair of pointers. Hence it is cheap to copy
+     * and it can be safely returned by value from hot code. The owner of the memory needs to outlive the span.
+     * 
+     * @code
+     * ConstSpan<int> span{v.data(), v.size()};
+     * for (auto& x: span) {
+     *  ...
+     * }
+     * @endcode
+     * 
+     * @tparam T type of the elements in the memory area
+     */
+    template <typename T>
+    class ConstSpan {
+    public:
+        using value_type = T;
+        using const_iterator = const T*;
+    private:
+        /**
+         * @brief the first element of the span
+         * 
+         */
+        const T* first;
+        /**
+         * @brief the element after the last one of the span
+         * 
+         */
+        const T* last;
+    public:
+        ConstSpan(): first{nullptr}, last{nullptr} {
+
+        }
+        ConstSpan(const T* first, const T* last): first{first}, last{last} {
+
+        }
+        ConstSpan(const T* first, std::size_t size): first{first}, last{first + size} {
+
+        }
+    public:
+        const T* begin() const {
+            return this->first;
+        }
+        const T* end() const {
+            return this->last;
+        }
+        const T* data() const {
+            return this->first;
+        }
+        std::size_t size() const {
+            return static_cast<std::size_t>(this->last - this->first);
+        }
+        bool empty() const {
+            return this->first == this->last;
+        }
+        const T& operator[](std::size_t i) const {
+            return this->first[i];
+        }
+    };
+
+}
+
+#endif
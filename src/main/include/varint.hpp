@@ -0,0 +1,83 @@
+#ifndef _CPP_UTILS_VARINT_HEADER__
+#define _CPP_UTILS_VARINT_HEADER__
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file
+ * @brief variable length encoding of integers (LEB128)
+ *
+ * Each byte stores 7 bits of the number, from the least significant ones: the most significant bit of the byte is set
+ * if other bytes follow. Small numbers take few bytes: numbers less than 128 take 1 byte, a `uint64_t` at most 10.
+ *
+ * @code
+ * std::vector<uint8_t> buffer{};
+ * appendVarint(buffer, 300);
+ * const uint8_t* position = buffer.data();
+ * uint64_t x = readVarint(position); //300
+ * @endcode
+ */
+
+namespace cpp_utils {
+
+    /**
+     * @brief encode a number at the end of a buffer
+     *
+     * @param buffer the buffer to extend
+     * @param value the number to encode
+     */
+    inline void appendVarint(std::vector<uint8_t>& buffer, uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(value));
+    }
+
+    /**
+     * @brief decode a number
+     *
+     * @param position the first byte of the number. After the call, the byte after the number
+     * @return uint64_t the number decoded
+     */
+    inline uint64_t readVarint(const uint8_t*& position) {
+        uint64_t result = *position++;
+        if (result < 0x80) {
+            return result;
+        }
+        result &= 0x7F;
+        for (int shift=7; ; shift+=7) {
+            uint64_t byte = *position++;
+            result |= (byte & 0x7F) << shift;
+            if (byte < 0x80) {
+                return result;
+            }
+        }
+    }
+
+    /**
+     * @brief map a signed number into an unsigned one, such that numbers close to 0 stay small
+     *
+     * 0 becomes 0, -1 becomes 1, 1 becomes 2, -2 becomes 3 and so on. Use it before ::appendVarint to encode signed numbers.
+     *
+     * @param value the number to map
+     * @return uint64_t the mapped number
+     */
+    inline uint64_t zigzagEncode(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    /**
+     * @brief the inverse of ::zigzagEncode
+     *
+     * @param value a number generated by ::zigzagEncode
+     * @return int64_t the original signed number
+     */
+    inline int64_t zigzagDecode(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+}
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef _CPP_UTILS_VERTEXORDERING_HEADER__
+#define _CPP_UTILS_VERTEXORDERING_HEADER__
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "igraph.hpp"
+
+/**
+ * @file
+ * @brief permutations of the vertices of a graph which improve the locality of the memory accesses
+ *
+ * Each generator yields a `fromNewToOld` vector: the cell @c i contains the (old) id of the vertex which will have id @c i.
+ * Use ::invertPermutation to generate `fromOldToNew` and then IImmutableGraph::reorderVertices to relabel the graph:
+ *
+ * @code
+ * auto fromNewToOld = getReverseCuthillMcKeeOrder(graph);
+ * auto fromOldToNew = invertPermutation(fromNewToOld);
+ * auto reordered = graph.reorderVertices(fromOldToNew, fromNewToOld);
+ * @endcode
+ *
+ * Vertices close in the new order tend to be close in the graph, hence a search touches fewer cache lines.
+ */
+
+namespace cpp_utils::graphs {
+
+    /**
+     * @brief invert a permutation of the vertices
+     *
+     * @param permutation either `fromNewToOld` or `fromOldToNew`
+     * @return std::vector<nodeid_t> the other permutation
+     */
+    inline std::vector<nodeid_t> invertPermutation(const std::vector<nodeid_t>& permutation) {
+        std::vector<nodeid_t> result(permutation.size());
+        for (nodeid_t i=0; i<permutation.size(); ++i) {
+            result[permutation[i]] = i;
+        }
+        return result;
+    }
+
+    /**
+     * @brief order the vertices as they are discovered by a breadth first visit
+     *
+     * Vertices not reachable from @c root are visited afterwards, starting from the unvisited vertex with the smallest id.
+     *
+     * @tparam GRAPH type of the graph
+     * @param graph the graph to visit
+     * @param root the first vertex to visit
+     * @return std::vector<nodeid_t> `fromNewToOld`
+     */
+    template <typename GRAPH>
+    std::vector<nodeid_t> getBFSOrder(const GRAPH& graph, nodeid_t root = 0) {
+        const size_t vertices = graph.numberOfVertices();
+        std::vector<nodeid_t> result{};
+        result.reserve(vertices);
+        std::vector<bool> visited(vertices, false);
+
+        //result is the queue of the visit as well
+        auto visitFrom = [&](nodeid_t start) {
+            size_t head = result.size();
+            visited[start] = true;
+            result.push_back(start);
+            while (head < result.size()) {
+                nodeid_t id = result[head++];
+                forEachOutEdge(graph, id, [&](const auto& outEdge) {
+                    if (!visited[outEdge.getSinkId()]) {
+                        visited[outEdge.getSinkId()] = true;
+                        result.push_back(outEdge.getSinkId());
+                    }
+                });
+            }
+        };
+
+        if (root < vertices) {
+            visitFrom(root);
+        }
+        for (nodeid_t id=0; id<vertices; ++id) {
+            if (!visited[id]) {
+                visitFrom(id);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief order the vertices as they are discovered by a depth first visit (preorder)
+     *
+     * Each subtree of the visit gets a contiguous range of ids. Vertices not reachable from @c root are visited afterwards,
+     * starting from the unvisited vertex with the smallest id.
+     *
+     * @tparam GRAPH type of the graph
+     * @param graph the graph to visit
+     * @param root the first vertex to visit
+     * @return std::vector<nodeid_t> `fromNewToOld`
+     */
+    template <typename GRAPH>
+    std::vector<nodeid_t> getDFSOrder(const GRAPH& graph, nodeid_t root = 0) {
+        const size_t vertices = graph.numberOfVertices();
+        std::vector<nodeid_t> result{};
+        result.reserve(vertices);
+        std::vector<bool> visited(vertices, false);
+        //an explicit stack: the recursion would overflow on long paths
+        std::vector<nodeid_t> stack{};
+        std::vector<nodeid_t> successors{};
+
+        auto visitFrom = [&](nodeid_t start) {
+            stack.push_back(start);
+            while (!stack.empty()) {
+                nodeid_t id = stack.back();
+                stack.pop_back();
+                if (visited[id]) {
+                    continue;
+                }
+                visited[id] = true;
+                result.push_back(id);
+                //push the successors backwards, so the first out edge is visited first
+                successors.clear();
+                forEachOutEdge(graph, id, [&](const auto& outEdge) {
+                    if (!visited[outEdge.getSinkId()]) {
+                        successors.push_back(outEdge.getSinkId());
+                    }
+                });
+                stack.insert(stack.end(), successors.rbegin(), successors.rend());
+            }
+        };
+
+        if (root < vertices) {
+            visitFrom(root);
+        }
+        for (nodeid_t id=0; id<vertices; ++id) {
+            if (!visited[id]) {
+                visitFrom(id);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief order the vertices by decreasing out degree
+     *
+     * Vertices with the same out degree are ordered by id. It is a counting sort, hence it takes \f$O(V)\f$.
+     *
+     * @tparam GRAPH type of the graph
+     * @param graph the graph to consider
+     * @return std::vector<nodeid_t> `fromNewToOld`
+     */
+    template <typename GRAPH>
+    std::vector<nodeid_t> getDegreeDescendingOrder(const GRAPH& graph) {
+        const size_t vertices = graph.numberOfVertices();
+        std::vector<size_t> degrees(vertices);
+        size_t maxDegree = 0;
+        for (nodeid_t id=0; id<vertices; ++id) {
+            degrees[id] = graph.getOutDegree(id);
+            maxDegree = std::max(maxDegree, degrees[id]);
+        }
+
+        //position where the first vertex with a certain degree will go
+        std::vector<size_t> position(maxDegree + 2, 0);
+        for (nodeid_t id=0; id<vertices; ++id) {
+            position[maxDegree - degrees[id] + 1] += 1;
+        }
+        for (size_t i=1; i<position.size(); ++i) {
+            position[i] += position[i - 1];
+        }
+        std::vector<nodeid_t> result(vertices);
+        for (nodeid_t id=0; id<vertices; ++id) {
+            result[position[maxDegree - degrees[id]]++] = id;
+        }
+        return result;
+    }
+
+    /**
+     * @brief order the vertices via the Reverse Cuthill-McKee algorithm
+     *
+     * A breadth first visit where the neighbours of a vertex are enqueued by increasing degree; every visit starts from a
+     * vertex with minimum degree. The final order is reversed. It minimizes the bandwidth of the adjacency matrix, namely the
+     * difference between the ids of the endpoints of an edge.
+     *
+     * @note
+     * the algorithm is meant for undirected graphs (namely, graphs where each edge has its opposite): on directed graphs
+     * only the out edges are followed
+     *
+     * @tparam GRAPH type of the graph
+     * @param graph the graph to consider
+     * @return std::vector<nodeid_t> `fromNewToOld`
+     */
+    template <typename GRAPH>
+    std::vector<nodeid_t> getReverseCuthillMcKeeOrder(const GRAPH& graph) {
+        const size_t vertices = graph.numberOfVertices();
+        std::vector<size_t> degrees(vertices);
+        for (nodeid_t id=0; id<vertices; ++id) {
+            degrees[id] = graph.getOutDegree(id);
+        }
+        //candidate starts of the visits, from the one with the smallest degree
+        std::vector<nodeid_t> starts = getDegreeDescendingOrder(graph);
+        std::reverse(starts.begin(), starts.end());
+
+        std::vector<nodeid_t> result{};
+        result.reserve(vertices);
+        std::vector<bool> visited(vertices, false);
+        std::vector<nodeid_t> neighbours{};
+        for (nodeid_t start : starts) {
+            if (visited[start]) {
+                continue;
+            }
+            size_t head = result.size();
+            visited[start] = true;
+            result.push_back(start);
+            while (head < result.size()) {
+                nodeid_t id = result[head++];
+                neighbours.clear();
+                forEachOutEdge(graph, id, [&](const auto& outEdge) {
+                    if (!visited[outEdge.getSinkId()]) {
+                        visited[outEdge.getSinkId()] = true;
+                        neighbours.push_back(outEdge.getSinkId());
+                    }
+                });
+                std::sort(neighbours.begin(), neighbours.end(), [&](nodeid_t a, nodeid_t b) {
+                    return std::make_pair(degrees[a], a) < std::make_pair(degrees[b], b);
+                });
+                result.insert(result.end(), neighbours.begin(), neighbours.end());
+            }
+        }
+
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    /**
+     * @brief the position of a cell along the Hilbert curve covering a square grid
+     *
+     * @param x the column of the cell
+     * @param y the row of the cell
+     * @param bits the grid has size \f$2^{bits} \times 2^{bits}\f$
+     * @return uint64_t the position of the cell along the curve
+     */
+    inline uint64_t getHilbertIndex(uint32_t x, uint32_t y, int bits) {
+        uint64_t result = 0;
+        for (uint64_t s=(static_cast<uint64_t>(1) << (bits - 1)); s>0; s/=2) {
+            uint64_t rx = (x & s) > 0 ? 1 : 0;
+            uint64_t ry = (y & s) > 0 ? 1 : 0;
+            result += s * s * ((3 * rx) ^ ry);
+            //rotate the quadrant
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = static_cast<uint32_t>(s - 1 - x);
+                    y = static_cast<uint32_t>(s - 1 - y);
+                }
+                std::swap(x, y);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief order the vertices along a Hilbert curve over their coordinates
+     *
+     * Useful for graphs embedded in a plane (e.g., grid maps or road networks): vertices close in space are close in the order.
+     *
+     * @code
+     * auto fromNewToOld = getHilbertOrder(graph, [&](const xyLoc& loc) { return std::make_pair(loc.x, loc.y); });
+     * @endcode
+     *
+     * @tparam GRAPH type of the graph
+     * @tparam COORDINATES callable which, given the payload of a vertex, yields a pair of non negative integer coordinates
+     * @param graph the graph to consider
+     * @param coordinatesOf function generating the coordinates of a vertex
+     * @return std::vector<nodeid_t> `fromNewToOld`
+     */
+    template <typename GRAPH, typename COORDINATES>
+    std::vector<nodeid_t> getHilbertOrder(const GRAPH& graph, COORDINATES coordinatesOf) {
+        const size_t vertices = graph.numberOfVertices();
+        std::vector<std::pair<uint32_t, uint32_t>> coordinates{};
+        coordinates.reserve(vertices);
+        uint32_t maxCoordinate = 0;
+        for (nodeid_t id=0; id<vertices; ++id) {
+            auto xy = coordinatesOf(graph.getVertex(id));
+            coordinates.push_back(std::make_pair(static_cast<uint32_t>(xy.first), static_cast<uint32_t>(xy.second)));
+            maxCoordinate = std::max(maxCoordinate, std::max(coordinates.back().first, coordinates.back().second));
+        }
+        int bits = 1;
+        while (bits < 32 && (static_cast<uint64_t>(1) << bits) <= maxCoordinate) {
+            bits += 1;
+        }
+
+        std::vector<std::pair<uint64_t, nodeid_t>> curve{};
+        curve.reserve(vertices);
+        for (nodeid_t id=0; id<vertices; ++id) {
+            curve.push_back(std::make_pair(getHilbertIndex(coordinates[id].first, coordinates[id].second, bits), id));
+        }
+        std::sort(curve.begin(), curve.end());
+
+        std::vector<nodeid_t> result{};
+        result.reserve(vertices);
+        for (auto& pair : curve) {
+            result.push_back(pair.second);
+        }
+        return result;
+    }
+
+}
+
+#endif
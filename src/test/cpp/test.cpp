@@ -327,6 +327,29 @@ SCENARIO("test ppmImage") {
             image.setAllPixels(color_t::WHITE);
             (image + image2).saveBMP("image03");
         }
+
+        WHEN("drawing lines and squares") {
+            image.setAllPixels(color_t::WHITE);
+            image.setLine(0, 0, 4, 2, color_t::RED);
+            REQUIRE(image.getPixel(0, 0) == color_t::RED);
+            REQUIRE(image.getPixel(2, 1) == color_t::RED);
+            REQUIRE(image.getPixel(4, 2) == color_t::RED);
+            REQUIRE(image.getPixel(4, 0) == color_t::WHITE);
+
+            //partially outside the image
+            image.setLine(-3, 1, 10, 1, color_t::BLUE);
+            for (size_t x=0; x<5; ++x) {
+                REQUIRE(image.getPixel(x, 1) == color_t::BLUE);
+            }
+            image.setLine(-10, -10, -1, 20, color_t::GREEN);
+
+            image.setSquare(4, 0, 1, color_t::GREEN);
+            REQUIRE(image.getPixel(3, 0) == color_t::GREEN);
+            REQUIRE(image.getPixel(3, 1) == color_t::GREEN);
+            REQUIRE(image.getPixel(4, 1) == color_t::GREEN);
+            REQUIRE(image.getPixel(2, 1) == color_t::BLUE);
+            REQUIRE(image.getPixel(0, 0) == color_t::RED);
+        }
     }
 }
 
@@ -2,6 +2,26 @@
 #include "igraph.hpp"
 #include "adjacentGraph.hpp"
 #include "listGraph.hpp"
+#include "mappedAdjacentGraph.hpp"
+#include "compactAdjacentGraph.hpp"
+#include "compressedAdjacentGraph.hpp"
+#include "vertexOrdering.hpp"
+#include "dynamicGraph.hpp"
+#include "components.hpp"
+#include "graphImporters.hpp"
+#include "graphRenderer.hpp"
+#include "graphGenerators.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
 
 using namespace cpp_utils;
 using namespace cpp_utils::graphs;
@@ -210,6 +230,442 @@ SCENARIO("test adjacent graph") {
             REQUIRE(ag.getOutEdges(n3) == std::vector<OutEdge<bool>>{OutEdge<bool>{n4, true}});
         }
 
+        WHEN("testing in edges index") {
+            REQUIRE(ag.hasInEdgesIndex());
+
+            AdjacentGraph<int, int, bool> noIndex{ag};
+            noIndex.clearInEdgesIndex();
+            REQUIRE_FALSE(noIndex.hasInEdgesIndex());
+            REQUIRE(ag.getByteMemoryOccupied() > noIndex.getByteMemoryOccupied());
+
+            for (nodeid_t id=0; id<ag.numberOfVertices(); ++id) {
+                REQUIRE(ag.getInDegree(id) == noIndex.getInDegree(id));
+                REQUIRE(ag.hasPredecessors(id) == noIndex.hasPredecessors(id));
+                REQUIRE(ag.getInEdges(id) == noIndex.getInEdges(id));
+            }
+
+            //the index refers to the out edges, hence it sees the new weights
+            ag.changeWeightEdge(n3, n4, false);
+            REQUIRE(ag.getInEdges(n4) == std::vector<InEdge<bool>>{InEdge<bool>{n3, false}});
+
+            boost::filesystem::path p{"./saveInEdgesIndex.dat"};
+            FILE* f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToFile(f, ag);
+            fclose(f);
+
+            AdjacentGraph<int, int, bool> ag2;
+            f = fopen(p.native().c_str(), "rb");
+            cpp_utils::serializers::loadFromFile(f, ag2);
+            fclose(f);
+
+            REQUIRE(ag2.hasInEdgesIndex());
+            REQUIRE(ag2.getInEdges(n4) == std::vector<InEdge<bool>>{InEdge<bool>{n3, false}});
+            REQUIRE(ag2.getInEdges(n0) == std::vector<InEdge<bool>>{InEdge<bool>{n2, true}});
+            REQUIRE(ag2.getInDegree(n1) == 1);
+        }
+
+        WHEN("testing in edges index with self loops") {
+            AdjacentGraph<int, int, bool> loops{0};
+            loops.addVertex(0);
+            loops.addVertex(1);
+            loops.addEdgeTail(0, 0, true);
+            loops.addEdgeTail(0, 1, true);
+            loops.addEdgeTail(1, 1, false);
+            loops.finalizeGraph();
+
+            REQUIRE(loops.getInDegree(0) == 1);
+            REQUIRE(loops.getInDegree(1) == 2);
+            REQUIRE_FALSE(loops.hasPredecessors(0));
+            REQUIRE(loops.hasPredecessors(1));
+            REQUIRE(loops.getInEdges(1) == std::vector<InEdge<bool>>{InEdge<bool>{0, true}});
+        }
+
+        WHEN("testing in degree with parallel edges") {
+            AdjacentGraph<int, int, bool> parallel{0};
+            parallel.addVertex(0);
+            parallel.addVertex(1);
+            parallel.addVertex(2);
+            parallel.addEdgeTail(0, 2, true);
+            parallel.addEdgeTail(0, 2, false);
+            parallel.addEdgeTail(1, 2, true);
+            parallel.finalizeGraph();
+            AdjacentGraph<int, int, bool> noIndex{parallel};
+            noIndex.clearInEdgesIndex();
+
+            //the in degree is the number of in edges, whether or not the index has been built
+            REQUIRE(parallel.hasInEdgesIndex());
+            REQUIRE(parallel.getInDegree(2) == 3);
+            REQUIRE_FALSE(noIndex.hasInEdgesIndex());
+            REQUIRE(noIndex.getInDegree(2) == 3);
+            for (nodeid_t id=0; id<parallel.numberOfVertices(); ++id) {
+                REQUIRE(parallel.getInDegree(id) == noIndex.getInDegree(id));
+                REQUIRE(parallel.getInEdges(id) == noIndex.getInEdges(id));
+            }
+
+            boost::filesystem::path p{"./saveParallelMappedGraph.dat"};
+            FILE* f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, parallel);
+            fclose(f);
+            MappedAdjacentGraph<int, int, bool> mapped{p};
+            REQUIRE(mapped.hasInEdgesIndex());
+            REQUIRE(mapped.getInDegree(2) == 3);
+            f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, noIndex);
+            fclose(f);
+            MappedAdjacentGraph<int, int, bool> mappedNoIndex{p};
+            REQUIRE_FALSE(mappedNoIndex.hasInEdgesIndex());
+            REQUIRE(mappedNoIndex.getInDegree(2) == 3);
+        }
+
+        WHEN("loading a file without the in edges index") {
+            //the layout of the files saved before the reverse index existed
+            boost::filesystem::path p{"./saveWithoutInEdgesIndex.dat"};
+            FILE* f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToFile(f, 0);
+            cpp_utils::serializers::saveToFile<int>(f, std::vector<int>{0, 1, 2});
+            cpp_utils::serializers::saveToFile<OutEdge<bool>>(f, std::vector<OutEdge<bool>>{OutEdge<bool>{2, true}, OutEdge<bool>{1, false}, OutEdge<bool>{2, true}});
+            cpp_utils::serializers::saveToFile<int>(f, std::vector<int>{0, 2, 3, 3});
+            fclose(f);
+
+            AdjacentGraph<int, int, bool> loaded;
+            f = fopen(p.native().c_str(), "rb");
+            cpp_utils::serializers::loadFromFile(f, loaded);
+            fclose(f);
+
+            REQUIRE(loaded.numberOfVertices() == 3);
+            REQUIRE(loaded.numberOfEdges() == 3);
+            REQUIRE(loaded.hasInEdgesIndex());
+            REQUIRE_FALSE(loaded.isSortedBySink());
+            REQUIRE(loaded.getEdge(0, 1) == false);
+            REQUIRE(loaded.getInEdges(2) == std::vector<InEdge<bool>>{InEdge<bool>{0, true}, InEdge<bool>{1, true}});
+            REQUIRE(loaded.getInDegree(2) == 2);
+        }
+
+        WHEN("testing out edge range") {
+            for (nodeid_t id=0; id<ag.numberOfVertices(); ++id) {
+                auto range = ag.outEdgeRange(id);
+                REQUIRE(range.size() == ag.getOutDegree(id));
+                REQUIRE(std::vector<OutEdge<bool>>{range.begin(), range.end()} == ag.getOutEdges(id));
+
+                std::vector<OutEdge<bool>> visited{};
+                forEachOutEdge(ag, id, [&](const OutEdge<bool>& outEdge) { visited.push_back(outEdge); });
+                REQUIRE(visited == ag.getOutEdges(id));
+
+                //ListGraph has no outEdgeRange: we fallback to getOutEdge
+                visited.clear();
+                forEachOutEdge(lg, id, [&](const OutEdge<bool>& outEdge) { visited.push_back(outEdge); });
+                REQUIRE(visited == lg.getOutEdges(id));
+            }
+            REQUIRE(has_out_edge_range<AdjacentGraph<int, int, bool>>::value);
+            REQUIRE_FALSE(has_out_edge_range<ListGraph<int, int, bool>>::value);
+        }
+
+        WHEN("testing fast edge iterator") {
+            std::vector<Edge<bool>> expected{};
+            for (auto it=ag.beginEdges(); it!=ag.endEdges(); ++it) {
+                expected.push_back(*it);
+            }
+            REQUIRE(expected.size() == ag.numberOfEdges());
+
+            std::vector<Edge<bool>> actual{};
+            for (auto it=ag.beginFastEdges(); it!=ag.endFastEdges(); ++it) {
+                REQUIRE(it.getSourceId() == (*it).getSourceId());
+                actual.push_back(*it);
+            }
+            REQUIRE(actual == expected);
+
+            actual.clear();
+            forEachEdge(ag, [&](nodeid_t sourceId, nodeid_t sinkId, const bool& payload) { actual.push_back(Edge<bool>{sourceId, sinkId, payload}); });
+            REQUIRE(actual == expected);
+
+            actual.clear();
+            const IImmutableGraph<int, int, bool>& iag = ag;
+            iag.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const bool& payload) { actual.push_back(Edge<bool>{sourceId, sinkId, payload}); });
+            REQUIRE(actual == expected);
+
+            expected.clear();
+            for (auto it=lg.beginEdges(); it!=lg.endEdges(); ++it) {
+                expected.push_back(*it);
+            }
+            actual.clear();
+            forEachEdge(lg, [&](nodeid_t sourceId, nodeid_t sinkId, const bool& payload) { actual.push_back(Edge<bool>{sourceId, sinkId, payload}); });
+            REQUIRE(actual == expected);
+
+            AdjacentGraph<int, int, bool> noEdges{0};
+            noEdges.addVertex(0);
+            noEdges.addVertex(1);
+            noEdges.finalizeGraph();
+            REQUIRE(noEdges.beginFastEdges() == noEdges.endFastEdges());
+        }
+
+        WHEN("testing bulk construction") {
+            std::vector<int> vertices{};
+            for (nodeid_t id=0; id<ag.numberOfVertices(); ++id) {
+                vertices.push_back(ag.getVertex(id));
+            }
+            std::vector<Edge<bool>> edges{};
+            for (auto it=ag.beginEdges(); it!=ag.endEdges(); ++it) {
+                edges.push_back(*it);
+            }
+            std::reverse(edges.begin(), edges.end());
+
+            for (size_t threads=1; threads<5; ++threads) {
+                auto built = AdjacentGraph<int, int, bool>::fromEdges(20, vertices, edges, threads);
+                REQUIRE(built == ag);
+                REQUIRE(built.getPayload() == 20);
+                REQUIRE(built.hasInEdgesIndex());
+                for (nodeid_t id=0; id<ag.numberOfVertices(); ++id) {
+                    REQUIRE(built.getOutDegree(id) == ag.getOutDegree(id));
+                    REQUIRE(built.getInEdges(id) == ag.getInEdges(id));
+                }
+                //edges with the same source keep the input order
+                REQUIRE(built.getOutEdges(n0) == std::vector<OutEdge<bool>>{OutEdge<bool>{n2, true}, OutEdge<bool>{n1, true}});
+            }
+
+            std::vector<std::vector<Edge<bool>>> buffers{
+                std::vector<Edge<bool>>{edges[0], edges[1]},
+                std::vector<Edge<bool>>{},
+                std::vector<Edge<bool>>{edges[2], edges[3], edges[4]}
+            };
+            auto built = AdjacentGraph<int, int, bool>::fromEdges(20, vertices, buffers, 2, false);
+            REQUIRE(built == ag);
+            REQUIRE_FALSE(built.hasInEdgesIndex());
+
+            edges.push_back(Edge<bool>{n0, 10, true});
+            using Graph = AdjacentGraph<int, int, bool>;
+            REQUIRE_THROWS_AS(Graph::fromEdges(20, vertices, edges, 2), cpp_utils::exceptions::InvalidArgumentException);
+
+            auto empty = AdjacentGraph<int, int, bool>::fromEdges(20, std::vector<int>{}, std::vector<Edge<bool>>{});
+            REQUIRE(empty.isEmpty());
+            REQUIRE(empty.numberOfEdges() == 0);
+        }
+
+        WHEN("testing mapped graph") {
+            boost::filesystem::path p{"./saveMappedGraph.dat"};
+            FILE* f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, ag);
+            fclose(f);
+
+            MappedAdjacentGraph<int, int, bool> mapped{p};
+
+            REQUIRE(mapped.hasInEdgesIndex());
+            REQUIRE(mapped == ag);
+            REQUIRE(mapped.getPayload() == ag.getPayload());
+            REQUIRE(mapped.numberOfVertices() == ag.numberOfVertices());
+            REQUIRE(mapped.numberOfEdges() == ag.numberOfEdges());
+            for (nodeid_t id=0; id<ag.numberOfVertices(); ++id) {
+                REQUIRE(mapped.getVertex(id) == ag.getVertex(id));
+                REQUIRE(mapped.getOutEdges(id) == ag.getOutEdges(id));
+                REQUIRE(mapped.getInEdges(id) == ag.getInEdges(id));
+                REQUIRE(mapped.getInDegree(id) == ag.getInDegree(id));
+                REQUIRE(mapped.hasPredecessors(id) == ag.hasPredecessors(id));
+            }
+            REQUIRE(mapped.getEdge(n3, n4) == true);
+            REQUIRE(mapped.getOutEdge(n0, 0) == ag.getOutEdge(n0, 0));
+            REQUIRE_THROWS(mapped.getEdge(n4, n3));
+
+            //the out edges are scanned straight from the mapped arrays
+            static_assert(has_out_edge_arrays<MappedAdjacentGraph<int, int, bool>>::value, "mapped graphs expose their out edge arrays");
+            for (nodeid_t id=0; id<ag.numberOfVertices(); ++id) {
+                std::vector<OutEdge<bool>> scanned{};
+                forEachOutEdge(mapped, id, [&](const OutEdge<bool>& outEdge) {
+                    scanned.push_back(outEdge);
+                });
+                REQUIRE(scanned == ag.getOutEdges(id));
+                REQUIRE(mapped.outEdgeSinks(id).size() == ag.getOutDegree(id));
+                REQUIRE(mapped.outEdgePayloads(id).size() == ag.getOutDegree(id));
+            }
+
+            AdjacentGraph<int, int, bool> noIndex{ag};
+            noIndex.clearInEdgesIndex();
+            f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, noIndex);
+            fclose(f);
+
+            MappedAdjacentGraph<int, int, bool> mappedNoIndex{p};
+            REQUIRE_FALSE(mappedNoIndex.hasInEdgesIndex());
+            REQUIRE(mappedNoIndex.getInEdges(n4) == ag.getInEdges(n4));
+
+            f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToFile(f, ag);
+            fclose(f);
+            using MappedGraph = MappedAdjacentGraph<int, int, bool>;
+            using FormatException = cpp_utils::exceptions::InvalidFormatException<std::string, std::string>;
+            REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+        }
+
+        WHEN("mapping a truncated or corrupted graph") {
+            using MappedGraph = MappedAdjacentGraph<int, int, bool>;
+            using FormatException = cpp_utils::exceptions::InvalidFormatException<std::string, std::string>;
+
+            boost::filesystem::path p{"./saveCorruptedMappedGraph.dat"};
+            FILE* f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, ag);
+            fclose(f);
+            const auto size = boost::filesystem::file_size(p);
+            graphs::internal::MappedAdjacentGraphHeader header;
+            f = fopen(p.native().c_str(), "rb");
+            REQUIRE(fread(&header, sizeof(header), 1, f) == 1);
+            fclose(f);
+            REQUIRE_NOTHROW(MappedGraph{p});
+
+            auto corrupt = [&](uint64_t position, uint64_t value) {
+                f = fopen(p.native().c_str(), "r+b");
+                fseek(f, position, SEEK_SET);
+                fwrite(&value, sizeof(value), 1, f);
+                fclose(f);
+            };
+
+            //the in edges index ends beyond the file
+            boost::filesystem::resize_file(p, header.inEdgesOutEdgeIndexOffset + sizeof(uint64_t));
+            REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+            //the out edges end beyond the file
+            boost::filesystem::resize_file(p, header.outEdgesSinkOffset);
+            REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+            boost::filesystem::resize_file(p, 0);
+            REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+
+            f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, ag);
+            fclose(f);
+            REQUIRE(boost::filesystem::file_size(p) == size);
+
+            //each section out of the file, misaligned or so large the end overflows
+            for (uint64_t position : std::vector<uint64_t>{
+                offsetof(graphs::internal::MappedAdjacentGraphHeader, vertexPayloadOffset),
+                offsetof(graphs::internal::MappedAdjacentGraphHeader, outEdgesBeginOffset),
+                offsetof(graphs::internal::MappedAdjacentGraphHeader, outEdgesSinkOffset),
+                offsetof(graphs::internal::MappedAdjacentGraphHeader, outEdgesPayloadOffset),
+                offsetof(graphs::internal::MappedAdjacentGraphHeader, inEdgesBeginOffset),
+                offsetof(graphs::internal::MappedAdjacentGraphHeader, inEdgesSourceOffset),
+                offsetof(graphs::internal::MappedAdjacentGraphHeader, inEdgesOutEdgeIndexOffset)
+            }) {
+                uint64_t original;
+                std::memcpy(&original, reinterpret_cast<const char*>(&header) + position, sizeof(original));
+                corrupt(position, size - 4);
+                REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+                corrupt(position, std::numeric_limits<uint64_t>::max() - 7);
+                REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+                corrupt(position, original);
+                REQUIRE_NOTHROW(MappedGraph{p});
+            }
+            corrupt(offsetof(graphs::internal::MappedAdjacentGraphHeader, graphPayloadOffset), size + 1);
+            REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+            corrupt(offsetof(graphs::internal::MappedAdjacentGraphHeader, graphPayloadOffset), header.graphPayloadOffset);
+            corrupt(offsetof(graphs::internal::MappedAdjacentGraphHeader, numberOfEdges), std::numeric_limits<uint64_t>::max() / 2);
+            REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+            corrupt(offsetof(graphs::internal::MappedAdjacentGraphHeader, numberOfEdges), header.numberOfEdges);
+            corrupt(offsetof(graphs::internal::MappedAdjacentGraphHeader, outEdgesSinkOffset), header.outEdgesSinkOffset + 1);
+            REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+            corrupt(offsetof(graphs::internal::MappedAdjacentGraphHeader, outEdgesSinkOffset), header.outEdgesSinkOffset);
+
+            //edges of a vertex beyond the edges, decreasing offsets and edges before the first vertex
+            for (uint64_t beginOffset : std::vector<uint64_t>{header.outEdgesBeginOffset, header.inEdgesBeginOffset}) {
+                uint64_t original;
+                f = fopen(p.native().c_str(), "rb");
+                fseek(f, beginOffset + sizeof(uint64_t) * 2, SEEK_SET);
+                REQUIRE(fread(&original, sizeof(original), 1, f) == 1);
+                fclose(f);
+                corrupt(beginOffset + sizeof(uint64_t) * 2, header.numberOfEdges + 10);
+                REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+                corrupt(beginOffset + sizeof(uint64_t) * 2, 0);
+                REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+                corrupt(beginOffset + sizeof(uint64_t) * 2, original);
+                corrupt(beginOffset, 1);
+                REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+                corrupt(beginOffset, 0);
+                corrupt(beginOffset + sizeof(uint64_t) * header.numberOfVertices, header.numberOfEdges - 1);
+                REQUIRE_THROWS_AS(MappedGraph{p}, FormatException);
+                corrupt(beginOffset + sizeof(uint64_t) * header.numberOfVertices, header.numberOfEdges);
+                REQUIRE_NOTHROW(MappedGraph{p});
+            }
+            boost::filesystem::remove(p);
+        }
+
+        WHEN("testing out edges sorted by sink") {
+            //a hub with successors added in scrambled order, plus a parallel edge
+            AdjacentGraph<int, int, int> hub{0};
+            for (int id=0; id<100; ++id) {
+                hub.addVertex(id);
+            }
+            for (int i=1; i<100; ++i) {
+                hub.addEdgeTail(0, (i * 37) % 99 + 1, i);
+            }
+            hub.addEdgeTail(0, 50, 1000);
+            hub.addEdgeTail(3, 0, 7);
+            hub.finalizeGraph();
+            AdjacentGraph<int, int, int> sorted{hub};
+            sorted.sortOutEdgesBySink();
+
+            REQUIRE_FALSE(hub.isSortedBySink());
+            REQUIRE(sorted.isSortedBySink());
+            REQUIRE(sorted == hub);
+            for (moveid_t i=1; i<sorted.getOutDegree(0); ++i) {
+                REQUIRE(sorted.getOutEdge(0, i - 1).getSinkId() <= sorted.getOutEdge(0, i).getSinkId());
+            }
+            for (nodeid_t id=0; id<100; ++id) {
+                REQUIRE(sorted.hasEdge(0, id) == hub.hasEdge(0, id));
+                REQUIRE(sorted.containsEdge(id, 0) == hub.containsEdge(id, 0));
+                if (hub.hasEdge(0, id)) {
+                    REQUIRE(sorted.getEdge(0, id) == hub.getEdge(0, id));
+                }
+                REQUIRE(sorted.getInEdges(id) == hub.getInEdges(id));
+            }
+            REQUIRE(sorted.containsEdge(0, 50, 1000));
+            REQUIRE_FALSE(sorted.containsEdge(0, 50, 999));
+            REQUIRE_THROWS(sorted.getEdge(0, 0));
+            sorted.changeWeightEdge(0, 99, -1);
+            REQUIRE(sorted.getEdge(0, 99) == -1);
+
+            //sorting while finalizing
+            AdjacentGraph<int, int, int> finalized{0};
+            for (int id=0; id<100; ++id) {
+                finalized.addVertex(id);
+            }
+            for (int i=1; i<100; ++i) {
+                finalized.addEdgeTail(0, (i * 37) % 99 + 1, i);
+            }
+            finalized.finalizeGraph(true, true);
+            REQUIRE(finalized.isSortedBySink());
+            REQUIRE(finalized.getOutEdge(0, 0).getSinkId() == 1);
+
+            //the flag survives serialization, mapping and relabelling
+            boost::filesystem::path p{"./saveSortedGraph.dat"};
+            FILE* f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToFile(f, sorted);
+            fclose(f);
+            AdjacentGraph<int, int, int> loaded;
+            f = fopen(p.native().c_str(), "rb");
+            cpp_utils::serializers::loadFromFile(f, loaded);
+            fclose(f);
+            REQUIRE(loaded.isSortedBySink());
+            REQUIRE(loaded == sorted);
+
+            f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, sorted);
+            fclose(f);
+            MappedAdjacentGraph<int, int, int> mapped{p};
+            REQUIRE(mapped.isSortedBySink());
+            for (nodeid_t id=0; id<100; ++id) {
+                REQUIRE(mapped.hasEdge(0, id) == sorted.hasEdge(0, id));
+                if (sorted.hasEdge(0, id)) {
+                    REQUIRE(mapped.getEdge(0, id) == sorted.getEdge(0, id));
+                }
+            }
+            REQUIRE(mapped.containsEdge(0, 50, 1000));
+            REQUIRE_FALSE(mapped.containsEdge(0, 50, 999));
+
+            std::vector<nodeid_t> fromNewToOld(100);
+            for (nodeid_t id=0; id<100; ++id) {
+                fromNewToOld[id] = 99 - id;
+            }
+            std::unique_ptr<IImmutableGraph<int, int, int>> reordered = sorted.reorderVertices(invertPermutation(fromNewToOld), fromNewToOld);
+            auto& reorderedSorted = dynamic_cast<AdjacentGraph<int, int, int>&>(*reordered);
+            REQUIRE(reorderedSorted.isSortedBySink());
+            REQUIRE(reorderedSorted.getEdge(99, 0) == -1);
+            REQUIRE(reorderedSorted.getOutEdge(99, 0).getSinkId() == 0);
+        }
+
         WHEN("testing change edges in single way") {
             //no change
             ag.changeWeightEdge(n2, n3, true);
@@ -289,7 +745,126 @@ SCENARIO("test adjacent graph") {
         }
     }
 
+    GIVEN("a grid whose weights change") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(6, 5);
+        AdjacentGraph<int, int, int> sorted = buildGridGraph(6, 5);
+        sorted.sortOutEdgesBySink();
+        //several updates per source, in no particular order, one edge twice
+        std::vector<Edge<int>> updates{{7, 8, 100}, {0, 1, 101}, {7, 1, 102}, {8, 7, 103}, {7, 13, 104}, {7, 6, 105}, {0, 1, 106}, {29, 23, 107}};
+
+        WHEN("changing several weights at once") {
+            for (AdjacentGraph<int, int, int>* g : std::vector<AdjacentGraph<int, int, int>*>{&grid, &sorted}) {
+                AdjacentGraph<int, int, int> expected{*g};
+                for (auto& update : updates) {
+                    expected.changeWeightEdge(update.getSourceId(), update.getSinkId(), update.getPayload());
+                }
+                const uint64_t version = g->getWeightsVersion();
+                g->changeWeightEdges(updates);
+                REQUIRE(*g == expected);
+                REQUIRE(g->getEdge(0, 1) == 106);
+                REQUIRE(g->getEdge(7, 6) == 105);
+                REQUIRE(g->getEdge(1, 0) == expected.getEdge(1, 0));
+                REQUIRE(g->getWeightsVersion() == version + 1);
+            }
+        }
 
+        WHEN("changing several weights of a vertex with many successors") {
+            AdjacentGraph<int, int, int> hub{0};
+            for (int id=0; id<50; ++id) {
+                hub.addVertex(id);
+            }
+            for (int i=1; i<50; ++i) {
+                hub.addEdgeTail(0, (i * 17) % 49 + 1, i);
+            }
+            hub.addEdgeTail(0, 10, 1000);
+            hub.addEdgeTail(1, 0, 7);
+            hub.finalizeGraph();
+            AdjacentGraph<int, int, int> sortedHub{hub};
+            sortedHub.sortOutEdgesBySink();
+            std::vector<Edge<int>> hubUpdates{{0, 30, 1}, {0, 10, 2}, {1, 0, 3}, {0, 49, 4}, {0, 2, 5}, {0, 30, 6}};
+
+            for (AdjacentGraph<int, int, int>* g : std::vector<AdjacentGraph<int, int, int>*>{&hub, &sortedHub}) {
+                AdjacentGraph<int, int, int> expected{*g};
+                for (auto& update : hubUpdates) {
+                    expected.changeWeightEdge(update.getSourceId(), update.getSinkId(), update.getPayload());
+                }
+                g->changeWeightEdges(hubUpdates);
+                REQUIRE(*g == expected);
+                REQUIRE(g->getEdge(0, 30) == 6);
+                //only the first parallel edge is changed
+                REQUIRE(g->containsEdge(0, 10, 2));
+                REQUIRE(g->containsEdge(0, 10, 1000));
+                REQUIRE_THROWS(g->changeWeightEdges(std::vector<Edge<int>>{{0, 3, 1}, {0, 0, 1}}));
+                REQUIRE(g->getEdge(0, 3) != 1);
+            }
+        }
+
+        WHEN("changing a missing edge") {
+            AdjacentGraph<int, int, int> original{grid};
+            updates.push_back(Edge<int>{7, 20, 1});
+            REQUIRE_THROWS(grid.changeWeightEdges(updates));
+            REQUIRE_THROWS(sorted.changeWeightEdges(updates));
+            //nothing has been changed
+            REQUIRE(grid == original);
+            REQUIRE(grid.getWeightsVersion() == original.getWeightsVersion());
+        }
+
+        WHEN("tracking the changes") {
+            std::vector<EdgeWeightChange<int>> changes{};
+            REQUIRE(grid.getWeightChangesSince(grid.getWeightsVersion(), changes));
+            grid.changeWeightEdge(0, 1, 5);
+            //log disabled
+            REQUIRE_FALSE(grid.getWeightChangesSince(0, changes));
+
+            grid.setWeightChangeLogCapacity(10);
+            const auto memoryWithoutLog = grid.getByteMemoryOccupied();
+            const uint64_t version = grid.getWeightsVersion();
+            const int oldWeight = grid.getEdge(7, 8);
+            grid.changeWeightEdges(updates);
+            grid.changeWeightOutEdge(2, 0, 50);
+            REQUIRE(grid.getWeightsVersion() == version + 2);
+            //the log takes memory
+            REQUIRE(grid.getByteMemoryOccupied() > memoryWithoutLog);
+
+            REQUIRE(grid.getWeightChangesSince(version, changes));
+            REQUIRE(changes.size() == updates.size() + 1);
+            REQUIRE(changes[0].version == version + 1);
+            REQUIRE(changes[0].sourceId == 7);
+            REQUIRE(changes[0].sinkId == 8);
+            REQUIRE(grid.getOutEdge(7, changes[0].index).getSinkId() == 8);
+            REQUIRE(changes[0].oldPayload == oldWeight);
+            REQUIRE(changes[0].newPayload == 100);
+            REQUIRE(changes.back().version == version + 2);
+            REQUIRE(changes.back().sourceId == 2);
+            REQUIRE(changes.back().newPayload == 50);
+
+            changes.clear();
+            REQUIRE(grid.getWeightChangesSince(version + 1, changes));
+            REQUIRE(changes.size() == 1);
+
+            //older changes are eventually forgotten
+            for (int i=0; i<20; ++i) {
+                grid.changeWeightEdge(3, 4, i);
+            }
+            changes.clear();
+            REQUIRE_FALSE(grid.getWeightChangesSince(version, changes));
+            REQUIRE(changes.empty());
+            REQUIRE(grid.getWeightChangesSince(grid.getWeightsVersion() - 10, changes));
+            REQUIRE(changes.size() == 10);
+            REQUIRE(changes.back().newPayload == 19);
+
+            //a graph loaded from a file is brand new
+            const char* filename = "./weights.dat";
+            FILE* f = fopen(filename, "wb");
+            cpp_utils::serializers::saveToFile(f, grid);
+            fclose(f);
+            f = fopen(filename, "rb");
+            cpp_utils::serializers::loadFromFile(f, grid);
+            fclose(f);
+            std::remove(filename);
+            REQUIRE_FALSE(grid.getWeightChangesSince(version, changes));
+        }
+    }
 }
 
 SCENARIO("test graphs") {
@@ -415,4 +990,902 @@ SCENARIO("test graphs") {
         }
         
     }
-}
\ No newline at end of file
+}
+SCENARIO("test vertex ordering") {
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(4, 4);
+
+        auto isPermutation = [&](const std::vector<nodeid_t>& order) {
+            std::vector<nodeid_t> sorted{order};
+            std::sort(sorted.begin(), sorted.end());
+            for (nodeid_t id=0; id<sorted.size(); ++id) {
+                if (sorted[id] != id) {
+                    return false;
+                }
+            }
+            return sorted.size() == grid.numberOfVertices();
+        };
+        auto getBandwidth = [&](const IImmutableGraph<int, int, int>& g) {
+            long result = 0;
+            g.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) {
+                result = std::max(result, std::abs(static_cast<long>(sourceId) - static_cast<long>(sinkId)));
+            });
+            return result;
+        };
+
+        WHEN("relabelling the vertices") {
+            std::vector<nodeid_t> fromNewToOld{};
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                fromNewToOld.push_back((id * 5) % grid.numberOfVertices());
+            }
+            auto fromOldToNew = invertPermutation(fromNewToOld);
+            REQUIRE(isPermutation(fromOldToNew));
+            REQUIRE(fromOldToNew[fromNewToOld[7]] == 7);
+
+            auto reordered = grid.reorderVertices(fromOldToNew, fromNewToOld);
+            REQUIRE(reordered->numberOfEdges() == grid.numberOfEdges());
+            for (nodeid_t newId=0; newId<grid.numberOfVertices(); ++newId) {
+                REQUIRE(reordered->getVertex(newId) == grid.getVertex(fromNewToOld[newId]));
+            }
+            grid.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) {
+                REQUIRE(reordered->getEdge(fromOldToNew[sourceId], fromOldToNew[sinkId]) == payload);
+            });
+            REQUIRE(reordered->getInEdges(fromOldToNew[5]).size() == grid.getInEdges(5).size());
+
+            //the generic implementation yields the same graph
+            const IImmutableGraph<int, int, int>& igrid = grid;
+            auto generic = igrid.IImmutableGraph<int, int, int>::reorderVertices(fromOldToNew, fromNewToOld);
+            REQUIRE(*generic == *reordered);
+        }
+
+        WHEN("computing the orders") {
+            auto bfs = getBFSOrder(grid, 5);
+            REQUIRE(isPermutation(bfs));
+            REQUIRE(bfs[0] == 5);
+            REQUIRE(std::set<nodeid_t>{bfs[1], bfs[2], bfs[3], bfs[4]} == std::set<nodeid_t>{1, 4, 6, 9});
+
+            auto dfs = getDFSOrder(grid, 5);
+            REQUIRE(isPermutation(dfs));
+            //the visit follows the first out edge of each vertex first
+            REQUIRE(dfs[0] == 5);
+            REQUIRE(dfs[1] == 1);
+            REQUIRE(dfs[2] == 0);
+
+            auto degree = getDegreeDescendingOrder(grid);
+            REQUIRE(isPermutation(degree));
+            for (nodeid_t i=1; i<degree.size(); ++i) {
+                REQUIRE(grid.getOutDegree(degree[i - 1]) >= grid.getOutDegree(degree[i]));
+            }
+            REQUIRE(degree[0] == 5);
+            REQUIRE(degree.back() == 15);
+
+            auto hilbert = getHilbertOrder(grid, [&](const int& id) { return std::make_pair(id % 4, id / 4); });
+            REQUIRE(isPermutation(hilbert));
+            //consecutive cells along the curve are adjacent
+            for (nodeid_t i=1; i<hilbert.size(); ++i) {
+                REQUIRE(grid.hasEdge(hilbert[i - 1], hilbert[i]));
+            }
+
+            //scramble the grid and check the bandwidth is reduced again
+            std::vector<nodeid_t> scrambled{};
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                scrambled.push_back((id * 7) % grid.numberOfVertices());
+            }
+            auto scrambledGrid = grid.reorderVertices(invertPermutation(scrambled), scrambled);
+            auto rcm = getReverseCuthillMcKeeOrder(*scrambledGrid);
+            REQUIRE(isPermutation(rcm));
+            auto rcmGrid = scrambledGrid->reorderVertices(invertPermutation(rcm), rcm);
+            REQUIRE(getBandwidth(*rcmGrid) < getBandwidth(*scrambledGrid));
+        }
+    }
+}
+
+SCENARIO("test compact adjacent graph") {
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(5, 4);
+        CompactAdjacentGraph<int, int, int> compact{grid};
+
+        WHEN("querying the graph") {
+            REQUIRE(compact == grid);
+            REQUIRE(grid == compact);
+            REQUIRE(compact.getPayload() == grid.getPayload());
+            REQUIRE(compact.numberOfVertices() == grid.numberOfVertices());
+            REQUIRE(compact.numberOfEdges() == grid.numberOfEdges());
+            REQUIRE(compact.hasInEdgesIndex());
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                REQUIRE(compact.getVertex(id) == grid.getVertex(id));
+                REQUIRE(compact.getOutEdges(id) == grid.getOutEdges(id));
+                REQUIRE(compact.getInEdges(id) == grid.getInEdges(id));
+                REQUIRE(compact.getInDegree(id) == grid.getInDegree(id));
+                REQUIRE(compact.hasPredecessors(id) == grid.hasPredecessors(id));
+                for (nodeid_t sinkId=0; sinkId<grid.numberOfVertices(); ++sinkId) {
+                    REQUIRE(compact.hasEdge(id, sinkId) == grid.hasEdge(id, sinkId));
+                }
+            }
+            REQUIRE(compact.getEdge(0, 1) == grid.getEdge(0, 1));
+            REQUIRE_THROWS(compact.getEdge(0, 6));
+
+            size_t edges = 0;
+            for (auto it=compact.beginEdges(); it!=compact.endEdges(); ++it) {
+                REQUIRE(grid.containsEdge(it->getSourceId(), it->getSinkId(), it->getPayload()));
+                edges += 1;
+            }
+            REQUIRE(edges == grid.numberOfEdges());
+        }
+
+        WHEN("scanning the out edges") {
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                std::vector<OutEdge<int>> outEdges{};
+                forEachOutEdge(compact, id, [&](const OutEdge<int>& outEdge) { outEdges.push_back(outEdge); });
+                REQUIRE(outEdges == grid.getOutEdges(id));
+
+                std::vector<nodeid_t> successors{};
+                forEachSuccessor(compact, id, [&](nodeid_t sinkId) { successors.push_back(sinkId); });
+                std::vector<nodeid_t> expected{};
+                forEachSuccessor(grid, id, [&](nodeid_t sinkId) { expected.push_back(sinkId); });
+                REQUIRE(successors == expected);
+            }
+
+            long sum = 0;
+            forEachEdge(compact, [&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) { sum += sourceId * sinkId + payload; });
+            long expected = 0;
+            forEachEdge(grid, [&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) { expected += sourceId * sinkId + payload; });
+            REQUIRE(sum == expected);
+        }
+
+        WHEN("changing the graph") {
+            compact.changeWeightEdge(6, 7, 100);
+            REQUIRE(compact.getEdge(6, 7) == 100);
+            REQUIRE(compact.getInEdges(7) != grid.getInEdges(7));
+            compact.changeWeightOutEdge(6, 0, 200);
+            REQUIRE(compact.getOutEdge(6, 0).getPayload() == 200);
+            compact.changeVertexPayload(3, 30);
+            REQUIRE(compact.getVertex(3) == 30);
+            REQUIRE_THROWS(compact.changeWeightEdge(0, 6, 1));
+        }
+
+        WHEN("sorting the out edges and dropping the in edges index") {
+            //the grid adds the out edges by sink id
+            REQUIRE(compact.isSortedBySink());
+
+            CompactAdjacentGraph<int, int, int> noIndex{grid, false};
+            REQUIRE_FALSE(noIndex.hasInEdgesIndex());
+            REQUIRE(noIndex.getByteMemoryOccupied() < compact.getByteMemoryOccupied());
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                REQUIRE(noIndex.getInEdges(id) == grid.getInEdges(id));
+            }
+
+            ListGraph<int, int, int> lg{0};
+            for (int id=0; id<4; ++id) {
+                lg.addVertex(id);
+            }
+            lg.addEdge(0, 3, 1);
+            lg.addEdge(0, 1, 2);
+            lg.addEdge(0, 3, 3);
+            lg.addEdge(2, 0, 4);
+            CompactAdjacentGraph<int, int, int> unsorted{lg};
+            REQUIRE_FALSE(unsorted.isSortedBySink());
+            unsorted.sortOutEdgesBySink();
+            REQUIRE(unsorted.isSortedBySink());
+            REQUIRE(unsorted.getOutEdges(0) == std::vector<OutEdge<int>>{OutEdge<int>{1, 2}, OutEdge<int>{3, 1}, OutEdge<int>{3, 3}});
+            REQUIRE(unsorted.containsEdge(0, 3, 3));
+            REQUIRE_FALSE(unsorted.containsEdge(0, 3, 2));
+            REQUIRE(unsorted.getInEdges(3) == std::vector<InEdge<int>>{InEdge<int>{0, 1}, InEdge<int>{0, 3}});
+            REQUIRE(unsorted == lg);
+
+            //each parallel edge counts, whether or not the index has been built
+            CompactAdjacentGraph<int, int, int> parallelNoIndex{lg, false};
+            REQUIRE(unsorted.getInDegree(3) == 2);
+            REQUIRE(parallelNoIndex.getInDegree(3) == 2);
+        }
+
+        WHEN("comparing the memory with AdjacentGraph") {
+            REQUIRE(compact.getByteMemoryOccupied() < grid.getByteMemoryOccupied());
+        }
+    }
+}
+
+SCENARIO("test compressed adjacent graph") {
+
+    GIVEN("some numbers") {
+        std::vector<uint64_t> numbers{0, 1, 127, 128, 300, 16383, 16384, std::numeric_limits<uint64_t>::max()};
+
+        WHEN("encoding them as varints") {
+            std::vector<uint8_t> buffer{};
+            for (auto number : numbers) {
+                appendVarint(buffer, number);
+            }
+            REQUIRE(buffer.size() == (1 + 1 + 1 + 2 + 2 + 2 + 3 + 10));
+            const uint8_t* position = buffer.data();
+            for (auto number : numbers) {
+                REQUIRE(readVarint(position) == number);
+            }
+            REQUIRE(position == buffer.data() + buffer.size());
+        }
+
+        WHEN("mapping signed numbers") {
+            REQUIRE(zigzagEncode(0) == 0);
+            REQUIRE(zigzagEncode(-1) == 1);
+            REQUIRE(zigzagEncode(1) == 2);
+            REQUIRE(zigzagEncode(-2) == 3);
+            for (int64_t x : std::vector<int64_t>{0, -5, 5, 1000000, -1000000, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()}) {
+                REQUIRE(zigzagDecode(zigzagEncode(x)) == x);
+            }
+        }
+    }
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(5, 4);
+        CompressedAdjacentGraph<int, int, int> compressed{grid};
+
+        WHEN("querying the graph") {
+            REQUIRE(compressed == grid);
+            REQUIRE(grid == compressed);
+            REQUIRE(compressed.getPayload() == grid.getPayload());
+            REQUIRE(compressed.numberOfVertices() == grid.numberOfVertices());
+            REQUIRE(compressed.numberOfEdges() == grid.numberOfEdges());
+            //every delta of a small grid fits in 1 byte
+            REQUIRE(compressed.getBytesPerSink() == Approx(1.0));
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                REQUIRE(compressed.getVertex(id) == grid.getVertex(id));
+                //the grid adds the out edges by sink id
+                REQUIRE(compressed.getOutEdges(id) == grid.getOutEdges(id));
+                REQUIRE(compressed.getInEdges(id) == grid.getInEdges(id));
+                REQUIRE(compressed.getInDegree(id) == grid.getInDegree(id));
+                REQUIRE(compressed.hasPredecessors(id) == grid.hasPredecessors(id));
+                for (moveid_t i=0; i<grid.getOutDegree(id); ++i) {
+                    REQUIRE(compressed.getOutEdge(id, i) == grid.getOutEdge(id, i));
+                }
+                for (nodeid_t sinkId=0; sinkId<grid.numberOfVertices(); ++sinkId) {
+                    REQUIRE(compressed.hasEdge(id, sinkId) == grid.hasEdge(id, sinkId));
+                }
+            }
+            REQUIRE(compressed.getEdge(0, 1) == grid.getEdge(0, 1));
+            REQUIRE_THROWS(compressed.getEdge(0, 6));
+
+            std::vector<Edge<int>> edges{};
+            for (auto it=compressed.beginEdges(); it!=compressed.endEdges(); ++it) {
+                edges.push_back(*it);
+            }
+            std::vector<Edge<int>> expected{};
+            for (auto it=grid.beginFastEdges(); it!=grid.endFastEdges(); ++it) {
+                expected.push_back(*it);
+            }
+            REQUIRE(edges == expected);
+        }
+
+        WHEN("scanning the out edges") {
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                std::vector<OutEdge<int>> outEdges{};
+                forEachOutEdge(compressed, id, [&](const OutEdge<int>& outEdge) { outEdges.push_back(outEdge); });
+                REQUIRE(outEdges == grid.getOutEdges(id));
+            }
+        }
+    }
+
+    GIVEN("a graph with far away sinks, parallel edges and vertices without out edges") {
+        ListGraph<int, int, int> lg{0};
+        for (int id=0; id<1000; ++id) {
+            lg.addVertex(id);
+        }
+        lg.addEdge(1, 1, 6);
+        lg.addEdge(500, 999, 4);
+        lg.addEdge(500, 2, 5);
+        lg.addEdge(999, 0, 1);
+        lg.addEdge(999, 998, 2);
+        lg.addEdge(999, 0, 3);
+        CompressedAdjacentGraph<int, int, int> compressed{lg};
+
+        REQUIRE(compressed == lg);
+        REQUIRE(compressed.getOutEdges(999) == std::vector<OutEdge<int>>{OutEdge<int>{0, 1}, OutEdge<int>{0, 3}, OutEdge<int>{998, 2}});
+        REQUIRE(compressed.getOutEdges(500) == std::vector<OutEdge<int>>{OutEdge<int>{2, 5}, OutEdge<int>{999, 4}});
+        REQUIRE(compressed.getOutEdges(0) == std::vector<OutEdge<int>>{});
+        REQUIRE(compressed.containsEdge(999, 0, 3));
+        REQUIRE_FALSE(compressed.containsEdge(999, 0, 2));
+        REQUIRE(compressed.getEdge(1, 1) == 6);
+        REQUIRE(compressed.getInEdges(0) == std::vector<InEdge<int>>{InEdge<int>{999, 1}, InEdge<int>{999, 3}});
+        REQUIRE(compressed.getInDegree(0) == lg.getInDegree(0));
+        REQUIRE(compressed.getInDegree(0) == 2);
+
+        size_t edges = 0;
+        for (auto it=compressed.beginEdges(); it!=compressed.endEdges(); ++it) {
+            REQUIRE(lg.containsEdge(it->getSourceId(), it->getSinkId(), it->getPayload()));
+            edges += 1;
+        }
+        REQUIRE(edges == lg.numberOfEdges());
+    }
+}
+
+SCENARIO("test dynamic graph") {
+
+    GIVEN("an empty dynamic graph") {
+        DynamicGraph<int, int, int> g{7};
+        for (int id=0; id<5; ++id) {
+            REQUIRE(g.addVertex(id * 10) == id);
+        }
+        REQUIRE(g.numberOfVertices() == 5);
+        REQUIRE(g.numberOfEdges() == 0);
+        REQUIRE(g.getPayload() == 7);
+
+        WHEN("adding edges in any order") {
+            g.addEdge(3, 1, 31);
+            g.addEdge(0, 1, 1);
+            g.addEdge(1, 1, 11);
+            g.addEdge(0, 2, 2);
+            g.addEdge(0, 1, 100);
+
+            REQUIRE(g.numberOfEdges() == 5);
+            REQUIRE(g.getOutDegree(0) == 3);
+            REQUIRE(g.getInDegree(1) == 4);
+            REQUIRE(g.getDegree(1) == 5);
+            REQUIRE(g.getEdge(0, 1) == 1);
+            REQUIRE(g.containsEdge(0, 1, 100));
+            REQUIRE(g.hasEdge(1, 1));
+            REQUIRE_FALSE(g.hasEdge(1, 0));
+            REQUIRE_THROWS(g.getEdge(1, 0));
+            REQUIRE(g.getOutEdge(0, 1) == OutEdge<int>{2, 2});
+            REQUIRE_FALSE(g.hasSuccessors(4));
+            REQUIRE_FALSE(g.hasPredecessors(3));
+            REQUIRE_THROWS(g.addEdge(0, 5, 1));
+
+            auto inEdges = g.getInEdges(1);
+            REQUIRE(inEdges.size() == 4);
+            REQUIRE(std::find(inEdges.begin(), inEdges.end(), InEdge<int>{3, 31}) != inEdges.end());
+
+            //same graph as the static ones
+            ListGraph<int, int, int> lg{7};
+            for (int id=0; id<5; ++id) {
+                lg.addVertex(id * 10);
+            }
+            lg.addEdge(0, 1, 1);
+            lg.addEdge(0, 2, 2);
+            lg.addEdge(0, 1, 100);
+            lg.addEdge(1, 1, 11);
+            lg.addEdge(3, 1, 31);
+            REQUIRE(g == lg);
+            REQUIRE(DynamicGraph<int, int, int>{lg} == g);
+            size_t edges = 0;
+            for (auto it=g.beginEdges(); it!=g.endEdges(); ++it) {
+                REQUIRE(lg.containsEdge(it->getSourceId(), it->getSinkId(), it->getPayload()));
+                edges += 1;
+            }
+            REQUIRE(edges == 5);
+
+            g.changeWeightEdge(0, 1, 50);
+            REQUIRE(g.getEdge(0, 1) == 50);
+            REQUIRE(g.containsEdge(0, 1, 100));
+            REQUIRE_THROWS(g.changeWeightEdge(4, 0, 1));
+
+            //parallel edges go away together
+            g.removeEdge(0, 1);
+            REQUIRE(g.numberOfEdges() == 3);
+            REQUIRE(g.getOutDegree(0) == 1);
+            REQUIRE(g.getInDegree(1) == 2);
+            REQUIRE(g.getEdge(0, 2) == 2);
+            g.removeEdge(1, 1);
+            REQUIRE(g.getInDegree(1) == 1);
+            REQUIRE(g.getInEdges(1) == std::vector<InEdge<int>>{InEdge<int>{3, 31}});
+            g.removeEdge(4, 0);
+            REQUIRE(g.numberOfEdges() == 2);
+
+            g.removeAllEdges();
+            REQUIRE(g.numberOfEdges() == 0);
+            REQUIRE(g.getInDegree(1) == 0);
+        }
+    }
+
+    GIVEN("random insertions and removals") {
+        const int vertices = 30;
+        DynamicGraph<int, int, int> g{0};
+        for (int id=0; id<vertices; ++id) {
+            g.addVertex(id);
+        }
+        //reference: the number of copies of each edge
+        std::map<std::tuple<nodeid_t, nodeid_t, int>, int> expected{};
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<nodeid_t> vertexDistribution{0, vertices - 1};
+        std::uniform_int_distribution<int> weightDistribution{0, 3};
+        for (int step=0; step<3000; ++step) {
+            nodeid_t sourceId = vertexDistribution(generator);
+            nodeid_t sinkId = vertexDistribution(generator);
+            if (step % 3 == 2) {
+                g.removeEdge(sourceId, sinkId);
+                for (auto it=expected.begin(); it!=expected.end(); ) {
+                    if (std::get<0>(it->first) == sourceId && std::get<1>(it->first) == sinkId) {
+                        it = expected.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            } else if (step % 7 == 3 && g.getOutDegree(sourceId) > 0) {
+                moveid_t index = static_cast<moveid_t>(step % g.getOutDegree(sourceId));
+                OutEdge<int> outEdge = g.getOutEdge(sourceId, index);
+                g.removeOutEdge(sourceId, index);
+                auto key = std::make_tuple(sourceId, outEdge.getSinkId(), outEdge.getPayload());
+                if (--expected[key] == 0) {
+                    expected.erase(key);
+                }
+            } else {
+                int weight = weightDistribution(generator);
+                g.addEdge(sourceId, sinkId, weight);
+                expected[std::make_tuple(sourceId, sinkId, weight)] += 1;
+            }
+        }
+
+        size_t edges = 0;
+        std::vector<size_t> outDegrees(vertices, 0);
+        std::vector<size_t> inDegrees(vertices, 0);
+        for (auto& entry : expected) {
+            edges += entry.second;
+            outDegrees[std::get<0>(entry.first)] += entry.second;
+            inDegrees[std::get<1>(entry.first)] += entry.second;
+        }
+
+        REQUIRE(g.numberOfEdges() == edges);
+        for (nodeid_t id=0; id<vertices; ++id) {
+            REQUIRE(g.getOutDegree(id) == outDegrees[id]);
+            REQUIRE(g.getInDegree(id) == inDegrees[id]);
+            std::map<std::tuple<nodeid_t, nodeid_t, int>, int> actual{};
+            for (auto& inEdge : g.getInEdges(id)) {
+                actual[std::make_tuple(inEdge.getSourceId(), id, inEdge.getPayload())] += 1;
+            }
+            for (auto& outEdge : g.getOutEdges(id)) {
+                REQUIRE(expected.count(std::make_tuple(id, outEdge.getSinkId(), outEdge.getPayload())) == 1);
+            }
+            for (auto& entry : actual) {
+                REQUIRE(expected[entry.first] == entry.second);
+            }
+        }
+
+        WHEN("freezing the graph") {
+            DynamicGraph<int, int, int> copy{g};
+            std::vector<std::vector<OutEdge<int>>> outEdges{};
+            for (nodeid_t id=0; id<vertices; ++id) {
+                outEdges.push_back(g.getOutEdges(id));
+            }
+            AdjacentGraph<int, int, int> frozen = g.freeze();
+
+            REQUIRE(g.numberOfVertices() == 0);
+            REQUIRE(g.numberOfEdges() == 0);
+            REQUIRE(frozen.numberOfEdges() == edges);
+            REQUIRE(frozen.hasInEdgesIndex());
+            REQUIRE(frozen == copy);
+            for (nodeid_t id=0; id<vertices; ++id) {
+                REQUIRE(frozen.getVertex(id) == id);
+                REQUIRE(frozen.getOutEdges(id) == outEdges[id]);
+                REQUIRE(frozen.getInDegree(id) == inDegrees[id]);
+            }
+
+            AdjacentGraph<int, int, int> frozenWithoutIndex = copy.freeze(false);
+            REQUIRE_FALSE(frozenWithoutIndex.hasInEdgesIndex());
+            REQUIRE(frozenWithoutIndex == frozen);
+        }
+    }
+}
+
+/**
+ * @brief the vertices reachable from a start, via a plain visit
+ *
+ */
+static std::vector<bool> getReachableVertices(const IImmutableGraph<int, int, int>& g, nodeid_t start, bool undirected) {
+    std::vector<bool> result(g.numberOfVertices(), false);
+    std::vector<nodeid_t> frontier{start};
+    result[start] = true;
+    while (!frontier.empty()) {
+        nodeid_t id = frontier.back();
+        frontier.pop_back();
+        std::vector<nodeid_t> neighbours{};
+        for (auto outEdge : g.getOutEdges(id)) {
+            neighbours.push_back(outEdge.getSinkId());
+        }
+        if (undirected) {
+            for (auto inEdge : g.getInEdges(id)) {
+                neighbours.push_back(inEdge.getSourceId());
+            }
+        }
+        for (auto neighbour : neighbours) {
+            if (!result[neighbour]) {
+                result[neighbour] = true;
+                frontier.push_back(neighbour);
+            }
+        }
+    }
+    return result;
+}
+
+SCENARIO("test components") {
+
+    GIVEN("a small directed graph") {
+        //{0, 1, 2} -> {3, 4} -> {5}, {6} alone, {7} -> {8}
+        ListGraph<int, int, int> g{0};
+        for (int id=0; id<9; ++id) {
+            g.addVertex(id);
+        }
+        g.addEdge(0, 1, 1);
+        g.addEdge(1, 2, 1);
+        g.addEdge(2, 0, 1);
+        g.addEdge(2, 3, 1);
+        g.addEdge(3, 4, 1);
+        g.addEdge(4, 3, 1);
+        g.addEdge(4, 5, 1);
+        g.addEdge(5, 5, 1);
+        g.addEdge(7, 8, 1);
+        AdjacentGraph<int, int, int> ag{g};
+
+        WHEN("computing the strongly connected components") {
+            ComponentLabels scc{getStronglyConnectedComponents(ag)};
+            REQUIRE(scc.getLabels() == getStronglyConnectedComponents(g));
+            REQUIRE(scc.getLabels() == getStronglyConnectedComponents(CompactAdjacentGraph<int, int, int>{g}));
+
+            REQUIRE(scc.numberOfComponents() == 6);
+            REQUIRE(scc.sameComponent(0, 2));
+            REQUIRE(scc.sameComponent(3, 4));
+            REQUIRE_FALSE(scc.sameComponent(2, 3));
+            REQUIRE_FALSE(scc.sameComponent(7, 8));
+            REQUIRE(scc.mayReach(0, 5));
+            REQUIRE_FALSE(scc.mayReach(5, 0));
+            REQUIRE_FALSE(scc.mayReach(3, 1));
+
+            auto sizes = scc.getComponentSizes();
+            REQUIRE(sizes[scc.getLabel(1)] == 3);
+            REQUIRE(sizes[scc.getLabel(4)] == 2);
+            REQUIRE(sizes[scc.getLabel(6)] == 1);
+        }
+
+        WHEN("computing the weakly connected components") {
+            for (size_t threads : {1, 2, 4}) {
+                ComponentLabels wcc{getWeaklyConnectedComponents(ag, threads)};
+                REQUIRE(wcc.getLabels() == std::vector<uint32_t>{0, 0, 0, 0, 0, 0, 1, 2, 2});
+                REQUIRE(getWeaklyConnectedComponents(g, threads) == wcc.getLabels());
+                REQUIRE(wcc.numberOfComponents() == 3);
+                REQUIRE(wcc.sameComponent(0, 5));
+                REQUIRE_FALSE(wcc.sameComponent(6, 7));
+            }
+        }
+    }
+
+    GIVEN("random sparse graphs") {
+        std::mt19937 random{42};
+        for (int round=0; round<20; ++round) {
+            const int vertices = 60;
+            DynamicGraph<int, int, int> dg{0};
+            for (int id=0; id<vertices; ++id) {
+                dg.addVertex(id);
+            }
+            const int edges = std::uniform_int_distribution<int>{0, 2 * vertices}(random);
+            std::uniform_int_distribution<int> vertex{0, vertices - 1};
+            for (int i=0; i<edges; ++i) {
+                dg.addEdge(vertex(random), vertex(random), 1);
+            }
+            //edge order may differ, hence labels may differ as well
+            auto dynamicScc = getStronglyConnectedComponents(dg);
+            AdjacentGraph<int, int, int> g = dg.freeze();
+
+            auto scc = getStronglyConnectedComponents(g);
+            auto wcc = getWeaklyConnectedComponents(g, 3);
+            std::vector<std::vector<bool>> reachable{};
+            for (nodeid_t id=0; id<vertices; ++id) {
+                reachable.push_back(getReachableVertices(g, id, false));
+            }
+            for (nodeid_t id=0; id<vertices; ++id) {
+                auto weaklyReachable = getReachableVertices(g, id, true);
+                for (nodeid_t other=0; other<vertices; ++other) {
+                    REQUIRE((scc[id] == scc[other]) == (reachable[id][other] && reachable[other][id]));
+                    REQUIRE((dynamicScc[id] == dynamicScc[other]) == (scc[id] == scc[other]));
+                    REQUIRE((wcc[id] == wcc[other]) == weaklyReachable[other]);
+                    if (reachable[id][other]) {
+                        REQUIRE(scc[id] >= scc[other]);
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("a very long cycle") {
+        //a recursive visit would overflow the stack
+        const int vertices = 500000;
+        DynamicGraph<int, int, int> g{0};
+        for (int id=0; id<vertices; ++id) {
+            g.addVertex(id);
+        }
+        for (int id=0; id<vertices; ++id) {
+            g.addEdge(id, (id + 1) % vertices, 1);
+        }
+
+        ComponentLabels scc{getStronglyConnectedComponents(g)};
+        REQUIRE(scc.numberOfComponents() == 1);
+        REQUIRE(scc.sameComponent(0, vertices - 1));
+        REQUIRE(ComponentLabels{getWeaklyConnectedComponents(g)}.numberOfComponents() == 1);
+    }
+}
+
+/**
+ * @brief create a file with some content
+ *
+ */
+static void writeTextFile(const char* filename, const std::string& content) {
+    FILE* f = fopen(filename, "w");
+    fputs(content.c_str(), f);
+    fclose(f);
+}
+
+/**
+ * @brief check that the out edges of 2 graphs are the same, in the same order
+ *
+ */
+static void checkSameOutEdges(const IImmutableGraph<int, int, int>& actual, const IImmutableGraph<int, int, int>& expected) {
+    REQUIRE(actual.numberOfVertices() == expected.numberOfVertices());
+    REQUIRE(actual.numberOfEdges() == expected.numberOfEdges());
+    for (nodeid_t id=0; id<expected.numberOfVertices(); ++id) {
+        REQUIRE(actual.getOutEdges(id) == expected.getOutEdges(id));
+    }
+}
+
+SCENARIO("test graph importers") {
+
+    const char* filename = "./graph.txt";
+
+    GIVEN("a DIMACS graph") {
+        writeTextFile(filename,
+            "c a small graph\n"
+            "p sp 4 5\n"
+            "a 1 2 10\n"
+            "a 3 1 5\n"
+            "c in the middle\n"
+            "a 1 3 7\n"
+            "a 2 4 1\r\n"
+            "\n"
+            "a 4 1 -2"
+        );
+        AdjacentGraph<int, int, int> g = importDimacsGraph<int, int, int>(filename, 3);
+        REQUIRE(g.getPayload() == 3);
+        REQUIRE(g.numberOfVertices() == 4);
+        REQUIRE(g.numberOfEdges() == 5);
+        REQUIRE(g.getOutEdges(0) == std::vector<OutEdge<int>>{OutEdge<int>{1, 10}, OutEdge<int>{2, 7}});
+        REQUIRE(g.getOutEdges(1) == std::vector<OutEdge<int>>{OutEdge<int>{3, 1}});
+        REQUIRE(g.getOutEdges(2) == std::vector<OutEdge<int>>{OutEdge<int>{0, 5}});
+        REQUIRE(g.getOutEdges(3) == std::vector<OutEdge<int>>{OutEdge<int>{0, -2}});
+        REQUIRE(g.getInDegree(0) == 2);
+
+        WHEN("the file is malformed") {
+            std::vector<std::pair<std::string, std::string>> malformed{
+                {"a 1 2 1\n", ":1 \""},
+                {"p sp 2 1\na 1 3 1\n", ":2 \""},
+                {"p sp 2 1\na 0 1 1\n", ":2 \""},
+                {"c\np sp 2 1\na 1 2 x\n", ":3 \""},
+                {"p sp 2 1\na 1 2 1 4\n", ":2 \""},
+                {"p sp 2 1\nq 1 2\n", ":2 \""},
+                {"p sp 2 1\np sp 2 1\n", ":2 \""},
+                {"p sp 2 2\na 1 2 1\nc\n", ":4 \""},
+                {"p sp 2 1\na 1 2 99999999999\n", ":2 \""},
+                {"c nothing\n", ":2 \""},
+                //counts the file cannot hold are not allocated
+                {"p sp 3 99999999999999999\na 1 2 1\n", ":1 \""},
+                {"p sp 3 2000000000\na 1 2 1\n", ":3 \""},
+            };
+            for (auto& pair : malformed) {
+                writeTextFile(filename, pair.first);
+                REQUIRE_THROWS_WITH((importDimacsGraph<int, int, int>(filename)), Catch::Contains(pair.second));
+            }
+            using InvalidFormat = cpp_utils::exceptions::InvalidFormatException<std::string, std::string>;
+            REQUIRE_THROWS_AS((importDimacsGraph<int, int, int>(filename)), InvalidFormat);
+            std::remove(filename);
+            REQUIRE_THROWS((importDimacsGraph<int, int, int>(filename)));
+        }
+        std::remove(filename);
+    }
+
+    GIVEN("METIS graphs") {
+        WHEN("edges have weights") {
+            writeTextFile(filename,
+                "% comment\n"
+                "4 4 1\n"
+                "2 3 3 1\n"
+                "1 3 4 2\n"
+                "% a comment between vertices\n"
+                "1 1 4 5\n"
+                "2 2 3 5\n"
+            );
+            AdjacentGraph<int, int, int> g = importMetisGraph<int, int, int>(filename);
+            REQUIRE(g.numberOfVertices() == 4);
+            REQUIRE(g.numberOfEdges() == 8);
+            REQUIRE(g.getOutEdges(0) == std::vector<OutEdge<int>>{OutEdge<int>{1, 3}, OutEdge<int>{2, 1}});
+            REQUIRE(g.getOutEdges(3) == std::vector<OutEdge<int>>{OutEdge<int>{1, 2}, OutEdge<int>{2, 5}});
+            REQUIRE(g.getEdge(2, 3) == 5);
+        }
+
+        WHEN("vertices have weights and some vertices are isolated") {
+            writeTextFile(filename,
+                "4 2 10 2\n"
+                "5 6 2\n"
+                "1 1 1 3\n"
+                "7 8 2\n"
+                "1 1\n"
+                "\n"
+            );
+            AdjacentGraph<int, int, int> g = importMetisGraph<int, int, int>(filename);
+            REQUIRE(g.numberOfVertices() == 4);
+            REQUIRE(g.numberOfEdges() == 4);
+            REQUIRE(g.getOutEdges(1) == std::vector<OutEdge<int>>{OutEdge<int>{0, 1}, OutEdge<int>{2, 1}});
+            REQUIRE(g.getOutDegree(3) == 0);
+        }
+
+        WHEN("the file is malformed") {
+            std::vector<std::pair<std::string, std::string>> malformed{
+                {"3 1 2\n", ":1 \""},
+                {"% header\n3 x\n", ":2 \""},
+                {"2 1\n2\n", ":3 \""},
+                {"2 1\n2\n1\n1\n", ":4 \""},
+                {"2 1\n2 2\n1\n", ":3 \""},
+                {"2 1\n2\n3\n", ":3 \""},
+                {"2 1 1\n2\n1 1\n", ":2 \""},
+                {"2 2\n2\n1\n", ":4 \""},
+                {"", ":1 \""},
+                //counts the file cannot hold are not allocated
+                {"4000000000 1\n2\n1\n", ":4 \""},
+                {"2 1000000000\n2\n1\n", ":4 \""},
+                {"2 9223372036854775808\n2\n1\n", ":1 \""},
+            };
+            for (auto& pair : malformed) {
+                writeTextFile(filename, pair.first);
+                REQUIRE_THROWS_WITH((importMetisGraph<int, int, int>(filename)), Catch::Contains(pair.second));
+            }
+        }
+        std::remove(filename);
+    }
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(30, 20);
+
+        WHEN("saving it as a binary edge list") {
+            FILE* f = fopen(filename, "wb");
+            cpp_utils::serializers::saveToBinaryEdgeList(f, grid);
+            fclose(f);
+
+            checkSameOutEdges(importBinaryEdgeList<int, int, int>(filename), grid);
+            checkSameOutEdges(importBinaryEdgeList<int, int, int>(filename, grid.numberOfVertices()), grid);
+            REQUIRE(importBinaryEdgeList<int, int, int>(filename, grid.numberOfVertices() + 5).numberOfVertices() == grid.numberOfVertices() + 5);
+            REQUIRE_THROWS_WITH((importBinaryEdgeList<int, int, int>(filename, 10)), Catch::Contains(":2 \""));
+
+            f = fopen(filename, "ab");
+            fputs("xyz", f);
+            fclose(f);
+            REQUIRE_THROWS_WITH((importBinaryEdgeList<int, int, int>(filename)), Catch::Contains(":" + std::to_string(grid.numberOfEdges() + 1) + " \""));
+        }
+
+        WHEN("saving it as DIMACS and METIS") {
+            std::string dimacs = "p sp " + std::to_string(grid.numberOfVertices()) + " " + std::to_string(grid.numberOfEdges()) + "\n";
+            std::string metis = std::to_string(grid.numberOfVertices()) + " " + std::to_string(grid.numberOfEdges() / 2) + " 1\n";
+            for (nodeid_t id=grid.numberOfVertices(); id>0; --id) {
+                for (auto& outEdge : grid.getOutEdges(id - 1)) {
+                    dimacs += "a " + std::to_string(id) + " " + std::to_string(outEdge.getSinkId() + 1) + " " + std::to_string(outEdge.getPayload()) + "\n";
+                }
+            }
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                for (auto& outEdge : grid.getOutEdges(id)) {
+                    //METIS graphs are undirected, so we need the same weight in both directions
+                    metis += std::to_string(outEdge.getSinkId() + 1) + " " + std::to_string(outEdge.getSinkId() + id) + " ";
+                }
+                metis += "\n";
+            }
+
+            writeTextFile(filename, dimacs);
+            checkSameOutEdges(importDimacsGraph<int, int, int>(filename), grid);
+
+            writeTextFile(filename, metis);
+            AdjacentGraph<int, int, int> g = importMetisGraph<int, int, int>(filename);
+            REQUIRE(g.numberOfEdges() == grid.numberOfEdges());
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                for (auto& outEdge : grid.getOutEdges(id)) {
+                    REQUIRE(g.getEdge(id, outEdge.getSinkId()) == static_cast<int>(outEdge.getSinkId() + id));
+                }
+            }
+        }
+        std::remove(filename);
+    }
+}
+
+SCENARIO("test graph rendering") {
+
+    GIVEN("a grid whose vertices know their coordinates") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(10, 5);
+        auto coordinatesOf = [](int id) { return std::make_pair(id % 10, id / 10); };
+
+        WHEN("drawing it") {
+            //each cell of the grid is 10 pixels wide
+            PPMImage image{2 + 90 + 1 + 2, 2 + 40 + 1 + 2, color_t::RED};
+            GraphRenderingStyle style{};
+            style.margin = 2;
+            style.vertexRadius = 0;
+            drawGraph(image, grid, coordinatesOf, style);
+
+            REQUIRE(image.getPixel(0, 0) == style.background);
+            REQUIRE(image.getPixel(2, 2) == style.vertexColor);
+            REQUIRE(image.getPixel(92, 42) == style.vertexColor);
+            REQUIRE(image.getPixel(12, 2) == style.vertexColor);
+            //the edges between the vertices
+            REQUIRE(image.getPixel(7, 2) == style.edgeColor);
+            REQUIRE(image.getPixel(2, 7) == style.edgeColor);
+            //the inside of a face of the grid
+            REQUIRE(image.getPixel(7, 7) == style.background);
+
+            //the image can be reused for another frame
+            style.vertexColor = color_t::BLUE;
+            drawGraph(image, grid, coordinatesOf, style);
+            REQUIRE(image.getPixel(2, 2) == color_t::BLUE);
+        }
+
+        WHEN("laying it out with a force directed layout") {
+            auto layout = getForceDirectedLayout(grid, 200);
+            REQUIRE(layout.size() == grid.numberOfVertices());
+            REQUIRE(layout == getForceDirectedLayout(grid, 200));
+
+            auto distance = [&](nodeid_t a, nodeid_t b) {
+                return std::hypot(layout[a].first - layout[b].first, layout[a].second - layout[b].second);
+            };
+            //adjacent vertices end up closer than far away ones
+            double adjacent = 0;
+            grid.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) {
+                adjacent += distance(sourceId, sinkId);
+            });
+            adjacent /= grid.numberOfEdges();
+            REQUIRE(adjacent < distance(0, 49));
+            REQUIRE(adjacent < distance(9, 40));
+            for (nodeid_t a=0; a<grid.numberOfVertices(); ++a) {
+                for (nodeid_t b=a+1; b<grid.numberOfVertices(); ++b) {
+                    REQUIRE(distance(a, b) > 0.05);
+                }
+            }
+        }
+
+        WHEN("generating its image") {
+            std::unique_ptr<PPMImage> image{grid.getPPM()};
+            REQUIRE(image->isValid());
+            size_t vertexPixels = 0;
+            for (size_t y=0; y<image->getHeight(); ++y) {
+                for (size_t x=0; x<image->getWidth(); ++x) {
+                    vertexPixels += image->getPixel(x, y) == color_t::BLACK ? 1 : 0;
+                }
+            }
+            //each vertex is a 3x3 square, but they may overlap
+            REQUIRE(vertexPixels > 9);
+            REQUIRE(vertexPixels <= 9 * grid.numberOfVertices());
+        }
+    }
+
+    GIVEN("a star, a pair and some isolated vertices") {
+        AdjacentGraph<int, int, int> graph{0};
+        for (int id=0; id<20; ++id) {
+            graph.addVertex(id);
+        }
+        for (nodeid_t leaf=1; leaf<8; ++leaf) {
+            graph.addEdgeTail(0, leaf, 1);
+        }
+        graph.addEdgeTail(10, 11, 1);
+        graph.finalizeGraph();
+
+        WHEN("laying it out with a force directed layout") {
+            auto layout = getForceDirectedLayout(graph);
+            REQUIRE(layout.size() == graph.numberOfVertices());
+            for (nodeid_t a=0; a<graph.numberOfVertices(); ++a) {
+                REQUIRE(std::isfinite(layout[a].first));
+                REQUIRE(std::isfinite(layout[a].second));
+                for (nodeid_t b=a+1; b<graph.numberOfVertices(); ++b) {
+                    REQUIRE(std::hypot(layout[a].first - layout[b].first, layout[a].second - layout[b].second) > 0.05);
+                }
+            }
+        }
+    }
+
+    GIVEN("an empty graph") {
+        AdjacentGraph<int, int, int> graph{0};
+
+        WHEN("drawing it") {
+            PPMImage image{10, 10, color_t::RED};
+            drawGraph(image, graph, getForceDirectedLayout(graph));
+            REQUIRE(image.getPixel(5, 5) == color_t::WHITE);
+        }
+    }
+}
@@ -0,0 +1,1169 @@
+#include "catch.hpp"
+#include "igraph.hpp"
+#include "adjacentGraph.hpp"
+#include "profiling.hpp"
+#include "log.hpp"
+#include "graphGenerators.hpp"
+#include "parallel.hpp"
+#include "vertexOrdering.hpp"
+#include "compactAdjacentGraph.hpp"
+#include "compressedAdjacentGraph.hpp"
+#include "dijkstra.hpp"
+#include "contractionHierarchy.hpp"
+#include "distanceTable.hpp"
+#include "firstMoveDatabase.hpp"
+#include "landmarks.hpp"
+#include "listGraph.hpp"
+#include "dynamicGraph.hpp"
+#include "components.hpp"
+#include "partitioning.hpp"
+#include "graphImporters.hpp"
+#include "graphRenderer.hpp"
+#include "KHeaps.hpp"
+#include "MonotoneHeaps.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+using namespace cpp_utils;
+using namespace cpp_utils::graphs;
+
+// Benchmarks are hidden: run them with `./cpp-utilsTest [benchmark]` from a Release build
+
+SCENARIO("benchmark out edges scan", "[.][benchmark]") {
+
+    GIVEN("a big grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(500, 500);
+        const IImmutableGraph<int, int, int>& igrid = grid;
+        const int repetitions = 20;
+
+        //each scan relaxes every edge, like the expansion of a search does
+        std::vector<long> vectorValues(grid.numberOfVertices(), 0);
+        timing_t vectorTime;
+        PROFILE_TIME(vectorTime) {
+            for (int r=0; r<repetitions; ++r) {
+                for (nodeid_t id=0; id<igrid.numberOfVertices(); ++id) {
+                    for (auto& outEdge : igrid.getOutEdges(id)) {
+                        auto& value = vectorValues[outEdge.getSinkId()];
+                        value = std::max(value, vectorValues[id] + outEdge.getPayload()) % 1000;
+                    }
+                }
+            }
+        }
+
+        std::vector<long> virtualValues(grid.numberOfVertices(), 0);
+        timing_t virtualTime;
+        PROFILE_TIME(virtualTime) {
+            for (int r=0; r<repetitions; ++r) {
+                for (nodeid_t id=0; id<igrid.numberOfVertices(); ++id) {
+                    for (moveid_t i=0; i<igrid.getOutDegree(id); ++i) {
+                        auto outEdge = igrid.getOutEdge(id, i);
+                        auto& value = virtualValues[outEdge.getSinkId()];
+                        value = std::max(value, virtualValues[id] + outEdge.getPayload()) % 1000;
+                    }
+                }
+            }
+        }
+
+        std::vector<long> rangeValues(grid.numberOfVertices(), 0);
+        timing_t rangeTime;
+        PROFILE_TIME(rangeTime) {
+            for (int r=0; r<repetitions; ++r) {
+                for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                    forEachOutEdge(grid, id, [&](const OutEdge<int>& outEdge) {
+                        auto& value = rangeValues[outEdge.getSinkId()];
+                        value = std::max(value, rangeValues[id] + outEdge.getPayload()) % 1000;
+                    });
+                }
+            }
+        }
+
+        REQUIRE(vectorValues == rangeValues);
+        REQUIRE(virtualValues == rangeValues);
+        critical("relaxing", repetitions, "times the", grid.numberOfEdges(), "edges of a grid");
+        critical("getOutEdges (vector) took", vectorTime);
+        critical("getOutEdge (virtual) took", virtualTime);
+        critical("forEachOutEdge (range) took", rangeTime);
+    }
+}
+
+SCENARIO("benchmark whole graph scan", "[.][benchmark]") {
+
+    GIVEN("a big grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(500, 500);
+        const IImmutableGraph<int, int, int>& igrid = grid;
+        const int repetitions = 10;
+
+        timing_t iteratorTime;
+        long iteratorSum = 0;
+        PROFILE_TIME(iteratorTime) {
+            for (int r=0; r<repetitions; ++r) {
+                for (auto it=igrid.beginEdges(); it!=igrid.endEdges(); ++it) {
+                    iteratorSum += it->getSourceId() + it->getPayload();
+                }
+            }
+        }
+
+        timing_t virtualTime;
+        long virtualSum = 0;
+        PROFILE_TIME(virtualTime) {
+            for (int r=0; r<repetitions; ++r) {
+                igrid.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) {
+                    virtualSum += sourceId + payload;
+                });
+            }
+        }
+
+        timing_t fastTime;
+        long fastSum = 0;
+        PROFILE_TIME(fastTime) {
+            for (int r=0; r<repetitions; ++r) {
+                for (auto it=grid.beginFastEdges(); it!=grid.endFastEdges(); ++it) {
+                    fastSum += it.getSourceId() + it.getOutEdge().getPayload();
+                }
+            }
+        }
+
+        timing_t lambdaTime;
+        long lambdaSum = 0;
+        PROFILE_TIME(lambdaTime) {
+            for (int r=0; r<repetitions; ++r) {
+                forEachEdge(grid, [&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) {
+                    lambdaSum += sourceId + payload;
+                });
+            }
+        }
+
+        timing_t mapTime;
+        PROFILE_TIME(mapTime) {
+            std::unique_ptr<IImmutableGraph<int, int, long>> mapped{igrid.mapEdges<long>([&](const int& payload) { return static_cast<long>(payload); })};
+            REQUIRE(mapped->numberOfEdges() == grid.numberOfEdges());
+        }
+
+        REQUIRE(iteratorSum == fastSum);
+        REQUIRE(virtualSum == fastSum);
+        REQUIRE(lambdaSum == fastSum);
+        critical("scanning", repetitions, "times the", grid.numberOfEdges(), "edges of a grid");
+        critical("beginEdges (polymorphic iterator) took", iteratorTime);
+        critical("IImmutableGraph::forEachEdge (std::function) took", virtualTime);
+        critical("beginFastEdges (value iterator) took", fastTime);
+        critical("forEachEdge (template) took", lambdaTime);
+        critical("a single mapEdges took", mapTime);
+    }
+}
+
+SCENARIO("benchmark bulk construction", "[.][benchmark]") {
+
+    GIVEN("the edges of a big grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(1000, 1000);
+        std::vector<int> vertices{};
+        for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+            vertices.push_back(grid.getVertex(id));
+        }
+        std::vector<Edge<int>> edges{};
+        edges.reserve(grid.numberOfEdges());
+        for (auto it=grid.beginFastEdges(); it!=grid.endFastEdges(); ++it) {
+            edges.push_back(*it);
+        }
+
+        timing_t tailTime;
+        PROFILE_TIME(tailTime) {
+            //addEdgeTail requires the edges sorted by source
+            AdjacentGraph<int, int, int> built{0};
+            for (auto vertex : vertices) {
+                built.addVertex(vertex);
+            }
+            for (auto& edge : edges) {
+                built.addEdgeTail(edge.getSourceId(), edge.getSinkId(), edge.getPayload());
+            }
+            built.finalizeGraph();
+            REQUIRE(built.numberOfEdges() == grid.numberOfEdges());
+        }
+
+        std::mt19937 generator{0};
+        std::shuffle(edges.begin(), edges.end(), generator);
+
+        timing_t sequentialTime;
+        PROFILE_TIME(sequentialTime) {
+            auto built = AdjacentGraph<int, int, int>::fromEdges(0, vertices, edges, 1);
+            REQUIRE(built.numberOfEdges() == grid.numberOfEdges());
+        }
+
+        timing_t parallelTime;
+        PROFILE_TIME(parallelTime) {
+            auto built = AdjacentGraph<int, int, int>::fromEdges(0, vertices, edges);
+            REQUIRE(built.numberOfEdges() == grid.numberOfEdges());
+        }
+
+        critical("building a graph with", edges.size(), "edges");
+        critical("addEdgeTail over sorted edges took", tailTime);
+        critical("fromEdges over shuffled edges with 1 thread took", sequentialTime);
+        critical("fromEdges over shuffled edges with", getDefaultNumberOfThreads(), "threads took", parallelTime);
+    }
+}
+
+SCENARIO("benchmark vertex ordering", "[.][benchmark]") {
+
+    GIVEN("a big grid whose vertices are randomly labelled") {
+        const int width = 1000;
+        AdjacentGraph<int, int, int> grid = buildGridGraph(width, width);
+        std::vector<nodeid_t> scrambled(grid.numberOfVertices());
+        std::iota(scrambled.begin(), scrambled.end(), 0);
+        std::mt19937 generator{0};
+        std::shuffle(scrambled.begin(), scrambled.end(), generator);
+        std::unique_ptr<IImmutableGraph<int, int, int>> tmp = grid.reorderVertices(invertPermutation(scrambled), scrambled);
+        AdjacentGraph<int, int, int>& scrambledGrid = dynamic_cast<AdjacentGraph<int, int, int>&>(*tmp);
+
+        //a breadth first visit from the center of the grid, computing the hop distance of every vertex
+        auto visit = [&](const AdjacentGraph<int, int, int>& g, nodeid_t start) {
+            std::vector<int> distance(g.numberOfVertices(), -1);
+            std::vector<nodeid_t> queue{};
+            queue.reserve(g.numberOfVertices());
+            distance[start] = 0;
+            queue.push_back(start);
+            long result = 0;
+            for (size_t head=0; head<queue.size(); ++head) {
+                nodeid_t id = queue[head];
+                result += distance[id];
+                forEachOutEdge(g, id, [&](const OutEdge<int>& outEdge) {
+                    if (distance[outEdge.getSinkId()] < 0) {
+                        distance[outEdge.getSinkId()] = distance[id] + 1;
+                        queue.push_back(outEdge.getSinkId());
+                    }
+                });
+            }
+            return result;
+        };
+        auto benchmark = [&](const std::string& name, const std::vector<nodeid_t>& fromNewToOld, timing_t orderTime) {
+            timing_t relabelTime;
+            std::unique_ptr<IImmutableGraph<int, int, int>> reordered;
+            auto fromOldToNew = invertPermutation(fromNewToOld);
+            PROFILE_TIME(relabelTime) {
+                reordered = scrambledGrid.reorderVertices(fromOldToNew, fromNewToOld);
+            }
+            auto& g = dynamic_cast<AdjacentGraph<int, int, int>&>(*reordered);
+            //the center of the grid, in the new labelling
+            nodeid_t center = fromOldToNew[invertPermutation(scrambled)[(width / 2) * width + (width / 2)]];
+            timing_t visitTime;
+            long hops = 0;
+            PROFILE_TIME(visitTime) {
+                for (int r=0; r<5; ++r) {
+                    hops += visit(g, center);
+                }
+            }
+            critical(name, ": computing the order took", orderTime, "relabelling took", relabelTime, "5 visits took", visitTime, "(checksum", hops, ")");
+        };
+
+        std::vector<nodeid_t> identity(grid.numberOfVertices());
+        std::iota(identity.begin(), identity.end(), 0);
+        benchmark("random labels", identity, timing_t{0, timeunit_e::MICRO});
+
+        std::vector<nodeid_t> order;
+        timing_t orderTime;
+        PROFILE_TIME(orderTime) {
+            order = getBFSOrder(scrambledGrid);
+        }
+        benchmark("BFS", order, orderTime);
+
+        PROFILE_TIME(orderTime) {
+            order = getReverseCuthillMcKeeOrder(scrambledGrid);
+        }
+        benchmark("RCM", order, orderTime);
+
+        PROFILE_TIME(orderTime) {
+            order = getDegreeDescendingOrder(scrambledGrid);
+        }
+        benchmark("degree descending", order, orderTime);
+
+        PROFILE_TIME(orderTime) {
+            order = getHilbertOrder(scrambledGrid, [&](const int& id) { return std::make_pair(id % width, id / width); });
+        }
+        benchmark("Hilbert", order, orderTime);
+    }
+}
+
+SCENARIO("benchmark edge lookup on hubs", "[.][benchmark]") {
+
+    GIVEN("a star whose center has a successor per vertex") {
+        const int vertices = 20000;
+        AdjacentGraph<int, int, int> star{0};
+        for (int id=0; id<vertices; ++id) {
+            star.addVertex(id);
+        }
+        std::vector<nodeid_t> successors(vertices - 1);
+        std::iota(successors.begin(), successors.end(), 1);
+        std::mt19937 generator{0};
+        std::shuffle(successors.begin(), successors.end(), generator);
+        for (auto id : successors) {
+            star.addEdgeTail(0, id, static_cast<int>(id));
+        }
+        star.finalizeGraph();
+        AdjacentGraph<int, int, int> sortedStar{star};
+        timing_t sortTime;
+        PROFILE_TIME(sortTime) {
+            sortedStar.sortOutEdgesBySink();
+        }
+
+        //query both present and absent sinks
+        std::vector<nodeid_t> queries(20000);
+        std::uniform_int_distribution<nodeid_t> distribution{0, 2 * vertices};
+        for (auto& query : queries) {
+            query = distribution(generator);
+        }
+        auto benchmark = [&](const AdjacentGraph<int, int, int>& g, long& hits) {
+            for (auto query : queries) {
+                if (g.hasEdge(0, query)) {
+                    hits += g.getEdge(0, query);
+                }
+            }
+        };
+
+        long linearHits = 0;
+        timing_t linearTime;
+        PROFILE_TIME(linearTime) {
+            benchmark(star, linearHits);
+        }
+        long sortedHits = 0;
+        timing_t sortedTime;
+        PROFILE_TIME(sortedTime) {
+            benchmark(sortedStar, sortedHits);
+        }
+
+        REQUIRE(linearHits == sortedHits);
+        critical(queries.size(), "lookups on a vertex with", star.getOutDegree(0), "successors");
+        critical("linear scan took", linearTime);
+        critical("binary search took", sortedTime, "(sorting took", sortTime, ")");
+    }
+}
+
+SCENARIO("benchmark compact edge storage", "[.][benchmark]") {
+
+    GIVEN("a big grid") {
+        const int width = 1000;
+        AdjacentGraph<int, int, int> grid = buildGridGraph(width, width);
+        grid.clearInEdgesIndex();
+        CompactAdjacentGraph<int, int, int> compact{grid, false};
+        const nodeid_t center = (width / 2) * width + (width / 2);
+
+        //an unweighted visit only needs the successors
+        auto visit = [&](const auto& g) {
+            std::vector<int> distance(g.numberOfVertices(), -1);
+            std::vector<nodeid_t> queue{};
+            queue.reserve(g.numberOfVertices());
+            distance[center] = 0;
+            queue.push_back(center);
+            long result = 0;
+            for (size_t head=0; head<queue.size(); ++head) {
+                nodeid_t id = queue[head];
+                result += distance[id];
+                forEachSuccessor(g, id, [&](nodeid_t sinkId) {
+                    if (distance[sinkId] < 0) {
+                        distance[sinkId] = distance[id] + 1;
+                        queue.push_back(sinkId);
+                    }
+                });
+            }
+            return result;
+        };
+        //a relaxation of each edge needs the payloads as well
+        auto relax = [&](const auto& g) {
+            std::vector<long> values(g.numberOfVertices(), 0);
+            for (nodeid_t id=0; id<g.numberOfVertices(); ++id) {
+                forEachOutEdge(g, id, [&](const OutEdge<int>& outEdge) {
+                    auto& value = values[outEdge.getSinkId()];
+                    value = std::max(value, values[id] + outEdge.getPayload()) % 1000;
+                });
+            }
+            return std::accumulate(values.begin(), values.end(), 0L);
+        };
+
+        long adjacentHops = 0;
+        long compactHops = 0;
+        long adjacentValues = 0;
+        long compactValues = 0;
+        timing_t adjacentVisitTime;
+        PROFILE_TIME(adjacentVisitTime) {
+            for (int r=0; r<5; ++r) {
+                adjacentHops += visit(grid);
+            }
+        }
+        timing_t compactVisitTime;
+        PROFILE_TIME(compactVisitTime) {
+            for (int r=0; r<5; ++r) {
+                compactHops += visit(compact);
+            }
+        }
+        timing_t adjacentRelaxTime;
+        PROFILE_TIME(adjacentRelaxTime) {
+            for (int r=0; r<5; ++r) {
+                adjacentValues += relax(grid);
+            }
+        }
+        timing_t compactRelaxTime;
+        PROFILE_TIME(compactRelaxTime) {
+            for (int r=0; r<5; ++r) {
+                compactValues += relax(compact);
+            }
+        }
+
+        REQUIRE(adjacentHops == compactHops);
+        REQUIRE(adjacentValues == compactValues);
+        critical("a grid with", grid.numberOfVertices(), "vertices and", grid.numberOfEdges(), "edges, without in edges index");
+        critical("AdjacentGraph memory", grid.getByteMemoryOccupied(), "5 visits took", adjacentVisitTime, "5 relaxations took", adjacentRelaxTime);
+        critical("CompactAdjacentGraph memory", compact.getByteMemoryOccupied(), "5 visits took", compactVisitTime, "5 relaxations took", compactRelaxTime);
+    }
+}
+
+SCENARIO("benchmark compressed adjacency", "[.][benchmark]") {
+
+    GIVEN("a big grid, labelled row by row and randomly") {
+        const int width = 1000;
+        AdjacentGraph<int, int, int> grid = buildGridGraph(width, width);
+        grid.clearInEdgesIndex();
+        std::vector<nodeid_t> scrambled(grid.numberOfVertices());
+        std::iota(scrambled.begin(), scrambled.end(), 0);
+        std::mt19937 generator{0};
+        std::shuffle(scrambled.begin(), scrambled.end(), generator);
+        std::unique_ptr<IImmutableGraph<int, int, int>> scrambledGrid = grid.reorderVertices(invertPermutation(scrambled), scrambled);
+        const int repetitions = 10;
+
+        auto scan = [&](const auto& g, const std::string& name) {
+            long sum = 0;
+            timing_t scanTime;
+            PROFILE_TIME(scanTime) {
+                for (int r=0; r<repetitions; ++r) {
+                    forEachEdge(g, [&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) {
+                        sum += sinkId + payload;
+                    });
+                }
+            }
+            double edgesPerSecond = (static_cast<double>(g.numberOfEdges()) * repetitions) / (scanTime.toMicros().toDouble() / 1e6);
+            double bytesPerEdge = static_cast<double>(static_cast<size_t>(g.getByteMemoryOccupied().to(MemoryConsumptionEnum::BYTE))) / g.numberOfEdges();
+            critical(name, ":", bytesPerEdge, "bytes/edge,", edgesPerSecond / 1e6, "millions of edges/second (checksum", sum, ")");
+            return sum;
+        };
+
+        for (auto* g : std::vector<const IImmutableGraph<int, int, int>*>{&grid, scrambledGrid.get()}) {
+            critical(g == &grid ? "row by row labels" : "random labels");
+            AdjacentGraph<int, int, int> adjacent{*g};
+            adjacent.clearInEdgesIndex();
+            CompactAdjacentGraph<int, int, int> compact{*g, false};
+            CompressedAdjacentGraph<int, int, int> compressed{*g};
+            long expected = scan(adjacent, "AdjacentGraph");
+            REQUIRE(scan(compact, "CompactAdjacentGraph") == expected);
+            REQUIRE(scan(compressed, "CompressedAdjacentGraph") == expected);
+            critical("CompressedAdjacentGraph encodes a sink in", compressed.getBytesPerSink(), "bytes");
+        }
+    }
+}
+
+SCENARIO("benchmark dijkstra queries", "[.][benchmark]") {
+
+    GIVEN("a big grid and some random queries") {
+        const int width = 500;
+        AdjacentGraph<int, int, int> grid = buildGridGraph(width, width);
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<nodeid_t> distribution{0, grid.numberOfVertices() - 1};
+        std::vector<std::pair<nodeid_t, nodeid_t>> queries{};
+        for (int i=0; i<200; ++i) {
+            queries.push_back(std::make_pair(distribution(generator), distribution(generator)));
+        }
+        using Dijkstra = DijkstraSearch<AdjacentGraph<int, int, int>, long>;
+
+        long freshSum = 0;
+        timing_t freshTime;
+        PROFILE_TIME(freshTime) {
+            for (auto& query : queries) {
+                //a new search per query pays O(V) for the initialization
+                Dijkstra dijkstra{grid};
+                freshSum += dijkstra.search(query.first, query.second);
+            }
+        }
+
+        long reusedSum = 0;
+        size_t reusedExpanded = 0;
+        timing_t reusedTime;
+        Dijkstra dijkstra{grid};
+        PROFILE_TIME(reusedTime) {
+            for (auto& query : queries) {
+                reusedSum += dijkstra.search(query.first, query.second);
+                reusedExpanded += dijkstra.getExpandedVertices();
+            }
+        }
+
+        auto manhattan = [&](nodeid_t id, nodeid_t goal) {
+            return static_cast<long>(std::abs(static_cast<long>(id % width) - static_cast<long>(goal % width)) + std::abs(static_cast<long>(id / width) - static_cast<long>(goal / width)));
+        };
+        DijkstraSearch<AdjacentGraph<int, int, int>, long, decltype(manhattan)> astar{grid, manhattan};
+        long astarSum = 0;
+        size_t astarExpanded = 0;
+        timing_t astarTime;
+        PROFILE_TIME(astarTime) {
+            for (auto& query : queries) {
+                astarSum += astar.search(query.first, query.second);
+                astarExpanded += astar.getExpandedVertices();
+            }
+        }
+
+        //short range queries, where the reset cost of a fresh search dominates
+        timing_t localFreshTime;
+        PROFILE_TIME(localFreshTime) {
+            for (auto& query : queries) {
+                Dijkstra fresh{grid};
+                fresh.searchUntil(query.first, [&](nodeid_t id, long distance) { return distance > 20; });
+            }
+        }
+        timing_t localReusedTime;
+        PROFILE_TIME(localReusedTime) {
+            for (auto& query : queries) {
+                dijkstra.searchUntil(query.first, [&](nodeid_t id, long distance) { return distance > 20; });
+            }
+        }
+
+        REQUIRE(freshSum == reusedSum);
+        REQUIRE(astarSum == reusedSum);
+        critical(queries.size(), "random queries on a grid with", grid.numberOfVertices(), "vertices");
+        critical("dijkstra, new search per query took", freshTime);
+        critical("dijkstra, reused search took", reusedTime, "(", reusedTime.toMicros().toDouble() / queries.size(), "us/query, ", reusedExpanded / queries.size(), "expanded/query)");
+        critical("A* with manhattan heuristic took", astarTime, "(", astarTime.toMicros().toDouble() / queries.size(), "us/query, ", astarExpanded / queries.size(), "expanded/query)");
+        critical("bounded searches (distance <= 20): new search per query took", localFreshTime, "reused search took", localReusedTime);
+    }
+}
+
+/**
+ * @brief time some full searches with a given heap
+ *
+ */
+template <typename HEAP, typename GRAPH>
+static void benchmarkDijkstraHeap(const std::string& name, const GRAPH& graph, const std::vector<nodeid_t>& starts, long& checksum) {
+    DijkstraSearch<GRAPH, int, ZeroHeuristic<int>, HEAP> dijkstra{graph};
+    long sum = 0;
+    timing_t time;
+    PROFILE_TIME(time) {
+        for (auto start : starts) {
+            dijkstra.searchAll(start);
+            sum += dijkstra.getDistance(graph.numberOfVertices() - 1 - start);
+        }
+    }
+    if (checksum < 0) {
+        checksum = sum;
+    }
+    REQUIRE(sum == checksum);
+    critical("  ", name, time);
+}
+
+SCENARIO("benchmark dijkstra heaps", "[.][benchmark]") {
+
+    const int width = 1000;
+    AdjacentGraph<int, int, int> smallWeights = buildGridGraph(width, width);
+    //same grid, but the weights go up to 100000
+    AdjacentGraph<int, int, int> largeWeights{width};
+    for (nodeid_t id=0; id<smallWeights.numberOfVertices(); ++id) {
+        largeWeights.addVertex(smallWeights.getVertex(id));
+    }
+    for (nodeid_t id=0; id<smallWeights.numberOfVertices(); ++id) {
+        for (auto& outEdge : smallWeights.getOutEdges(id)) {
+            largeWeights.addEdgeTail(id, outEdge.getSinkId(), outEdge.getPayload() * 9973 % 100000 + 1);
+        }
+    }
+    largeWeights.finalizeGraph();
+    std::vector<nodeid_t> starts{0, 123456, 500500, 999999};
+
+    for (auto graph : std::vector<const AdjacentGraph<int, int, int>*>{&smallWeights, &largeWeights}) {
+        critical(starts.size(), "full searches on a grid with", graph->numberOfVertices(), "vertices and weights up to", graph == &smallWeights ? 10 : 100000);
+        long checksum = -1;
+        benchmarkDijkstraHeap<kway_min_id_heap<nodeid_t, int, 4>>("kway_min_id_heap k=4      ", *graph, starts, checksum);
+        benchmarkDijkstraHeap<kway_min_id_split_heap<nodeid_t, int, 8>>("kway_min_id_split_heap k=8", *graph, starts, checksum);
+        benchmarkDijkstraHeap<radix_min_id_heap<nodeid_t, int>>("radix_min_id_heap         ", *graph, starts, checksum);
+        benchmarkDijkstraHeap<bucket_min_id_heap<nodeid_t, int>>("bucket_min_id_heap        ", *graph, starts, checksum);
+    }
+}
+
+SCENARIO("benchmark contraction hierarchy", "[.][benchmark]") {
+
+    GIVEN("a big grid and some random queries") {
+        const int width = 200;
+        AdjacentGraph<int, int, int> grid = buildGridGraph(width, width);
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<nodeid_t> distribution{0, grid.numberOfVertices() - 1};
+        std::vector<std::pair<nodeid_t, nodeid_t>> queries{};
+        for (int i=0; i<1000; ++i) {
+            queries.push_back(std::make_pair(distribution(generator), distribution(generator)));
+        }
+
+        timing_t preprocessingTime;
+        ContractionHierarchy<int> ch{};
+        PROFILE_TIME(preprocessingTime) {
+            ch = ContractionHierarchy<int>{grid};
+        }
+
+        DijkstraSearch<AdjacentGraph<int, int, int>, int> dijkstra{grid};
+        long dijkstraSum = 0;
+        size_t dijkstraExpanded = 0;
+        timing_t dijkstraTime;
+        PROFILE_TIME(dijkstraTime) {
+            for (auto& query : queries) {
+                dijkstraSum += dijkstra.search(query.first, query.second);
+                dijkstraExpanded += dijkstra.getExpandedVertices();
+            }
+        }
+
+        ContractionHierarchySearch<int> search{ch};
+        long chSum = 0;
+        size_t chExpanded = 0;
+        timing_t chTime;
+        PROFILE_TIME(chTime) {
+            for (auto& query : queries) {
+                chSum += search.search(query.first, query.second);
+                chExpanded += search.getExpandedVertices();
+            }
+        }
+
+        size_t pathLength = 0;
+        timing_t unpackTime;
+        PROFILE_TIME(unpackTime) {
+            for (auto& query : queries) {
+                search.search(query.first, query.second);
+                pathLength += search.getPath().size();
+            }
+        }
+
+        REQUIRE(chSum == dijkstraSum);
+        critical(queries.size(), "random queries on a grid with", grid.numberOfVertices(), "vertices and", grid.numberOfEdges(), "edges");
+        critical("contraction took", preprocessingTime, "and added", ch.numberOfShortcuts(), "shortcuts");
+        critical("dijkstra took", dijkstraTime, "(", dijkstraTime.toMicros().toDouble() / queries.size(), "us/query, ", dijkstraExpanded / queries.size(), "expanded/query)");
+        critical("contraction hierarchy took", chTime, "(", chTime.toMicros().toDouble() / queries.size(), "us/query, ", chExpanded / queries.size(), "expanded/query)");
+        critical("contraction hierarchy with path unpacking took", unpackTime, "(", pathLength / queries.size(), "vertices/path)");
+    }
+}
+
+SCENARIO("benchmark distance table", "[.][benchmark]") {
+
+    GIVEN("a big grid and some depots") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(300, 300);
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<nodeid_t> distribution{0, grid.numberOfVertices() - 1};
+        std::vector<nodeid_t> depots{};
+        for (int i=0; i<200; ++i) {
+            depots.push_back(distribution(generator));
+        }
+
+        critical("distance table between", depots.size(), "depots on a grid with", grid.numberOfVertices(), "vertices;", getDefaultNumberOfThreads(), "hardware threads");
+        std::vector<long> expected{};
+        for (size_t threads : std::vector<size_t>{1, 2, 4, 8}) {
+            timing_t time;
+            DistanceTable<long> table{0, 0, 0};
+            PROFILE_TIME(time) {
+                table = computeDistanceTable<AdjacentGraph<int, int, int>, long>(grid, depots, depots, threads);
+            }
+            if (expected.empty()) {
+                expected = table.getData();
+            }
+            REQUIRE(table.getData() == expected);
+            critical(threads, "threads took", time, "(", depots.size() / (time.toMicros().toDouble() / 1e6), "one-to-many queries/s)");
+        }
+    }
+}
+
+SCENARIO("benchmark first move database", "[.][benchmark]") {
+
+    GIVEN("a grid and some random queries") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(100, 100);
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<nodeid_t> distribution{0, grid.numberOfVertices() - 1};
+        std::vector<std::pair<nodeid_t, nodeid_t>> queries{};
+        for (int i=0; i<10000; ++i) {
+            queries.push_back(std::make_pair(distribution(generator), distribution(generator)));
+        }
+
+        timing_t buildTime;
+        std::unique_ptr<FirstMoveDatabase> db{nullptr};
+        PROFILE_TIME(buildTime) {
+            db.reset(new FirstMoveDatabase{grid});
+        }
+        const size_t vertices = grid.numberOfVertices();
+        const size_t compressedBytes = db->numberOfRuns() * (sizeof(uint32_t) + sizeof(moveid_t)) + vertices * (sizeof(uint32_t) + sizeof(uint64_t));
+
+        boost::filesystem::path p{"./cpd-benchmark.dat"};
+        FILE* f = fopen(p.native().c_str(), "wb");
+        cpp_utils::serializers::saveToMappableFile(f, *db);
+        fclose(f);
+        FirstMoveDatabase mapped{p};
+
+        DijkstraSearch<AdjacentGraph<int, int, int>, long> dijkstra{grid};
+        size_t dijkstraLength = 0;
+        timing_t dijkstraTime;
+        PROFILE_TIME(dijkstraTime) {
+            for (auto& query : queries) {
+                dijkstra.search(query.first, query.second);
+                dijkstraLength += dijkstra.getPath(query.second).size();
+            }
+        }
+
+        size_t cpdLength = 0;
+        timing_t cpdTime;
+        PROFILE_TIME(cpdTime) {
+            for (auto& query : queries) {
+                cpdLength += mapped.getPath(grid, query.first, query.second).size();
+            }
+        }
+        boost::filesystem::remove(p);
+
+        critical(queries.size(), "random queries on a grid with", vertices, "vertices");
+        critical("building the database took", buildTime, "with", getDefaultNumberOfThreads(), "threads");
+        critical("runs", db->numberOfRuns(), "(", static_cast<double>(db->numberOfRuns()) / vertices, "per source):", compressedBytes, "bytes against", vertices * vertices * sizeof(moveid_t), "bytes of the uncompressed tables");
+        critical("dijkstra with path extraction took", dijkstraTime, "(", dijkstraTime.toMicros().toDouble() / queries.size(), "us/query,", dijkstraLength / queries.size(), "vertices/path)");
+        critical("mapped first move database took", cpdTime, "(", cpdTime.toMicros().toDouble() / queries.size(), "us/query,", cpdLength / queries.size(), "vertices/path)");
+    }
+}
+
+SCENARIO("benchmark landmarks", "[.][benchmark]") {
+
+    GIVEN("a grid and some random queries") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(300, 300);
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<nodeid_t> distribution{0, grid.numberOfVertices() - 1};
+        std::vector<std::pair<nodeid_t, nodeid_t>> queries{};
+        for (int i=0; i<300; ++i) {
+            queries.push_back(std::make_pair(distribution(generator), distribution(generator)));
+        }
+
+        DijkstraSearch<AdjacentGraph<int, int, int>, long> dijkstra{grid};
+        size_t dijkstraExpanded = 0;
+        long dijkstraSum = 0;
+        timing_t dijkstraTime;
+        PROFILE_TIME(dijkstraTime) {
+            for (auto& query : queries) {
+                dijkstraSum += dijkstra.search(query.first, query.second);
+                dijkstraExpanded += dijkstra.getExpandedVertices();
+            }
+        }
+        critical(queries.size(), "random queries on a grid with", grid.numberOfVertices(), "vertices");
+        critical("dijkstra took", dijkstraTime, "(", dijkstraTime.toMicros().toDouble() / queries.size(), "us/query,", dijkstraExpanded / queries.size(), "expanded/query)");
+
+        for (auto selection : std::vector<LandmarkSelection>{LandmarkSelection::FARTHEST, LandmarkSelection::AVOID}) {
+            for (size_t k : std::vector<size_t>{4, 8, 16}) {
+                timing_t buildTime;
+                std::unique_ptr<Landmarks<long>> landmarks{nullptr};
+                PROFILE_TIME(buildTime) {
+                    landmarks.reset(new Landmarks<long>{grid, k, selection});
+                }
+
+                DijkstraSearch<AdjacentGraph<int, int, int>, long, LandmarkHeuristic<long>> astar{grid, landmarks->getHeuristic()};
+                size_t astarExpanded = 0;
+                long astarSum = 0;
+                timing_t astarTime;
+                PROFILE_TIME(astarTime) {
+                    for (auto& query : queries) {
+                        astarSum += astar.search(query.first, query.second);
+                        astarExpanded += astar.getExpandedVertices();
+                    }
+                }
+                REQUIRE(astarSum == dijkstraSum);
+                critical(selection == LandmarkSelection::FARTHEST ? "farthest" : "avoid", k, "landmarks: preprocessing took", buildTime, "; ALT took", astarTime, "(", astarTime.toMicros().toDouble() / queries.size(), "us/query,", astarExpanded / queries.size(), "expanded/query)");
+            }
+        }
+    }
+}
+
+/**
+ * @brief time the lower bound of random pairs of vertices, with and without SIMD
+ *
+ */
+template <typename COST>
+static void benchmarkLandmarkBound(const std::string& costName, size_t vertices, size_t k, size_t queries) {
+    std::mt19937 generator{0};
+    std::uniform_int_distribution<int> distanceDistribution{0, 100000};
+    std::vector<COST> fromLandmarks(vertices * k);
+    std::vector<COST> toLandmarks(vertices * k);
+    for (size_t i=0; i<vertices * k; ++i) {
+        fromLandmarks[i] = static_cast<COST>(distanceDistribution(generator));
+        toLandmarks[i] = static_cast<COST>(distanceDistribution(generator));
+    }
+    std::uniform_int_distribution<size_t> vertexDistribution{0, vertices - 1};
+    std::vector<std::pair<size_t, size_t>> pairs{};
+    for (size_t i=0; i<queries; ++i) {
+        pairs.push_back(std::make_pair(vertexDistribution(generator), vertexDistribution(generator)));
+    }
+
+    auto run = [&](auto bound) {
+        COST result = 0;
+        for (auto& pair : pairs) {
+            result += bound(fromLandmarks.data() + pair.first * k, fromLandmarks.data() + pair.second * k, toLandmarks.data() + pair.first * k, toLandmarks.data() + pair.second * k, k);
+        }
+        return result;
+    };
+    timing_t scalarTime;
+    COST scalarSum;
+    PROFILE_TIME(scalarTime) {
+        scalarSum = run(graphs::internal::ScalarLandmarkBound<COST>::compute);
+    }
+    timing_t simdTime;
+    COST simdSum;
+    PROFILE_TIME(simdTime) {
+        simdSum = run(graphs::internal::LandmarkBound<COST>::compute);
+    }
+    REQUIRE(scalarSum == simdSum);
+    critical(costName, k, "landmarks:", queries, "bounds took", scalarTime, "with the generic loop and", simdTime, "with internal::LandmarkBound");
+}
+
+SCENARIO("benchmark landmark bounds", "[.][benchmark]") {
+
+    GIVEN("random distance tables of 100000 vertices") {
+        for (size_t k : std::vector<size_t>{4, 16, 32}) {
+            benchmarkLandmarkBound<int>("int", 100000, k, 5000000);
+            benchmarkLandmarkBound<long>("long", 100000, k, 5000000);
+            benchmarkLandmarkBound<double>("double", 100000, k, 5000000);
+        }
+    }
+}
+
+SCENARIO("benchmark batched weight updates", "[.][benchmark]") {
+
+    auto benchmark = [&](const std::string& name, const AdjacentGraph<int, int, int>& g, const std::vector<Edge<int>>& updates) {
+        AdjacentGraph<int, int, int> single{g};
+        timing_t singleTime;
+        PROFILE_TIME(singleTime) {
+            for (auto& update : updates) {
+                single.changeWeightEdge(update.getSourceId(), update.getSinkId(), update.getPayload());
+            }
+        }
+        AdjacentGraph<int, int, int> batched{g};
+        timing_t batchedTime;
+        PROFILE_TIME(batchedTime) {
+            batched.changeWeightEdges(updates);
+        }
+        AdjacentGraph<int, int, int> logged{g};
+        logged.setWeightChangeLogCapacity(updates.size());
+        timing_t loggedTime;
+        PROFILE_TIME(loggedTime) {
+            logged.changeWeightEdges(updates);
+        }
+        REQUIRE(single == batched);
+        REQUIRE(single == logged);
+        critical(updates.size(), "updates on", name, ": one at a time took", singleTime, "; batched took", batchedTime, "; batched with change log took", loggedTime);
+    };
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(300, 300);
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<nodeid_t> distribution{0, grid.numberOfVertices() - 1};
+        std::vector<Edge<int>> updates{};
+        for (int i=0; i<100000; ++i) {
+            nodeid_t sourceId = distribution(generator);
+            updates.emplace_back(sourceId, grid.getOutEdge(sourceId, i % grid.getOutDegree(sourceId)).getSinkId(), i);
+        }
+        benchmark("a 300x300 grid", grid, updates);
+    }
+
+    GIVEN("a star whose center has a successor per vertex") {
+        const int vertices = 100000;
+        AdjacentGraph<int, int, int> star{0};
+        for (int id=0; id<vertices; ++id) {
+            star.addVertex(id);
+        }
+        std::vector<nodeid_t> successors(vertices - 1);
+        std::iota(successors.begin(), successors.end(), 1);
+        std::mt19937 generator{0};
+        std::shuffle(successors.begin(), successors.end(), generator);
+        for (auto id : successors) {
+            star.addEdgeTail(0, id, static_cast<int>(id));
+        }
+        star.finalizeGraph();
+        std::vector<Edge<int>> updates{};
+        for (int i=0; i<20000; ++i) {
+            updates.emplace_back(0, successors[(i * 7919) % successors.size()], i);
+        }
+        benchmark("the center of a star", star, updates);
+    }
+}
+
+SCENARIO("benchmark dynamic graph", "[.][benchmark]") {
+
+    GIVEN("the edges of a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(100, 100);
+        const size_t vertices = grid.numberOfVertices();
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<nodeid_t> distribution{0, vertices - 1};
+        std::vector<nodeid_t> queries(1000);
+        for (auto& query : queries) {
+            query = distribution(generator);
+        }
+
+        //ListGraph needs the edges sorted by source, DynamicGraph does not
+        timing_t listBuildTime;
+        ListGraph<int, int, int> list{0};
+        PROFILE_TIME(listBuildTime) {
+            for (nodeid_t id=0; id<vertices; ++id) {
+                list.addVertex(grid.getVertex(id));
+            }
+            grid.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) {
+                list.addEdge(sourceId, sinkId, payload);
+            });
+        }
+        timing_t dynamicBuildTime;
+        DynamicGraph<int, int, int> dynamic{0};
+        PROFILE_TIME(dynamicBuildTime) {
+            for (nodeid_t id=0; id<vertices; ++id) {
+                dynamic.addVertex(grid.getVertex(id));
+            }
+            for (nodeid_t id=vertices; id>0; --id) {
+                forEachOutEdge(grid, id - 1, [&](const OutEdge<int>& outEdge) {
+                    dynamic.addEdge(id - 1, outEdge.getSinkId(), outEdge.getPayload());
+                });
+            }
+        }
+
+        auto query = [&](const IVertexExtendableGraph<int, int, int>& g) {
+            size_t result = 0;
+            for (auto id : queries) {
+                result += g.getOutDegree(id) + g.getInDegree(id) + g.getInEdges(id).size();
+                if (g.hasEdge(id, (id + 1) % vertices)) {
+                    result += g.getEdge(id, (id + 1) % vertices);
+                }
+            }
+            return result;
+        };
+        size_t listResult = 0;
+        timing_t listQueryTime;
+        PROFILE_TIME(listQueryTime) {
+            listResult = query(list);
+        }
+        size_t dynamicResult = 0;
+        timing_t dynamicQueryTime;
+        PROFILE_TIME(dynamicQueryTime) {
+            dynamicResult = query(dynamic);
+        }
+        REQUIRE(listResult == dynamicResult);
+
+        auto remove = [&](IVertexExtendableGraph<int, int, int>& g) {
+            for (auto id : queries) {
+                g.removeEdge(id, (id + 1) % vertices);
+            }
+        };
+        timing_t listRemoveTime;
+        PROFILE_TIME(listRemoveTime) {
+            remove(list);
+        }
+        timing_t dynamicRemoveTime;
+        PROFILE_TIME(dynamicRemoveTime) {
+            remove(dynamic);
+        }
+        REQUIRE(list.numberOfEdges() == dynamic.numberOfEdges());
+
+        timing_t copyTime;
+        PROFILE_TIME(copyTime) {
+            AdjacentGraph<int, int, int> copy{dynamic};
+        }
+        timing_t freezeTime;
+        PROFILE_TIME(freezeTime) {
+            AdjacentGraph<int, int, int> frozen = dynamic.freeze();
+        }
+
+        critical("a grid with", vertices, "vertices and", grid.numberOfEdges(), "edges");
+        critical("ListGraph: building took", listBuildTime, ";", queries.size(), "degree, in edges and edge queries took", listQueryTime, "; removing", queries.size(), "edges took", listRemoveTime);
+        critical("DynamicGraph: building (sources in reverse order) took", dynamicBuildTime, ";", queries.size(), "degree, in edges and edge queries took", dynamicQueryTime, "; removing", queries.size(), "edges took", dynamicRemoveTime);
+        critical("to AdjacentGraph: generic copy took", copyTime, "; freeze took", freezeTime);
+    }
+}
+
+SCENARIO("benchmark components", "[.][benchmark]") {
+
+    GIVEN("a large grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(1000, 1000);
+
+        std::vector<uint32_t> scc;
+        timing_t sccTime;
+        PROFILE_TIME(sccTime) {
+            scc = getStronglyConnectedComponents(grid);
+        }
+        REQUIRE(ComponentLabels{std::move(scc)}.numberOfComponents() == 1);
+        critical("a grid with", grid.numberOfVertices(), "vertices and", grid.numberOfEdges(), "edges");
+        critical("iterative tarjan took", sccTime);
+
+        std::vector<uint32_t> reference{};
+        for (size_t threads : std::vector<size_t>{1, 2, 4, 0}) {
+            std::vector<uint32_t> wcc;
+            timing_t wccTime;
+            PROFILE_TIME(wccTime) {
+                wcc = getWeaklyConnectedComponents(grid, threads);
+            }
+            if (reference.empty()) {
+                reference = wcc;
+            }
+            REQUIRE(wcc == reference);
+            critical("weakly connected components with", threads, "threads (0 is the default) took", wccTime);
+        }
+
+        ComponentLabels components{std::move(reference)};
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<nodeid_t> distribution{0, grid.numberOfVertices() - 1};
+        std::vector<std::pair<nodeid_t, nodeid_t>> queries{};
+        for (int i=0; i<1000000; ++i) {
+            queries.push_back(std::make_pair(distribution(generator), distribution(generator)));
+        }
+        size_t same = 0;
+        timing_t queryTime;
+        PROFILE_TIME(queryTime) {
+            for (auto& query : queries) {
+                same += components.sameComponent(query.first, query.second) ? 1 : 0;
+            }
+        }
+        REQUIRE(same == queries.size());
+        critical(queries.size(), "sameComponent queries took", queryTime);
+    }
+}
+
+SCENARIO("benchmark graph partitioning", "[.][benchmark]") {
+
+    GIVEN("a large grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(300, 300);
+        critical("a grid with", grid.numberOfVertices(), "vertices and", grid.numberOfEdges(), "edges");
+
+        for (uint32_t k : std::vector<uint32_t>{2, 4, 16, 64}) {
+            std::unique_ptr<GraphPartition> partition{nullptr};
+            timing_t partitionTime;
+            PROFILE_TIME(partitionTime) {
+                partition.reset(new GraphPartition{grid, k});
+            }
+            auto sizes = partition->getCellSizes();
+
+            std::vector<GraphCell<int, int, int>> cells;
+            timing_t extractTime;
+            PROFILE_TIME(extractTime) {
+                cells = partition->extractCells(grid);
+            }
+            std::unique_ptr<OverlayGraph<long>> overlay{nullptr};
+            timing_t overlayTime;
+            PROFILE_TIME(overlayTime) {
+                overlay.reset(new OverlayGraph<long>{cells});
+            }
+            REQUIRE(cells.size() == k);
+
+            //cutting the grid in straight stripes or blocks cuts 2 * 300 edges per line
+            critical(k, "cells: partitioning took", partitionTime, "; cut edges", partition->numberOfCutEdges(), "; largest cell", *std::max_element(sizes.begin(), sizes.end()), "smallest", *std::min_element(sizes.begin(), sizes.end()));
+            critical(k, "cells: extracting them took", extractTime, "; the overlay took", overlayTime, "and has", overlay->numberOfVertices(), "vertices and", overlay->getGraph().numberOfEdges(), "edges");
+        }
+    }
+}
+
+SCENARIO("benchmark graph importers", "[.][benchmark]") {
+
+    GIVEN("a large grid saved as DIMACS and as a binary edge list") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(1000, 1000);
+        critical("a grid with", grid.numberOfVertices(), "vertices and", grid.numberOfEdges(), "edges");
+
+        const char* dimacsFilename = "./benchmark.gr";
+        FILE* f = fopen(dimacsFilename, "w");
+        fprintf(f, "c a 1000x1000 grid\np sp %lu %lu\n", static_cast<unsigned long>(grid.numberOfVertices()), static_cast<unsigned long>(grid.numberOfEdges()));
+        for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+            for (auto& outEdge : grid.getOutEdges(id)) {
+                fprintf(f, "a %lu %lu %d\n", static_cast<unsigned long>(id + 1), static_cast<unsigned long>(outEdge.getSinkId() + 1), outEdge.getPayload());
+            }
+        }
+        fclose(f);
+
+        const char* binaryFilename = "./benchmark.bin";
+        f = fopen(binaryFilename, "wb");
+        cpp_utils::serializers::saveToBinaryEdgeList(f, grid);
+        fclose(f);
+
+        //the naive way: iostreams and an edge at a time in a ListGraph
+        timing_t naiveTime;
+        size_t naiveEdges = 0;
+        PROFILE_TIME(naiveTime) {
+            std::ifstream in{dimacsFilename};
+            ListGraph<int, int, int> naive{0};
+            std::string line;
+            while (std::getline(in, line)) {
+                if (line.empty() || line[0] == 'c') {
+                    continue;
+                }
+                std::istringstream ss{line};
+                char kind;
+                ss >> kind;
+                if (kind == 'p') {
+                    std::string sp;
+                    size_t vertices, edges;
+                    ss >> sp >> vertices >> edges;
+                    for (size_t i=0; i<vertices; ++i) {
+                        naive.addVertex(0);
+                    }
+                } else {
+                    nodeid_t source, sink;
+                    int weight;
+                    ss >> source >> sink >> weight;
+                    naive.addEdge(source - 1, sink - 1, weight);
+                }
+            }
+            naiveEdges = naive.numberOfEdges();
+        }
+        REQUIRE(naiveEdges == grid.numberOfEdges());
+        critical("reading the DIMACS file with iostreams took", naiveTime);
+
+        timing_t dimacsTime;
+        size_t dimacsEdges = 0;
+        PROFILE_TIME(dimacsTime) {
+            dimacsEdges = importDimacsGraph<int, int, int>(dimacsFilename).numberOfEdges();
+        }
+        REQUIRE(dimacsEdges == grid.numberOfEdges());
+        critical("importDimacsGraph took", dimacsTime);
+
+        timing_t binaryTime;
+        size_t binaryEdges = 0;
+        PROFILE_TIME(binaryTime) {
+            binaryEdges = importBinaryEdgeList<int, int, int>(binaryFilename).numberOfEdges();
+        }
+        REQUIRE(binaryEdges == grid.numberOfEdges());
+        critical("importBinaryEdgeList took", binaryTime);
+
+        remove(dimacsFilename);
+        remove(binaryFilename);
+    }
+}
+
+SCENARIO("benchmark graph rendering", "[.][benchmark]") {
+
+    GIVEN("a large grid whose vertices know their coordinates") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(1000, 1000);
+        critical("a grid with", grid.numberOfVertices(), "vertices and", grid.numberOfEdges(), "edges");
+
+        //the same image is reused by each frame
+        PPMImage image{2048, 2048};
+        const int frames = 10;
+        timing_t drawTime;
+        PROFILE_TIME(drawTime) {
+            for (int frame=0; frame<frames; ++frame) {
+                drawGraph(image, grid, [](int id) { return std::make_pair(id % 1000, id / 1000); });
+            }
+        }
+        REQUIRE(image.isValid());
+        critical("drawing", frames, "frames of 2048x2048 pixels took", drawTime);
+    }
+
+    GIVEN("a grid without coordinates") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(100, 100);
+        critical("a grid with", grid.numberOfVertices(), "vertices and", grid.numberOfEdges(), "edges");
+
+        std::vector<std::pair<double, double>> layout;
+        timing_t layoutTime;
+        PROFILE_TIME(layoutTime) {
+            layout = getForceDirectedLayout(grid, 100);
+        }
+        REQUIRE(layout.size() == grid.numberOfVertices());
+        critical("100 iterations of the force directed layout took", layoutTime);
+
+        std::unique_ptr<PPMImage> image{nullptr};
+        timing_t ppmTime;
+        PROFILE_TIME(ppmTime) {
+            image.reset(grid.getPPM());
+        }
+        REQUIRE(image->isValid());
+        critical("getPPM took", ppmTime);
+    }
+}
@@ -44,6 +44,15 @@ SCENARIO("test timer") {
             t.stop();
             REQUIRE(t.isRunning() == false);
         }
+
+        WHEN("measuring more than 1 second") {
+            t.start();
+            usleep(1100000); //microseconds
+            REQUIRE(t.getCurrentElapsedMicroSeconds().toDouble() >= 1100000);
+            t.stop();
+            REQUIRE(t.getElapsedMicroSeconds().toDouble() >= 1100000);
+            REQUIRE(t.getElapsedMicroSeconds().toDouble() < 60000000);
+        }
     }
 
     GIVEN("PROFILE_TIME") {
@@ -3,9 +3,19 @@
 #include <boost/heap/d_ary_heap.hpp>
 
 #include "KHeaps.hpp"
+#include "MonotoneHeaps.hpp"
+#include "MultiQueue.hpp"
 #include "BoostQueue.hpp"
+#include "IntrusiveQueue.hpp"
 #include "IQueue.hpp"
 #include "StaticPriorityQueue.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
 
 using namespace cpp_utils;
 
@@ -98,6 +108,32 @@ struct NewOrder {
     }
 };
 
+/**
+ * @brief an item whose key can be changed while it is in a queue
+ *
+ */
+struct KeyedItem: public HasPriority<priority_t> {
+    int key;
+    priority_t position;
+
+    KeyedItem(): key{0}, position{0} {
+
+    }
+    friend bool operator < (const KeyedItem& a, const KeyedItem& b) {
+        return a.key < b.key;
+    }
+    friend std::ostream& operator <<(std::ostream& ss, const KeyedItem& item) {
+        ss << item.key;
+        return ss;
+    }
+    priority_t getPriority(const void* q) const {
+        return this->position;
+    }
+    void setPriority(const void* q, priority_t p) {
+        this->position = p;
+    }
+};
+
 SCENARIO("test boostQueue") {
 
     GIVEN("boost Queue") {
@@ -187,6 +223,151 @@ SCENARIO("test boostQueue") {
             REQUIRE(q.isEmpty());
         }
     }
+
+    GIVEN("items whose keys change while in the queue") {
+        BoostQueue<KeyedItem> q{};
+        std::vector<KeyedItem> items(4);
+        for (int i=0; i<4; ++i) {
+            items[i].key = 10 * (i + 1);
+            q.push(items[i]);
+        }
+
+        items[3].key = 5;
+        q.decrease_key(items[3]);
+        items[0].key = 35;
+        q.increase_key(items[0]);
+
+        REQUIRE(&q.pop() == &items[3]);
+        REQUIRE(&q.pop() == &items[1]);
+        REQUIRE(&q.pop() == &items[2]);
+        REQUIRE(&q.pop() == &items[0]);
+        REQUIRE(q.isEmpty());
+    }
+}
+
+struct ReverseFooOrder {
+    bool operator() (const Foo& a, const Foo& b) const {
+        return (b < a);
+    }
+};
+
+SCENARIO("test intrusiveQueue") {
+
+    GIVEN("an intrusive queue") {
+        IntrusiveQueue<Foo> q{};
+
+        WHEN("empty") {
+            REQUIRE(q.isEmpty());
+            REQUIRE(q.size() == 0);
+            REQUIRE_THROWS(q.pop());
+            REQUIRE_THROWS(q.peek());
+        }
+
+        WHEN("non empty") {
+            Foo o1 = Foo{std::string{"a"}, 5};
+            Foo o2 = Foo{std::string{"b"}, 10};
+            Foo o3 = Foo{std::string{"c"}, 1};
+            Foo o4 = Foo{std::string{"d"}, 11};
+
+            q.push(o1);
+            q.push(o2);
+            q.push(o3);
+            q.push(o4);
+            q.push(o4);
+
+            REQUIRE(!q.isEmpty());
+            REQUIRE(q.size() == 4);
+
+            REQUIRE(q.peek() == o3);
+            REQUIRE(q.pop() == o3);
+            REQUIRE(q.pop() == o1);
+            REQUIRE(q.pop() == o2);
+
+            q.push(o2);
+            REQUIRE(!q.contains(o1));
+            REQUIRE(q.contains(o2));
+            REQUIRE(!q.contains(o3));
+            REQUIRE(q.contains(o4));
+
+            REQUIRE(q.size() == 2);
+            REQUIRE(q.pop() == o2);
+            REQUIRE(q.pop() == o4);
+            REQUIRE(q.isEmpty());
+        }
+    }
+
+    GIVEN("an intrusive queue with a custom order") {
+        IntrusiveQueue<Foo, ReverseFooOrder, 2> q{};
+        Foo o1 = Foo{std::string{"a"}, 5};
+        Foo o2 = Foo{std::string{"b"}, 10};
+        Foo o3 = Foo{std::string{"c"}, 1};
+
+        q.push(o1);
+        q.push(o2);
+        q.push(o3);
+        REQUIRE(q.pop() == o2);
+        REQUIRE(q.pop() == o1);
+        REQUIRE(q.pop() == o3);
+        REQUIRE(q.isEmpty());
+    }
+
+    GIVEN("items whose keys change while in the queue") {
+        std::mt19937 generator{0};
+        std::uniform_int_distribution<int> keyDistribution{0, 1000};
+        std::uniform_int_distribution<int> operationDistribution{0, 4};
+        std::vector<KeyedItem> items(200);
+        IntrusiveQueue<KeyedItem> q{10};
+        std::multiset<std::pair<int, KeyedItem*>> expected{};
+
+        for (int step=0; step<20000; ++step) {
+            KeyedItem& item = items[std::uniform_int_distribution<size_t>{0, items.size() - 1}(generator)];
+            switch (operationDistribution(generator)) {
+                case 0:
+                case 1: {
+                    if (!q.contains(item)) {
+                        item.key = keyDistribution(generator);
+                        q.push(item);
+                        expected.insert(std::make_pair(item.key, &item));
+                    }
+                    break;
+                }
+                case 2: {
+                    if (q.contains(item)) {
+                        expected.erase(std::make_pair(item.key, &item));
+                        item.key -= keyDistribution(generator);
+                        q.decrease_key(item);
+                        expected.insert(std::make_pair(item.key, &item));
+                    }
+                    break;
+                }
+                case 3: {
+                    if (q.contains(item)) {
+                        expected.erase(std::make_pair(item.key, &item));
+                        item.key += keyDistribution(generator);
+                        q.increase_key(item);
+                        expected.insert(std::make_pair(item.key, &item));
+                    }
+                    break;
+                }
+                case 4: {
+                    if (!q.isEmpty()) {
+                        KeyedItem& popped = q.pop();
+                        REQUIRE(popped.key == expected.begin()->first);
+                        REQUIRE(!q.contains(popped));
+                        expected.erase(std::make_pair(popped.key, &popped));
+                    }
+                    break;
+                }
+            }
+            REQUIRE(q.size() == expected.size());
+        }
+
+        while (!q.isEmpty()) {
+            REQUIRE(q.pop().key == expected.begin()->first);
+            expected.erase(expected.begin());
+        }
+        REQUIRE(expected.empty());
+    }
 }
 
 template <typename T>
@@ -330,6 +511,182 @@ SCENARIO("test min_id_heap") {
             REQUIRE(heap.pop() == 50L);
             REQUIRE(heap.pop() == 60L);
         }
+
+        WHEN("cleaning up a partially emptied heap") {
+            heap.pushOrDecrease(50L, 3);
+            heap.pushOrDecrease(60L, 4);
+            heap.pushOrDecrease(70L, 2);
+            REQUIRE(heap.pop() == 70L);
+
+            heap.cleanup();
+            REQUIRE(heap.isEmpty());
+            REQUIRE_FALSE(heap.contains(50L));
+            REQUIRE_FALSE(heap.contains(60L));
+            REQUIRE_FALSE(heap.contains(70L));
+
+            heap.pushOrDecrease(60L, 1);
+            heap.pushOrDecrease(50L, 2);
+            REQUIRE(heap.pop() == 60L);
+            REQUIRE(heap.pop() == 50L);
+            REQUIRE(heap.isEmpty());
+        }
+    }
+}
+
+/**
+ * @brief run random pushes, decreases and pops on a heap and check them against a sorted set
+ *
+ * @tparam HEAP a heap with the interface of kway_min_id_heap, whose ids are int
+ * @param maxWeight if positive, keys are monotone: each key is the last popped one plus at most this much. Otherwise keys are random
+ */
+template <typename HEAP>
+static void checkHeapAgainstSet(int ids, int steps, unsigned int seed, int maxWeight = 0) {
+    using key_type = typename HEAP::key_type;
+    HEAP heap{static_cast<std::size_t>(ids)};
+    std::set<std::pair<key_type, int>> expected{};
+    std::vector<key_type> keys(ids);
+    std::vector<bool> inHeap(ids, false);
+    std::mt19937 generator{seed};
+    std::uniform_int_distribution<int> idDistribution{0, ids - 1};
+    std::uniform_int_distribution<int> keyDistribution{0, 1000};
+    std::uniform_int_distribution<int> weightDistribution{0, std::max(0, maxWeight)};
+    std::uniform_int_distribution<int> actionDistribution{0, 2};
+    key_type lastPopped = 0;
+
+    for (int step=0; step<steps; ++step) {
+        if (actionDistribution(generator) == 0 && !expected.empty()) {
+            REQUIRE(heap.peekKey() == expected.begin()->first);
+            int id = heap.pop();
+            //ties can be broken in any way
+            REQUIRE(inHeap[id]);
+            REQUIRE(keys[id] == expected.begin()->first);
+            expected.erase(std::make_pair(keys[id], id));
+            inHeap[id] = false;
+            lastPopped = keys[id];
+        } else {
+            int id = idDistribution(generator);
+            key_type key = static_cast<key_type>(maxWeight > 0 ? lastPopped + weightDistribution(generator) : keyDistribution(generator));
+            bool changed = heap.pushOrDecrease(id, key);
+            REQUIRE(changed == (!inHeap[id] || key < keys[id]));
+            if (changed) {
+                expected.erase(std::make_pair(keys[id], id));
+                expected.insert(std::make_pair(key, id));
+                keys[id] = key;
+                inHeap[id] = true;
+            }
+        }
+        REQUIRE(heap.isEmpty() == expected.empty());
+    }
+    while (!expected.empty()) {
+        int id = heap.pop();
+        REQUIRE(keys[id] == expected.begin()->first);
+        expected.erase(std::make_pair(keys[id], id));
+    }
+    REQUIRE(heap.isEmpty());
+}
+
+SCENARIO("test kway_min_id_heap arities") {
+
+    GIVEN("random operations") {
+        WHEN("the arity is a power of 2") {
+            checkHeapAgainstSet<kway_min_id_heap<int, int, 2>>(200, 5000, 1);
+            checkHeapAgainstSet<kway_min_id_heap<int, int, 4>>(200, 5000, 2);
+            checkHeapAgainstSet<kway_min_id_heap<int, int, 8>>(200, 5000, 3);
+            checkHeapAgainstSet<kway_min_id_heap<int, int, 16>>(200, 5000, 4);
+        }
+
+        WHEN("the arity is not a power of 2") {
+            checkHeapAgainstSet<kway_min_id_heap<int, int, 3>>(200, 5000, 5);
+            checkHeapAgainstSet<kway_min_id_heap<int, int, 5>>(200, 5000, 6);
+        }
+    }
+}
+
+SCENARIO("test kway_min_id_split_heap") {
+
+    GIVEN("random operations") {
+        WHEN("keys are scanned with SIMD instructions") {
+            checkHeapAgainstSet<kway_min_id_split_heap<int, int32_t, 4>>(200, 5000, 1);
+            checkHeapAgainstSet<kway_min_id_split_heap<int, int32_t, 16>>(200, 5000, 2);
+            checkHeapAgainstSet<kway_min_id_split_heap<int, uint32_t, 8>>(200, 5000, 3);
+            checkHeapAgainstSet<kway_min_id_split_heap<int, float, 8>>(200, 5000, 4);
+            checkHeapAgainstSet<kway_min_id_split_heap<int, float, 16>>(200, 5000, 5);
+        }
+
+        WHEN("keys are scanned with scalar instructions") {
+            checkHeapAgainstSet<kway_min_id_split_heap<int, int32_t, 2>>(200, 5000, 6);
+            checkHeapAgainstSet<kway_min_id_split_heap<int, int32_t, 3>>(200, 5000, 7);
+            checkHeapAgainstSet<kway_min_id_split_heap<int, uint64_t, 8>>(200, 5000, 8);
+            checkHeapAgainstSet<kway_min_id_split_heap<int, double, 4>>(200, 5000, 9);
+        }
+    }
+
+    GIVEN("unsigned keys above 2^31") {
+        kway_min_id_split_heap<int, uint32_t, 4> heap{10};
+        for (int id=0; id<10; ++id) {
+            heap.pushOrDecrease(id, 0x80000000u + static_cast<uint32_t>((id * 7) % 10));
+        }
+        heap.pushOrDecrease(9, 5);
+
+        REQUIRE(heap.pop() == 9);
+        for (uint32_t expected=0; expected<9; ++expected) {
+            //the ids 0 to 8 have all different keys
+            REQUIRE(heap.peekKey() == 0x80000000u + expected + (expected >= 3 ? 1 : 0));
+            heap.pop();
+        }
+        REQUIRE(heap.isEmpty());
+    }
+}
+
+SCENARIO("test monotone heaps") {
+
+    GIVEN("random monotone operations") {
+        WHEN("using a radix heap") {
+            checkHeapAgainstSet<radix_min_id_heap<int, int>>(200, 5000, 1, 10);
+            checkHeapAgainstSet<radix_min_id_heap<int, unsigned long>>(200, 5000, 2, 1000);
+            checkHeapAgainstSet<radix_min_id_heap<int, uint8_t>>(200, 300, 3, 1);
+        }
+
+        WHEN("using a bucket queue") {
+            checkHeapAgainstSet<bucket_min_id_heap<int, int>>(200, 5000, 4, 10);
+            checkHeapAgainstSet<bucket_min_id_heap<int, long>>(200, 5000, 5, 1000);
+        }
+    }
+
+    GIVEN("random operations") {
+        WHEN("using a bucket queue") {
+            //keys are not monotone, so the buckets need to cover the whole range of the keys
+            checkHeapAgainstSet<bucket_min_id_heap<int, int>>(200, 5000, 6);
+        }
+    }
+
+    GIVEN("a bucket queue with few buckets") {
+        bucket_min_id_heap<long, long> heap{100, 3};
+        REQUIRE(heap.getBuckets() == 4);
+
+        WHEN("keys in the heap span more than the buckets") {
+            heap.pushOrDecrease(1L, 1000000L);
+            heap.pushOrDecrease(2L, 1000002L);
+            heap.pushOrDecrease(3L, 1000010L);
+            REQUIRE(heap.getBuckets() == 16);
+            heap.pushOrDecrease(4L, 999990L);
+            REQUIRE(heap.getBuckets() == 32);
+            REQUIRE(heap.pushOrDecrease(3L, 1000001L));
+            REQUIRE_FALSE(heap.pushOrDecrease(2L, 1000005L));
+
+            REQUIRE(heap.peekKey() == 999990L);
+            REQUIRE(heap.pop() == 4L);
+            REQUIRE(heap.pop() == 1L);
+            REQUIRE(heap.pop() == 3L);
+            REQUIRE(heap.get_key(2L) == 1000002L);
+            REQUIRE(heap.pop() == 2L);
+            REQUIRE(heap.isEmpty());
+
+            heap.pushOrDecrease(5L, 7L);
+            heap.cleanup();
+            REQUIRE(heap.isEmpty());
+            REQUIRE_FALSE(heap.contains(5L));
+        }
     }
 }
 
@@ -379,4 +736,99 @@ SCENARIO("test queue") {
         }
     }
 
-}
\ No newline at end of file
+}
+SCENARIO("test multiQueue") {
+
+    GIVEN("a multiqueue with a single heap") {
+        MultiQueue<int, int> q{1, 1};
+        int key;
+        int value;
+
+        REQUIRE(q.isEmpty());
+        REQUIRE(q.numberOfHeaps() == 1);
+        REQUIRE(!q.tryPop(0, key, value));
+
+        WHEN("used by a single thread") {
+            std::mt19937 generator{0};
+            std::uniform_int_distribution<int> keyDistribution{0, 1000};
+            std::multiset<int> expected{};
+            for (int i=0; i<1000; ++i) {
+                int pushed = keyDistribution(generator);
+                q.push(0, pushed, -pushed);
+                expected.insert(pushed);
+            }
+            //a single heap is an exact queue
+            while (q.tryPop(0, key, value)) {
+                REQUIRE(key == *expected.begin());
+                REQUIRE(value == -key);
+                expected.erase(expected.begin());
+            }
+            REQUIRE(expected.empty());
+            REQUIRE(q.isEmpty());
+        }
+    }
+
+    GIVEN("a multiqueue with several heaps") {
+        MultiQueue<uint32_t, int> q{4, 2, 1};
+        REQUIRE(q.numberOfHeaps() == 8);
+        REQUIRE(q.numberOfThreads() == 4);
+
+        WHEN("used by a single thread") {
+            for (int i=0; i<1000; ++i) {
+                q.push(i % 4, static_cast<uint32_t>(i), i);
+            }
+            std::vector<int> popped(1000, 0);
+            uint32_t key;
+            int value;
+            while (q.tryPop(0, key, value)) {
+                REQUIRE(key == static_cast<uint32_t>(value));
+                popped[value] += 1;
+            }
+            //pops are relaxed, yet nothing is lost
+            REQUIRE(std::all_of(popped.begin(), popped.end(), [](int count) { return count == 1; }));
+            REQUIRE(q.isEmpty());
+        }
+
+        WHEN("cleared") {
+            q.push(0, 5, 5);
+            q.push(1, 3, 3);
+            q.clear();
+            REQUIRE(q.isEmpty());
+        }
+
+        WHEN("used by several threads at once") {
+            const int perThread = 20000;
+            std::vector<std::atomic<int>> popped(4 * perThread);
+            for (auto& count : popped) {
+                count.store(0);
+            }
+            std::atomic<int> remaining{4 * perThread};
+            parallelForBlocks(0, 4, 4, [&](std::size_t threadId, std::size_t, std::size_t) {
+                uint32_t key;
+                int value;
+                for (int i=0; i<perThread; ++i) {
+                    int pushed = static_cast<int>(threadId) * perThread + i;
+                    q.push(threadId, static_cast<uint32_t>(i), pushed);
+                    //interleave pops with pushes
+                    if (i % 2 == 1 && q.tryPop(threadId, key, value)) {
+                        popped[value].fetch_add(1);
+                        remaining.fetch_sub(1);
+                    }
+                }
+                while (remaining.load() > 0) {
+                    if (q.tryPop(threadId, key, value)) {
+                        popped[value].fetch_add(1);
+                        remaining.fetch_sub(1);
+                    }
+                }
+            });
+            REQUIRE(std::all_of(popped.begin(), popped.end(), [](const std::atomic<int>& count) { return count.load() == 1; }));
+            REQUIRE(q.isEmpty());
+        }
+    }
+
+    GIVEN("invalid parameters") {
+        REQUIRE_THROWS(MultiQueue<int, int>{0, 2});
+        REQUIRE_THROWS(MultiQueue<int, int>{2, 0});
+    }
+}
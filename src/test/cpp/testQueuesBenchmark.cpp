@@ -0,0 +1,452 @@
+#include "catch.hpp"
+#include "BoostQueue.hpp"
+#include "IntrusiveQueue.hpp"
+#include "KHeaps.hpp"
+#include "MonotoneHeaps.hpp"
+#include "MultiQueue.hpp"
+#include "StaticPriorityQueue.hpp"
+#include "parallel.hpp"
+#include "profiling.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cpp_utils;
+
+// Benchmarks are hidden: run them with `./cpp-utilsTest [benchmark]` from a Release build
+
+/**
+ * @brief the random choices of a Dijkstra-like sequence of operations, generated before timing it
+ *
+ * The heap always contains the ids from 0 to @c size (excluded). Each step pops the minimum id, pushes it back with a
+ * larger key (as relaxing an edge of weight `weights[i]` would do) and, if `decreases[i]` is not 0, decreases the key of
+ * the id `decreaseIds[i]` by that much (but never below the last popped key). Hence keys are monotone, as in Dijkstra.
+ *
+ * @tparam KEY type of the keys
+ */
+template <typename KEY>
+struct HeapTrace {
+    int size;
+    std::vector<KEY> initialKeys;
+    std::vector<KEY> weights;
+    std::vector<int> decreaseIds;
+    std::vector<KEY> decreases;
+
+    HeapTrace(int size, int steps, unsigned int seed): size{size}, initialKeys{}, weights{}, decreaseIds{}, decreases{} {
+        std::mt19937 generator{seed};
+        std::uniform_int_distribution<int> keyDistribution{0, 1000};
+        std::uniform_int_distribution<int> weightDistribution{1, 100};
+        std::uniform_int_distribution<int> idDistribution{0, size - 1};
+        std::uniform_int_distribution<int> decreaseDistribution{0, 1};
+        for (int i=0; i<size; ++i) {
+            this->initialKeys.push_back(static_cast<KEY>(keyDistribution(generator)));
+        }
+        for (int i=0; i<steps; ++i) {
+            this->weights.push_back(static_cast<KEY>(weightDistribution(generator)));
+            this->decreaseIds.push_back(idDistribution(generator));
+            this->decreases.push_back(static_cast<KEY>(decreaseDistribution(generator) * weightDistribution(generator)));
+        }
+    }
+};
+
+/**
+ * @brief run a trace over a heap
+ *
+ * @return the sum of the popped keys, so that the work can't be optimized away
+ */
+template <typename HEAP, typename KEY>
+static double runHeapTrace(HEAP& heap, const HeapTrace<KEY>& trace) {
+    for (int id=0; id<trace.size; ++id) {
+        heap.pushOrDecrease(id, trace.initialKeys[id]);
+    }
+    double result = 0;
+    for (size_t i=0; i<trace.weights.size(); ++i) {
+        const KEY last = heap.peekKey();
+        const int id = heap.pop();
+        result += static_cast<double>(last);
+        heap.pushOrDecrease(id, last + trace.weights[i]);
+        if (trace.decreases[i] != 0) {
+            const KEY current = heap.get_key(trace.decreaseIds[i]);
+            if (current - last > trace.decreases[i]) {
+                heap.pushOrDecrease(trace.decreaseIds[i], current - trace.decreases[i]);
+            }
+        }
+    }
+    heap.cleanup();
+    return result;
+}
+
+/**
+ * @brief time a trace for each arity we care about
+ *
+ */
+template <typename KEY>
+static void benchmarkHeapArities(const std::string& keyName, int size, int steps) {
+    HeapTrace<KEY> trace{size, steps, 0};
+    timing_t times[4];
+    double checksums[4];
+
+    kway_min_id_heap<int, KEY, 2> heap2{static_cast<std::size_t>(size)};
+    PROFILE_TIME(times[0]) {
+        checksums[0] = runHeapTrace(heap2, trace);
+    }
+    kway_min_id_heap<int, KEY, 4> heap4{static_cast<std::size_t>(size)};
+    PROFILE_TIME(times[1]) {
+        checksums[1] = runHeapTrace(heap4, trace);
+    }
+    kway_min_id_heap<int, KEY, 8> heap8{static_cast<std::size_t>(size)};
+    PROFILE_TIME(times[2]) {
+        checksums[2] = runHeapTrace(heap8, trace);
+    }
+    kway_min_id_heap<int, KEY, 16> heap16{static_cast<std::size_t>(size)};
+    PROFILE_TIME(times[3]) {
+        checksums[3] = runHeapTrace(heap16, trace);
+    }
+
+    //ties may be broken differently, so the popped ids (and hence the checksums) may differ between arities
+    for (int i=0; i<4; ++i) {
+        REQUIRE(checksums[i] > 0);
+    }
+    critical(keyName, "keys, heap of", size, "ids,", steps, "steps: k=2", times[0], "k=4", times[1], "k=8", times[2], "k=16", times[3]);
+}
+
+SCENARIO("benchmark kway heap arity", "[.][benchmark]") {
+
+    GIVEN("Dijkstra-like traces") {
+        const int steps = 1000000;
+        for (int size : std::vector<int>{1000, 100000, 1000000}) {
+            benchmarkHeapArities<uint32_t>("uint32_t", size, steps);
+            benchmarkHeapArities<uint64_t>("uint64_t", size, steps);
+            benchmarkHeapArities<float>("float", size, steps);
+            benchmarkHeapArities<double>("double", size, steps);
+        }
+    }
+}
+
+/**
+ * @brief time a trace, then filling the heap and popping everything, then filling it and decreasing random keys
+ *
+ */
+template <typename HEAP, typename KEY>
+static void benchmarkHeapLayout(const std::string& name, const HeapTrace<KEY>& trace) {
+    HEAP heap{static_cast<std::size_t>(trace.size)};
+    timing_t traceTime;
+    double checksum = 0;
+    PROFILE_TIME(traceTime) {
+        checksum += runHeapTrace(heap, trace);
+    }
+
+    timing_t popTime;
+    for (int id=0; id<trace.size; ++id) {
+        heap.pushOrDecrease(id, trace.initialKeys[id]);
+    }
+    PROFILE_TIME(popTime) {
+        while (!heap.isEmpty()) {
+            checksum += heap.pop();
+        }
+    }
+
+    timing_t decreaseTime;
+    //ensure every key can be decreased by the whole trace
+    const KEY offset = static_cast<KEY>(200 * trace.weights.size());
+    for (int id=0; id<trace.size; ++id) {
+        heap.pushOrDecrease(id, trace.initialKeys[id] + offset);
+    }
+    PROFILE_TIME(decreaseTime) {
+        for (size_t i=0; i<trace.weights.size(); ++i) {
+            heap.pushOrDecrease(trace.decreaseIds[i], heap.get_key(trace.decreaseIds[i]) - trace.weights[i]);
+        }
+    }
+    checksum += heap.peekKey();
+    heap.cleanup();
+
+    REQUIRE(checksum > 0);
+    critical(name, ": trace", traceTime, "; popping", trace.size, "ids", popTime, ";", trace.weights.size(), "decreases", decreaseTime);
+}
+
+template <typename KEY>
+static void benchmarkHeapLayouts(const std::string& keyName, int size, int steps) {
+    HeapTrace<KEY> trace{size, steps, 0};
+    critical(keyName, "keys, heap of", size, "ids,", steps, "steps");
+    benchmarkHeapLayout<kway_min_id_heap<int, KEY, 4>>("  interleaved k=4 ", trace);
+    benchmarkHeapLayout<kway_min_id_split_heap<int, KEY, 4>>("  split k=4       ", trace);
+    benchmarkHeapLayout<kway_min_id_heap<int, KEY, 8>>("  interleaved k=8 ", trace);
+    benchmarkHeapLayout<kway_min_id_split_heap<int, KEY, 8>>("  split k=8       ", trace);
+    benchmarkHeapLayout<kway_min_id_heap<int, KEY, 16>>("  interleaved k=16", trace);
+    benchmarkHeapLayout<kway_min_id_split_heap<int, KEY, 16>>("  split k=16      ", trace);
+}
+
+SCENARIO("benchmark kway heap layout", "[.][benchmark]") {
+
+    GIVEN("Dijkstra-like traces") {
+        const int steps = 1000000;
+        for (int size : std::vector<int>{1000, 100000, 1000000}) {
+            benchmarkHeapLayouts<int32_t>("int32_t", size, steps);
+            benchmarkHeapLayouts<uint32_t>("uint32_t", size, steps);
+            benchmarkHeapLayouts<float>("float", size, steps);
+            benchmarkHeapLayouts<uint64_t>("uint64_t", size, steps);
+        }
+    }
+}
+
+SCENARIO("benchmark monotone heaps", "[.][benchmark]") {
+
+    GIVEN("Dijkstra-like traces") {
+        const int steps = 1000000;
+        for (int size : std::vector<int>{1000, 100000, 1000000}) {
+            HeapTrace<uint32_t> trace{size, steps, 0};
+            std::vector<timing_t> times(4);
+            std::vector<double> checksums(4);
+
+            kway_min_id_heap<int, uint32_t, 4> kway{static_cast<std::size_t>(size)};
+            PROFILE_TIME(times[0]) {
+                checksums[0] = runHeapTrace(kway, trace);
+            }
+            kway_min_id_split_heap<int, uint32_t, 8> split{static_cast<std::size_t>(size)};
+            PROFILE_TIME(times[1]) {
+                checksums[1] = runHeapTrace(split, trace);
+            }
+            radix_min_id_heap<int, uint32_t> radix{static_cast<std::size_t>(size)};
+            PROFILE_TIME(times[2]) {
+                checksums[2] = runHeapTrace(radix, trace);
+            }
+            //the initial keys span 1000
+            bucket_min_id_heap<int, uint32_t> bucket{static_cast<std::size_t>(size), 1000};
+            PROFILE_TIME(times[3]) {
+                checksums[3] = runHeapTrace(bucket, trace);
+            }
+
+            for (int i=0; i<4; ++i) {
+                REQUIRE(checksums[i] > 0);
+            }
+            critical("heap of", size, "ids,", steps, "steps: kway k=4", times[0], "split k=8", times[1], "radix", times[2], "bucket", times[3]);
+        }
+    }
+}
+
+/**
+ * @brief an item of the queues implementing IQueue, as a search node would be
+ *
+ */
+struct QueueItem: public HasPriority<priority_t> {
+    uint32_t key;
+    priority_t position;
+
+    QueueItem(): key{0}, position{0} {
+
+    }
+    friend bool operator < (const QueueItem& a, const QueueItem& b) {
+        return a.key < b.key;
+    }
+    friend bool operator == (const QueueItem& a, const QueueItem& b) {
+        return &a == &b;
+    }
+    friend std::ostream& operator <<(std::ostream& ss, const QueueItem& item) {
+        ss << item.key;
+        return ss;
+    }
+    priority_t getPriority(const void* q) const {
+        return this->position;
+    }
+    void setPriority(const void* q, priority_t p) {
+        this->position = p;
+    }
+};
+
+/**
+ * @brief run a trace over a queue of items, as ::runHeapTrace does over an id heap
+ *
+ * @return the sum of the popped keys
+ */
+template <typename QUEUE>
+static double runQueueTrace(QUEUE& queue, std::vector<QueueItem>& items, const HeapTrace<uint32_t>& trace) {
+    for (int id=0; id<trace.size; ++id) {
+        items[id].key = trace.initialKeys[id];
+        queue.push(items[id]);
+    }
+    double result = 0;
+    for (size_t i=0; i<trace.weights.size(); ++i) {
+        QueueItem& item = queue.pop();
+        const uint32_t last = item.key;
+        result += static_cast<double>(last);
+        item.key = last + trace.weights[i];
+        queue.push(item);
+        if (trace.decreases[i] != 0) {
+            QueueItem& other = items[trace.decreaseIds[i]];
+            if (other.key - last > trace.decreases[i]) {
+                other.key -= trace.decreases[i];
+                queue.decrease_key(other);
+            }
+        }
+    }
+    queue.cleanup();
+    return result;
+}
+
+SCENARIO("benchmark item queues", "[.][benchmark]") {
+
+    GIVEN("Dijkstra-like traces") {
+        const int steps = 1000000;
+        for (int size : std::vector<int>{1000, 100000, 1000000}) {
+            HeapTrace<uint32_t> trace{size, steps, 0};
+            std::vector<QueueItem> items(size);
+            std::vector<timing_t> times(4);
+            std::vector<double> checksums(4);
+
+            BoostQueue<QueueItem> boostQueue{};
+            PROFILE_TIME(times[0]) {
+                checksums[0] = runQueueTrace(boostQueue, items, trace);
+            }
+            StaticPriorityQueue<QueueItem> staticQueue{static_cast<size_t>(size), true};
+            PROFILE_TIME(times[1]) {
+                checksums[1] = runQueueTrace(staticQueue, items, trace);
+            }
+            IntrusiveQueue<QueueItem, std::less<QueueItem>, 2> intrusive2{static_cast<size_t>(size)};
+            PROFILE_TIME(times[2]) {
+                checksums[2] = runQueueTrace(intrusive2, items, trace);
+            }
+            IntrusiveQueue<QueueItem> intrusive4{static_cast<size_t>(size)};
+            PROFILE_TIME(times[3]) {
+                checksums[3] = runQueueTrace(intrusive4, items, trace);
+            }
+
+            for (int i=0; i<4; ++i) {
+                REQUIRE(checksums[i] > 0);
+            }
+            critical("queue of", size, "items,", steps, "steps: BoostQueue", times[0], "StaticPriorityQueue", times[1], "IntrusiveQueue k=2", times[2], "IntrusiveQueue k=4", times[3]);
+            critical("  popped key sums:", checksums[0], checksums[1], checksums[2], checksums[3]);
+        }
+    }
+}
+
+/**
+ * @brief a single heap behind a mutex: the simplest thread safe queue, as a reference for MultiQueue
+ *
+ */
+class MutexQueue {
+private:
+    std::mutex mutex;
+    internal::KaryPairHeap<uint32_t, int, 4> heap;
+public:
+    MutexQueue(): mutex{}, heap{} {
+
+    }
+    void push(std::size_t threadId, uint32_t key, int value) {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        this->heap.push(key, value);
+    }
+    bool tryPop(std::size_t threadId, uint32_t& key, int& value) {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        if (this->heap.isEmpty()) {
+            return false;
+        }
+        std::tie(key, value) = this->heap.pop();
+        return true;
+    }
+};
+
+/**
+ * @brief fill a concurrent queue and let some threads pop a pair and push it back with a larger key, as in a search
+ *
+ * @return the time taken by the threads
+ */
+template <typename QUEUE>
+static timing_t runConcurrentTrace(QUEUE& queue, std::size_t threads, const HeapTrace<uint32_t>& trace) {
+    for (int id=0; id<trace.size; ++id) {
+        queue.push(id % threads, trace.initialKeys[id], id);
+    }
+    timing_t result;
+    PROFILE_TIME(result) {
+        parallelForBlocks(0, trace.weights.size(), threads, [&](std::size_t threadId, std::size_t begin, std::size_t end) {
+            uint32_t key;
+            int value;
+            for (std::size_t i=begin; i<end; ++i) {
+                if (queue.tryPop(threadId, key, value)) {
+                    queue.push(threadId, key + trace.weights[i], value);
+                }
+            }
+        });
+    }
+    return result;
+}
+
+SCENARIO("benchmark multiqueue scaling", "[.][benchmark]") {
+
+    GIVEN("Dijkstra-like traces") {
+        const int steps = 4000000;
+        std::vector<std::size_t> threadCounts{};
+        for (std::size_t threads=1; threads<getDefaultNumberOfThreads(); threads *= 2) {
+            threadCounts.push_back(threads);
+        }
+        threadCounts.push_back(getDefaultNumberOfThreads());
+
+        for (int size : std::vector<int>{1000, 1000000}) {
+            HeapTrace<uint32_t> trace{size, steps, 0};
+            for (auto threads : threadCounts) {
+                MutexQueue mutexQueue{};
+                timing_t mutexTime = runConcurrentTrace(mutexQueue, threads, trace);
+                MultiQueue<uint32_t, int> multiQueue{threads, 2};
+                timing_t multiTime = runConcurrentTrace(multiQueue, threads, trace);
+                critical(size, "pairs,", steps, "pops and pushes with", threads, "threads: single heap with a mutex", mutexTime, "MultiQueue c=2", multiTime);
+            }
+        }
+    }
+}
+
+SCENARIO("benchmark multiqueue rank error", "[.][benchmark]") {
+
+    GIVEN("Dijkstra-like traces") {
+        //pops are done by a single thread posing as each thread in turn: the rank of a popped key is exact, but it
+        //ignores the errors coming from threads reading the minima of heaps being changed
+        const int size = 100000;
+        const int steps = 1000000;
+        HeapTrace<uint32_t> trace{size, steps, 0};
+        //number of keys in the queue, as a Fenwick tree indexed by key
+        const std::size_t maxKey = 1 << 20;
+        std::vector<int> counts(maxKey + 1);
+        auto add = [&](uint32_t key, int delta) {
+            for (std::size_t i=key + 1; i<=maxKey; i += i & (~i + 1)) {
+                counts[i] += delta;
+            }
+        };
+        auto countSmaller = [&](uint32_t key) {
+            long result = 0;
+            for (std::size_t i=key; i>0; i -= i & (~i + 1)) {
+                result += counts[i];
+            }
+            return result;
+        };
+
+        for (std::size_t threads : std::vector<std::size_t>{1, 2, 4, 8, 16, 32, 64}) {
+            for (std::size_t queuesPerThread : std::vector<std::size_t>{1, 2, 4}) {
+                std::fill(counts.begin(), counts.end(), 0);
+                MultiQueue<uint32_t, int> queue{threads, queuesPerThread};
+                for (int id=0; id<size; ++id) {
+                    queue.push(id % threads, trace.initialKeys[id], id);
+                    add(trace.initialKeys[id], 1);
+                }
+                double rankSum = 0;
+                long maxRank = 0;
+                for (int i=0; i<steps; ++i) {
+                    uint32_t key;
+                    int value;
+                    REQUIRE(queue.tryPop(i % threads, key, value));
+                    long rank = countSmaller(key);
+                    rankSum += rank;
+                    maxRank = std::max(maxRank, rank);
+                    add(key, -1);
+                    const uint32_t pushed = key + trace.weights[i];
+                    REQUIRE(pushed < maxKey);
+                    queue.push(i % threads, pushed, value);
+                    add(pushed, 1);
+                }
+                critical(threads, "threads, c=", queuesPerThread, "(", queue.numberOfHeaps(), "heaps): mean rank error", rankSum / steps, "max rank error", maxRank);
+            }
+        }
+    }
+}
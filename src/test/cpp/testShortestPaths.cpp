@@ -0,0 +1,803 @@
+#include "catch.hpp"
+#include "igraph.hpp"
+#include "adjacentGraph.hpp"
+#include "listGraph.hpp"
+#include "compactAdjacentGraph.hpp"
+#include "dijkstra.hpp"
+#include "contractionHierarchy.hpp"
+#include "distanceTable.hpp"
+#include "firstMoveDatabase.hpp"
+#include "landmarks.hpp"
+#include "partitioning.hpp"
+#include "MonotoneHeaps.hpp"
+#include "graphGenerators.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace cpp_utils;
+using namespace cpp_utils::graphs;
+
+/**
+ * @brief distances from a vertex computed with the plainest Dijkstra possible
+ */
+static std::vector<long> getReferenceDistances(const IImmutableGraph<int, int, int>& g, nodeid_t start) {
+    std::vector<long> result(g.numberOfVertices(), std::numeric_limits<long>::max());
+    using item_t = std::pair<long, nodeid_t>;
+    std::priority_queue<item_t, std::vector<item_t>, std::greater<item_t>> queue{};
+    result[start] = 0;
+    queue.push(item_t{0, start});
+    while (!queue.empty()) {
+        auto item = queue.top();
+        queue.pop();
+        if (item.first > result[item.second]) {
+            continue;
+        }
+        for (auto& outEdge : g.getOutEdges(item.second)) {
+            long distance = item.first + outEdge.getPayload();
+            if (distance < result[outEdge.getSinkId()]) {
+                result[outEdge.getSinkId()] = distance;
+                queue.push(item_t{distance, outEdge.getSinkId()});
+            }
+        }
+    }
+    return result;
+}
+
+SCENARIO("test dijkstra") {
+
+    GIVEN("a grid") {
+        const int width = 12;
+        AdjacentGraph<int, int, int> grid = buildGridGraph(width, 9);
+        DijkstraSearch<AdjacentGraph<int, int, int>, long> dijkstra{grid};
+
+        WHEN("searching from a vertex to every other one") {
+            for (nodeid_t start : std::vector<nodeid_t>{0, 17, 107}) {
+                auto expected = getReferenceDistances(grid, start);
+                dijkstra.searchAll(start);
+                REQUIRE(dijkstra.getExpandedVertices() == grid.numberOfVertices());
+                for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                    REQUIRE(dijkstra.isExpanded(id));
+                    REQUIRE(dijkstra.getDistance(id) == expected[id]);
+                }
+            }
+        }
+
+        WHEN("searching a single target") {
+            auto expected = getReferenceDistances(grid, 5);
+            for (nodeid_t goal=0; goal<grid.numberOfVertices(); ++goal) {
+                REQUIRE(dijkstra.search(5, goal) == expected[goal]);
+
+                //the path is made of edges and its cost is the distance
+                auto path = dijkstra.getPath(goal);
+                REQUIRE(path.front() == 5);
+                REQUIRE(path.back() == goal);
+                long cost = 0;
+                for (size_t i=1; i<path.size(); ++i) {
+                    cost += grid.getEdge(path[i - 1], path[i]);
+                }
+                REQUIRE(cost == expected[goal]);
+            }
+            REQUIRE(dijkstra.search(7, 7) == 0);
+            REQUIRE(dijkstra.getPath(7) == std::vector<nodeid_t>{7});
+            REQUIRE(dijkstra.getExpandedVertices() == 1);
+        }
+
+        WHEN("searching with A*") {
+            auto manhattan = [&](nodeid_t id, nodeid_t goal) {
+                //each edge costs at least 1
+                return static_cast<long>(std::abs(static_cast<int>(id % width) - static_cast<int>(goal % width)) + std::abs(static_cast<int>(id / width) - static_cast<int>(goal / width)));
+            };
+            DijkstraSearch<AdjacentGraph<int, int, int>, long, decltype(manhattan)> astar{grid, manhattan};
+            for (nodeid_t goal=0; goal<grid.numberOfVertices(); goal+=7) {
+                REQUIRE(astar.search(3, goal) == dijkstra.search(3, goal));
+                REQUIRE(astar.getExpandedVertices() <= dijkstra.getExpandedVertices());
+            }
+        }
+
+        WHEN("searching several targets") {
+            auto expected = getReferenceDistances(grid, 30);
+            std::vector<nodeid_t> goals{31, 2, 30, 2, 100};
+            auto distances = dijkstra.search(30, goals);
+            REQUIRE(distances.size() == goals.size());
+            for (size_t i=0; i<goals.size(); ++i) {
+                REQUIRE(distances[i] == expected[goals[i]]);
+            }
+            //the search stops once the farthest goal has been expanded
+            REQUIRE(dijkstra.getExpandedVertices() < grid.numberOfVertices());
+        }
+
+        WHEN("interrupting the search") {
+            dijkstra.searchUntil(0, [&](nodeid_t id, long distance) { return distance >= 10; });
+            auto expected = getReferenceDistances(grid, 0);
+            for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                if (expected[id] < 10) {
+                    REQUIRE(dijkstra.isExpanded(id));
+                    REQUIRE(dijkstra.getDistance(id) == expected[id]);
+                }
+                if (expected[id] > 10) {
+                    REQUIRE_FALSE(dijkstra.isExpanded(id));
+                }
+            }
+
+            //a new query forgets the old one
+            dijkstra.searchUntil(grid.numberOfVertices() - 1, [&](nodeid_t id, long distance) { return true; });
+            REQUIRE(dijkstra.getExpandedVertices() == 1);
+            REQUIRE(dijkstra.getDistance(0) == (DijkstraSearch<AdjacentGraph<int, int, int>, long>::INFINITE_COST));
+            REQUIRE_FALSE(dijkstra.isExpanded(0));
+            REQUIRE_THROWS(dijkstra.getParent(0));
+        }
+
+        WHEN("searching other kinds of graph") {
+            CompactAdjacentGraph<int, int, int> compact{grid};
+            DijkstraSearch<CompactAdjacentGraph<int, int, int>, long> compactDijkstra{compact};
+            const IImmutableGraph<int, int, int>& igrid = grid;
+            DijkstraSearch<IImmutableGraph<int, int, int>, long> virtualDijkstra{igrid};
+            for (nodeid_t goal=0; goal<grid.numberOfVertices(); goal+=5) {
+                long expected = dijkstra.search(1, goal);
+                REQUIRE(compactDijkstra.search(1, goal) == expected);
+                REQUIRE(virtualDijkstra.search(1, goal) == expected);
+            }
+        }
+
+        WHEN("using heaps for monotone integer keys") {
+            DijkstraSearch<AdjacentGraph<int, int, int>, long, ZeroHeuristic<long>, radix_min_id_heap<nodeid_t, long>> radixDijkstra{grid};
+            DijkstraSearch<AdjacentGraph<int, int, int>, long, ZeroHeuristic<long>, bucket_min_id_heap<nodeid_t, long>> bucketDijkstra{grid};
+            for (nodeid_t start : std::vector<nodeid_t>{0, 17, 107}) {
+                auto expected = getReferenceDistances(grid, start);
+                radixDijkstra.searchAll(start);
+                bucketDijkstra.searchAll(start);
+                for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                    REQUIRE(radixDijkstra.getDistance(id) == expected[id]);
+                    REQUIRE(bucketDijkstra.getDistance(id) == expected[id]);
+                }
+            }
+            for (nodeid_t goal=0; goal<grid.numberOfVertices(); goal+=5) {
+                long expected = dijkstra.search(1, goal);
+                REQUIRE(radixDijkstra.search(1, goal) == expected);
+                REQUIRE(bucketDijkstra.search(1, goal) == expected);
+            }
+        }
+    }
+
+    GIVEN("a graph with unreachable vertices") {
+        AdjacentGraph<int, int, int> g = buildUnreachableGraph();
+        DijkstraSearch<AdjacentGraph<int, int, int>, int> dijkstra{g};
+
+        REQUIRE(dijkstra.search(0, 1) == 2);
+        REQUIRE(dijkstra.getPath(1) == std::vector<nodeid_t>{0, 2, 1});
+        REQUIRE(dijkstra.search(0, 3) == (DijkstraSearch<AdjacentGraph<int, int, int>, int>::INFINITE_COST));
+        REQUIRE(dijkstra.getExpandedVertices() == 3);
+        REQUIRE(dijkstra.search(0, std::vector<nodeid_t>{3, 1}) == std::vector<int>{std::numeric_limits<int>::max(), 2});
+    }
+}
+
+/**
+ * @brief check that @c path is a path of @c g from @c start to @c goal costing @c expected
+ */
+static void checkPath(const AdjacentGraph<int, int, int>& g, const std::vector<nodeid_t>& path, nodeid_t start, nodeid_t goal, long expected) {
+    REQUIRE(path.front() == start);
+    REQUIRE(path.back() == goal);
+    long cost = 0;
+    for (size_t i=1; i<path.size(); ++i) {
+        //the lightest among the parallel edges
+        long weight = std::numeric_limits<long>::max();
+        for (auto& outEdge : g.getOutEdges(path[i - 1])) {
+            if (outEdge.getSinkId() == path[i]) {
+                weight = std::min<long>(weight, outEdge.getPayload());
+            }
+        }
+        REQUIRE(weight != std::numeric_limits<long>::max());
+        cost += weight;
+    }
+    REQUIRE(cost == expected);
+}
+
+SCENARIO("test contraction hierarchy") {
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(9, 7);
+        ContractionHierarchy<int> ch{grid};
+        ContractionHierarchySearch<int> search{ch};
+
+        REQUIRE(ch.numberOfVertices() == grid.numberOfVertices());
+        REQUIRE(ch.numberOfEdges() >= grid.numberOfEdges());
+        REQUIRE(ch.numberOfEdges() <= grid.numberOfEdges() + ch.numberOfShortcuts());
+
+        WHEN("inspecting the hierarchy") {
+            for (nodeid_t id=0; id<ch.numberOfVertices(); ++id) {
+                for (auto& edge : ch.getUpwardEdges(id)) {
+                    REQUIRE(ch.getRank(edge.other) > ch.getRank(id));
+                }
+                for (auto& edge : ch.getDownwardEdges(id)) {
+                    REQUIRE(ch.getRank(edge.other) > ch.getRank(id));
+                }
+            }
+        }
+
+        WHEN("querying every pair of vertices") {
+            for (nodeid_t start=0; start<grid.numberOfVertices(); ++start) {
+                auto expected = getReferenceDistances(grid, start);
+                for (nodeid_t goal=0; goal<grid.numberOfVertices(); ++goal) {
+                    REQUIRE(search.search(start, goal) == expected[goal]);
+                    checkPath(grid, search.getPath(), start, goal, expected[goal]);
+                }
+            }
+        }
+
+        WHEN("saving and loading") {
+            const char* filename = "./ch.dat";
+            FILE* f = fopen(filename, "wb");
+            cpp_utils::serializers::saveToFile(f, ch);
+            fclose(f);
+
+            ContractionHierarchy<int> ch2{};
+            f = fopen(filename, "rb");
+            cpp_utils::serializers::loadFromFile(f, ch2);
+            fclose(f);
+            std::remove(filename);
+
+            REQUIRE(ch2.numberOfVertices() == ch.numberOfVertices());
+            REQUIRE(ch2.numberOfEdges() == ch.numberOfEdges());
+            ContractionHierarchySearch<int> search2{ch2};
+            for (nodeid_t goal=0; goal<grid.numberOfVertices(); ++goal) {
+                REQUIRE(search2.search(4, goal) == search.search(4, goal));
+                REQUIRE(search2.getPath() == search.getPath());
+            }
+        }
+    }
+
+    GIVEN("a random directed graph") {
+        //parallel edges, self loops and vertices with no edges at all
+        std::mt19937 generator{0};
+        const int vertices = 80;
+        std::uniform_int_distribution<int> vertexDistribution{0, vertices - 1};
+        std::uniform_int_distribution<int> weightDistribution{0, 20};
+        std::vector<std::tuple<int, int, int>> edges{};
+        for (int i=0; i<200; ++i) {
+            edges.emplace_back(vertexDistribution(generator), vertexDistribution(generator), weightDistribution(generator));
+        }
+        std::sort(edges.begin(), edges.end());
+        AdjacentGraph<int, int, int> g{0};
+        for (int id=0; id<vertices; ++id) {
+            g.addVertex(id);
+        }
+        for (auto& edge : edges) {
+            g.addEdgeTail(std::get<0>(edge), std::get<1>(edge), std::get<2>(edge));
+        }
+        g.finalizeGraph();
+
+        ContractionHierarchy<int> ch{g};
+        ContractionHierarchySearch<int> search{ch};
+        for (nodeid_t start=0; start<g.numberOfVertices(); ++start) {
+            auto expected = getReferenceDistances(g, start);
+            for (nodeid_t goal=0; goal<g.numberOfVertices(); ++goal) {
+                if (expected[goal] == std::numeric_limits<long>::max()) {
+                    REQUIRE(search.search(start, goal) == ContractionHierarchySearch<int>::INFINITE_COST);
+                    REQUIRE_THROWS(search.getPath());
+                } else {
+                    REQUIRE(search.search(start, goal) == expected[goal]);
+                    checkPath(g, search.getPath(), start, goal, expected[goal]);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("test distance table") {
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(10, 8);
+        std::vector<nodeid_t> sources{0, 79, 33, 33, 12, 41, 5};
+        std::vector<nodeid_t> targets{1, 79, 40, 0, 66};
+
+        WHEN("computing a many to many table") {
+            for (size_t threads : std::vector<size_t>{1, 3, 0}) {
+                auto table = computeDistanceTable<AdjacentGraph<int, int, int>, long>(grid, sources, targets, threads);
+                REQUIRE(table.numberOfRows() == sources.size());
+                REQUIRE(table.numberOfColumns() == targets.size());
+                REQUIRE(table.getData().size() == sources.size() * targets.size());
+                for (size_t i=0; i<sources.size(); ++i) {
+                    auto expected = getReferenceDistances(grid, sources[i]);
+                    for (size_t j=0; j<targets.size(); ++j) {
+                        REQUIRE(table.get(i, j) == expected[targets[j]]);
+                        REQUIRE(table.getRow(i)[j] == expected[targets[j]]);
+                    }
+                }
+            }
+        }
+
+        WHEN("there are no sources or targets") {
+            auto noSources = computeDistanceTable<AdjacentGraph<int, int, int>, long>(grid, std::vector<nodeid_t>{}, targets, 2);
+            REQUIRE(noSources.numberOfRows() == 0);
+            auto noTargets = computeDistanceTable<AdjacentGraph<int, int, int>, long>(grid, sources, std::vector<nodeid_t>{}, 2);
+            REQUIRE(noTargets.numberOfRows() == sources.size());
+            REQUIRE(noTargets.getData().empty());
+        }
+    }
+
+    GIVEN("a graph with unreachable vertices") {
+        AdjacentGraph<int, int, int> g = buildUnreachableGraph();
+
+        auto table = computeAllPairsDistances<AdjacentGraph<int, int, int>, int>(g, 2);
+        const int inf = std::numeric_limits<int>::max();
+        REQUIRE(table.getData() == std::vector<int>{
+            0, 2, 1, inf, inf,
+            inf, 0, inf, inf, inf,
+            inf, 1, 0, inf, inf,
+            1, 3, 2, 0, inf,
+            inf, inf, inf, inf, 0
+        });
+    }
+}
+
+SCENARIO("test first move database") {
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(8, 6);
+        FirstMoveDatabase db{grid, 3};
+
+        REQUIRE(db.numberOfVertices() == grid.numberOfVertices());
+        REQUIRE_FALSE(db.isMapped());
+        //the tables are compressed
+        REQUIRE(db.numberOfRuns() < grid.numberOfVertices() * grid.numberOfVertices() / 2);
+
+        WHEN("extracting paths") {
+            for (nodeid_t start=0; start<grid.numberOfVertices(); ++start) {
+                auto expected = getReferenceDistances(grid, start);
+                REQUIRE(db.getFirstMove(start, start) == FirstMoveDatabase::NO_MOVE);
+                for (nodeid_t goal=0; goal<grid.numberOfVertices(); ++goal) {
+                    checkPath(grid, db.getPath(grid, start, goal), start, goal, expected[goal]);
+                }
+            }
+        }
+
+        WHEN("building the database with a different number of threads") {
+            FirstMoveDatabase serial{grid, 1};
+            REQUIRE(serial.numberOfRuns() == db.numberOfRuns());
+            for (nodeid_t start=0; start<grid.numberOfVertices(); ++start) {
+                for (nodeid_t goal=0; goal<grid.numberOfVertices(); ++goal) {
+                    REQUIRE(serial.getFirstMove(start, goal) == db.getFirstMove(start, goal));
+                }
+            }
+        }
+
+        WHEN("mapping the database from a file") {
+            boost::filesystem::path p{"./cpd.dat"};
+            FILE* f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, db);
+            fclose(f);
+
+            FirstMoveDatabase mapped{p};
+            REQUIRE(mapped.isMapped());
+            REQUIRE(mapped.numberOfVertices() == db.numberOfVertices());
+            REQUIRE(mapped.numberOfRuns() == db.numberOfRuns());
+            for (nodeid_t start=0; start<grid.numberOfVertices(); ++start) {
+                for (nodeid_t goal=0; goal<grid.numberOfVertices(); ++goal) {
+                    REQUIRE(mapped.getFirstMove(start, goal) == db.getFirstMove(start, goal));
+                }
+            }
+            REQUIRE(mapped.getPath(grid, 0, 47) == db.getPath(grid, 0, 47));
+
+            //a moved database still works
+            FirstMoveDatabase moved{std::move(mapped)};
+            REQUIRE(moved.getPath(grid, 47, 0) == db.getPath(grid, 47, 0));
+            boost::filesystem::remove(p);
+        }
+
+        WHEN("mapping a corrupted database") {
+            boost::filesystem::path p{"./badcpd.dat"};
+            FILE* f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, db);
+            fclose(f);
+            const auto size = boost::filesystem::file_size(p);
+            graphs::internal::MappedFirstMoveDatabaseHeader header;
+            f = fopen(p.native().c_str(), "rb");
+            REQUIRE(fread(&header, sizeof(header), 1, f) == 1);
+            fclose(f);
+
+            auto corrupt = [&](uint64_t position, uint64_t value) {
+                f = fopen(p.native().c_str(), "r+b");
+                fseek(f, position, SEEK_SET);
+                fwrite(&value, sizeof(value), 1, f);
+                fclose(f);
+            };
+
+            //each section out of the file
+            for (uint64_t position : std::vector<uint64_t>{offsetof(graphs::internal::MappedFirstMoveDatabaseHeader, orderOffset), offsetof(graphs::internal::MappedFirstMoveDatabaseHeader, runsBeginOffset), offsetof(graphs::internal::MappedFirstMoveDatabaseHeader, runStartsOffset)}) {
+                uint64_t original;
+                std::memcpy(&original, reinterpret_cast<const char*>(&header) + position, sizeof(original));
+                corrupt(position, size - 4);
+                REQUIRE_THROWS_AS(FirstMoveDatabase{p}, cpp_utils::exceptions::AbstractException);
+                corrupt(position, std::numeric_limits<uint64_t>::max() - 7);
+                REQUIRE_THROWS_AS(FirstMoveDatabase{p}, cpp_utils::exceptions::AbstractException);
+                corrupt(position, original);
+                REQUIRE_NOTHROW(FirstMoveDatabase{p});
+            }
+
+            //runs of a vertex beyond the runs
+            corrupt(header.runsBeginOffset + sizeof(uint64_t) * 5, header.numberOfRuns + 10);
+            REQUIRE_THROWS_AS(FirstMoveDatabase{p}, cpp_utils::exceptions::AbstractException);
+            //a vertex without runs
+            corrupt(header.runsBeginOffset + sizeof(uint64_t) * 5, 0);
+            REQUIRE_THROWS_AS(FirstMoveDatabase{p}, cpp_utils::exceptions::AbstractException);
+            boost::filesystem::remove(p);
+        }
+
+        WHEN("mapping something else") {
+            boost::filesystem::path p{"./notcpd.dat"};
+            FILE* f = fopen(p.native().c_str(), "wb");
+            cpp_utils::serializers::saveToMappableFile(f, grid);
+            fclose(f);
+            REQUIRE_THROWS(FirstMoveDatabase{p});
+            boost::filesystem::remove(p);
+        }
+    }
+
+    GIVEN("a graph with unreachable vertices and parallel edges") {
+        AdjacentGraph<int, int, int> g = buildUnreachableGraph();
+        FirstMoveDatabase db{g};
+
+        REQUIRE(db.getFirstMove(0, 1) == 2);
+        REQUIRE(db.getFirstMove(0, 2) == 2);
+        REQUIRE(db.getPath(g, 3, 1) == std::vector<nodeid_t>{3, 0, 2, 1});
+        REQUIRE(db.getFirstMove(0, 3) == FirstMoveDatabase::NO_MOVE);
+        REQUIRE(db.getFirstMove(4, 0) == FirstMoveDatabase::NO_MOVE);
+        REQUIRE(db.getPath(g, 0, 3).empty());
+        REQUIRE(db.getPath(g, 1, 1) == std::vector<nodeid_t>{1});
+    }
+}
+
+SCENARIO("test landmarks") {
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(10, 8);
+        std::vector<std::vector<long>> expected{};
+        for (nodeid_t start=0; start<grid.numberOfVertices(); ++start) {
+            expected.push_back(getReferenceDistances(grid, start));
+        }
+
+        for (auto selection : std::vector<LandmarkSelection>{LandmarkSelection::FARTHEST, LandmarkSelection::AVOID}) {
+            Landmarks<long> landmarks{grid, 4, selection, 2};
+            REQUIRE(landmarks.numberOfLandmarks() == 4);
+
+            WHEN("computing the lower bounds") {
+                for (size_t i=0; i<landmarks.numberOfLandmarks(); ++i) {
+                    nodeid_t landmark = landmarks.getLandmarks()[i];
+                    for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+                        REQUIRE(landmarks.getDistanceFromLandmark(i, id) == expected[landmark][id]);
+                        REQUIRE(landmarks.getDistanceToLandmark(i, id) == expected[id][landmark]);
+                    }
+                }
+                for (nodeid_t start=0; start<grid.numberOfVertices(); ++start) {
+                    for (nodeid_t goal=0; goal<grid.numberOfVertices(); ++goal) {
+                        REQUIRE(landmarks.getLowerBound(start, goal) >= 0);
+                        REQUIRE(landmarks.getLowerBound(start, goal) <= expected[start][goal]);
+                    }
+                    REQUIRE(landmarks.getLowerBound(start, start) == 0);
+                }
+            }
+
+            WHEN("using the landmarks as an A* heuristic") {
+                DijkstraSearch<AdjacentGraph<int, int, int>, long> dijkstra{grid};
+                DijkstraSearch<AdjacentGraph<int, int, int>, long, LandmarkHeuristic<long>> astar{grid, landmarks.getHeuristic()};
+                size_t dijkstraExpanded = 0;
+                size_t astarExpanded = 0;
+                for (nodeid_t start : std::vector<nodeid_t>{0, 23, 79}) {
+                    for (nodeid_t goal=0; goal<grid.numberOfVertices(); ++goal) {
+                        REQUIRE(astar.search(start, goal) == expected[start][goal]);
+                        checkPath(grid, astar.getPath(goal), start, goal, expected[start][goal]);
+                        astarExpanded += astar.getExpandedVertices();
+                        dijkstra.search(start, goal);
+                        dijkstraExpanded += dijkstra.getExpandedVertices();
+                    }
+                }
+                REQUIRE(astarExpanded < dijkstraExpanded);
+            }
+
+            WHEN("saving and loading") {
+                const char* filename = "./landmarks.dat";
+                FILE* f = fopen(filename, "wb");
+                cpp_utils::serializers::saveToFile(f, landmarks);
+                fclose(f);
+
+                Landmarks<long> landmarks2{};
+                f = fopen(filename, "rb");
+                cpp_utils::serializers::loadFromFile(f, landmarks2);
+                fclose(f);
+                std::remove(filename);
+
+                REQUIRE(landmarks2.getLandmarks() == landmarks.getLandmarks());
+                for (nodeid_t start=0; start<grid.numberOfVertices(); start+=7) {
+                    for (nodeid_t goal=0; goal<grid.numberOfVertices(); ++goal) {
+                        REQUIRE(landmarks2.getLowerBound(start, goal) == landmarks.getLowerBound(start, goal));
+                    }
+                }
+            }
+        }
+
+        WHEN("asking more landmarks than vertices") {
+            AdjacentGraph<int, int, int> small = buildGridGraph(2, 2);
+            Landmarks<long> landmarks{small, 10, LandmarkSelection::FARTHEST};
+            REQUIRE(landmarks.numberOfLandmarks() == 4);
+            Landmarks<long> landmarks2{small, 10, LandmarkSelection::AVOID};
+            REQUIRE(landmarks2.numberOfLandmarks() <= 4);
+        }
+    }
+
+    GIVEN("a graph with unreachable vertices") {
+        AdjacentGraph<int, int, int> g = buildUnreachableGraph();
+        Landmarks<int> landmarks{g, std::vector<nodeid_t>{0, 4}};
+
+        REQUIRE(landmarks.getDistanceFromLandmark(0, 3) == Landmarks<int>::INFINITE_COST);
+        REQUIRE(landmarks.getDistanceToLandmark(0, 3) == 1);
+        REQUIRE(landmarks.getDistanceToLandmark(1, 0) == Landmarks<int>::INFINITE_COST);
+        for (nodeid_t start=0; start<g.numberOfVertices(); ++start) {
+            auto expected = getReferenceDistances(g, start);
+            for (nodeid_t goal=0; goal<g.numberOfVertices(); ++goal) {
+                REQUIRE(landmarks.getLowerBound(start, goal) >= 0);
+                if (expected[goal] != std::numeric_limits<long>::max()) {
+                    REQUIRE(landmarks.getLowerBound(start, goal) <= expected[goal]);
+                }
+            }
+        }
+        DijkstraSearch<AdjacentGraph<int, int, int>, int, LandmarkHeuristic<int>> astar{g, landmarks.getHeuristic()};
+        REQUIRE(astar.search(3, 1) == 3);
+        REQUIRE(astar.search(0, 3) == decltype(astar)::INFINITE_COST);
+    }
+
+    GIVEN("degenerate graphs") {
+        ListGraph<int, int, int> lg{0};
+
+        WHEN("the graph is empty") {
+            AdjacentGraph<int, int, int> empty{lg};
+            for (auto selection : std::vector<LandmarkSelection>{LandmarkSelection::FARTHEST, LandmarkSelection::AVOID}) {
+                Landmarks<long> landmarks{empty, 4, selection};
+                REQUIRE(landmarks.numberOfLandmarks() == 0);
+            }
+        }
+
+        WHEN("vertices are at distance 0") {
+            for (int id=0; id<5; ++id) {
+                lg.addVertex(id);
+            }
+            for (int id=0; id<4; ++id) {
+                lg.addEdge(id, id + 1, 0);
+                lg.addEdge(id + 1, id, 0);
+            }
+            AdjacentGraph<int, int, int> g{lg};
+            for (size_t k : std::vector<size_t>{3, 5, 8}) {
+                Landmarks<long> landmarks{g, k, LandmarkSelection::FARTHEST};
+                auto chosen = landmarks.getLandmarks();
+                REQUIRE(chosen.size() == std::min<size_t>(k, 5));
+                std::sort(chosen.begin(), chosen.end());
+                REQUIRE(std::adjacent_find(chosen.begin(), chosen.end()) == chosen.end());
+            }
+        }
+    }
+}
+
+/**
+ * @brief check the SIMD lower bound of some landmarks against the scalar one
+ *
+ */
+template <typename COST>
+static void checkLandmarkBound(std::mt19937& generator) {
+    const COST unreachable = Landmarks<COST>::UNREACHABLE;
+    std::uniform_int_distribution<int> distanceDistribution{0, 1000};
+    std::uniform_int_distribution<int> unreachableDistribution{0, 5};
+    auto randomDistance = [&]() {
+        return unreachableDistribution(generator) == 0 ? unreachable : static_cast<COST>(distanceDistribution(generator));
+    };
+    for (size_t k=0; k<10; ++k) {
+        for (int i=0; i<50; ++i) {
+            std::vector<COST> tables[4];
+            for (auto& table : tables) {
+                for (size_t j=0; j<k; ++j) {
+                    table.push_back(randomDistance());
+                }
+            }
+            const COST expected = graphs::internal::ScalarLandmarkBound<COST>::compute(tables[0].data(), tables[1].data(), tables[2].data(), tables[3].data(), k);
+            REQUIRE(graphs::internal::LandmarkBound<COST>::compute(tables[0].data(), tables[1].data(), tables[2].data(), tables[3].data(), k) == expected);
+            REQUIRE(expected >= 0);
+            REQUIRE(expected <= unreachable);
+        }
+    }
+}
+
+SCENARIO("test landmark bounds") {
+    std::mt19937 generator{0};
+    checkLandmarkBound<int>(generator);
+    checkLandmarkBound<long>(generator);
+    checkLandmarkBound<float>(generator);
+    checkLandmarkBound<double>(generator);
+}
+
+SCENARIO("test graph partitioning") {
+
+    GIVEN("a grid") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(20, 20);
+        const size_t vertices = grid.numberOfVertices();
+
+        WHEN("partitioning it") {
+            for (uint32_t k : std::vector<uint32_t>{1, 2, 3, 4, 7}) {
+                GraphPartition partition{grid, k, 0.03};
+                REQUIRE(partition.numberOfCells() == k);
+                auto sizes = partition.getCellSizes();
+                REQUIRE(std::accumulate(sizes.begin(), sizes.end(), static_cast<size_t>(0)) == vertices);
+                for (auto size : sizes) {
+                    REQUIRE(size > 0);
+                    REQUIRE(size <= std::ceil(1.03 * vertices / k) + 1);
+                }
+
+                size_t cutEdges = 0;
+                std::vector<bool> boundary(vertices, false);
+                grid.forEachEdge([&](nodeid_t sourceId, nodeid_t sinkId, const int& payload) {
+                    if (partition.getCell(sourceId) != partition.getCell(sinkId)) {
+                        cutEdges += 1;
+                        boundary[sourceId] = true;
+                        boundary[sinkId] = true;
+                    }
+                });
+                REQUIRE(partition.numberOfCutEdges() == cutEdges);
+                for (nodeid_t id=0; id<vertices; ++id) {
+                    REQUIRE(partition.isBoundary(id) == boundary[id]);
+                }
+                //slicing the grid in k stripes cuts 2 * 20 edges per slice
+                REQUIRE(cutEdges <= 2 * 20 * (k - 1));
+            }
+            REQUIRE(GraphPartition{grid, 4, 0.03, 5}.getCells() == GraphPartition{grid, 4, 0.03, 5}.getCells());
+            REQUIRE_THROWS(GraphPartition{grid, 0});
+        }
+
+        WHEN("extracting the cells") {
+            GraphPartition partition{grid, 4};
+            auto cells = partition.extractCells(grid);
+            REQUIRE(cells.size() == 4);
+            size_t edges = 0;
+            for (const auto& cell : cells) {
+                const auto& g = cell.getGraph();
+                REQUIRE(g.getPayload() == grid.getPayload());
+                for (nodeid_t localId=0; localId<g.numberOfVertices(); ++localId) {
+                    const nodeid_t globalId = cell.getGlobalId(localId);
+                    REQUIRE(partition.getCell(globalId) == cell.getCellId());
+                    REQUIRE(g.getVertex(localId) == grid.getVertex(globalId));
+                    for (auto& outEdge : g.getOutEdges(localId)) {
+                        REQUIRE(grid.containsEdge(globalId, cell.getGlobalId(outEdge.getSinkId()), outEdge.getPayload()));
+                    }
+                }
+                for (auto localId : cell.getBoundaryVertices()) {
+                    REQUIRE(partition.isBoundary(cell.getGlobalId(localId)));
+                }
+                for (auto& edge : cell.getCutEdges()) {
+                    REQUIRE(partition.getCell(edge.getSourceId()) == cell.getCellId());
+                    REQUIRE(partition.getCell(edge.getSinkId()) != cell.getCellId());
+                    REQUIRE(grid.containsEdge(edge.getSourceId(), edge.getSinkId(), edge.getPayload()));
+                }
+                edges += g.numberOfEdges() + cell.getCutEdges().size();
+            }
+            REQUIRE(edges == grid.numberOfEdges());
+
+            WHEN("building the overlay") {
+                OverlayGraph<long> overlay{cells};
+                size_t boundaryVertices = 0;
+                for (nodeid_t id=0; id<vertices; ++id) {
+                    boundaryVertices += partition.isBoundary(id) ? 1 : 0;
+                    REQUIRE((overlay.getOverlayId(id) != OverlayGraph<long>::NO_VERTEX) == partition.isBoundary(id));
+                }
+                REQUIRE(overlay.numberOfVertices() == boundaryVertices);
+
+                DijkstraSearch<AdjacentGraph<int, nodeid_t, long>, long> search{overlay.getGraph()};
+                for (nodeid_t start=0; start<overlay.numberOfVertices(); start+=5) {
+                    const nodeid_t globalStart = overlay.getGlobalId(start);
+                    REQUIRE(overlay.getOverlayId(globalStart) == start);
+                    auto expected = getReferenceDistances(grid, globalStart);
+                    search.searchAll(start);
+                    for (nodeid_t goal=0; goal<overlay.numberOfVertices(); ++goal) {
+                        REQUIRE(search.getDistance(goal) == expected[overlay.getGlobalId(goal)]);
+                    }
+                }
+
+                THEN("cells handled in separate processes give the same overlay") {
+                    std::vector<std::vector<Edge<long>>> edgeBuffers{};
+                    for (const auto& cell : cells) {
+                        const std::string cellFilename = "./cell" + std::to_string(cell.getCellId()) + ".dat";
+                        const std::string cliqueFilename = "./clique" + std::to_string(cell.getCellId()) + ".dat";
+                        FILE* f = fopen(cellFilename.c_str(), "wb");
+                        cpp_utils::serializers::saveToFile(f, cell);
+                        fclose(f);
+
+                        pid_t child = fork();
+                        REQUIRE(child >= 0);
+                        if (child == 0) {
+                            int status = 0;
+                            try {
+                                GraphCell<int, int, int> loaded{};
+                                FILE* in = fopen(cellFilename.c_str(), "rb");
+                                cpp_utils::serializers::loadFromFile(in, loaded);
+                                fclose(in);
+                                FILE* out = fopen(cliqueFilename.c_str(), "wb");
+                                cpp_utils::serializers::saveToFile(out, loaded.getBoundaryDistances<long>());
+                                fclose(out);
+                            } catch (...) {
+                                status = 1;
+                            }
+                            _exit(status);
+                        }
+                        int status;
+                        REQUIRE(waitpid(child, &status, 0) == child);
+                        REQUIRE(WIFEXITED(status));
+                        REQUIRE(WEXITSTATUS(status) == 0);
+
+                        std::vector<Edge<long>> clique{};
+                        f = fopen(cliqueFilename.c_str(), "rb");
+                        cpp_utils::serializers::loadFromFile(f, clique);
+                        fclose(f);
+                        std::remove(cellFilename.c_str());
+                        std::remove(cliqueFilename.c_str());
+                        REQUIRE(clique == cell.getBoundaryDistances<long>());
+
+                        for (auto& edge : cell.getCutEdges()) {
+                            clique.emplace_back(edge.getSourceId(), edge.getSinkId(), edge.getPayload());
+                        }
+                        edgeBuffers.push_back(std::move(clique));
+                    }
+
+                    OverlayGraph<long> merged{vertices, edgeBuffers};
+                    REQUIRE(merged.numberOfVertices() == overlay.numberOfVertices());
+                    REQUIRE(merged.getGraph().numberOfEdges() == overlay.getGraph().numberOfEdges());
+                    for (nodeid_t id=0; id<overlay.numberOfVertices(); ++id) {
+                        REQUIRE(merged.getGlobalId(id) == overlay.getGlobalId(id));
+                        for (auto& outEdge : overlay.getGraph().getOutEdges(id)) {
+                            REQUIRE(merged.getGraph().containsEdge(id, outEdge.getSinkId(), outEdge.getPayload()));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("a graph with several components and isolated vertices") {
+        AdjacentGraph<int, int, int> grid = buildGridGraph(10, 10);
+        AdjacentGraph<int, int, int> g{0};
+        for (int id=0; id<300; ++id) {
+            g.addVertex(id);
+        }
+        for (nodeid_t id=0; id<grid.numberOfVertices(); ++id) {
+            for (auto& outEdge : grid.getOutEdges(id)) {
+                g.addEdgeTail(id, outEdge.getSinkId(), outEdge.getPayload());
+                g.addEdgeTail(id, outEdge.getSinkId(), outEdge.getPayload());
+            }
+            g.addEdgeTail(id, id, 1);
+        }
+        for (nodeid_t id=100; id<200; ++id) {
+            g.addEdgeTail(id, (id - 100 + 1) % 100 + 100, 1);
+        }
+        g.finalizeGraph();
+
+        GraphPartition partition{g, 3, 0.1};
+        for (auto size : partition.getCellSizes()) {
+            REQUIRE(size >= 90);
+            REQUIRE(size <= 111);
+        }
+        auto cells = partition.extractCells(g);
+        OverlayGraph<long> overlay{cells};
+        for (nodeid_t id=0; id<overlay.numberOfVertices(); ++id) {
+            REQUIRE(partition.isBoundary(overlay.getGlobalId(id)));
+        }
+        for (nodeid_t id=200; id<300; ++id) {
+            REQUIRE_FALSE(partition.isBoundary(id));
+        }
+    }
+}
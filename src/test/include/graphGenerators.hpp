@@ -0,0 +1,67 @@
+#ifndef _GRAPHGENERATORS_HEADER__
+#define _GRAPHGENERATORS_HEADER__
+
+#include "adjacentGraph.hpp"
+
+/**
+ * @brief a 4-connected grid graph, used to test and benchmark the graph algorithms
+ *
+ * The vertex in cell (x, y) has id `y * width + x` and its payload is its id. Every edge is present in both directions;
+ * weights are deterministic but not uniform, so that shortest paths are not trivial.
+ *
+ * @param width number of columns of the grid
+ * @param height number of rows of the grid
+ * @return cpp_utils::graphs::AdjacentGraph<int, int, int> the grid. The payload of the graph is the width
+ */
+inline cpp_utils::graphs::AdjacentGraph<int, int, int> buildGridGraph(int width, int height) {
+    cpp_utils::graphs::AdjacentGraph<int, int, int> result{width};
+
+    for (int id=0; id<(width * height); ++id) {
+        result.addVertex(id);
+    }
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            int id = y * width + x;
+            int weight = 1 + ((x * 7 + y * 13) % 10);
+            if (y > 0) {
+                result.addEdgeTail(id, id - width, weight);
+            }
+            if (x > 0) {
+                result.addEdgeTail(id, id - 1, weight);
+            }
+            if (x + 1 < width) {
+                result.addEdgeTail(id, id + 1, weight);
+            }
+            if (y + 1 < height) {
+                result.addEdgeTail(id, id + width, weight);
+            }
+        }
+    }
+    result.finalizeGraph();
+    return result;
+}
+
+/**
+ * @brief a tiny directed graph where not every vertex reaches every other one, used to test the corner cases of searches
+ *
+ * The edges are 0->1 (weight 5), 0->2 (weights 3 and 1), 2->1 (1) and 3->0 (1); the vertex 4 has no edges at all.
+ * Hence the shortest path from 0 to 1 is 0, 2, 1 (cost 2), nothing reaches 3 and 4 is isolated.
+ *
+ * @return cpp_utils::graphs::AdjacentGraph<int, int, int> the graph. The payload of each vertex is its id
+ */
+inline cpp_utils::graphs::AdjacentGraph<int, int, int> buildUnreachableGraph() {
+    cpp_utils::graphs::AdjacentGraph<int, int, int> result{0};
+
+    for (int id=0; id<5; ++id) {
+        result.addVertex(id);
+    }
+    result.addEdgeTail(0, 1, 5);
+    result.addEdgeTail(0, 2, 3);
+    result.addEdgeTail(0, 2, 1);
+    result.addEdgeTail(2, 1, 1);
+    result.addEdgeTail(3, 0, 1);
+    result.finalizeGraph();
+    return result;
+}
+
+#endif